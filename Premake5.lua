@@ -1,5 +1,22 @@
 include "../BTDSTD3"
 
+--asset pack compression, set SMOK_PACK_LZ4 or SMOK_PACK_ZSTD to true to build with it, the library has to be findable by the linker
+--every project reading or writing packs has to agree, so games using Smok call SmokAssetPackCompression() in their project too
+SMOK_PACK_LZ4 = SMOK_PACK_LZ4 or false
+SMOK_PACK_ZSTD = SMOK_PACK_ZSTD or false
+
+function SmokAssetPackCompression()
+    if SMOK_PACK_LZ4 then
+        defines { "SMOK_ASSET_PACK_LZ4" }
+        links { "lz4" }
+    end
+
+    if SMOK_PACK_ZSTD then
+        defines { "SMOK_ASSET_PACK_ZSTD" }
+        links { "zstd" }
+    end
+end
+
 project "Smok"
 kind "StaticLib"
 language "C++"
@@ -38,6 +55,8 @@ links
 "BTDSTD",
 }
 
+SmokAssetPackCompression()
+
 
 defines
 {
@@ -125,4 +144,348 @@ defines
 flags
 {
 "LinkTimeOptimization",
+}
+
+--benchmarks, needs Google Benchmark built next to Smok or GOOGLE_BENCHMARK_DIR set to it's install
+GOOGLE_BENCHMARK_DIR = GOOGLE_BENCHMARK_DIR or "../benchmark"
+
+filter {}
+
+project "SmokBench"
+kind "ConsoleApp"
+language "C++"
+targetdir ("bin/%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}/SmokBench")
+objdir ("bin/%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}/SmokBench")
+
+files 
+{
+"./bench/**.hpp",
+"./bench/**.cpp",
+}
+
+includedirs 
+{
+---base code
+"./includes",
+"./bench",
+
+"../" .. BTD_INCLUDE,
+"../BTDSTD3/" .. GLM_INCLUDE,
+"../BTDSTD3/" .. FMT_INCLUDE,
+"../BTDSTD3/" .. SDL_INCLUDE,
+
+"../BTDSTD3/" .. VK_BOOTSTRAP_INCLUDE,
+"../BTDSTD3/" .. STB_INCLUDE,
+"../BTDSTD3/" .. VOLK_INCLUDE,
+"../BTDSTD3/" .. VMA_INCLUDE,
+VULKAN_SDK_MANUAL_OVERRIDE,
+
+GOOGLE_BENCHMARK_DIR .. "/include",
+}
+
+libdirs
+{
+GOOGLE_BENCHMARK_DIR .. "/lib",
+}
+
+links
+{
+"Smok",
+"BTDSTD",
+"benchmark",
+}
+
+SmokAssetPackCompression()
+
+
+defines
+{
+"GLM_FORCE_DEPTH_ZERO_TO_ONE",
+"GLM_FORCE_RADIANS",
+"GLM_ENABLE_EXPERIMENTAL",
+}
+
+
+flags
+{
+"MultiProcessorCompile",
+"NoRuntimeChecks",
+}
+
+
+--platforms
+filter "system:windows"
+    cppdialect "C++20"
+    staticruntime "On"
+    systemversion "latest"
+    buildoptions "/utf-8"
+
+
+defines
+{
+"Window_Build",
+"VK_USE_PLATFORM_WIN32_KHR",
+"Desktop_Build",
+"BENCHMARK_STATIC_DEFINE",
+}
+
+links
+{
+"Shlwapi",
+}
+
+filter "system:linux"
+    cppdialect "C++20"
+    staticruntime "On"
+    systemversion "latest"
+
+
+defines
+{
+"Linux_Build",
+"VK_USE_PLATFORM_XLIB_KHR",
+"Desktop_Build",
+}
+
+links
+{
+"pthread",
+}
+
+--configs, benchmarks are only meaningful in Release or Dist
+filter "configurations:Debug"
+    defines "BTD_DEBUG"
+    symbols "On"
+
+filter "configurations:Release"
+    defines "BTD_RELEASE"
+    optimize "On"
+
+
+filter "configurations:Dist"
+    defines "BTD_DIST"
+    optimize "On"
+
+
+defines
+{
+"NDEBUG",
+}
+
+--the asset packer
+filter {}
+
+project "SmokPack"
+kind "ConsoleApp"
+language "C++"
+targetdir ("bin/%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}/SmokPack")
+objdir ("bin/%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}/SmokPack")
+
+files 
+{
+"./tools/SmokPack/**.hpp",
+"./tools/SmokPack/**.cpp",
+}
+
+includedirs 
+{
+---base code
+"./includes",
+
+"../" .. BTD_INCLUDE,
+"../BTDSTD3/" .. GLM_INCLUDE,
+"../BTDSTD3/" .. FMT_INCLUDE,
+"../BTDSTD3/" .. SDL_INCLUDE,
+
+"../BTDSTD3/" .. VK_BOOTSTRAP_INCLUDE,
+"../BTDSTD3/" .. STB_INCLUDE,
+"../BTDSTD3/" .. VOLK_INCLUDE,
+"../BTDSTD3/" .. VMA_INCLUDE,
+VULKAN_SDK_MANUAL_OVERRIDE,
+}
+
+links
+{
+"Smok",
+"BTDSTD",
+}
+
+SmokAssetPackCompression()
+
+
+defines
+{
+"GLM_FORCE_DEPTH_ZERO_TO_ONE",
+"GLM_FORCE_RADIANS",
+"GLM_ENABLE_EXPERIMENTAL",
+}
+
+
+flags
+{
+"MultiProcessorCompile",
+"NoRuntimeChecks",
+}
+
+
+--platforms
+filter "system:windows"
+    cppdialect "C++20"
+    staticruntime "On"
+    systemversion "latest"
+    buildoptions "/utf-8"
+
+
+defines
+{
+"Window_Build",
+"VK_USE_PLATFORM_WIN32_KHR",
+"Desktop_Build",
+}
+
+filter "system:linux"
+    cppdialect "C++20"
+    staticruntime "On"
+    systemversion "latest"
+
+
+defines
+{
+"Linux_Build",
+"VK_USE_PLATFORM_XLIB_KHR",
+"Desktop_Build",
+}
+
+links
+{
+"pthread",
+}
+
+--configs
+filter "configurations:Debug"
+    defines "BTD_DEBUG"
+    symbols "On"
+
+filter "configurations:Release"
+    defines "BTD_RELEASE"
+    optimize "On"
+
+
+filter "configurations:Dist"
+    defines "BTD_DIST"
+    optimize "On"
+
+
+defines
+{
+"NDEBUG",
+}
+
+--the incremental mesh cooker
+filter {}
+
+project "SmokCook"
+kind "ConsoleApp"
+language "C++"
+targetdir ("bin/%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}/SmokCook")
+objdir ("bin/%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}/SmokCook")
+
+files 
+{
+"./tools/SmokCook/**.hpp",
+"./tools/SmokCook/**.cpp",
+}
+
+includedirs 
+{
+---base code
+"./includes",
+
+"../" .. BTD_INCLUDE,
+"../BTDSTD3/" .. GLM_INCLUDE,
+"../BTDSTD3/" .. FMT_INCLUDE,
+"../BTDSTD3/" .. SDL_INCLUDE,
+
+"../BTDSTD3/" .. VK_BOOTSTRAP_INCLUDE,
+"../BTDSTD3/" .. STB_INCLUDE,
+"../BTDSTD3/" .. VOLK_INCLUDE,
+"../BTDSTD3/" .. VMA_INCLUDE,
+VULKAN_SDK_MANUAL_OVERRIDE,
+}
+
+links
+{
+"Smok",
+"BTDSTD",
+}
+
+SmokAssetPackCompression()
+
+
+defines
+{
+"GLM_FORCE_DEPTH_ZERO_TO_ONE",
+"GLM_FORCE_RADIANS",
+"GLM_ENABLE_EXPERIMENTAL",
+}
+
+
+flags
+{
+"MultiProcessorCompile",
+"NoRuntimeChecks",
+}
+
+
+--platforms
+filter "system:windows"
+    cppdialect "C++20"
+    staticruntime "On"
+    systemversion "latest"
+    buildoptions "/utf-8"
+
+
+defines
+{
+"Window_Build",
+"VK_USE_PLATFORM_WIN32_KHR",
+"Desktop_Build",
+}
+
+filter "system:linux"
+    cppdialect "C++20"
+    staticruntime "On"
+    systemversion "latest"
+
+
+defines
+{
+"Linux_Build",
+"VK_USE_PLATFORM_XLIB_KHR",
+"Desktop_Build",
+}
+
+links
+{
+"pthread",
+}
+
+--configs
+filter "configurations:Debug"
+    defines "BTD_DEBUG"
+    symbols "On"
+
+filter "configurations:Release"
+    defines "BTD_RELEASE"
+    optimize "On"
+
+
+filter "configurations:Dist"
+    defines "BTD_DIST"
+    optimize "On"
+
+
+defines
+{
+"NDEBUG",
 }
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+
+//defines the synthetic data used by SmokBench
+//everything is made from a fixed seed so a run is comparable against a baseline from another machine or commit
+
+#include <Smok/Assets/Mesh.hpp>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Smok::Bench
+{
+	//defines a small deterministic random generator, the std engines are not the same across standard libraries
+	struct BenchRandom
+	{
+		uint64_t state = 0x9E3779B97F4A7C15ull;
+
+		BenchRandom() = default;
+		BenchRandom(const uint64_t& seed) : state(seed ? seed : 0x9E3779B97F4A7C15ull) {}
+
+		//gets the next number, xorshift64*
+		inline uint64_t Next()
+		{
+			state ^= state >> 12;
+			state ^= state << 25;
+			state ^= state >> 27;
+			return state * 0x2545F4914F6CDD1Dull;
+		}
+
+		//gets a number in [0, range)
+		inline uint32_t NextRange(const uint32_t& range) { return (uint32_t)((Next() >> 32) % range); }
+
+		//gets a float in [min, max)
+		inline float NextFloat(const float& min, const float& max) { return min + (float)((Next() >> 40) * (1.0 / 16777216.0)) * (max - min); }
+	};
+
+	//makes a grid of sideCount x sideCount vertices with two triangles per cell, split into subMeshCount sub-meshes
+	static inline Smok::Asset::Mesh::StaticMesh MakeGridMesh(const uint32_t& sideCount, const uint32_t& subMeshCount = 1)
+	{
+		Smok::Asset::Mesh::StaticMesh mesh;
+		BenchRandom random(sideCount);
+
+		mesh.vertices.resize((size_t)sideCount * sideCount);
+		for (uint32_t y = 0; y < sideCount; ++y)
+		{
+			for (uint32_t x = 0; x < sideCount; ++x)
+			{
+				Smok::Asset::Mesh::Vertex& v = mesh.vertices[(size_t)y * sideCount + x];
+				v.position = { (float)x, random.NextFloat(-0.5f, 0.5f), (float)y };
+				v.normal = { 0.0f, 1.0f, 0.0f };
+				v.color = { random.NextFloat(0.0f, 1.0f), random.NextFloat(0.0f, 1.0f), random.NextFloat(0.0f, 1.0f) };
+				v.textureCoords = { (float)x / (float)sideCount, (float)y / (float)sideCount };
+			}
+		}
+
+		//rows of cells are dealt out to the sub-meshes in even bands
+		const uint32_t cellRows = (sideCount > 1 ? sideCount - 1 : 0);
+		mesh.meshes.resize(subMeshCount);
+		for (uint32_t y = 0; y < cellRows; ++y)
+		{
+			std::vector<uint32_t>& indices = mesh.meshes[(size_t)y * subMeshCount / cellRows].indices;
+			for (uint32_t x = 0; x < sideCount - 1; ++x)
+			{
+				const uint32_t i = y * sideCount + x;
+				indices.insert(indices.end(), { i, i + sideCount, i + 1, i + 1, i + sideCount, i + sideCount + 1 });
+			}
+		}
+
+		return mesh;
+	}
+
+	//expands a mesh into a triangle soup, every index becomes it's own vertex, the input to a deduplication pass
+	static inline std::vector<Smok::Asset::Mesh::Vertex> MakeTriangleSoup(const Smok::Asset::Mesh::StaticMesh& mesh)
+	{
+		std::vector<Smok::Asset::Mesh::Vertex> soup;
+		for (size_t m = 0; m < mesh.meshes.size(); ++m)
+		{
+			for (size_t i = 0; i < mesh.meshes[m].indices.size(); ++i)
+				soup.emplace_back(mesh.vertices[mesh.meshes[m].indices[i]]);
+		}
+		return soup;
+	}
+
+	//shuffles the triangles of every sub-mesh, imported meshes come in a order with little cache reuse like this
+	static inline void ShuffleTriangles(Smok::Asset::Mesh::StaticMesh& mesh, const uint64_t& seed = 1)
+	{
+		BenchRandom random(seed);
+		for (size_t m = 0; m < mesh.meshes.size(); ++m)
+		{
+			std::vector<uint32_t>& indices = mesh.meshes[m].indices;
+			for (size_t t = indices.size() / 3; t > 1; --t)
+			{
+				const size_t other = random.NextRange((uint32_t)t);
+				for (size_t c = 0; c < 3; ++c)
+					std::swap(indices[(t - 1) * 3 + c], indices[other * 3 + c]);
+			}
+		}
+	}
+}
\ No newline at end of file
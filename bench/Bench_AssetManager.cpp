@@ -0,0 +1,94 @@
+//benchmarks asset manager registration and lookup, nothing is loaded so no GPU or files are needed
+
+#include "BenchData.hpp"
+
+#include <Smok/Assets/AssetManager.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+
+using namespace Smok::Asset::AssetManager;
+
+//makes the asset names used by the benchmarks
+static inline std::vector<std::string> MakeAssetNames(const size_t& count)
+{
+	std::vector<std::string> names(count);
+	for (size_t i = 0; i < count; ++i)
+		names[i] = "Meshes/Level_" + std::to_string(i / 64) + "/StaticMesh_" + std::to_string(i);
+	return names;
+}
+
+//registers static meshes into a empty manager
+static void BM_AssetManagerRegisterStaticMesh(benchmark::State& state)
+{
+	const std::vector<std::string> names = MakeAssetNames((size_t)state.range(0));
+	const BTD::IO::FileInfo declFile("Bench.smeshdecl"), binaryFile("Bench.smesh");
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		std::unique_ptr<AssetManager> manager = std::make_unique<AssetManager>();
+		state.ResumeTiming();
+
+		for (size_t i = 0; i < names.size(); ++i)
+			benchmark::DoNotOptimize(manager->RegisterAsset_StaticMesh(names[i], declFile, binaryFile));
+
+		state.PauseTiming();
+		manager.reset();
+		state.ResumeTiming();
+	}
+
+	state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AssetManagerRegisterStaticMesh)->Arg(1024)->Arg(16384)->Unit(benchmark::kMicrosecond);
+
+//makes a manager with count static meshes registered
+static inline std::unique_ptr<AssetManager> MakeRegisteredManager(const std::vector<std::string>& names, std::vector<uint64_t>& IDs)
+{
+	std::unique_ptr<AssetManager> manager = std::make_unique<AssetManager>();
+	const BTD::IO::FileInfo declFile("Bench.smeshdecl"), binaryFile("Bench.smesh");
+	IDs.resize(names.size());
+	for (size_t i = 0; i < names.size(); ++i)
+		IDs[i] = manager->RegisterAsset_StaticMesh(names[i], declFile, binaryFile);
+	return manager;
+}
+
+//looks up static meshes by ID in a shuffled order so the slot map is not walked in sequence
+static void BM_AssetManagerLookupByID(benchmark::State& state)
+{
+	const std::vector<std::string> names = MakeAssetNames((size_t)state.range(0));
+	std::vector<uint64_t> IDs;
+	std::unique_ptr<AssetManager> manager = MakeRegisteredManager(names, IDs);
+
+	Smok::Bench::BenchRandom random(IDs.size());
+	for (size_t i = IDs.size(); i > 1; --i)
+		std::swap(IDs[i - 1], IDs[random.NextRange((uint32_t)i)]);
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < IDs.size(); ++i)
+			benchmark::DoNotOptimize(manager->GetStaticMesh(IDs[i]));
+	}
+
+	state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AssetManagerLookupByID)->Arg(1024)->Arg(16384);
+
+//looks up static meshes by name, the AssetID is hashed from the string each time like a runtime built name would be
+static void BM_AssetManagerLookupByName(benchmark::State& state)
+{
+	const std::vector<std::string> names = MakeAssetNames((size_t)state.range(0));
+	std::vector<uint64_t> IDs;
+	std::unique_ptr<AssetManager> manager = MakeRegisteredManager(names, IDs);
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < names.size(); ++i)
+			benchmark::DoNotOptimize(manager->GetStaticMesh(Smok::Asset::AssetID(names[i])));
+	}
+
+	state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AssetManagerLookupByName)->Arg(1024)->Arg(16384);
\ No newline at end of file
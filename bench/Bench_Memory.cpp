@@ -0,0 +1,153 @@
+//benchmarks the deletion queue and the offset allocator
+
+#include "BenchData.hpp"
+
+#include <Smok/Memory/LifetimeDeleteQueue.hpp>
+#include <Smok/Memory/OffsetAllocator.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <functional>
+
+using namespace Smok::Memory;
+
+//pushes lambdas into a deletion queue and flushes it
+static void BM_DeletionQueuePushFlush(benchmark::State& state)
+{
+	DeletionQueue queue;
+	uint64_t sum = 0;
+
+	for (auto _ : state)
+	{
+		for (int64_t i = 0; i < state.range(0); ++i)
+			queue.push([&sum, i]() { sum += (uint64_t)i; });
+		queue.flush();
+	}
+
+	benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DeletionQueuePushFlush)->Arg(64)->Arg(4096);
+
+//the same through push_function, the std::function path kept for existing code
+static void BM_DeletionQueuePushFunctionFlush(benchmark::State& state)
+{
+	DeletionQueue queue;
+	uint64_t sum = 0;
+
+	for (auto _ : state)
+	{
+		for (int64_t i = 0; i < state.range(0); ++i)
+			queue.push_function([&sum, i]() { sum += (uint64_t)i; });
+		queue.flush();
+	}
+
+	benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DeletionQueuePushFunctionFlush)->Arg(64)->Arg(4096);
+
+//allocates then frees a batch of mixed sizes
+static void BM_OffsetAllocatorAllocateFree(benchmark::State& state)
+{
+	const size_t count = (size_t)state.range(0);
+	Smok::Bench::BenchRandom random(count);
+	std::vector<uint32_t> sizes(count);
+	for (size_t i = 0; i < count; ++i)
+		sizes[i] = 1 + random.NextRange(4096);
+
+	OffsetAllocator allocator;
+	allocator.Init(1u << 30, (uint32_t)count + 1);
+	std::vector<OffsetAllocation> allocations(count);
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < count; ++i)
+			allocations[i] = allocator.Allocate(sizes[i]);
+		for (size_t i = 0; i < count; ++i)
+			allocator.Free(allocations[i]);
+	}
+
+	state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)count * 2);
+}
+BENCHMARK(BM_OffsetAllocatorAllocateFree)->Arg(1024)->Arg(65536);
+
+//frees and allocates random ranges in a full allocator, the way meshes stream in and out of the geometry pool
+//the counters report how fragmented the free space ends up, largestFree / totalFree near 1 means it's in one piece
+static void BM_OffsetAllocatorFragmentation(benchmark::State& state)
+{
+	const size_t count = (size_t)state.range(0);
+	const uint32_t capacity = (uint32_t)count * 2048;
+	Smok::Bench::BenchRandom random(count);
+
+	OffsetAllocator allocator;
+	allocator.Init(capacity, (uint32_t)count * 2);
+	std::vector<OffsetAllocation> allocations;
+	allocations.reserve(count);
+	while (allocations.size() < count)
+	{
+		const OffsetAllocation allocation = allocator.Allocate(1 + random.NextRange(2048));
+		if (!allocation.IsValid())
+			break;
+		allocations.emplace_back(allocation);
+	}
+
+	uint64_t failed = 0;
+	for (auto _ : state)
+	{
+		const size_t slot = random.NextRange((uint32_t)allocations.size());
+		allocator.Free(allocations[slot]);
+		allocations[slot] = allocator.Allocate(1 + random.NextRange(2048));
+		if (!allocations[slot].IsValid())
+		{
+			failed++;
+			allocations[slot] = allocator.Allocate(1); //keeps the slot live so it can be freed again
+		}
+	}
+
+	const OffsetAllocatorReport report = allocator.GetReport();
+	state.counters["failedAllocations"] = (double)failed;
+	state.counters["freeRanges"] = (double)report.freeRanges;
+	state.counters["largestFreeRatio"] = (report.totalFree > 0 ? (double)report.largestFree / (double)report.totalFree : 1.0);
+	state.SetItemsProcessed((int64_t)state.iterations() * 2);
+}
+BENCHMARK(BM_OffsetAllocatorFragmentation)->Arg(1024)->Arg(16384);
+
+//packs a fragmented allocator back into one run
+static void BM_OffsetAllocatorCompact(benchmark::State& state)
+{
+	const size_t count = (size_t)state.range(0);
+	Smok::Bench::BenchRandom random(count);
+	std::vector<uint32_t> sizes(count);
+	for (size_t i = 0; i < count; ++i)
+		sizes[i] = 1 + random.NextRange(2048);
+
+	OffsetAllocator allocator;
+	std::vector<OffsetAllocation> allocations(count);
+	std::vector<OffsetAllocation*> live;
+	std::vector<OffsetMove> moves;
+
+	for (auto _ : state)
+	{
+		//every other range is freed so there is a hole after each live one
+		state.PauseTiming();
+		allocator.Init((uint32_t)count * 4096, (uint32_t)count + 1);
+		live.clear();
+		for (size_t i = 0; i < count; ++i)
+			allocations[i] = allocator.Allocate(sizes[i]);
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (i & 1)
+				allocator.Free(allocations[i]);
+			else
+				live.emplace_back(&allocations[i]);
+		}
+		state.ResumeTiming();
+
+		allocator.Compact(live.data(), live.size(), moves);
+		benchmark::DoNotOptimize(moves.data());
+	}
+
+	state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)(count / 2));
+}
+BENCHMARK(BM_OffsetAllocatorCompact)->Arg(1024)->Arg(16384);
\ No newline at end of file
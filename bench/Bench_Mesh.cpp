@@ -0,0 +1,285 @@
+//benchmarks the smesh serializer and vertex deduplication
+
+#include "BenchData.hpp"
+
+#include <Smok/Assets/VertexWeld.hpp>
+#include <Smok/Assets/MeshOptimize.hpp>
+#include <Smok/Assets/MeshletBuild.hpp>
+#include <Smok/Assets/MeshCodec.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <filesystem>
+
+using namespace Smok::Asset::Mesh;
+
+//gets the files a benchmark writes it's smesh to, in the temp directory
+static inline void GetBenchMeshFiles(const std::string& name, BTD::IO::FileInfo& declFile, BTD::IO::FileInfo& binaryFile)
+{
+	const std::filesystem::path base = std::filesystem::temp_directory_path() / ("SmokBench_" + name);
+	declFile = BTD::IO::FileInfo(base.string() + "." + Serilize::GetSmeshDeclFileExtensionStr());
+	binaryFile = BTD::IO::FileInfo(base.string() + "." + Serilize::GetSmeshBinaryFileExtensionStr());
+}
+
+//writes a grid mesh, the arg is the grid side so vertices grow with it's square
+static void BM_WriteStaticMesh(benchmark::State& state)
+{
+	const StaticMesh mesh = Smok::Bench::MakeGridMesh((uint32_t)state.range(0), 4);
+	BTD::IO::FileInfo declFile, binaryFile;
+	GetBenchMeshFiles("Write", declFile, binaryFile);
+
+	for (auto _ : state)
+	{
+		if (!Serilize::WriteStaticMeshDataToFile(declFile, binaryFile, mesh))
+		{
+			state.SkipWithError("WriteStaticMeshDataToFile failed");
+			break;
+		}
+	}
+
+	state.SetBytesProcessed((int64_t)state.iterations() * (int64_t)std::filesystem::file_size(binaryFile.GetPathStr()));
+	state.counters["vertices"] = (double)mesh.vertices.size();
+}
+BENCHMARK(BM_WriteStaticMesh)->Arg(32)->Arg(128)->Arg(512)->Unit(benchmark::kMillisecond);
+
+//loads a grid mesh written once up front
+static void BM_LoadStaticMesh(benchmark::State& state)
+{
+	const StaticMesh mesh = Smok::Bench::MakeGridMesh((uint32_t)state.range(0), 4);
+	BTD::IO::FileInfo declFile, binaryFile;
+	GetBenchMeshFiles("Load", declFile, binaryFile);
+	if (!Serilize::WriteStaticMeshDataToFile(declFile, binaryFile, mesh))
+	{
+		state.SkipWithError("WriteStaticMeshDataToFile failed");
+		return;
+	}
+
+	for (auto _ : state)
+	{
+		StaticMesh loaded;
+		if (!Serilize::LoadStaticMeshDataFromFile(declFile, binaryFile, loaded))
+		{
+			state.SkipWithError("LoadStaticMeshDataFromFile failed");
+			break;
+		}
+		benchmark::DoNotOptimize(loaded.vertices.data());
+	}
+
+	state.SetBytesProcessed((int64_t)state.iterations() * (int64_t)std::filesystem::file_size(binaryFile.GetPathStr()));
+	state.counters["vertices"] = (double)mesh.vertices.size();
+}
+BENCHMARK(BM_LoadStaticMesh)->Arg(32)->Arg(128)->Arg(512)->Unit(benchmark::kMillisecond);
+
+//packs and unpacks a grid mesh with random normals and texture coords in a layout, the arg is the VertexLayout
+//fails if any attribute moved further from the float data than the layout's quantization allows
+static void BM_VertexPackingRoundTrip(benchmark::State& state)
+{
+	StaticMesh mesh = Smok::Bench::MakeGridMesh(256);
+	Smok::Bench::BenchRandom random(4);
+	for (Vertex& v : mesh.vertices)
+	{
+		v.normal = glm::normalize(glm::vec3(random.NextFloat(-1.0f, 1.0f), random.NextFloat(-1.0f, 1.0f), random.NextFloat(0.1f, 1.0f)));
+		v.textureCoords = { random.NextFloat(0.0f, 1.0f), random.NextFloat(0.0f, 1.0f) };
+	}
+
+	const VertexLayout layout = (VertexLayout)state.range(0);
+	VertexPackingError error;
+	for (auto _ : state)
+	{
+		error = MeasureVertexPackingError(mesh.vertices.data(), mesh.vertices.size(), layout);
+		benchmark::DoNotOptimize(error);
+	}
+
+	//half a step of each format, positions and unorm16 texture coords are quantized over the mesh's ranges
+	const VertexQuantization quantization = CalculateVertexQuantization(mesh.vertices.data(), mesh.vertices.size());
+	const bool positionsAreQuantized = (layout == VertexLayout::Quantized_HalfUV || layout == VertexLayout::Quantized_UNorm16UV);
+	const bool textureCoordsAreHalf = (layout == VertexLayout::Packed_HalfUV || layout == VertexLayout::Quantized_HalfUV);
+	const float maxPositionError = (positionsAreQuantized ? glm::length(quantization.positionExtent) * (0.5f / 65535.0f + 1e-6f) : 0.0f);
+	const float maxNormalAngleError = 0.001f;
+	const float maxColorError = 0.004f;
+	const float maxTextureCoordsError = (textureCoordsAreHalf ? 0.001f : glm::length(quantization.textureCoordsExtent) * (0.5f / 65535.0f + 1e-6f));
+	if (error.maxPositionError > maxPositionError || error.maxNormalAngleError > maxNormalAngleError ||
+		error.maxColorError > maxColorError || error.maxTextureCoordsError > maxTextureCoordsError)
+		state.SkipWithError("packing error is over the layout's bound");
+
+	state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)mesh.vertices.size());
+	state.counters["position_error"] = error.maxPositionError;
+	state.counters["normal_angle_error"] = error.maxNormalAngleError;
+	state.counters["color_error"] = error.maxColorError;
+	state.counters["texture_coords_error"] = error.maxTextureCoordsError;
+}
+BENCHMARK(BM_VertexPackingRoundTrip)->Arg((int64_t)VertexLayout::Float)->Arg((int64_t)VertexLayout::Packed_HalfUV)->Arg((int64_t)VertexLayout::Packed_UNorm16UV)
+	->Arg((int64_t)VertexLayout::Quantized_HalfUV)->Arg((int64_t)VertexLayout::Quantized_UNorm16UV)->Unit(benchmark::kMillisecond);
+
+//dedups a triangle soup with the linear VertexIsAlreadyInArray search, it's O(n^2) so the sizes are kept small
+static void BM_VertexIsAlreadyInArray(benchmark::State& state)
+{
+	const std::vector<Vertex> soup = Smok::Bench::MakeTriangleSoup(Smok::Bench::MakeGridMesh((uint32_t)state.range(0)));
+	std::vector<Vertex> unique;
+	std::vector<uint32_t> indices;
+
+	for (auto _ : state)
+	{
+		unique.clear();
+		indices.clear();
+		for (size_t i = 0; i < soup.size(); ++i)
+		{
+			size_t index = 0;
+			if (!VertexIsAlreadyInArray(unique.data(), unique.size(), soup[i], index))
+			{
+				index = unique.size();
+				unique.emplace_back(soup[i]);
+			}
+			indices.emplace_back((uint32_t)index);
+		}
+		benchmark::DoNotOptimize(indices.data());
+	}
+
+	state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)soup.size());
+}
+BENCHMARK(BM_VertexIsAlreadyInArray)->Arg(8)->Arg(16)->Arg(32)->Unit(benchmark::kMicrosecond);
+
+//dedups the same soups with the hashed welder for comparison
+static void BM_WeldTriangleSoup(benchmark::State& state)
+{
+	const std::vector<Vertex> soup = Smok::Bench::MakeTriangleSoup(Smok::Bench::MakeGridMesh((uint32_t)state.range(0)));
+
+	for (auto _ : state)
+	{
+		StaticMesh mesh;
+		WeldTriangleSoup(soup.data(), soup.size(), mesh);
+		benchmark::DoNotOptimize(mesh.vertices.data());
+	}
+
+	state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)soup.size());
+}
+BENCHMARK(BM_WeldTriangleSoup)->Arg(8)->Arg(16)->Arg(32)->Arg(256)->Unit(benchmark::kMicrosecond);
+
+//optimizes a grid mesh whose triangles were shuffled, the counters are the simulated cache results before and after
+static void BM_OptimizeStaticMesh(benchmark::State& state)
+{
+	StaticMesh source = Smok::Bench::MakeGridMesh((uint32_t)state.range(0));
+	Smok::Bench::ShuffleTriangles(source);
+	MeshOptimizeStats stats;
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		StaticMesh mesh = source;
+		state.ResumeTiming();
+
+		stats = OptimizeStaticMesh(mesh);
+		benchmark::DoNotOptimize(mesh.meshes[0].indices.data());
+	}
+
+	state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)stats.before.triangleCount);
+	state.counters["ACMR_before"] = stats.before.ACMR;
+	state.counters["ACMR_after"] = stats.after.ACMR;
+	state.counters["ATVR_before"] = stats.before.ATVR;
+	state.counters["ATVR_after"] = stats.after.ATVR;
+}
+BENCHMARK(BM_OptimizeStaticMesh)->Arg(32)->Arg(128)->Arg(512)->Unit(benchmark::kMillisecond);
+
+//builds meshlets for a grid mesh whose triangles were shuffled, the counters show how full the meshlets are
+static void BM_BuildStaticMeshMeshlets(benchmark::State& state)
+{
+	StaticMesh mesh = Smok::Bench::MakeGridMesh((uint32_t)state.range(0));
+	Smok::Bench::ShuffleTriangles(mesh);
+	MeshletBuildStats stats;
+
+	for (auto _ : state)
+	{
+		stats = BuildStaticMeshMeshlets(mesh);
+		benchmark::DoNotOptimize(mesh.meshes[0].meshlets.data());
+	}
+
+	state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)stats.triangleCount);
+	state.counters["meshlets"] = (double)stats.meshletCount;
+	state.counters["triangles_per_meshlet"] = stats.AverageTriangleCount();
+	state.counters["vertices_per_meshlet"] = stats.AverageVertexCount();
+}
+BENCHMARK(BM_BuildStaticMeshMeshlets)->Arg(32)->Arg(128)->Arg(512)->Unit(benchmark::kMillisecond);
+
+//decodes the vertices of a optimized grid mesh, the first arg is the grid side and the second the VertexLayout, bytes are the decoded size
+static void BM_DecodeStaticMeshVertices(benchmark::State& state)
+{
+	StaticMesh mesh = Smok::Bench::MakeGridMesh((uint32_t)state.range(0));
+	OptimizeStaticMesh(mesh);
+	const VertexLayout layout = (VertexLayout)state.range(1);
+	if (layout != VertexLayout::Float)
+		PackStaticMesh(mesh, layout);
+
+	const size_t vertexCount = mesh.GetVertexCount(), stride = GetVertexLayoutStride(layout);
+	const uint8_t* vertices = (layout == VertexLayout::Float ? (const uint8_t*)mesh.vertices.data() : mesh.packedVertices.data());
+	std::vector<uint8_t> encoded, decoded(vertexCount * stride);
+	Codec::EncodeVertices(vertices, vertexCount, stride, encoded);
+
+	//the vertices must come back byte for byte, a fast decoder that's wrong is not worth timing
+	if (!Codec::DecodeVertices(encoded.data(), encoded.size(), decoded.data(), vertexCount, stride) || std::memcmp(decoded.data(), vertices, decoded.size()) != 0)
+	{
+		state.SkipWithError("DecodeVertices does not give back the encoded vertices");
+		return;
+	}
+
+	for (auto _ : state)
+	{
+		if (!Codec::DecodeVertices(encoded.data(), encoded.size(), decoded.data(), vertexCount, stride))
+		{
+			state.SkipWithError("DecodeVertices failed");
+			break;
+		}
+		benchmark::DoNotOptimize(decoded.data());
+	}
+
+	state.SetBytesProcessed((int64_t)state.iterations() * (int64_t)decoded.size());
+	state.counters["ratio"] = (double)encoded.size() / (double)decoded.size();
+}
+BENCHMARK(BM_DecodeStaticMeshVertices)->Args({ 128, (int64_t)VertexLayout::Float })->Args({ 512, (int64_t)VertexLayout::Float })
+	->Args({ 512, (int64_t)VertexLayout::Quantized_HalfUV })->Unit(benchmark::kMicrosecond);
+
+//checks two triangle lists are the same triangles in the same order, each one may be rotated but keeps it's winding
+static inline bool TrianglesMatch(const uint32_t* expected, const uint32_t* actual, const size_t& indexCount)
+{
+	for (size_t t = 0; t + 2 < indexCount; t += 3)
+	{
+		const uint32_t* a = expected + t;
+		const uint32_t* b = actual + t;
+		if (!(a[0] == b[0] && a[1] == b[1] && a[2] == b[2]) && !(a[0] == b[1] && a[1] == b[2] && a[2] == b[0]) && !(a[0] == b[2] && a[1] == b[0] && a[2] == b[1]))
+			return false;
+	}
+	return true;
+}
+
+//decodes the indices of a optimized grid mesh, bytes are the decoded size
+static void BM_DecodeStaticMeshIndices(benchmark::State& state)
+{
+	StaticMesh mesh = Smok::Bench::MakeGridMesh((uint32_t)state.range(0));
+	OptimizeStaticMesh(mesh);
+
+	const std::vector<uint32_t>& indices = mesh.meshes[0].indices;
+	std::vector<uint8_t> encoded;
+	std::vector<uint32_t> decoded(indices.size());
+	Codec::EncodeIndices(indices.data(), indices.size(), encoded);
+
+	//the triangles must come back in order with their winding, the codec is allowed to rotate them
+	if (!Codec::DecodeIndices(encoded.data(), encoded.size(), decoded.data(), decoded.size()) || !TrianglesMatch(indices.data(), decoded.data(), indices.size()))
+	{
+		state.SkipWithError("DecodeIndices does not give back the encoded triangles");
+		return;
+	}
+
+	for (auto _ : state)
+	{
+		if (!Codec::DecodeIndices(encoded.data(), encoded.size(), decoded.data(), decoded.size()))
+		{
+			state.SkipWithError("DecodeIndices failed");
+			break;
+		}
+		benchmark::DoNotOptimize(decoded.data());
+	}
+
+	state.SetBytesProcessed((int64_t)state.iterations() * (int64_t)(decoded.size() * sizeof(uint32_t)));
+	state.counters["bytes_per_triangle"] = (double)encoded.size() / (double)(indices.size() / 3);
+}
+BENCHMARK(BM_DecodeStaticMeshIndices)->Arg(128)->Arg(512)->Unit(benchmark::kMicrosecond);
\ No newline at end of file
@@ -0,0 +1,134 @@
+//benchmarks the transform component
+
+#include "BenchData.hpp"
+
+#include <Smok/Components/Transform.hpp>
+#include <Smok/Components/TransformHierarchy.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace Smok::ECS::Comp;
+
+//makes transforms with varied positions, rotations and scales
+static inline std::vector<Transform> MakeTransforms(const size_t& count)
+{
+	Smok::Bench::BenchRandom random(count);
+	std::vector<Transform> transforms(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		transforms[i].position = { random.NextFloat(-100.0f, 100.0f), random.NextFloat(-100.0f, 100.0f), random.NextFloat(-100.0f, 100.0f) };
+		transforms[i].scale = glm::vec3(random.NextFloat(0.5f, 2.0f));
+		transforms[i].SetEularRotation_Radians({ random.NextFloat(-3.14f, 3.14f), random.NextFloat(-3.14f, 3.14f), random.NextFloat(-3.14f, 3.14f) });
+	}
+	return transforms;
+}
+
+//rebuilds every model matrix, the dirty flag is set each time so nothing is cached
+static void BM_TransformModelMatrix(benchmark::State& state)
+{
+	std::vector<Transform> transforms = MakeTransforms((size_t)state.range(0));
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < transforms.size(); ++i)
+		{
+			transforms[i].isDirty = true;
+			benchmark::DoNotOptimize(transforms[i].ModelMatrix());
+		}
+	}
+
+	state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TransformModelMatrix)->Arg(1024)->Arg(16384);
+
+//gets every model matrix when nothing changed, the cost of the dirty check
+static void BM_TransformModelMatrix_Clean(benchmark::State& state)
+{
+	std::vector<Transform> transforms = MakeTransforms((size_t)state.range(0));
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < transforms.size(); ++i)
+			benchmark::DoNotOptimize(transforms[i].ModelMatrix());
+	}
+
+	state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TransformModelMatrix_Clean)->Arg(1024)->Arg(16384);
+
+//sets every rotation from eular angles
+static void BM_TransformSetEularRotation(benchmark::State& state)
+{
+	std::vector<Transform> transforms = MakeTransforms((size_t)state.range(0));
+	Smok::Bench::BenchRandom random(7);
+	std::vector<glm::vec3> rotations(transforms.size());
+	for (size_t i = 0; i < rotations.size(); ++i)
+		rotations[i] = { random.NextFloat(-3.14f, 3.14f), random.NextFloat(-3.14f, 3.14f), random.NextFloat(-3.14f, 3.14f) };
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < transforms.size(); ++i)
+			transforms[i].SetEularRotation_Radians(rotations[i]);
+		benchmark::DoNotOptimize(transforms.data());
+	}
+
+	state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TransformSetEularRotation)->Arg(1024)->Arg(16384);
+
+//makes a hierarchy of nodeCount nodes as chainCount chains hanging off one root, 1 chain is fully deep and nodeCount - 1 chains is fully wide
+static inline TransformHierarchy MakeHierarchy(const size_t& nodeCount, const size_t& chainCount, std::vector<uint32_t>& chainHeads)
+{
+	const std::vector<Transform> locals = MakeTransforms(nodeCount);
+	TransformHierarchy hierarchy;
+	const uint32_t root = hierarchy.AddNode(locals[0]);
+	std::vector<uint32_t> chainTails(chainCount, root);
+	chainHeads.assign(chainCount, TransformHierarchy::NO_NODE);
+	for (size_t i = 1; i < nodeCount; ++i)
+	{
+		const size_t chain = (i - 1) % chainCount;
+		chainTails[chain] = hierarchy.AddNode(locals[i], chainTails[chain]);
+		if (chainHeads[chain] == TransformHierarchy::NO_NODE)
+			chainHeads[chain] = chainTails[chain];
+	}
+	hierarchy.UpdateWorldMatrices();
+	return hierarchy;
+}
+
+//edits one chain head a frame and rebuilds the dirty world matrices, the args are the node count and the chain count
+//every head's whole chain is rebuilt, so the cost should follow the chain length and not the node count
+static void BM_TransformHierarchy(benchmark::State& state)
+{
+	std::vector<uint32_t> chainHeads;
+	TransformHierarchy hierarchy = MakeHierarchy((size_t)state.range(0), (size_t)state.range(1), chainHeads);
+
+	size_t frame = 0, updated = 0;
+	for (auto _ : state)
+	{
+		hierarchy.EditLocal(chainHeads[frame++ % chainHeads.size()]).position.x += 0.01f;
+		updated += hierarchy.UpdateWorldMatrices();
+	}
+
+	state.SetItemsProcessed((int64_t)updated);
+	state.counters["nodes_per_frame"] = (double)updated / (double)state.iterations();
+}
+BENCHMARK(BM_TransformHierarchy)->ArgNames({ "nodes", "chains" })
+	->Args({ 16384, 1 })->Args({ 16384, 16 }) //deep
+	->Args({ 1024, 1023 })->Args({ 16384, 16383 }); //wide
+
+//rebuilds every world matrix each frame by editing the root, the cost of a full sweep for the deep and wide shapes
+static void BM_TransformHierarchy_Root(benchmark::State& state)
+{
+	std::vector<uint32_t> chainHeads;
+	TransformHierarchy hierarchy = MakeHierarchy((size_t)state.range(0), (size_t)state.range(1), chainHeads);
+	const uint32_t root = hierarchy.GetParent(chainHeads[0]);
+
+	for (auto _ : state)
+	{
+		hierarchy.EditLocal(root).position.x += 0.01f;
+		benchmark::DoNotOptimize(hierarchy.UpdateWorldMatrices());
+	}
+
+	state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TransformHierarchy_Root)->ArgNames({ "nodes", "chains" })->Args({ 16384, 1 })->Args({ 16384, 16383 });
\ No newline at end of file
@@ -0,0 +1,63 @@
+//the entry point of SmokBench, the benchmarks are spread over the Bench_*.cpp files
+//results are written as Google Benchmark JSON to SmokBench.json unless --benchmark_out is given
+//compare two runs with Google Benchmark's tools/compare.py, "compare.py benchmarks baseline.json SmokBench.json"
+//a benchmark that calls SkipWithError makes SmokBench exit with 1, so the checks some of them run fail a CI job
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+//gets if a run errored, Google Benchmark 1.8 replaced "error_occurred" with "skipped", our benchmarks only skip on errors
+template<typename Run>
+static inline bool RunErrored(const Run& run)
+{
+	if constexpr (requires { run.error_occurred; })
+		return run.error_occurred;
+	else
+		return run.skipped != decltype(run.skipped)();
+}
+
+//prints to the console the same as the default reporter and remembers if any run errored
+struct ErrorTrackingReporter : public benchmark::ConsoleReporter
+{
+	bool anyErrors = false;
+
+	void ReportRuns(const std::vector<Run>& runs) override
+	{
+		for (size_t i = 0; i < runs.size(); ++i)
+			anyErrors |= RunErrored(runs[i]);
+		ConsoleReporter::ReportRuns(runs);
+	}
+};
+
+int main(int argc, char** argv)
+{
+	std::vector<char*> args(argv, argv + argc);
+
+	//defaults to JSON output so every run can be diffed against a baseline
+	bool hasOut = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strncmp(argv[i], "--benchmark_out=", 16) == 0)
+			hasOut = true;
+	}
+
+	std::string out = "--benchmark_out=SmokBench.json", outFormat = "--benchmark_out_format=json";
+	if (!hasOut)
+	{
+		args.emplace_back(out.data());
+		args.emplace_back(outFormat.data());
+	}
+
+	int count = (int)args.size();
+	benchmark::Initialize(&count, args.data());
+	if (benchmark::ReportUnrecognizedArguments(count, args.data()))
+		return 1;
+
+	ErrorTrackingReporter reporter;
+	benchmark::RunSpecifiedBenchmarks(&reporter);
+	benchmark::Shutdown();
+	return (reporter.anyErrors ? 1 : 0);
+}
\ No newline at end of file
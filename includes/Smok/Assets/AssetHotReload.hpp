@@ -0,0 +1,46 @@
+#pragma once
+
+//defines the hot reload types used by the asset manager
+//watched files map back to the assets using them, a changed file queues a reload of just those assets
+//the new data is loaded into a copy on the loader's workers and swapped in from "ProcessLoadedAssets", so it always lands between frames
+
+#include <Smok/Assets/AssetManagerAssets.hpp>
+
+#include <Smok/Memory/LifetimeDeleteQueue.hpp>
+
+#include <chrono>
+#include <memory>
+
+namespace Smok::Asset::AssetManager
+{
+	//defines a asset using a watched file
+	struct HotReloadTarget
+	{
+		AssetType type = AssetType::Count;
+		uint64_t ID = 0;
+
+		inline bool operator==(const HotReloadTarget& other) const { return type == other.type && ID == other.ID; }
+	};
+
+	//defines the hot reload stats
+	struct HotReloadStats
+	{
+		uint64_t filesChanged = 0;
+		uint64_t reloadsQueued = 0;
+		uint64_t reloadsSwapped = 0; //reloads that replaced the live asset
+		uint64_t reloadsFailed = 0; //reloads that loaded but could not be created, the old asset is kept
+
+		double lastReloadMilliseconds = 0.0; //from the change being seen to the new asset being swapped in
+		double maxReloadMilliseconds = 0.0;
+	};
+
+	//defines a static mesh reload that loaded while a load of the same mesh was still in flight
+	//it is swapped in after that load's create step, so the reloaded data always lands last
+	struct DeferredStaticMeshSwap
+	{
+		uint64_t ID = 0;
+		std::shared_ptr<Smok::Asset::Mesh::StaticMesh> staged;
+		Memory::FrameDeletionQueue* deletionQueue = nullptr;
+		std::chrono::high_resolution_clock::time_point seenTime;
+	};
+}
\ No newline at end of file
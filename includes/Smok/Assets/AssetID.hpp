@@ -0,0 +1,53 @@
+#pragma once
+
+//defines a hashed asset name, worked out at compile time for literals
+//"meshes/rock"_asset is a constant, so game code can name assets without keeping IDs around or hashing strings at runtime
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Smok::Asset
+{
+	//hashes a asset name, 64 bit FNV-1a
+	static constexpr uint64_t HashAssetName(const std::string_view name)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (const char c : name)
+		{
+			hash ^= (uint8_t)c;
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	//defines a hashed asset name
+	//it's a structural type so it can be a template argument, use ".hash" for switch cases
+	struct AssetID
+	{
+		uint64_t hash = 0;
+
+		constexpr AssetID() = default;
+		constexpr explicit AssetID(const uint64_t& _hash) : hash(_hash) {}
+		constexpr AssetID(const std::string_view name) : hash(HashAssetName(name)) {}
+		constexpr AssetID(const char* name) : hash(HashAssetName(name)) {}
+		constexpr AssetID(const std::string& name) : hash(HashAssetName(name)) {}
+
+		constexpr explicit operator uint64_t() const { return hash; }
+
+		constexpr bool operator==(const AssetID& other) const { return hash == other.hash; }
+		constexpr bool operator!=(const AssetID& other) const { return hash != other.hash; }
+	};
+
+	//hashes asset IDs for maps, the FNV hash is already mixed so it's used as is
+	struct AssetIDHasher
+	{
+		inline size_t operator()(const AssetID& ID) const { return (size_t)ID.hash; }
+	};
+
+	namespace Literals
+	{
+		//makes a asset ID from a literal at compile time
+		consteval AssetID operator""_asset(const char* name, const size_t length) { return AssetID(std::string_view(name, length)); }
+	}
+}
\ No newline at end of file
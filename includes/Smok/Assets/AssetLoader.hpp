@@ -0,0 +1,401 @@
+#pragma once
+
+//defines the background loading thread pool used by the asset manager
+//file reads and parsing run on worker threads, anything that touches the GPU is handed back to the thread that owns the asset manager
+
+#include <Smok/Assets/AssetManagerAssets.hpp>
+#include <Smok/Profiling/Profiler.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Smok::Asset::AssetManager
+{
+	//defines the common load priorities, higher loads first
+	enum LoadPriority : int32_t
+	{
+		LoadPriority_Low = 0,
+		LoadPriority_Normal = 100,
+		LoadPriority_High = 200,
+		LoadPriority_Critical = 300
+	};
+
+	//defines the state of a load request
+	enum class LoadStatus : uint8_t
+	{
+		Queued = 0, //waiting for a worker
+		Loading, //a worker is reading and parsing the data
+		PendingCreate, //the data is loaded and waiting for the owning thread to create the GPU side
+		Creating, //the owning thread is creating the GPU side
+
+		Complete, //done
+		Failed, //the load or create step failed
+		Cancelled, //the request was cancelled before it finished
+
+		Count
+	};
+
+	//defines the shared state of a load request
+	struct LoadRequestState
+	{
+		uint64_t assetID = 0;
+		AssetType type = AssetType::Count;
+
+		std::atomic<LoadStatus> status = LoadStatus::Queued;
+		std::atomic<bool> cancelRequested = false;
+
+		std::function<bool()> decodeTask; //runs on a worker thread, reads and parses the asset
+		std::function<bool(VmaAllocator&, Wireframe::Device::GPU*)> createTask; //runs on the owning thread, if empty the request is done after decoding
+
+		std::promise<bool> promise;
+		std::shared_future<bool> future = promise.get_future().share();
+
+		//moves the request into a finished state, only the first caller wins
+		inline bool Finish(LoadStatus expected, const LoadStatus finalStatus)
+		{
+			if (!status.compare_exchange_strong(expected, finalStatus))
+				return false;
+
+			promise.set_value(finalStatus == LoadStatus::Complete);
+			return true;
+		}
+
+		//is the request in a finished state
+		inline bool IsDone() const
+		{
+			const LoadStatus s = status.load();
+			return (s == LoadStatus::Complete || s == LoadStatus::Failed || s == LoadStatus::Cancelled);
+		}
+	};
+
+	//defines a handle to a load request, can be polled, waited on or cancelled
+	struct LoadHandle
+	{
+		std::shared_ptr<LoadRequestState> state;
+
+		//is the handle tied to a request
+		inline bool IsValid() const { return state != nullptr; }
+
+		//gets the status
+		inline LoadStatus GetStatus() const { return (state ? state->status.load() : LoadStatus::Failed); }
+
+		//is the request finished, for better or worse
+		inline bool IsDone() const { return (state ? state->IsDone() : true); }
+
+		//did the request finish successfully
+		inline bool Succeeded() const { return GetStatus() == LoadStatus::Complete; }
+
+		//gets a future that becomes true when the request is complete, or false if it failed or was cancelled
+		inline std::shared_future<bool> GetFuture() const { return (state ? state->future : std::shared_future<bool>()); }
+
+		//blocks until the request is finished || DO NOT call this on the owning thread for requests that need the GPU create step, it runs there
+		inline bool Wait() const { return (state ? state->future.get() : false); }
+
+		//cancels the request, if a worker is already loading it the data is kept but the request will not be created
+		inline void Cancel()
+		{
+			if (!state)
+				return;
+
+			state->cancelRequested = true;
+			if (!state->Finish(LoadStatus::Queued, LoadStatus::Cancelled))
+				state->Finish(LoadStatus::PendingCreate, LoadStatus::Cancelled);
+		}
+	};
+
+	//defines a entry in the load queue
+	struct LoadQueueEntry
+	{
+		int32_t priority = LoadPriority_Normal;
+		uint64_t sequence = 0; //keeps requests with the same priority in the order they were made
+		std::shared_ptr<LoadRequestState> state;
+
+		inline bool operator<(const LoadQueueEntry& other) const
+		{
+			if (priority != other.priority)
+				return priority < other.priority;
+			return sequence > other.sequence;
+		}
+	};
+
+	//defines the background loader
+	struct AssetLoader
+	{
+		std::vector<std::thread> workers;
+		bool isRunning = false;
+
+		std::mutex queueMutex;
+		std::condition_variable queueCondition;
+		std::priority_queue<LoadQueueEntry> queue;
+		std::unordered_map<uint64_t, std::shared_ptr<LoadRequestState>> inFlight; //requests that have not finished yet, by asset ID
+		std::unordered_multimap<uint64_t, std::shared_ptr<LoadRequestState>> unsharedInFlight; //requests that are not shared, kept so they can be cancelled
+		uint64_t nextSequence = 0;
+
+		std::mutex createMutex;
+		std::vector<std::shared_ptr<LoadRequestState>> createQueue; //requests waiting for the owning thread
+
+		//starts the worker threads, a count of 0 picks one based on the hardware
+		inline void Start(uint32_t workerCount = 0)
+		{
+			if (isRunning)
+				return;
+
+			if (workerCount == 0)
+			{
+				const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+				workerCount = (hardwareThreads > 2 ? hardwareThreads - 1 : 1);
+				if (workerCount > 4)
+					workerCount = 4;
+			}
+
+			isRunning = true;
+			workers.reserve(workerCount);
+			for (uint32_t i = 0; i < workerCount; ++i)
+				workers.emplace_back([this]() { WorkerLoop(); });
+		}
+
+		//cancels everything still queued and joins the workers
+		inline void Stop()
+		{
+			{
+				std::lock_guard<std::mutex> lock(queueMutex);
+				if (!isRunning)
+					return;
+				isRunning = false;
+
+				while (!queue.empty())
+				{
+					queue.top().state->Finish(LoadStatus::Queued, LoadStatus::Cancelled);
+					queue.pop();
+				}
+				inFlight.clear();
+				unsharedInFlight.clear();
+			}
+			queueCondition.notify_all();
+
+			for (size_t i = 0; i < workers.size(); ++i)
+				workers[i].join();
+			workers.clear();
+
+			std::lock_guard<std::mutex> lock(createMutex);
+			for (size_t i = 0; i < createQueue.size(); ++i)
+				createQueue[i]->Finish(LoadStatus::PendingCreate, LoadStatus::Cancelled);
+			createQueue.clear();
+		}
+
+		//queues a request, if the asset already has one in flight that handle is returned and bumped to the higher priority
+		//a request that is not shared is never handed out again or waited on by other requests, used for work on a copy of the asset
+		inline LoadHandle Enqueue(const uint64_t& assetID, const AssetType& type, const int32_t& priority,
+			std::function<bool()>&& decodeTask, std::function<bool(VmaAllocator&, Wireframe::Device::GPU*)>&& createTask, const bool shareInFlight = true)
+		{
+			std::lock_guard<std::mutex> lock(queueMutex);
+
+			if (!isRunning)
+			{
+				fmt::print("Smok Asset Manager Error: AssetLoader || Enqueue || The loader is not running, call \"AssetManager::Init\" before requesting async loads. Asset {} will not be loaded.\n", assetID);
+				return LoadHandle();
+			}
+
+			//re-use the request already in flight, pushing a second entry is how we bump it's priority, the stale one gets skipped
+			auto existing = (shareInFlight ? inFlight.find(assetID) : inFlight.end());
+			if (existing != inFlight.end() && !existing->second->IsDone() && !existing->second->cancelRequested)
+			{
+				if (existing->second->status == LoadStatus::Queued)
+					queue.push({ priority, nextSequence++, existing->second });
+				return { existing->second };
+			}
+
+			std::shared_ptr<LoadRequestState> state = std::make_shared<LoadRequestState>();
+			state->assetID = assetID;
+			state->type = type;
+			state->decodeTask = std::move(decodeTask);
+			state->createTask = std::move(createTask);
+
+			if (shareInFlight)
+				inFlight[assetID] = state;
+			else
+				unsharedInFlight.emplace(assetID, state);
+			queue.push({ priority, nextSequence++, state });
+			queueCondition.notify_one();
+			return { state };
+		}
+
+		//gets the number of requests still waiting for a worker
+		inline size_t GetQueuedCount()
+		{
+			std::lock_guard<std::mutex> lock(queueMutex);
+			return queue.size();
+		}
+
+		//gets if a asset has a request that has not finished
+		inline bool HasRequestInFlight(const uint64_t& assetID)
+		{
+			std::lock_guard<std::mutex> lock(queueMutex);
+			auto it = inFlight.find(assetID);
+			return (it != inFlight.end() && !it->second->IsDone());
+		}
+
+		//removes a finished request from the in flight table
+		inline void Retire(const std::shared_ptr<LoadRequestState>& state)
+		{
+			std::lock_guard<std::mutex> lock(queueMutex);
+			auto it = inFlight.find(state->assetID);
+			if (it != inFlight.end() && it->second == state)
+			{
+				inFlight.erase(it);
+				return;
+			}
+
+			auto range = unsharedInFlight.equal_range(state->assetID);
+			for (auto u = range.first; u != range.second; ++u)
+			{
+				if (u->second == state)
+				{
+					unsharedInFlight.erase(u);
+					return;
+				}
+			}
+		}
+
+		//cancels every request for a asset, shared or not, and waits until no worker is touching it
+		//call on the owning thread, requests waiting on their create step are cancelled so nothing is left for it to wait on
+		inline void CancelAndWait(const uint64_t& assetID)
+		{
+			std::vector<std::shared_ptr<LoadRequestState>> states;
+			{
+				std::lock_guard<std::mutex> lock(queueMutex);
+				auto it = inFlight.find(assetID);
+				if (it != inFlight.end())
+					states.emplace_back(it->second);
+				auto range = unsharedInFlight.equal_range(assetID);
+				for (auto u = range.first; u != range.second; ++u)
+					states.emplace_back(u->second);
+			}
+
+			for (size_t i = 0; i < states.size(); ++i)
+			{
+				//a worker still loading finishes it's decode first, it may also move it to PendingCreate between our checks so keep cancelling
+				LoadHandle handle = { states[i] };
+				while (!states[i]->IsDone() && states[i]->status != LoadStatus::Creating)
+				{
+					handle.Cancel();
+					if (!states[i]->IsDone())
+						std::this_thread::yield();
+				}
+
+				Retire(states[i]);
+			}
+		}
+
+		//runs the GPU create step of loaded requests on the calling thread, should be the thread that owns the asset manager
+		//maxCreates limits how many are created this call so a frame is never stalled by a burst of loads, 0 means no limit
+		inline size_t ProcessCreateQueue(VmaAllocator& allocator, Wireframe::Device::GPU* GPU, const size_t& maxCreates = 0)
+		{
+			std::vector<std::shared_ptr<LoadRequestState>> ready;
+			{
+				std::lock_guard<std::mutex> lock(createMutex);
+				if (createQueue.empty())
+					return 0;
+
+				const size_t count = (maxCreates == 0 || maxCreates > createQueue.size() ? createQueue.size() : maxCreates);
+				ready.assign(createQueue.begin(), createQueue.begin() + count);
+				createQueue.erase(createQueue.begin(), createQueue.begin() + count);
+			}
+
+			size_t created = 0;
+			for (size_t i = 0; i < ready.size(); ++i)
+			{
+				//cancelled while it was waiting
+				LoadStatus expected = LoadStatus::PendingCreate;
+				if (!ready[i]->status.compare_exchange_strong(expected, LoadStatus::Creating))
+				{
+					Retire(ready[i]);
+					continue;
+				}
+
+				if (ready[i]->cancelRequested)
+				{
+					ready[i]->Finish(LoadStatus::Creating, LoadStatus::Cancelled);
+					Retire(ready[i]);
+					continue;
+				}
+
+				bool result;
+				{
+					SMOK_PROFILE_ASSET_ZONE("AssetLoader::Create", ready[i]->assetID, Profiling::AssetStage::Create);
+					result = ready[i]->createTask(allocator, GPU);
+				}
+				ready[i]->Finish(LoadStatus::Creating, (result ? LoadStatus::Complete : LoadStatus::Failed));
+				Retire(ready[i]);
+				created++;
+			}
+
+			return created;
+		}
+
+		//the worker thread loop
+		inline void WorkerLoop()
+		{
+			SMOK_PROFILE_THREAD_NAME("Smok Asset Loader");
+
+			while (true)
+			{
+				std::shared_ptr<LoadRequestState> state;
+				{
+					std::unique_lock<std::mutex> lock(queueMutex);
+					queueCondition.wait(lock, [this]() { return !isRunning || !queue.empty(); });
+					if (!isRunning)
+						return;
+
+					state = queue.top().state;
+					queue.pop();
+				}
+
+				//skip stale priority entries and cancelled requests
+				LoadStatus expected = LoadStatus::Queued;
+				if (!state->status.compare_exchange_strong(expected, LoadStatus::Loading))
+					continue;
+
+				bool result;
+				{
+					SMOK_PROFILE_ASSET_ZONE("AssetLoader::Decode", state->assetID, Profiling::AssetStage::Decode);
+					result = state->decodeTask();
+				}
+				if (!result)
+				{
+					state->Finish(LoadStatus::Loading, LoadStatus::Failed);
+					Retire(state);
+					continue;
+				}
+
+				if (state->cancelRequested)
+				{
+					state->Finish(LoadStatus::Loading, LoadStatus::Cancelled);
+					Retire(state);
+					continue;
+				}
+
+				if (!state->createTask)
+				{
+					state->Finish(LoadStatus::Loading, LoadStatus::Complete);
+					Retire(state);
+					continue;
+				}
+
+				//hand the GPU side back to the owning thread
+				std::lock_guard<std::mutex> lock(createMutex);
+				state->status = LoadStatus::PendingCreate;
+				createQueue.emplace_back(state);
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -2,99 +2,1365 @@
 
 //defines a asset manager for Smok
 //this uses wrapper objects with a little extra needed for them
+//each asset type lives in a slot map, a asset's ID is it's packed slot handle so looking one up is a index and a generation check
+//names are keyed by their AssetID hash, so "name"_asset lookups never touch the string
+//every name is also put in the BTD name registery, it's IDs are not the AssetID hashes so "GetAssetIDFromRegisteryID" maps between them
+//with hot reload enabled the files of every asset are watched, see "ProcessHotReload"
+//static meshes and graphics pipelines can also be read out of mounted asset packs instead of their own files, see "MountAssetPack"
 
 #include <Smok/Assets/AssetManagerAssets.hpp>
+#include <Smok/Assets/AssetLoader.hpp>
+#include <Smok/Assets/AssetID.hpp>
+#include <Smok/Assets/AssetResidency.hpp>
+#include <Smok/Assets/AssetHotReload.hpp>
+
+#include <Smok/IO/FileWatcher.hpp>
+#include <Smok/IO/BulkFileReader.hpp>
+
+#include <Smok/Components/MeshComponent.hpp>
+
+#include <Smok/Memory/SlotMap.hpp>
+#include <Smok/Memory/LifetimeDeleteQueue.hpp>
 
 #include <BTDSTD/Maps/StringIDRegistery.hpp>
 
+#include <algorithm>
+#include <memory>
+#include <unordered_set>
+
 namespace Smok::Asset::AssetManager
 {
-	//defines a queue task for loading a asset
+	//defines a entry in the name table, the name is kept to catch hash collisions
+	struct AssetNameEntry
+	{
+		std::string name;
+		uint64_t ID = Memory::INVALID_SLOT_ID;
+		uint64_t registeryID = 0; //the ID the BTD name registery gave the name
+	};
+
+	//defines a graphics pipeline to create in a batch
+	struct GraphicsPipelineCreateRequest
+	{
+		uint64_t pipelineID = Memory::INVALID_SLOT_ID;
+		uint64_t pipelineLayoutID = Memory::INVALID_SLOT_ID; //the layout must already be created
+		VkRenderPass renderPass = VK_NULL_HANDLE;
+	};
+
+	//defines the results of a batch of pipeline creates
+	struct GraphicsPipelineBatchStats
+	{
+		size_t created = 0;
+		size_t failed = 0;
+		size_t duplicates = 0; //requests for a pipeline already earlier in the batch, only the first is created
+
+		size_t shaderModulesCreated = 0;
+		size_t shaderModulesReused = 0; //modules handed to a pipeline without being made again
+
+		bool warmPipelineCache = false; //was the pipeline cache loaded from disk
+		double pipelineCacheLoadMilliseconds = 0.0;
+		double milliseconds = 0.0; //the time spent creating the whole batch
+	};
+
+	//defines the results of a bulk static mesh load
+	struct StaticMeshBulkLoadStats
+	{
+		size_t loaded = 0;
+		size_t failed = 0;
+		size_t skipped = 0; //meshes not decoded as they are already loaded, created, being loaded by the workers or listed more than once
+		size_t packed = 0; //meshes decoded straight out of a mounted asset pack, they are not part of the reads
+
+		IO::BulkReadStats binaryReads;
+		IO::BulkReadStats declReads; //decls are only read for v1 binaries
+		double milliseconds = 0.0; //the time for the whole call, reads and decoding overlap
+	};
 
 	//defines a asset manager
 	struct AssetManager
 	{
-		BTD::Map::IDStringRegistery assetNameRegistery;
-		std::unordered_map<uint64_t, Asset_PipelineLayout> pipelineLayouts;
-		std::unordered_map<uint64_t, Asset_GraphicsPipeline> pipelines;
-		std::unordered_map<uint64_t, Asset_StaticMesh> staticMeshes;
+		Memory::SlotMap<Asset_PipelineLayout> pipelineLayouts;
+		Memory::SlotMap<Asset_GraphicsPipeline> pipelines;
+		Memory::SlotMap<Asset_StaticMesh> staticMeshes;
+
+		std::unordered_map<AssetID, AssetNameEntry, AssetIDHasher> assetIDsByName[(size_t)AssetType::Count]; //the ID registered under each name, per asset type
+
+		BTD::Map::IDStringRegistery assetNameRegistery; //every name ever registered, shared by all asset types
+		std::unordered_map<uint64_t, AssetID> assetIDsByRegisteryID; //the AssetID hash of each registery ID
+
+		AssetLoader loader; //the background loading threads
+		PipelineCache pipelineCache; //kept across runs, see "InitPipelineCache"
+		Rendering::MeshUploader meshUploader; //batches static mesh uploads when initalized, see "InitBatchedMeshUploads"
+		Rendering::GeometryPool geometryPool; //shared vertex and index buffers for static meshes when initalized, see "InitGeometryPool"
+
+		ResidencyBudget residencyBudget; //see "SetResidencyBudget"
+		ResidencyStats residencyStats;
+		StaticMeshLRU unusedStaticMeshes; //resident meshes nothing has acquired, the eviction candidates
+
+		bool hotReloadIsEnabled = false; //see "EnableHotReload"
+		IO::FileWatcher fileWatcher;
+		std::unordered_map<std::string, std::vector<HotReloadTarget>> hotReloadTargets; //the assets using each watched file, by normalized path
+		std::vector<std::string> changedFiles; //reused every poll
+		std::vector<DeferredStaticMeshSwap> deferredStaticMeshSwaps; //reloads waiting on a load of the same mesh, see "ProcessDeferredStaticMeshSwaps"
+		HotReloadStats hotReloadStats;
+
+		std::vector<std::unique_ptr<Pack::AssetPack>> assetPacks; //the mounted packs, they stay open until "Destroy" as their meshes point into them
 
-		//inits the asset manager
-		inline bool Init()
+		//inits the asset manager || workerThreadCount of 0 picks a count based on the hardware
+		inline bool Init(const uint32_t workerThreadCount = 0)
 		{
 			//reserve space in the assets
+			pipelineLayouts.Reserve(16);
+			pipelines.Reserve(64);
+			staticMeshes.Reserve(256);
 
 			//run the thread for loading asset data
+			loader.Start(workerThreadCount);
+			return true;
 		}
 
 		//destroys all assets
 		inline void Destroy(VmaAllocator& _allocator, Wireframe::Device::GPU* GPU)
 		{
 			//wait for loading thread to be finished and then close
+			loader.Stop();
+			if (meshUploader.IsInitalized())
+				meshUploader.Destroy();
 
 			//clean up assets loaded
-			for (auto& m : staticMeshes)
+			staticMeshes.ForEach([&](const Memory::SlotHandle&, Asset_StaticMesh& m) {
+				if (!m.assetIsCreated)
+					return;
+
+				m.assetIsCreated = false;
+				if (m.asset.UsesGeometryPool())
+					return; //the pool is destroyed as a whole
+				if (m.asset.UsesPackedBuffers())
+				{
+					m.asset.DestroyPackedBuffers(_allocator);
+					return;
+				}
+
+				for (size_t i = 0; i < m.asset.meshes.size(); ++i)
+					m.asset.meshes[i].DestroyIndexBuffers(_allocator);
+				m.asset.DestroyVertexBuffers(_allocator);
+			});
+
+			pipelines.ForEach([&](const Memory::SlotHandle&, Asset_GraphicsPipeline& p) { p.asset.Destroy(GPU); });
+			pipelineLayouts.ForEach([&](const Memory::SlotHandle&, Asset_PipelineLayout& l) { l.asset.Destroy(GPU); });
+
+			pipelineCache.Destroy();
+			geometryPool.Destroy();
+
+			unusedStaticMeshes.Clear();
+			deferredStaticMeshSwaps.clear();
+			residencyStats = ResidencyStats();
+
+			DisableHotReload();
+			assetPacks.clear();
+		}
+
+		//makes static meshes upload in batches through a staging ring instead of a allocation and upload per buffer
+		//transferQueue can be a dedicated transfer queue, if it's null the graphics queue is used
+		inline bool InitBatchedMeshUploads(VkDevice device, VkQueue graphicsQueue, const uint32_t& graphicsQueueFamily, VmaAllocator& allocator,
+			const VkDeviceSize& stagingSize = Rendering::MeshUploader::DEFAULT_STAGING_SIZE, VkQueue transferQueue = VK_NULL_HANDLE, const uint32_t& transferQueueFamily = 0)
+		{
+			return meshUploader.Init(device, graphicsQueue, graphicsQueueFamily, allocator, stagingSize, transferQueue, transferQueueFamily);
+		}
+
+		//makes batched static mesh uploads go into shared buffers, vertexPoolSize is the size in bytes of each vertex layout's buffer
+		//needs batched uploads, see "InitBatchedMeshUploads"
+		inline bool InitGeometryPool(VmaAllocator& allocator, const VkDeviceSize& vertexPoolSize, const uint32_t& indexCapacity, const uint32_t& maxMeshes = 64 * 1024)
+		{
+			if (!meshUploader.IsInitalized())
 			{
-				if (!m.second.assetIsCreated)
+				fmt::print("Smok Asset Manager Error: AssetManager || InitGeometryPool || Batched mesh uploads must be initalized first.\n");
+				return false;
+			}
+
+			return geometryPool.Init(allocator, vertexPoolSize, indexCapacity, maxMeshes, meshUploader.sharingQueueFamilies, meshUploader.sharingQueueFamilyCount);
+		}
+
+		//defragments the geometry pool, waits for any batched upload first
+		//the copies are recorded into commandBuffer, submit it before drawing anything from the pool
+		inline void DefragmentGeometryPool(VkCommandBuffer commandBuffer, Memory::FrameDeletionQueue& deletionQueue)
+		{
+			if (!geometryPool.IsInitalized())
+				return;
+
+			meshUploader.Finish();
+			geometryPool.Defragment(commandBuffer, deletionQueue);
+		}
+
+		//creates the pipeline cache, loading it from cacheFile when it was saved by the same device and driver
+		//pipelines only share shader modules and go through the cache once this is called, before that they're made the same as "Asset_GraphicsPipeline::Create" on it's own
+		inline bool InitPipelineCache(VkPhysicalDevice physicalDevice, VkDevice device, const BTD::IO::FileInfo& cacheFile)
+		{
+			return pipelineCache.Create(physicalDevice, device, cacheFile);
+		}
+
+		//saves the pipeline cache to disk, call after creating pipelines or before shutting down
+		inline bool SavePipelineCache()
+		{
+			return pipelineCache.Save();
+		}
+
+		//creates a batch of graphics pipelines across threadCount threads, 0 picks a count based on the hardware
+		//shader modules are shared across the batch by the contents of their SPIR-V and destroyed once it's done
+		//pipelines are made through the pipeline cache once it's created, see "InitPipelineCache", a pipeline asked for more than once is only made by it's first request
+		//settings not loaded yet are loaded on the creating thread, nothing else may register or unregister assets during the call
+		inline GraphicsPipelineBatchStats CreateGraphicsPipelines(const std::vector<GraphicsPipelineCreateRequest>& requests,
+			Wireframe::Device::GPU* GPU, uint32_t threadCount = 0)
+		{
+			SMOK_PROFILE_ZONE("AssetManager::CreateGraphicsPipelines");
+			const auto start = std::chrono::high_resolution_clock::now();
+			GraphicsPipelineBatchStats stats;
+			stats.warmPipelineCache = pipelineCache.loadedFromDisk;
+			stats.pipelineCacheLoadMilliseconds = pipelineCache.loadMilliseconds;
+
+			if (threadCount == 0)
+			{
+				const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+				threadCount = (hardwareThreads > 0 ? hardwareThreads : 1);
+			}
+
+			//two threads making the same pipeline would race on it's asset
+			std::vector<size_t> uniqueRequests;
+			uniqueRequests.reserve(requests.size());
+			{
+				std::unordered_set<uint64_t> seen;
+				for (size_t r = 0; r < requests.size(); ++r)
+				{
+					if (seen.insert(requests[r].pipelineID).second)
+						uniqueRequests.emplace_back(r);
+					else
+						stats.duplicates++;
+				}
+			}
+
+			if (threadCount > uniqueRequests.size())
+				threadCount = (uint32_t)(uniqueRequests.empty() ? 1 : uniqueRequests.size());
+
+			//the shader modules need the device the pipeline cache was made with
+			const bool useCaches = (pipelineCache.cache != VK_NULL_HANDLE);
+			ShaderModuleCache shaderCache;
+			shaderCache.device = pipelineCache.device;
+			std::atomic<size_t> nextRequest = 0, created = 0, failed = 0;
+			auto createPipelines = [&]() {
+				for (size_t u = nextRequest++; u < uniqueRequests.size(); u = nextRequest++)
+				{
+					const size_t r = uniqueRequests[u];
+					Asset_GraphicsPipeline* pipeline = GetGraphicsPipeline(requests[r].pipelineID);
+					Asset_PipelineLayout* layout = GetPipelineLayout(requests[r].pipelineLayoutID);
+					if (!pipeline || !layout || !layout->assetIsCreated)
+					{
+						fmt::print("Smok Asset Manager Error: AssetManager || CreateGraphicsPipelines || Request {} has a invalid pipeline or a pipeline layout that is not created.\n", r);
+						failed++;
+						continue;
+					}
+
+					//timed as the pipeline's decode and create stages, the same as a pipeline going through the loader
+					bool loaded, isCreated = false;
+					{
+						SMOK_PROFILE_ASSET_ZONE("AssetManager::LoadPipelineSettings", pipeline->ID, Profiling::AssetStage::Decode);
+						loaded = pipeline->LoadPipelineSettingsAndShaders();
+					}
+
+					VkRenderPass renderPass = requests[r].renderPass;
+					if (loaded)
+					{
+						SMOK_PROFILE_ASSET_ZONE("AssetManager::CreateGraphicsPipeline", pipeline->ID, Profiling::AssetStage::Create);
+						isCreated = pipeline->Create(GPU, layout->asset, renderPass, (useCaches ? &shaderCache : nullptr), (useCaches ? &pipelineCache : nullptr));
+					}
+					if (!isCreated)
+					{
+						failed++;
+						continue;
+					}
+					pipeline->pipelineLayoutID = requests[r].pipelineLayoutID;
+					pipeline->renderPass = renderPass;
+					created++;
+				}
+			};
+
+			std::vector<std::thread> threads;
+			for (uint32_t t = 1; t < threadCount; ++t)
+				threads.emplace_back(createPipelines);
+			createPipelines();
+			for (auto& thread : threads)
+				thread.join();
+
+			stats.created = created;
+			stats.failed = failed;
+
+			//the SPIR-V paths are only known once the settings are loaded
+			if (hotReloadIsEnabled)
+			{
+				for (size_t r = 0; r < requests.size(); ++r)
+				{
+					Asset_GraphicsPipeline* pipeline = GetGraphicsPipeline(requests[r].pipelineID);
+					if (pipeline)
+						WatchAssetFiles(*pipeline);
+				}
+			}
+
+			stats.shaderModulesCreated = shaderCache.modulesCreated;
+			stats.shaderModulesReused = shaderCache.modulesReused;
+			shaderCache.Destroy();
+
+			stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			return stats;
+		}
+
+		//gets a static mesh by ID, nullptr if the ID is stale or was never registered
+		inline Asset_StaticMesh* GetStaticMesh(const uint64_t& ID) { return staticMeshes.Get(Memory::SlotHandle::Unpack(ID)); }
+
+		//gets a graphics pipeline by ID, nullptr if the ID is stale or was never registered
+		inline Asset_GraphicsPipeline* GetGraphicsPipeline(const uint64_t& ID) { return pipelines.Get(Memory::SlotHandle::Unpack(ID)); }
+
+		//gets a pipeline layout by ID, nullptr if the ID is stale or was never registered
+		inline Asset_PipelineLayout* GetPipelineLayout(const uint64_t& ID) { return pipelineLayouts.Get(Memory::SlotHandle::Unpack(ID)); }
+
+		//gets the ID a asset was registered with by name, Memory::INVALID_SLOT_ID if there is none
+		//this is a hash map lookup, hot code should resolve it once and keep the ID
+		inline uint64_t GetAssetID(const AssetType& type, const AssetID& name) const
+		{
+			auto it = assetIDsByName[(size_t)type].find(name);
+			return (it != assetIDsByName[(size_t)type].end() ? it->second.ID : Memory::INVALID_SLOT_ID);
+		}
+
+		//gets the ID a asset was registered with from the ID the BTD name registery gave it's name, Memory::INVALID_SLOT_ID if there is none
+		inline uint64_t GetAssetIDFromRegisteryID(const AssetType& type, const uint64_t& registeryID) const
+		{
+			auto it = assetIDsByRegisteryID.find(registeryID);
+			return (it != assetIDsByRegisteryID.end() ? GetAssetID(type, it->second) : Memory::INVALID_SLOT_ID);
+		}
+
+		//gets a static mesh by name, nullptr if there is none
+		inline Asset_StaticMesh* GetStaticMesh(const AssetID& name) { return GetStaticMesh(GetAssetID(AssetType::StaticMesh, name)); }
+
+		//gets a graphics pipeline by name, nullptr if there is none
+		inline Asset_GraphicsPipeline* GetGraphicsPipeline(const AssetID& name) { return GetGraphicsPipeline(GetAssetID(AssetType::GraphicsPipeline, name)); }
+
+		//gets a pipeline layout by name, nullptr if there is none
+		inline Asset_PipelineLayout* GetPipelineLayout(const AssetID& name) { return GetPipelineLayout(GetAssetID(AssetType::PipelineLayout, name)); }
+
+		//queues a static mesh to be loaded on a worker thread, the GPU buffers are created in "ProcessLoadedAssets"
+		//the asset must be registered and must stay registered until the load is done
+		inline LoadHandle LoadStaticMeshAsync(const uint64_t& ID, const int32_t& priority = LoadPriority_Normal)
+		{
+			Asset_StaticMesh* mesh = GetStaticMesh(ID);
+			if (!mesh)
+			{
+				fmt::print("Smok Asset Manager Error: AssetManager || LoadStaticMeshAsync || No static mesh is registered with the ID {}. Use \"RegisterAsset_StaticMesh\" first.\n", ID);
+				return LoadHandle();
+			}
+
+			//the pointer stays valid as slot map chunks never move
+			return loader.Enqueue(ID, AssetType::StaticMesh, priority,
+				[mesh]() { return mesh->LoadMesh(); },
+				[this, mesh](VmaAllocator& allocator, Wireframe::Device::GPU*) {
+					if (mesh->assetIsCreated)
+						return true;
+
+					//a batched upload is only queued here, it counts against the budgets once the GPU has it
+					if (meshUploader.IsInitalized())
+						return mesh->InitalizeMeshBatched(meshUploader, (geometryPool.IsInitalized() ? &geometryPool : nullptr),
+							[this, mesh]() { TrackStaticMeshResidency(*mesh); });
+
+					const bool created = mesh->InitalizeMesh(allocator);
+					if (created)
+						TrackStaticMeshResidency(*mesh);
+					return created;
+				});
+		}
+
+		//queues a graphics pipeline's settings and shader data to be loaded on a worker thread
+		//the pipeline it's self needs a layout and render pass so creating it is left to the caller once the handle is done
+		inline LoadHandle LoadGraphicsPipelineAsync(const uint64_t& ID, const int32_t& priority = LoadPriority_Normal)
+		{
+			Asset_GraphicsPipeline* pipeline = GetGraphicsPipeline(ID);
+			if (!pipeline)
+			{
+				fmt::print("Smok Asset Manager Error: AssetManager || LoadGraphicsPipelineAsync || No graphics pipeline is registered with the ID {}. Use \"RegisterAsset_GraphicsPipeline\" first.\n", ID);
+				return LoadHandle();
+			}
+
+			return loader.Enqueue(ID, AssetType::GraphicsPipeline, priority,
+				[pipeline]() { return pipeline->LoadPipelineSettingsAndShaders(); }, nullptr);
+		}
+
+		//queues a pipeline layout's push constant data to be loaded on a worker thread
+		inline LoadHandle LoadPipelineLayoutAsync(const uint64_t& ID, const int32_t& priority = LoadPriority_Normal)
+		{
+			Asset_PipelineLayout* layout = GetPipelineLayout(ID);
+			if (!layout)
+			{
+				fmt::print("Smok Asset Manager Error: AssetManager || LoadPipelineLayoutAsync || No pipeline layout is registered with the ID {}. Use \"RegisterAsset_PipelineLayout\" first.\n", ID);
+				return LoadHandle();
+			}
+
+			return loader.Enqueue(ID, AssetType::PipelineLayout, priority,
+				[layout]() { return layout->LoadPushConstantSettings(); }, nullptr);
+		}
+
+		//creates the GPU side of assets the workers finished loading, call once a frame on the thread that owns the asset manager
+		//maxCreates limits the work done per call so streaming never stalls a frame, 0 means create everything ready
+		//with batched mesh uploads this also submits the uploads queued this call and finishes the ones the GPU is done with
+		inline size_t ProcessLoadedAssets(VmaAllocator& allocator, Wireframe::Device::GPU* GPU, const size_t& maxCreates = 0)
+		{
+			SMOK_PROFILE_ZONE("AssetManager::ProcessLoadedAssets");
+			const size_t created = loader.ProcessCreateQueue(allocator, GPU, maxCreates);
+			ProcessDeferredStaticMeshSwaps(allocator);
+
+			//every mesh queued this call goes up in one submission
+			if (meshUploader.IsInitalized())
+			{
+				meshUploader.Submit();
+				meshUploader.Update();
+			}
+
+			return created;
+		}
+
+		//loads many static meshes at once, every binary is read in one batch and decoded across threadCount threads as it arrives, 0 uses every hardware thread
+		//this is for level loads, the time scales with disk bandwidth and cores instead of the latency of each file
+		//with queueCreates the GPU side is queued for "ProcessLoadedAssets" the same as "LoadStaticMeshAsync", handles gets the requests if given
+		//nothing else may register, unregister or load these meshes during the call
+		inline StaticMeshBulkLoadStats LoadStaticMeshesBulk(const std::vector<uint64_t>& IDs, const bool& queueCreates = true,
+			std::vector<LoadHandle>* handles = nullptr, const uint32_t& threadCount = 0)
+		{
+			SMOK_PROFILE_ZONE("AssetManager::LoadStaticMeshesBulk");
+			const auto start = std::chrono::high_resolution_clock::now();
+			StaticMeshBulkLoadStats stats;
+
+			//gathers the meshes that need loading
+			std::vector<Asset_StaticMesh*> meshes;
+			std::vector<Asset_StaticMesh*> packedMeshes;
+			std::vector<Asset_StaticMesh*> loadedMeshes; //already loaded but not created, they only need their create step
+			std::vector<std::string> paths;
+			std::unordered_set<uint64_t> gatheredIDs;
+			meshes.reserve(IDs.size());
+			paths.reserve(IDs.size());
+			gatheredIDs.reserve(IDs.size());
+			for (size_t i = 0; i < IDs.size(); ++i)
+			{
+				Asset_StaticMesh* mesh = GetStaticMesh(IDs[i]);
+				if (!mesh)
+				{
+					fmt::print("Smok Asset Manager Error: AssetManager || LoadStaticMeshesBulk || No static mesh is registered with the ID {}. Use \"RegisterAsset_StaticMesh\" first.\n", IDs[i]);
+					stats.failed++;
+					continue;
+				}
+
+				//a mesh listed twice would be decoded into by two threads at once
+				if (!gatheredIDs.insert(IDs[i]).second || mesh->assetIsCreated || mesh->uploadIsPending || loader.HasRequestInFlight(IDs[i]))
+				{
+					stats.skipped++;
+					continue;
+				}
+
+				if (mesh->settingDataIsLoaded)
+				{
+					loadedMeshes.emplace_back(mesh);
+					stats.skipped++;
 					continue;
+				}
 
-				for (size_t i = 0; i < m.second.asset.meshes.size(); ++i)
-					m.second.asset.meshes[i].DestroyIndexBuffers(_allocator);
-				m.second.asset.DestroyVertexBuffers(_allocator);
+				if (mesh->packEntry)
+				{
+					packedMeshes.emplace_back(mesh);
+					continue;
+				}
+
+				meshes.emplace_back(mesh);
+				paths.emplace_back(mesh->binaryFile.GetPathStr());
+			}
+
+			//packed meshes are already mapped so they only need decoding, they go first as they never wait on the disk
+			std::atomic<size_t> loaded = 0, failed = 0;
+			if (!packedMeshes.empty())
+			{
+				uint32_t packThreadCount = threadCount;
+				if (packThreadCount == 0)
+				{
+					const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+					packThreadCount = (hardwareThreads > 0 ? hardwareThreads : 1);
+				}
+				if (packThreadCount > packedMeshes.size())
+					packThreadCount = (uint32_t)packedMeshes.size();
+
+				std::atomic<size_t> nextMesh = 0;
+				auto decodePackedMeshes = [&]() {
+					for (size_t m = nextMesh++; m < packedMeshes.size(); m = nextMesh++)
+					{
+						SMOK_PROFILE_ASSET_ZONE("AssetManager::DecodeStaticMesh_Packed", packedMeshes[m]->ID, Profiling::AssetStage::Decode);
+						if (packedMeshes[m]->LoadMesh())
+							loaded++;
+						else
+							failed++;
+					}
+				};
 
-				m.second.assetIsCreated = false;
+				std::vector<std::thread> threads;
+				for (uint32_t t = 1; t < packThreadCount; ++t)
+					threads.emplace_back(decodePackedMeshes);
+				decodePackedMeshes();
+				for (auto& thread : threads)
+					thread.join();
+				stats.packed = packedMeshes.size();
 			}
 
-			for (auto& p : pipelines)
-				p.second.asset.Destroy(GPU);
+			//v2 binaries decode on their own, v1 ones need their decl so they are set aside for a second batch
+			IO::BulkFileReader reader;
+			std::vector<IO::BulkReadResult> binaries;
+			std::mutex legacyMutex;
+			std::vector<size_t> legacyMeshes;
+			stats.binaryReads = reader.ReadAndProcessFiles(paths, binaries, [&](const size_t& m) {
+				SMOK_PROFILE_ASSET_ZONE("AssetManager::DecodeStaticMesh", meshes[m]->ID, Profiling::AssetStage::Decode);
+				if (!binaries[m].succeeded)
+				{
+					failed++;
+					return;
+				}
+
+				if (!Smok::Asset::Mesh::Serilize::BinaryDataIsV2(binaries[m].data.get(), binaries[m].size))
+				{
+					std::lock_guard<std::mutex> lock(legacyMutex);
+					legacyMeshes.emplace_back(m);
+					return;
+				}
+
+				if (!Smok::Asset::Mesh::Serilize::LoadStaticMeshDataFromMemory(std::string_view(), binaries[m].data.get(), binaries[m].size, paths[m], meshes[m]->asset))
+					failed++;
+				else
+				{
+					meshes[m]->settingDataIsLoaded = true;
+					loaded++;
+				}
+				binaries[m].data.reset();
+			}, threadCount);
+
+			if (!legacyMeshes.empty())
+			{
+				std::vector<std::string> declPaths(legacyMeshes.size());
+				for (size_t l = 0; l < legacyMeshes.size(); ++l)
+					declPaths[l] = meshes[legacyMeshes[l]]->declFile.GetPathStr();
+
+				std::vector<IO::BulkReadResult> decls;
+				stats.declReads = reader.ReadAndProcessFiles(declPaths, decls, [&](const size_t& l) {
+					const size_t m = legacyMeshes[l];
+					SMOK_PROFILE_ASSET_ZONE("AssetManager::DecodeStaticMesh_Legacy", meshes[m]->ID, Profiling::AssetStage::Decode);
+					const std::string_view declText((const char*)decls[l].data.get(), decls[l].size);
+					if (!decls[l].succeeded || !Smok::Asset::Mesh::Serilize::LoadStaticMeshDataFromMemory(declText, binaries[m].data.get(), binaries[m].size, paths[m], meshes[m]->asset))
+						failed++;
+					else
+					{
+						meshes[m]->settingDataIsLoaded = true;
+						loaded++;
+					}
+					decls[l].data.reset();
+					binaries[m].data.reset();
+				}, threadCount);
+			}
 
-			for (auto& l : pipelineLayouts)
-				l.second.asset.Destroy(GPU);
+			stats.loaded = loaded;
+			stats.failed += failed;
+			meshes.insert(meshes.end(), packedMeshes.begin(), packedMeshes.end());
+			meshes.insert(meshes.end(), loadedMeshes.begin(), loadedMeshes.end());
+
+			//the decode step of these requests sees the data is already loaded and returns straight away
+			if (queueCreates)
+			{
+				for (size_t m = 0; m < meshes.size(); ++m)
+				{
+					if (!meshes[m]->settingDataIsLoaded)
+						continue;
+
+					LoadHandle handle = LoadStaticMeshAsync(meshes[m]->ID);
+					if (handles)
+						handles->emplace_back(handle);
+				}
+			}
+
+			stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			return stats;
 		}
 
-		//registers a graphics pipeline
+		//registers a graphics pipeline, a name already registered is replaced, it's pending loads are cancelled first
+		//a pipeline that is already created can not be replaced, unregister it first so it's destroyed through the deletion queue
 		inline uint64_t RegisterAsset_GraphicsPipeline(const std::string& name, const BTD::IO::FileInfo& pipelineDataSettingFile,
 			const BTD::IO::FileInfo& vertexShaderDataSettingFile, const BTD::IO::FileInfo& fragmentShaderDataSettingFile)
 		{
-			uint64_t ID = assetNameRegistery.GenerateID(name);
+			Asset_GraphicsPipeline pipeline;
+			pipeline.type = AssetType::GraphicsPipeline;
+			pipeline.pipelineDataSettingFile = pipelineDataSettingFile;
+			pipeline.vertexShaderDataSettingFile = vertexShaderDataSettingFile;
+			pipeline.fragmentShaderDataSettingFile = fragmentShaderDataSettingFile;
+			pipeline.asset = Wireframe::Pipeline::GraphicsPipeline();
+			const uint64_t ID = RegisterAsset(pipelines, name, std::move(pipeline), nullptr);
 
-			pipelines[ID] = Asset_GraphicsPipeline();
-			pipelines[ID].ID = ID;
-			pipelines[ID].pipelineDataSettingFile = pipelineDataSettingFile;
-			pipelines[ID].vertexShaderDataSettingFile = vertexShaderDataSettingFile;
-			pipelines[ID].fragmentShaderDataSettingFile = fragmentShaderDataSettingFile;
-			pipelines[ID].asset = Wireframe::Pipeline::GraphicsPipeline();
+			if (hotReloadIsEnabled && GetGraphicsPipeline(ID))
+				WatchAssetFiles(*GetGraphicsPipeline(ID));
 			return ID;
 		}
 
-		//registers a pipeline layout
+		//registers a graphics pipeline read out of a asset pack, the pack must stay open while the pipeline is registered
+		inline uint64_t RegisterAsset_GraphicsPipeline(const std::string& name, const Pack::AssetPack& pack)
+		{
+			const Pack::PackEntry* entry = pack.Find(Pack::PackEntryType::PipelineSettings, name);
+			if (!entry || pack.GetName(*entry) != name)
+			{
+				fmt::print("Smok Asset Manager Error: AssetManager || RegisterAsset_GraphicsPipeline || \"{}\" has no graphics pipeline named \"{}\".\n", pack.filepath, name);
+				return Memory::INVALID_SLOT_ID;
+			}
+
+			Asset_GraphicsPipeline pipeline;
+			pipeline.type = AssetType::GraphicsPipeline;
+			pipeline.pack = &pack;
+			pipeline.asset = Wireframe::Pipeline::GraphicsPipeline();
+			return RegisterAsset(pipelines, name, std::move(pipeline), nullptr);
+		}
+
+		//registers a pipeline layout, replacing one works the same as "RegisterAsset_GraphicsPipeline"
 		inline uint64_t RegisterAsset_PipelineLayout(const std::string& name, const BTD::IO::FileInfo& pushConstantDataSettingFile)
 		{
-			uint64_t ID = assetNameRegistery.GenerateID(name);
-			pipelineLayouts[ID] = Asset_PipelineLayout();
-			pipelineLayouts[ID].ID = ID;
-			pipelineLayouts[ID].pushConstantDataSettingFile = pushConstantDataSettingFile;
-			pipelineLayouts[ID].asset = Wireframe::Pipeline::PipelineLayout();
-			return ID;
+			Asset_PipelineLayout layout;
+			layout.type = AssetType::PipelineLayout;
+			layout.pushConstantDataSettingFile = pushConstantDataSettingFile;
+			layout.asset = Wireframe::Pipeline::PipelineLayout();
+			return RegisterAsset(pipelineLayouts, name, std::move(layout), nullptr);
 		}
 
-		//registers a static mesh
+		//registers a static mesh, a name already registered is replaced, it's pending loads are cancelled first
+		//replacing a mesh that is created needs deletionQueue so it's buffers are retired once frames in flight are done with them
 		inline uint64_t RegisterAsset_StaticMesh(const std::string& name,
-			const BTD::IO::FileInfo& declFile, const BTD::IO::FileInfo& binaryFile)
-		{
-			uint64_t ID = assetNameRegistery.GenerateID(name);
-			staticMeshes[ID] = Asset_StaticMesh();
-			staticMeshes[ID].ID = ID;
-			staticMeshes[ID].asset = Smok::Asset::Mesh::StaticMesh();
-			staticMeshes[ID].declFile = declFile;
-			staticMeshes[ID].binaryFile = binaryFile;
-			return ID;
+			const BTD::IO::FileInfo& declFile, const BTD::IO::FileInfo& binaryFile, Memory::FrameDeletionQueue* deletionQueue = nullptr)
+		{
+			Asset_StaticMesh mesh;
+			mesh.type = AssetType::StaticMesh;
+			mesh.asset = Smok::Asset::Mesh::StaticMesh();
+			mesh.declFile = declFile;
+			mesh.binaryFile = binaryFile;
+			return RegisterStaticMesh(name, std::move(mesh), deletionQueue);
+		}
+
+		//registers a static mesh read out of a asset pack, the pack must stay open while the mesh is registered
+		inline uint64_t RegisterAsset_StaticMesh(const std::string& name, const Pack::AssetPack& pack, Memory::FrameDeletionQueue* deletionQueue = nullptr)
+		{
+			const Pack::PackEntry* entry = pack.Find(Pack::PackEntryType::StaticMesh, name);
+			if (!entry || pack.GetName(*entry) != name)
+			{
+				fmt::print("Smok Asset Manager Error: AssetManager || RegisterAsset_StaticMesh || \"{}\" has no static mesh named \"{}\".\n", pack.filepath, name);
+				return Memory::INVALID_SLOT_ID;
+			}
+
+			Asset_StaticMesh mesh;
+			mesh.type = AssetType::StaticMesh;
+			mesh.asset = Smok::Asset::Mesh::StaticMesh();
+			mesh.pack = &pack;
+			mesh.packEntry = entry;
+			return RegisterStaticMesh(name, std::move(mesh), deletionQueue);
+		}
+
+		//opens a asset pack and registers every static mesh and graphics pipeline in it, a name already registered is replaced by the pack's and keeps it's ID
+		//one pack replaces the open and stat of every loose file, the meshes load with "LoadStaticMeshAsync" or "LoadStaticMeshesBulk" the same as any other
+		//replacing meshes that are created needs deletionQueue, see "RegisterAsset_StaticMesh"
+		//returns the pack, nullptr if it could not be opened
+		inline const Pack::AssetPack* MountAssetPack(const BTD::IO::FileInfo& packFile, size_t* registeredCount = nullptr, Memory::FrameDeletionQueue* deletionQueue = nullptr)
+		{
+			SMOK_PROFILE_ZONE("AssetManager::MountAssetPack");
+
+			std::unique_ptr<Pack::AssetPack> pack = std::make_unique<Pack::AssetPack>();
+			if (!pack->Open(packFile))
+				return nullptr;
+
+			size_t registered = 0;
+			for (size_t e = 0; e < pack->GetEntryCount(); ++e)
+			{
+				const Pack::PackEntry& entry = pack->GetEntry(e);
+				if (entry.type == Pack::PackEntryType::StaticMesh &&
+					RegisterAsset_StaticMesh(std::string(pack->GetName(entry)), *pack, deletionQueue) != Memory::INVALID_SLOT_ID)
+					registered++;
+				else if (entry.type == Pack::PackEntryType::PipelineSettings &&
+					RegisterAsset_GraphicsPipeline(std::string(pack->GetName(entry)), *pack) != Memory::INVALID_SLOT_ID)
+					registered++;
+			}
+
+			if (registeredCount)
+				*registeredCount = registered;
+			assetPacks.emplace_back(std::move(pack));
+			return assetPacks.back().get();
 		}
 
 		//gets if a ID matches the static mesh asset
 		inline bool AssetIsRegistered_StaticMesh(const uint64_t& ID) const
 		{
-			return (staticMeshes.find(ID) != staticMeshes.end() ? true : false);
+			return staticMeshes.IsValid(Memory::SlotHandle::Unpack(ID));
+		}
+
+		//unregisters a static mesh, it's buffers are retired through the deletion queue so frames in flight can finish with them
+		//any async load of the mesh must be done first
+		inline bool UnregisterAsset_StaticMesh(const uint64_t& ID, Memory::FrameDeletionQueue& deletionQueue)
+		{
+			Asset_StaticMesh* mesh = GetStaticMesh(ID);
+			if (!mesh)
+				return false;
+
+			//a upload landing after this would count the mesh again
+			if (mesh->uploadIsPending)
+				meshUploader.Finish();
+
+			unusedStaticMeshes.Remove(mesh);
+			SetStaticMeshResidency(*mesh, 0, 0);
+			RetireStaticMeshBuffers(*mesh, deletionQueue);
+			return UnregisterAsset(staticMeshes, ID);
+		}
+
+		//unregisters a graphics pipeline, it's destroyed through the deletion queue so frames in flight can finish with it
+		inline bool UnregisterAsset_GraphicsPipeline(const uint64_t& ID, Memory::FrameDeletionQueue& deletionQueue, Wireframe::Device::GPU* GPU)
+		{
+			Asset_GraphicsPipeline* pipeline = GetGraphicsPipeline(ID);
+			if (!pipeline)
+				return false;
+
+			if (pipeline->assetIsCreated)
+				deletionQueue.Push([asset = pipeline->asset, GPU]() mutable { asset.Destroy(GPU); });
+
+			return UnregisterAsset(pipelines, ID);
+		}
+
+		//unregisters a pipeline layout, it's destroyed through the deletion queue so frames in flight can finish with it
+		inline bool UnregisterAsset_PipelineLayout(const uint64_t& ID, Memory::FrameDeletionQueue& deletionQueue, Wireframe::Device::GPU* GPU)
+		{
+			Asset_PipelineLayout* layout = GetPipelineLayout(ID);
+			if (!layout)
+				return false;
+
+			if (layout->assetIsCreated)
+				deletionQueue.Push([asset = layout->asset, GPU]() mutable { asset.Destroy(GPU); });
+
+			return UnregisterAsset(pipelineLayouts, ID);
+		}
+
+		//sets the memory budgets in bytes, 0 is no limit, meshes are evicted in "UpdateResidency"
+		inline void SetResidencyBudget(const uint64_t& CPUBytes, const uint64_t& GPUBytes)
+		{
+			residencyBudget.CPUBytes = CPUBytes;
+			residencyBudget.GPUBytes = GPUBytes;
+		}
+
+		//adds a user to a static mesh so it can not be evicted, loads it if it was never loaded or was evicted
+		inline bool AcquireStaticMesh(const uint64_t& ID, const int32_t& priority = LoadPriority_Normal)
+		{
+			Asset_StaticMesh* mesh = GetStaticMesh(ID);
+			if (!mesh)
+			{
+				fmt::print("Smok Asset Manager Error: AssetManager || AcquireStaticMesh || No static mesh is registered with the ID {}.\n", ID);
+				return false;
+			}
+
+			mesh->refCount++;
+			unusedStaticMeshes.Remove(mesh);
+			if (!mesh->assetIsCreated && !mesh->uploadIsPending)
+				RequestStaticMeshReload(*mesh, priority);
+			return true;
+		}
+
+		//removes a user from a static mesh, once it has none it can be evicted
+		inline void ReleaseStaticMesh(const uint64_t& ID)
+		{
+			Asset_StaticMesh* mesh = GetStaticMesh(ID);
+			if (!mesh || mesh->refCount == 0)
+				return;
+
+			mesh->refCount--;
+			if (mesh->refCount == 0 && (mesh->cpuBytes > 0 || mesh->gpuBytes > 0))
+				unusedStaticMeshes.PushBack(mesh);
+		}
+
+		//adds a mesh renderer as a user of it's static mesh, call when the component is added or it's mesh changes
+		inline bool AcquireMeshRender(const ECS::Comp::MeshRender& render, const int32_t& priority = LoadPriority_Normal) { return AcquireStaticMesh(render.staticMeshID, priority); }
+
+		//removes a mesh renderer as a user of it's static mesh, call when the component is removed or before it's mesh changes
+		inline void ReleaseMeshRender(const ECS::Comp::MeshRender& render) { ReleaseStaticMesh(render.staticMeshID); }
+
+		//gets a static mesh to draw, nullptr if it's not created yet
+		//a mesh that was evicted or never loaded is queued to load, so this can be called every frame
+		inline Asset_StaticMesh* UseStaticMesh(const uint64_t& ID, const int32_t& priority = LoadPriority_High)
+		{
+			Asset_StaticMesh* mesh = GetStaticMesh(ID);
+			if (!mesh)
+				return nullptr;
+
+			if (mesh->assetIsCreated)
+			{
+				residencyStats.hits++;
+				unusedStaticMeshes.Touch(mesh);
+				return mesh;
+			}
+
+			residencyStats.misses++;
+			if (!mesh->uploadIsPending)
+				RequestStaticMeshReload(*mesh, priority);
+			return nullptr;
+		}
+
+		//evicts the least recently used meshes nothing has acquired until the budgets are met, returns the number of meshes evicted from
+		//GPU buffers go through the deletion queue, call once a frame after "ProcessLoadedAssets"
+		inline size_t UpdateResidency(Memory::FrameDeletionQueue& deletionQueue)
+		{
+			SMOK_PROFILE_ZONE("AssetManager::UpdateResidency");
+			size_t evicted = 0;
+			Asset_StaticMesh* mesh = unusedStaticMeshes.head;
+			while (mesh && (IsOverCPUBudget() || IsOverGPUBudget()))
+			{
+				Asset_StaticMesh* next = mesh->LRUNext;
+
+				//a worker may be writing to a mesh that is loading
+				if (mesh->uploadIsPending || loader.HasRequestInFlight(mesh->ID))
+				{
+					mesh = next;
+					continue;
+				}
+
+				bool didEvict = false;
+				if (IsOverGPUBudget() && mesh->gpuBytes > 0)
+				{
+					RetireStaticMeshBuffers(*mesh, deletionQueue);
+					SetStaticMeshResidency(*mesh, mesh->cpuBytes, 0);
+					mesh->wasEvicted = true;
+					residencyStats.GPUEvictions++;
+					didEvict = true;
+				}
+
+				if (IsOverCPUBudget() && mesh->cpuBytes > 0)
+				{
+					EvictStaticMeshArrays(*mesh);
+					SetStaticMeshResidency(*mesh, 0, mesh->gpuBytes);
+					residencyStats.CPUEvictions++;
+					didEvict = true;
+				}
+
+				if (mesh->cpuBytes == 0 && mesh->gpuBytes == 0)
+					unusedStaticMeshes.Remove(mesh);
+
+				evicted += didEvict;
+				mesh = next;
+			}
+
+			return evicted;
+		}
+
+		//is a budget passed
+		inline bool IsOverCPUBudget() const { return residencyBudget.CPUBytes > 0 && residencyStats.CPUBytesResident > residencyBudget.CPUBytes; }
+		inline bool IsOverGPUBudget() const { return residencyBudget.GPUBytes > 0 && residencyStats.GPUBytesResident > residencyBudget.GPUBytes; }
+
+		//starts watching the files of every static mesh and graphics pipeline, assets registered later are watched as they're added
+		//pipeline layouts are not reloaded, the pipelines made from them would all have to be remade
+		inline bool EnableHotReload()
+		{
+			if (hotReloadIsEnabled)
+				return true;
+			if (!fileWatcher.Init())
+				return false;
+
+			hotReloadIsEnabled = true;
+			staticMeshes.ForEach([&](const Memory::SlotHandle&, Asset_StaticMesh& m) { WatchAssetFiles(m); });
+			pipelines.ForEach([&](const Memory::SlotHandle&, Asset_GraphicsPipeline& p) { WatchAssetFiles(p); });
+			return true;
+		}
+
+		//stops watching files, reloads already queued still land
+		inline void DisableHotReload()
+		{
+			hotReloadIsEnabled = false;
+			fileWatcher.Destroy();
+			hotReloadTargets.clear();
+		}
+
+		//queues a reload of every asset using a file changed since the last call, returns the number of reloads queued
+		//call once a frame, the new assets are created and swapped in by "ProcessLoadedAssets" and the old ones retired through deletionQueue
+		//deletionQueue must outlive the reloads
+		inline size_t ProcessHotReload(Memory::FrameDeletionQueue& deletionQueue)
+		{
+			SMOK_PROFILE_ZONE("AssetManager::ProcessHotReload");
+			if (!hotReloadIsEnabled || fileWatcher.Poll(changedFiles) == 0)
+				return 0;
+
+			const auto seenTime = std::chrono::high_resolution_clock::now();
+			hotReloadStats.filesChanged += changedFiles.size();
+
+			//a asset using more than one of the changed files is only reloaded once
+			std::vector<HotReloadTarget> targets;
+			for (const std::string& file : changedFiles)
+			{
+				auto it = hotReloadTargets.find(file);
+				if (it == hotReloadTargets.end())
+					continue;
+				for (const HotReloadTarget& target : it->second)
+				{
+					if (std::find(targets.begin(), targets.end(), target) == targets.end())
+						targets.emplace_back(target);
+				}
+			}
+
+			size_t queued = 0;
+			for (const HotReloadTarget& target : targets)
+			{
+				if (target.type == AssetType::StaticMesh)
+					queued += QueueStaticMeshReload(target.ID, deletionQueue, seenTime);
+				else if (target.type == AssetType::GraphicsPipeline)
+					queued += QueueGraphicsPipelineReload(target.ID, deletionQueue, seenTime);
+			}
+
+			hotReloadStats.reloadsQueued += queued;
+			return queued;
+		}
+
+		//---internal
+
+		//watches a file for a asset
+		inline void WatchFile(const std::string& path, const HotReloadTarget& target)
+		{
+			if (path.empty() || !fileWatcher.Watch(path))
+				return;
+
+			std::vector<HotReloadTarget>& targets = hotReloadTargets[IO::FileWatcher::NormalizePath(path)];
+			if (std::find(targets.begin(), targets.end(), target) == targets.end())
+				targets.emplace_back(target);
+		}
+
+		//watches the files of a static mesh, packed meshes have none
+		inline void WatchAssetFiles(const Asset_StaticMesh& mesh)
+		{
+			if (mesh.packEntry)
+				return;
+
+			WatchFile(mesh.declFile.GetPathStr(), { AssetType::StaticMesh, mesh.ID });
+			WatchFile(mesh.binaryFile.GetPathStr(), { AssetType::StaticMesh, mesh.ID });
+		}
+
+		//watches the files of a graphics pipeline, the SPIR-V binaries too once the settings are loaded
+		//packed pipelines have none, their settings files are extracted copies
+		inline void WatchAssetFiles(const Asset_GraphicsPipeline& pipeline)
+		{
+			if (pipeline.pack)
+				return;
+
+			const HotReloadTarget target = { AssetType::GraphicsPipeline, pipeline.ID };
+			WatchFile(pipeline.pipelineDataSettingFile.GetPathStr(), target);
+			WatchFile(pipeline.vertexShaderDataSettingFile.GetPathStr(), target);
+			WatchFile(pipeline.fragmentShaderDataSettingFile.GetPathStr(), target);
+			if (pipeline.settingDataIsLoaded)
+			{
+				WatchFile(pipeline.vertexSettings.binaryFilepath, target);
+				WatchFile(pipeline.fragmentSettings.binaryFilepath, target);
+			}
+		}
+
+		//records how long a reload took
+		inline void RecordHotReload(const bool& swapped, const std::chrono::high_resolution_clock::time_point& seenTime)
+		{
+			if (!swapped)
+			{
+				hotReloadStats.reloadsFailed++;
+				return;
+			}
+
+			hotReloadStats.reloadsSwapped++;
+			hotReloadStats.lastReloadMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - seenTime).count();
+			if (hotReloadStats.lastReloadMilliseconds > hotReloadStats.maxReloadMilliseconds)
+				hotReloadStats.maxReloadMilliseconds = hotReloadStats.lastReloadMilliseconds;
+		}
+
+		//loads a static mesh's files into a copy on a worker, the live mesh keeps drawing until the copy is swapped in
+		inline bool QueueStaticMeshReload(const uint64_t& ID, Memory::FrameDeletionQueue& deletionQueue, const std::chrono::high_resolution_clock::time_point& seenTime)
+		{
+			Asset_StaticMesh* mesh = GetStaticMesh(ID);
+			if (!mesh)
+				return false;
+
+			std::shared_ptr<Smok::Asset::Mesh::StaticMesh> staged = std::make_shared<Smok::Asset::Mesh::StaticMesh>();
+			const BTD::IO::FileInfo declFile = mesh->declFile;
+			const BTD::IO::FileInfo binaryFile = mesh->binaryFile;
+			return loader.Enqueue(ID, AssetType::StaticMesh, LoadPriority_High,
+				[staged, declFile, binaryFile]() { return Smok::Asset::Mesh::Serilize::LoadStaticMeshDataFromFile(declFile, binaryFile, *staged); },
+				[this, ID, staged, &deletionQueue, seenTime](VmaAllocator& allocator, Wireframe::Device::GPU*) {
+					//a load in flight may still be filling the mesh on a worker, the swap waits for it's create step instead of stalling the frame
+					if (loader.HasRequestInFlight(ID))
+					{
+						DeferStaticMeshSwap({ ID, staged, &deletionQueue, seenTime });
+						return true;
+					}
+
+					const bool swapped = SwapStaticMesh(ID, *staged, allocator, deletionQueue);
+					RecordHotReload(swapped, seenTime);
+					return swapped;
+				}, false).IsValid();
+		}
+
+		//holds a reload back until the mesh's load in flight is done, a newer reload of the same mesh replaces a older one
+		inline void DeferStaticMeshSwap(DeferredStaticMeshSwap&& swap)
+		{
+			for (DeferredStaticMeshSwap& deferred : deferredStaticMeshSwaps)
+			{
+				if (deferred.ID == swap.ID)
+				{
+					deferred = std::move(swap);
+					return;
+				}
+			}
+			deferredStaticMeshSwaps.emplace_back(std::move(swap));
+		}
+
+		//swaps in the deferred reloads of meshes with no load left in flight, call on the owning thread after the create steps ran
+		inline void ProcessDeferredStaticMeshSwaps(VmaAllocator& allocator)
+		{
+			for (size_t i = 0; i < deferredStaticMeshSwaps.size();)
+			{
+				if (loader.HasRequestInFlight(deferredStaticMeshSwaps[i].ID))
+				{
+					++i;
+					continue;
+				}
+
+				DeferredStaticMeshSwap swap = std::move(deferredStaticMeshSwaps[i]);
+				deferredStaticMeshSwaps[i] = std::move(deferredStaticMeshSwaps.back());
+				deferredStaticMeshSwaps.pop_back();
+
+				RecordHotReload(SwapStaticMesh(swap.ID, *swap.staged, allocator, *swap.deletionQueue), swap.seenTime);
+			}
+		}
+
+		//swaps reloaded data into a live static mesh, it's new buffers are made before the old ones are retired
+		//no load of the mesh may be in flight, see "DeferStaticMeshSwap"
+		inline bool SwapStaticMesh(const uint64_t& ID, Smok::Asset::Mesh::StaticMesh& staged, VmaAllocator& allocator, Memory::FrameDeletionQueue& deletionQueue)
+		{
+			Asset_StaticMesh* mesh = GetStaticMesh(ID);
+			if (!mesh)
+				return false; //unregistered while it was loading
+
+			if (mesh->uploadIsPending)
+				meshUploader.Finish();
+
+			//a mesh that was never loaded or was evicted picks the new files up on it's next load
+			if (!mesh->assetIsCreated)
+			{
+				if (!mesh->settingDataIsLoaded)
+					return true;
+
+				//only the CPU copy is resident, replace it
+				mesh->asset = std::move(staged);
+				SetStaticMeshResidency(*mesh, GetStaticMeshDataSize(*mesh), 0);
+				return true;
+			}
+
+			if (meshUploader.IsInitalized())
+			{
+				//a reload is rare enough to wait on, so the swap happens this frame
+				const bool uploaded = (geometryPool.IsInitalized() && meshUploader.UploadStaticMesh(staged, geometryPool, std::function<void()>())) ||
+					(!staged.UsesGeometryPool() && meshUploader.UploadStaticMesh(staged, std::function<void()>()));
+				if (!uploaded)
+					return false;
+				meshUploader.Finish();
+			}
+			else
+			{
+				staged.CreateVertexBuffers(allocator);
+				for (size_t i = 0; i < staged.meshes.size(); ++i)
+					staged.meshes[i].CreateIndexBuffers(allocator);
+			}
+
+			RetireStaticMeshBuffers(*mesh, deletionQueue);
+			mesh->asset = std::move(staged);
+			geometryPool.Rebind(mesh->asset);
+			mesh->assetIsCreated = true;
+			mesh->settingDataIsLoaded = true;
+			TrackStaticMeshResidency(*mesh);
+			return true;
+		}
+
+		//loads a graphics pipeline's settings and shaders into a copy on a worker, the live pipeline keeps being used until the copy is swapped in
+		inline bool QueueGraphicsPipelineReload(const uint64_t& ID, Memory::FrameDeletionQueue& deletionQueue, const std::chrono::high_resolution_clock::time_point& seenTime)
+		{
+			Asset_GraphicsPipeline* pipeline = GetGraphicsPipeline(ID);
+			if (!pipeline)
+				return false;
+
+			std::shared_ptr<Asset_GraphicsPipeline> staged = std::make_shared<Asset_GraphicsPipeline>();
+			staged->pipelineDataSettingFile = pipeline->pipelineDataSettingFile;
+			staged->vertexShaderDataSettingFile = pipeline->vertexShaderDataSettingFile;
+			staged->fragmentShaderDataSettingFile = pipeline->fragmentShaderDataSettingFile;
+			return loader.Enqueue(ID, AssetType::GraphicsPipeline, LoadPriority_High,
+				[staged]() { return staged->LoadPipelineSettingsAndShaders(); },
+				[this, ID, staged, &deletionQueue, seenTime](VmaAllocator&, Wireframe::Device::GPU* GPU) {
+					const bool swapped = SwapGraphicsPipeline(ID, *staged, GPU, deletionQueue);
+					RecordHotReload(swapped, seenTime);
+					return swapped;
+				}, false).IsValid();
+		}
+
+		//swaps a reloaded graphics pipeline into the live one, the old pipeline is destroyed through the deletion queue
+		inline bool SwapGraphicsPipeline(const uint64_t& ID, Asset_GraphicsPipeline& staged, Wireframe::Device::GPU* GPU, Memory::FrameDeletionQueue& deletionQueue)
+		{
+			Asset_GraphicsPipeline* pipeline = GetGraphicsPipeline(ID);
+			if (!pipeline)
+				return false;
+
+			//a pipeline that was never made just takes the new settings
+			if (!pipeline->assetIsCreated)
+			{
+				pipeline->pipelineSettings = staged.pipelineSettings;
+				pipeline->vertexSettings = staged.vertexSettings;
+				pipeline->fragmentSettings = staged.fragmentSettings;
+				pipeline->settingDataIsLoaded = true;
+				WatchAssetFiles(*pipeline);
+				return true;
+			}
+
+			Asset_PipelineLayout* layout = GetPipelineLayout(pipeline->pipelineLayoutID);
+			if (!layout || !layout->assetIsCreated || pipeline->renderPass == VK_NULL_HANDLE)
+			{
+				fmt::print("Smok Asset Manager Warning: AssetManager || SwapGraphicsPipeline || \"{}\" was not made by \"CreateGraphicsPipelines\", it's layout and render pass are unknown so it can not be remade.\n", pipeline->name);
+				return false;
+			}
+
+			//the cache makes a bad SPIR-V file fail the create instead of reaching the driver
+			const bool useCaches = (pipelineCache.cache != VK_NULL_HANDLE);
+			ShaderModuleCache shaderCache;
+			shaderCache.device = pipelineCache.device;
+			const bool created = staged.Create(GPU, layout->asset, pipeline->renderPass, (useCaches ? &shaderCache : nullptr), (useCaches ? &pipelineCache : nullptr));
+			shaderCache.Destroy();
+			if (!created)
+			{
+				fmt::print("Smok Asset Manager Error: AssetManager || SwapGraphicsPipeline || Failed to remake \"{}\", the old pipeline is kept.\n", pipeline->name);
+				return false;
+			}
+
+			deletionQueue.Push([asset = pipeline->asset, GPU]() mutable { asset.Destroy(GPU); });
+			pipeline->asset = staged.asset;
+			pipeline->pipelineSettings = staged.pipelineSettings;
+			pipeline->vertexSettings = staged.vertexSettings;
+			pipeline->fragmentSettings = staged.fragmentSettings;
+			pipeline->settingDataIsLoaded = true;
+			WatchAssetFiles(*pipeline);
+			return true;
+		}
+
+		//gets the bytes of a mesh's vertex and index arrays
+		static inline uint64_t GetStaticMeshDataSize(const Asset_StaticMesh& mesh)
+		{
+			uint64_t bytes = mesh.asset.GetVertexDataSize();
+			for (size_t i = 0; i < mesh.asset.meshes.size(); ++i)
+				bytes += mesh.asset.meshes[i].indices.size() * sizeof(uint32_t);
+			return bytes;
+		}
+
+		//queues a load for a mesh that is not created, timing it if it was evicted
+		inline void RequestStaticMeshReload(Asset_StaticMesh& mesh, const int32_t& priority)
+		{
+			//asking every frame while it loads would keep pushing queue entries
+			if (loader.HasRequestInFlight(mesh.ID))
+				return;
+
+			if (mesh.wasEvicted && !mesh.isReloading)
+			{
+				mesh.isReloading = true;
+				mesh.reloadStart = std::chrono::high_resolution_clock::now();
+			}
+
+			LoadStaticMeshAsync(mesh.ID, priority);
+		}
+
+		//counts a mesh that was just created against the budgets
+		inline void TrackStaticMeshResidency(Asset_StaticMesh& mesh)
+		{
+			const uint64_t bytes = GetStaticMeshDataSize(mesh);
+			SetStaticMeshResidency(mesh, bytes, bytes);
+
+			if (mesh.isReloading)
+			{
+				const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - mesh.reloadStart).count();
+				residencyStats.reloads++;
+				residencyStats.reloadMilliseconds += milliseconds;
+				if (milliseconds > residencyStats.maxReloadMilliseconds)
+					residencyStats.maxReloadMilliseconds = milliseconds;
+			}
+			mesh.isReloading = false;
+			mesh.wasEvicted = false;
+
+			if (mesh.refCount == 0)
+			{
+				unusedStaticMeshes.PushBack(&mesh);
+				unusedStaticMeshes.Touch(&mesh);
+			}
+		}
+
+		//sets the bytes a mesh counts against the budgets
+		inline void SetStaticMeshResidency(Asset_StaticMesh& mesh, const uint64_t& CPUBytes, const uint64_t& GPUBytes)
+		{
+			residencyStats.CPUBytesResident = residencyStats.CPUBytesResident - mesh.cpuBytes + CPUBytes;
+			residencyStats.GPUBytesResident = residencyStats.GPUBytesResident - mesh.gpuBytes + GPUBytes;
+			mesh.cpuBytes = CPUBytes;
+			mesh.gpuBytes = GPUBytes;
+		}
+
+		//retires a mesh's buffers through the deletion queue, the mesh is left not created
+		inline void RetireStaticMeshBuffers(Asset_StaticMesh& mesh, Memory::FrameDeletionQueue& deletionQueue)
+		{
+			//the upload's callback points at the slot, let it land first
+			if (mesh.uploadIsPending)
+				meshUploader.Finish();
+
+			if (!mesh.assetIsCreated)
+				return;
+
+			if (mesh.asset.UsesGeometryPool())
+			{
+				const Rendering::GeometryPoolRange range = geometryPool.Release(mesh.asset);
+				deletionQueue.Push([this, range]() { geometryPool.Free(range); });
+			}
+			else if (mesh.asset.UsesPackedBuffers())
+			{
+				deletionQueue.RetireBuffer(mesh.asset.packedVertexBuffer);
+				deletionQueue.RetireBuffer(mesh.asset.packedIndexBuffer);
+				mesh.asset.packedVertexBuffer = Memory::GPUBuffer();
+				mesh.asset.packedIndexBuffer = Memory::GPUBuffer();
+			}
+			else
+			{
+				deletionQueue.RetireVertexBuffer(mesh.asset.vertexBuffer);
+				mesh.asset.vertexBuffer = Wireframe::MeshBuffers::VertexBuffer();
+				for (size_t i = 0; i < mesh.asset.meshes.size(); ++i)
+				{
+					deletionQueue.RetireIndexBuffer(mesh.asset.meshes[i].indexBuffer);
+					mesh.asset.meshes[i].indexBuffer = Wireframe::MeshBuffers::IndexBuffer();
+				}
+			}
+
+			mesh.assetIsCreated = false;
+		}
+
+		//frees a mesh's vertex and index arrays, the sub-meshes and bounds are kept
+		inline void EvictStaticMeshArrays(Asset_StaticMesh& mesh)
+		{
+			std::vector<Smok::Asset::Mesh::Vertex>().swap(mesh.asset.vertices);
+			std::vector<uint8_t>().swap(mesh.asset.packedVertices);
+			for (size_t i = 0; i < mesh.asset.meshes.size(); ++i)
+				std::vector<uint32_t>().swap(mesh.asset.meshes[i].indices);
+			mesh.settingDataIsLoaded = false;
+		}
+
+		//registers a static mesh, watching it's files if hot reload is on
+		inline uint64_t RegisterStaticMesh(const std::string& name, Asset_StaticMesh&& mesh, Memory::FrameDeletionQueue* deletionQueue)
+		{
+			const uint64_t ID = RegisterAsset(staticMeshes, name, std::move(mesh), deletionQueue);
+			if (hotReloadIsEnabled && GetStaticMesh(ID))
+				WatchAssetFiles(*GetStaticMesh(ID));
+			return ID;
+		}
+
+		//lets go of a static mesh that is about to be replaced, returns false if it can not be
+		//no worker may be loading into it and it's buffers go through the deletion queue
+		inline bool ReleaseReplacedAsset(Asset_StaticMesh& mesh, Memory::FrameDeletionQueue* deletionQueue)
+		{
+			//a upload that is queued becomes created once it lands
+			if (mesh.uploadIsPending)
+				meshUploader.Finish();
+
+			if (mesh.assetIsCreated && !deletionQueue)
+			{
+				fmt::print("Smok Asset Manager Error: AssetManager || RegisterAsset || \"{}\" is created, pass a deletion queue so it's buffers can be retired before it is replaced.\n", mesh.name);
+				return false;
+			}
+
+			loader.CancelAndWait(mesh.ID);
+			std::erase_if(deferredStaticMeshSwaps, [&mesh](const DeferredStaticMeshSwap& swap) { return swap.ID == mesh.ID; }); //it's reload is of the old files
+			unusedStaticMeshes.Remove(&mesh);
+			SetStaticMeshResidency(mesh, 0, 0);
+			if (mesh.assetIsCreated)
+				RetireStaticMeshBuffers(mesh, *deletionQueue);
+			return true;
+		}
+
+		//lets go of a graphics pipeline that is about to be replaced, a created one has to be unregistered instead as destroying it needs the GPU
+		inline bool ReleaseReplacedAsset(Asset_GraphicsPipeline& pipeline, Memory::FrameDeletionQueue*)
+		{
+			if (pipeline.assetIsCreated)
+			{
+				fmt::print("Smok Asset Manager Error: AssetManager || RegisterAsset || \"{}\" is created, use \"UnregisterAsset_GraphicsPipeline\" before registering it again.\n", pipeline.name);
+				return false;
+			}
+
+			loader.CancelAndWait(pipeline.ID);
+			return true;
+		}
+
+		//lets go of a pipeline layout that is about to be replaced, a created one has to be unregistered instead as destroying it needs the GPU
+		inline bool ReleaseReplacedAsset(Asset_PipelineLayout& layout, Memory::FrameDeletionQueue*)
+		{
+			if (layout.assetIsCreated)
+			{
+				fmt::print("Smok Asset Manager Error: AssetManager || RegisterAsset || \"{}\" is created, use \"UnregisterAsset_PipelineLayout\" before registering it again.\n", layout.name);
+				return false;
+			}
+
+			loader.CancelAndWait(layout.ID);
+			return true;
+		}
+
+		//adds a asset to it's storage and names it, registering a name again replaces the asset but keeps it's ID
+		//returns Memory::INVALID_SLOT_ID if the name's hash collides with a different name, or the asset being replaced can not be let go of
+		template<typename T>
+		inline uint64_t RegisterAsset(Memory::SlotMap<T>& storage, const std::string& name, T&& asset, Memory::FrameDeletionQueue* deletionQueue)
+		{
+			std::unordered_map<AssetID, AssetNameEntry, AssetIDHasher>& names = assetIDsByName[(size_t)asset.type];
+			const AssetID hashedName(name);
+			asset.name = name;
+
+			auto it = names.find(hashedName);
+			if (it != names.end())
+			{
+				if (it->second.name != name)
+				{
+					fmt::print("Smok Asset Manager Error: AssetManager || RegisterAsset || \"{}\" and \"{}\" hash to the same asset ID {}. Rename one of them.\n",
+						name, it->second.name, hashedName.hash);
+					return Memory::INVALID_SLOT_ID;
+				}
+
+				T* existing = storage.Get(Memory::SlotHandle::Unpack(it->second.ID));
+				if (existing)
+				{
+					if (!ReleaseReplacedAsset(*existing, deletionQueue))
+						return Memory::INVALID_SLOT_ID;
+
+					asset.ID = it->second.ID;
+					if constexpr (requires { asset.refCount; })
+						asset.refCount = existing->refCount; //users that acquired the old asset still hold it under the same ID
+					*existing = std::move(asset);
+					return it->second.ID;
+				}
+			}
+
+			const uint64_t registeryID = assetNameRegistery.GenerateID(name);
+			assetIDsByRegisteryID[registeryID] = hashedName;
+
+			const Memory::SlotHandle handle = storage.Insert(std::move(asset));
+			T* stored = storage.Get(handle);
+			stored->ID = handle.Pack();
+			names[hashedName] = { name, stored->ID, registeryID };
+			return stored->ID;
+		}
+
+		//removes a asset from it's storage and the name table, the ID goes stale
+		template<typename T>
+		inline bool UnregisterAsset(Memory::SlotMap<T>& storage, const uint64_t& ID)
+		{
+			T* asset = storage.Get(Memory::SlotHandle::Unpack(ID));
+			if (!asset)
+				return false;
+
+			assetIDsByName[(size_t)asset->type].erase(AssetID(asset->name));
+			return storage.Remove(Memory::SlotHandle::Unpack(ID));
 		}
 	};
 }
\ No newline at end of file
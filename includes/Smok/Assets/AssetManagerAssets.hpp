@@ -6,9 +6,16 @@
 //in the future, might just merge them all into one
 
 #include <Smok/Assets/Mesh.hpp>
+#include <Smok/Assets/AssetPack.hpp>
+#include <Smok/Assets/PipelineCache.hpp>
+#include <Smok/Rendering/MeshUploader.hpp>
+#include <Smok/Memory/SlotMap.hpp>
 
 #include <BTDSTD/Wireframe/Pipeline/GraphicsPipeline.hpp>
 
+#include <chrono>
+#include <functional>
+
 namespace Smok::Asset::AssetManager
 {
 	//defines the types of assets
@@ -25,7 +32,8 @@ namespace Smok::Asset::AssetManager
 	//defines a common asset
 	struct IAsset
 	{
-		uint64_t ID = 0; //the ID
+		uint64_t ID = 0; //the ID, a packed slot handle into the asset manager's storage for this type
+		std::string name; //the name it was registered with
 
 		AssetType type = AssetType::Count; //the type of asset
 
@@ -49,6 +57,7 @@ namespace Smok::Asset::AssetManager
 			//if data is not loaded
 
 			//creates
+			SMOK_PROFILE_ASSET_ZONE("PipelineLayout::Create", ID, Profiling::AssetStage::None);
 			assetIsCreated = asset.Create(info, GPU);
 			return assetIsCreated;
 		}
@@ -88,26 +97,79 @@ namespace Smok::Asset::AssetManager
 		BTD::IO::FileInfo fragmentShaderDataSettingFile;
 		Wireframe::Shader::Serilize::ShaderSerilizeData fragmentSettings;
 
+		//set when the settings and SPIR-V are read out of a asset pack instead of their files, see "AssetManager::MountAssetPack"
+		const Pack::AssetPack* pack = nullptr;
+
 		Wireframe::Pipeline::GraphicsPipeline asset; //the asset
 
+		//what the pipeline was made with by "AssetManager::CreateGraphicsPipelines", needed to remake it on a hot reload
+		uint64_t pipelineLayoutID = Memory::INVALID_SLOT_ID;
+		VkRenderPass renderPass = VK_NULL_HANDLE;
+
 		//creates the graphics pipeline
-		inline bool Create(Wireframe::Device::GPU* GPU, Wireframe::Pipeline::PipelineLayout& pipelineLayout, VkRenderPass& renderpass)
+		//with a shader cache the modules come from and stay in the cache, otherwise they are made and destroyed here
+		//with a pipeline cache the pipeline is made through it, so a warm cache skips compiling the shaders again
+		inline bool Create(Wireframe::Device::GPU* GPU, Wireframe::Pipeline::PipelineLayout& pipelineLayout, VkRenderPass& renderpass,
+			ShaderModuleCache* shaderCache = nullptr, const PipelineCache* pipelineCache = nullptr)
 		{
 			//if asset is already created
 
 			//if data is not loaded
 
+			//the pipeline cache is handed to Wireframe, which passes it on to vkCreateGraphicsPipelines
+			VkPipelineCache cache = (pipelineCache ? pipelineCache->cache : VK_NULL_HANDLE);
+
+			//packed SPIR-V is not a file Wireframe's shader modules can read, so it always goes through a cache
+			if (pack && !shaderCache)
+			{
+				if (!pipelineCache || pipelineCache->device == VK_NULL_HANDLE)
+				{
+					fmt::print("Smok Asset Manager Error: Asset_GraphicsPipeline || Create || \"{}\" is packed, it's shaders need a pipeline cache to get the device from, call \"AssetManager::InitPipelineCache\" first.\n", name);
+					return false;
+				}
+
+				ShaderModuleCache packShaderCache;
+				packShaderCache.device = pipelineCache->device;
+				const bool created = Create(GPU, pipelineLayout, renderpass, &packShaderCache, pipelineCache);
+				packShaderCache.Destroy();
+				return created;
+			}
+
+			if (shaderCache)
+			{
+				VkShaderModule meshVertShader = shaderCache->Get(vertexSettings.binaryFilepath, pack);
+				VkShaderModule meshFragShader = shaderCache->Get(fragmentSettings.binaryFilepath, pack);
+				if (meshVertShader == VK_NULL_HANDLE || meshFragShader == VK_NULL_HANDLE)
+					return false;
+
+				pipelineSettings._shaderStages = { ShaderModuleCache::GetStageInfo(meshVertShader, VK_SHADER_STAGE_VERTEX_BIT),
+					ShaderModuleCache::GetStageInfo(meshFragShader, VK_SHADER_STAGE_FRAGMENT_BIT) };
+
+				{
+					SMOK_PROFILE_ASSET_ZONE("GraphicsPipeline::Create", ID, Profiling::AssetStage::None);
+					asset.Create(pipelineSettings, pipelineLayout, renderpass, GPU, cache);
+				}
+				assetIsCreated = true;
+				return assetIsCreated;
+			}
+
 			//creates shaders
 			Wireframe::Shader::ShaderModule meshVertShader;
-			if (!meshVertShader.Create(vertexSettings.binaryFilepath.c_str(), GPU)) {}
 			Wireframe::Shader::ShaderModule meshFragShader;
-			if (!meshFragShader.Create(fragmentSettings.binaryFilepath.c_str(), GPU)) {}
+			{
+				SMOK_PROFILE_ASSET_ZONE("ShaderModule::Create", ID, Profiling::AssetStage::None);
+				if (!meshVertShader.Create(vertexSettings.binaryFilepath.c_str(), GPU)) {}
+				if (!meshFragShader.Create(fragmentSettings.binaryFilepath.c_str(), GPU)) {}
+			}
 
 			pipelineSettings._shaderStages = { Wireframe::Shader::GenerateShaderStageInfoForPipeline(meshVertShader, Wireframe::Shader::Util::ShaderStage::Vertex),
 				Wireframe::Shader::GenerateShaderStageInfoForPipeline(meshFragShader, Wireframe::Shader::Util::ShaderStage::Fragment) };
 
 			//creates the pipeline
-			asset.Create(pipelineSettings, pipelineLayout, renderpass, GPU);
+			{
+				SMOK_PROFILE_ASSET_ZONE("GraphicsPipeline::Create", ID, Profiling::AssetStage::None);
+				asset.Create(pipelineSettings, pipelineLayout, renderpass, GPU, cache);
+			}
 
 			//cleans up shaders since we don't need them taking up VRAM anymore
 			meshFragShader.Destroy(GPU);
@@ -126,6 +188,12 @@ namespace Smok::Asset::AssetManager
 				return true;
 			}
 
+			SMOK_PROFILE_ASSET_ZONE("Asset_GraphicsPipeline::LoadPipelineSettingsAndShaders", ID, Profiling::AssetStage::None);
+
+			//Wireframe only parses settings files, so packed ones are extracted first
+			if (pack && !pack->ExtractGraphicsPipelineSettings(name, pipelineDataSettingFile, vertexShaderDataSettingFile, fragmentShaderDataSettingFile))
+				return false;
+
 			//loads the settings file
 			Wireframe::Pipeline::Serilize::LoadPipelineSettingsDataFromFile(pipelineDataSettingFile, pipelineSettings);
 
@@ -144,19 +212,42 @@ namespace Smok::Asset::AssetManager
 		BTD::IO::FileInfo declFile; //the decl file describing how to import the binary data
 		BTD::IO::FileInfo binaryFile; //the binary file actually storing all the tasty vertices and indices
 
+		//set when the mesh is read out of a asset pack instead of it's files, see "AssetManager::MountAssetPack"
+		const Pack::AssetPack* pack = nullptr;
+		const Pack::PackEntry* packEntry = nullptr;
+
 		Smok::Asset::Mesh::StaticMesh asset; //the asset
 
+		bool uploadIsPending = false; //is the mesh waiting on a batched upload, assetIsCreated is set once it's done
+
+		//residency, see "AssetManager::UpdateResidency"
+		uint32_t refCount = 0; //the number of users, only meshes nobody uses can be evicted
+		uint64_t cpuBytes = 0; //the vertex and index arrays counted against the CPU budget
+		uint64_t gpuBytes = 0; //the buffers counted against the GPU budget
+		bool wasEvicted = false; //were the mesh's buffers evicted, the next create counts as a reload
+		bool isReloading = false; //was the mesh asked for after being evicted
+		std::chrono::high_resolution_clock::time_point reloadStart; //when the reload was asked for
+		Asset_StaticMesh* LRUPrev = nullptr; //the unused meshes, least recently used first
+		Asset_StaticMesh* LRUNext = nullptr;
+		bool isInLRU = false;
+
 		//loads the mesh
 		inline bool LoadMesh()
 		{
-			if (assetIsCreated)
+			if (assetIsCreated || settingDataIsLoaded)
 				return true;
 
-			if (!Smok::Asset::Mesh::Serilize::LoadStaticMeshDataFromFile(declFile, binaryFile, asset))
+			if (packEntry)
+			{
+				if (!pack->LoadStaticMesh(*packEntry, asset))
+					return false;
+			}
+			else if (!Smok::Asset::Mesh::Serilize::LoadStaticMeshDataFromFile(declFile, binaryFile, asset))
 			{
 				return false;
 			}
 
+			settingDataIsLoaded = true;
 			return true;
 		}
 
@@ -175,5 +266,28 @@ namespace Smok::Asset::AssetManager
 
 			return true;
 		}
+
+		//queues the mesh in a batched upload, assetIsCreated is set from the uploader's "Update" once the GPU has the data
+		//with a geometry pool the mesh is put in it, if the pool is full the mesh gets it's own buffers
+		//onCreated runs right after assetIsCreated is set, so anything counting created meshes sees it when it's true
+		inline bool InitalizeMeshBatched(Smok::Rendering::MeshUploader& uploader, Smok::Rendering::GeometryPool* pool = nullptr,
+			const std::function<void()>& onCreated = std::function<void()>())
+		{
+			if (assetIsCreated || uploadIsPending)
+				return true;
+
+			auto onComplete = [this, onCreated]() {
+				uploadIsPending = false;
+				assetIsCreated = true;
+				if (onCreated)
+					onCreated();
+			};
+
+			if (pool)
+				uploadIsPending = uploader.UploadStaticMesh(asset, *pool, onComplete);
+			if (!uploadIsPending && !asset.UsesGeometryPool())
+				uploadIsPending = uploader.UploadStaticMesh(asset, onComplete);
+			return uploadIsPending;
+		}
 	};
 }
\ No newline at end of file
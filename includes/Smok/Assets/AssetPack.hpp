@@ -0,0 +1,801 @@
+#pragma once
+
+//defines the Smok asset pack, many assets bundled into one file
+//the file is a fixed header, aligned payloads and then a table of contents sorted by asset type and AssetID hash, followed by the asset names
+//the pack is memory mapped, finding a asset is a binary search of the table and uncompressed payloads are read straight out of the mapping
+//payloads can be compressed with LZ4 or zstd, define SMOK_ASSET_PACK_LZ4 or SMOK_ASSET_PACK_ZSTD and link the library to read or write them
+//graphics pipelines are packed as their settings files and SPIR-V, Wireframe only parses settings from files so those are extracted once into a temp folder
+
+#include <Smok/Assets/AssetID.hpp>
+#include <Smok/Assets/Mesh.hpp>
+#include <Smok/IO/MappedFile.hpp>
+#include <Smok/Profiling/Profiler.hpp>
+
+#include <BTDSTD/IO/FileInfo.hpp>
+#include <BTDSTD/Wireframe/Pipeline/GraphicsPipeline.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#ifdef SMOK_ASSET_PACK_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+
+#ifdef SMOK_ASSET_PACK_ZSTD
+#include <zstd.h>
+#endif
+
+namespace Smok::Asset::Pack
+{
+	//the magic at the start of every asset pack, reads "SPAK" in a hex editor
+	static constexpr uint32_t PACK_MAGIC = 0x4B415053;
+
+	//the version of the pack format
+	static constexpr uint32_t PACK_VERSION = 1;
+
+	//the default alignment of every payload, a cache line so smesh sections keep their alignment inside the pack
+	static constexpr uint64_t PACK_DEFAULT_ALIGNMENT = 64;
+
+	//gets the file extension for a asset pack
+	static inline std::string GetAssetPackFileExtensionStr() { return "spak"; }
+
+	//defines the types of assets a pack can hold
+	//new types go on the end so older packs stay valid
+	enum class PackEntryType : uint32_t
+	{
+		StaticMesh = 0, //a v2 smesh binary, the decl is not needed
+		PipelineSettings, //a graphics pipeline's settings file, named by the pipeline
+		ShaderSettings, //a shader's settings file, named by the pipeline with "/vertex" or "/fragment" on the end
+		ShaderBinary, //a SPIR-V binary, named by the binary path in it's shader settings so pipelines sharing a shader share the entry
+
+		Count
+	};
+
+	//defines how a payload is compressed
+	enum class PackCompression : uint32_t
+	{
+		None = 0,
+		LZ4,
+		Zstd,
+
+		Count
+	};
+
+	//defines the fixed header at the start of the pack
+	struct PackHeader
+	{
+		uint32_t magic = PACK_MAGIC;
+		uint32_t version = PACK_VERSION;
+		uint32_t headerSize = 0; //the size of this header, used to validate the file was written with the same layout
+		uint32_t entryCount = 0; //the number of entries in the table of contents
+
+		uint64_t payloadAlignment = PACK_DEFAULT_ALIGNMENT; //every payload's offset is a multiple of this
+		uint64_t fileSize = 0; //the total size of the file, used to detect truncated files
+
+		uint64_t TOCOffset = 0; //the offset of the table of contents, the names follow straight after it
+		uint64_t namesSize = 0; //the size of the names
+		uint64_t TOCHash = 0; //a hash of the table of contents and names, catches truncated or corrupt files
+		uint64_t reserved = 0;
+	};
+	static_assert(sizeof(PackHeader) == 64, "PackHeader is written to disk, it's size can not change");
+	static_assert(std::is_trivially_copyable_v<PackHeader>, "PackHeader must be trivially copyable");
+
+	//defines a entry in the table of contents
+	struct PackEntry
+	{
+		uint64_t assetHash = 0; //the AssetID hash of the name, the same key the asset manager names assets with
+		PackEntryType type = PackEntryType::StaticMesh;
+		PackCompression compression = PackCompression::None;
+
+		uint64_t offset = 0; //the offset of the payload from the start of the file
+		uint64_t storedSize = 0; //the size of the payload in the file
+		uint64_t size = 0; //the size once decompressed
+		uint64_t contentHash = 0; //a hash of the decompressed payload, see "AssetPack::VerifyEntry"
+
+		uint32_t nameOffset = 0; //the offset of the name into the names
+		uint32_t nameSize = 0;
+	};
+	static_assert(sizeof(PackEntry) == 56, "PackEntry is written to disk, it's size can not change");
+
+	//orders entries the way the table of contents is sorted
+	static inline bool PackEntryIsBefore(const PackEntry& entry, const PackEntryType& type, const uint64_t& assetHash)
+	{
+		return (entry.type != type ? entry.type < type : entry.assetHash < assetHash);
+	}
+
+	//aligns a offset up to a power of two alignment
+	static inline constexpr uint64_t AlignPackOffset(const uint64_t offset, const uint64_t alignment)
+	{
+		return (offset + (alignment - 1)) & ~(alignment - 1);
+	}
+
+	//gets the name of a entry type, used in errors and the packer's listing
+	static inline const char* GetPackEntryTypeStr(const PackEntryType& type)
+	{
+		switch (type)
+		{
+		case PackEntryType::StaticMesh:
+			return "static mesh";
+		case PackEntryType::PipelineSettings:
+			return "pipeline settings";
+		case PackEntryType::ShaderSettings:
+			return "shader settings";
+		case PackEntryType::ShaderBinary:
+			return "shader binary";
+		default:
+			return "unknown";
+		}
+	}
+
+	//gets the pack names of a pipeline's shader settings
+	static inline std::string GetPackVertexShaderName(const std::string_view& pipelineName) { return fmt::format("{}/vertex", pipelineName); }
+	static inline std::string GetPackFragmentShaderName(const std::string_view& pipelineName) { return fmt::format("{}/fragment", pipelineName); }
+
+	//gets the name of a compression, used in errors and the packer's listing
+	static inline const char* GetPackCompressionStr(const PackCompression& compression)
+	{
+		switch (compression)
+		{
+		case PackCompression::None:
+			return "none";
+		case PackCompression::LZ4:
+			return "lz4";
+		case PackCompression::Zstd:
+			return "zstd";
+		default:
+			return "unknown";
+		}
+	}
+
+	//is a compression compiled in
+	static inline bool PackCompressionIsSupported(const PackCompression& compression)
+	{
+		switch (compression)
+		{
+		case PackCompression::None:
+			return true;
+#ifdef SMOK_ASSET_PACK_LZ4
+		case PackCompression::LZ4:
+			return true;
+#endif
+#ifdef SMOK_ASSET_PACK_ZSTD
+		case PackCompression::Zstd:
+			return true;
+#endif
+		default:
+			return false;
+		}
+	}
+
+	//compresses a payload, level 0 uses the codec's default
+	//returns false if the compression is not compiled in or fails, the caller then stores the payload as is
+	static inline bool CompressPayload(const PackCompression& compression, [[maybe_unused]] const int& level, [[maybe_unused]] const uint8_t* data,
+		[[maybe_unused]] const size_t& size, [[maybe_unused]] std::vector<uint8_t>& out)
+	{
+		switch (compression)
+		{
+#ifdef SMOK_ASSET_PACK_LZ4
+		case PackCompression::LZ4:
+		{
+			if (size > (size_t)LZ4_MAX_INPUT_SIZE)
+				return false;
+
+			out.resize((size_t)LZ4_compressBound((int)size));
+			const int written = (level > 0 ? LZ4_compress_HC((const char*)data, (char*)out.data(), (int)size, (int)out.size(), level) :
+				LZ4_compress_default((const char*)data, (char*)out.data(), (int)size, (int)out.size()));
+			out.resize(written > 0 ? (size_t)written : 0);
+			return written > 0;
+		}
+#endif
+#ifdef SMOK_ASSET_PACK_ZSTD
+		case PackCompression::Zstd:
+		{
+			out.resize(ZSTD_compressBound(size));
+			const size_t written = ZSTD_compress(out.data(), out.size(), data, size, (level != 0 ? level : ZSTD_CLEVEL_DEFAULT));
+			if (ZSTD_isError(written))
+			{
+				out.clear();
+				return false;
+			}
+			out.resize(written);
+			return true;
+		}
+#endif
+		default:
+			return false;
+		}
+	}
+
+	//decompresses a payload into out, out must be the entry's decompressed size
+	static inline bool DecompressPayload(const PackCompression& compression, const uint8_t* data, const size_t& storedSize, uint8_t* out, const size_t& size)
+	{
+		switch (compression)
+		{
+		case PackCompression::None:
+			if (storedSize != size)
+				return false;
+			if (size > 0)
+				std::memcpy(out, data, size);
+			return true;
+#ifdef SMOK_ASSET_PACK_LZ4
+		case PackCompression::LZ4:
+			return (size <= (size_t)LZ4_MAX_INPUT_SIZE && storedSize <= (size_t)INT32_MAX &&
+				LZ4_decompress_safe((const char*)data, (char*)out, (int)storedSize, (int)size) == (int)size);
+#endif
+#ifdef SMOK_ASSET_PACK_ZSTD
+		case PackCompression::Zstd:
+		{
+			const size_t written = ZSTD_decompress(out, size, data, storedSize);
+			return (!ZSTD_isError(written) && written == size);
+		}
+#endif
+		default:
+			return false;
+		}
+	}
+
+	//defines a asset pack opened for reading
+	//every function is const once it's open, so worker threads can read from it at the same time
+	struct AssetPack
+	{
+		IO::MappedFile file; //the mapped pack
+		std::string filepath; //the path the pack was opened from, used in errors
+
+		const PackHeader* header = nullptr;
+		const PackEntry* entries = nullptr; //the table of contents, sorted by type then asset hash
+		const char* names = nullptr; //the names of every entry, not null terminated
+
+		AssetPack() = default;
+		AssetPack(const AssetPack&) = delete;
+		AssetPack& operator=(const AssetPack&) = delete;
+
+		//is the pack open
+		inline bool IsOpen() const { return header != nullptr; }
+
+		//gets the number of entries
+		inline size_t GetEntryCount() const { return (header ? (size_t)header->entryCount : 0); }
+
+		//gets a entry by it's place in the table of contents
+		inline const PackEntry& GetEntry(const size_t& index) const { return entries[index]; }
+
+		//gets the name of a entry
+		inline std::string_view GetName(const PackEntry& entry) const { return std::string_view(names + entry.nameOffset, entry.nameSize); }
+
+		//gets the payload of a entry as stored in the pack, it's still compressed if the entry is
+		inline const uint8_t* GetStoredData(const PackEntry& entry) const { return file.data + entry.offset; }
+
+		//maps a pack and validates it's header and table of contents
+		inline bool Open(const BTD::IO::FileInfo& packFile)
+		{
+			SMOK_PROFILE_ZONE("AssetPack::Open");
+
+			Close();
+			filepath = packFile.GetPathStr();
+			if (!file.Open(packFile))
+				return false;
+
+			//checks the header
+			if (file.size < sizeof(PackHeader))
+			{
+				fmt::print("Smok Asset Pack Error: AssetPack || Open || \"{}\" is too small to be a asset pack.\n", filepath);
+				Close();
+				return false;
+			}
+
+			const PackHeader* fileHeader = (const PackHeader*)file.data;
+			if (fileHeader->magic != PACK_MAGIC || fileHeader->version != PACK_VERSION || fileHeader->headerSize != sizeof(PackHeader))
+			{
+				fmt::print("Smok Asset Pack Error: AssetPack || Open || \"{}\" does not have a valid v{} asset pack header. The \"AssetPackWriter\" or SmokPack tool can be used to make one.\n",
+					filepath, PACK_VERSION);
+				Close();
+				return false;
+			}
+
+			const uint64_t TOCSize = (uint64_t)fileHeader->entryCount * sizeof(PackEntry);
+			if (fileHeader->fileSize != file.size || fileHeader->payloadAlignment < 16 || (fileHeader->payloadAlignment & (fileHeader->payloadAlignment - 1)) != 0 ||
+				fileHeader->TOCOffset < sizeof(PackHeader) || fileHeader->TOCOffset % alignof(PackEntry) != 0 || fileHeader->TOCOffset > file.size ||
+				TOCSize > file.size - fileHeader->TOCOffset || fileHeader->namesSize != file.size - fileHeader->TOCOffset - TOCSize)
+			{
+				fmt::print("Smok Asset Pack Error: AssetPack || Open || \"{}\" is truncated or it's table of contents is out of bounds. Expected {} bytes, got {} bytes.\n",
+					filepath, fileHeader->fileSize, file.size);
+				Close();
+				return false;
+			}
+
+			if (fileHeader->TOCHash != HashAssetName(std::string_view((const char*)file.data + fileHeader->TOCOffset, (size_t)(TOCSize + fileHeader->namesSize))))
+			{
+				fmt::print("Smok Asset Pack Error: AssetPack || Open || \"{}\" has a corrupt table of contents.\n", filepath);
+				Close();
+				return false;
+			}
+
+			//checks every entry, so reads never have to
+			const PackEntry* fileEntries = (const PackEntry*)(file.data + fileHeader->TOCOffset);
+			for (uint32_t e = 0; e < fileHeader->entryCount; ++e)
+			{
+				const PackEntry& entry = fileEntries[e];
+				const bool isSorted = (e == 0 || PackEntryIsBefore(fileEntries[e - 1], entry.type, entry.assetHash));
+				if (!isSorted || entry.type >= PackEntryType::Count || entry.compression >= PackCompression::Count ||
+					entry.offset % fileHeader->payloadAlignment != 0 || entry.offset < sizeof(PackHeader) || entry.offset > fileHeader->TOCOffset || entry.storedSize > fileHeader->TOCOffset - entry.offset ||
+					(entry.compression == PackCompression::None && entry.storedSize != entry.size) ||
+					entry.nameOffset > fileHeader->namesSize || entry.nameSize > fileHeader->namesSize - entry.nameOffset)
+				{
+					fmt::print("Smok Asset Pack Error: AssetPack || Open || \"{}\" entry {} is out of bounds, out of order or has a unknown type or compression.\n", filepath, e);
+					Close();
+					return false;
+				}
+			}
+
+			header = fileHeader;
+			entries = fileEntries;
+			names = (const char*)file.data + fileHeader->TOCOffset + TOCSize;
+			return true;
+		}
+
+		//closes the pack, every entry and payload pointer is invalid after this
+		inline void Close()
+		{
+			header = nullptr;
+			entries = nullptr;
+			names = nullptr;
+			file.Close();
+		}
+
+		//finds a entry, nullptr if the pack does not have it
+		inline const PackEntry* Find(const PackEntryType& type, const AssetID& name) const
+		{
+			const PackEntry* end = entries + GetEntryCount();
+			const PackEntry* entry = std::lower_bound(entries, end, name.hash, [&](const PackEntry& e, const uint64_t& hash) { return PackEntryIsBefore(e, type, hash); });
+			return (entry != end && entry->type == type && entry->assetHash == name.hash ? entry : nullptr);
+		}
+
+		//decompresses a entry into out, uncompressed entries are copied
+		//out is sized to the entry, it's allocation is aligned to at least 16 bytes so smesh payloads can be parsed in place
+		inline bool ReadEntry(const PackEntry& entry, std::vector<uint8_t>& out) const
+		{
+			SMOK_PROFILE_ZONE("AssetPack::ReadEntry");
+
+			if (!PackCompressionIsSupported(entry.compression))
+			{
+				fmt::print("Smok Asset Pack Error: AssetPack || ReadEntry || \"{}\" in \"{}\" is compressed with {}, which this build of Smok was not compiled with.\n",
+					GetName(entry), filepath, GetPackCompressionStr(entry.compression));
+				return false;
+			}
+
+			out.resize((size_t)entry.size);
+			if (!DecompressPayload(entry.compression, GetStoredData(entry), (size_t)entry.storedSize, out.data(), out.size()))
+			{
+				fmt::print("Smok Asset Pack Error: AssetPack || ReadEntry || Failed to decompress \"{}\" in \"{}\".\n", GetName(entry), filepath);
+				out.clear();
+				return false;
+			}
+
+			return true;
+		}
+
+		//checks a entry's payload against the hash written when it was packed, this reads the whole payload so it's for tools and debugging
+		inline bool VerifyEntry(const PackEntry& entry) const
+		{
+			if (entry.compression == PackCompression::None)
+				return entry.contentHash == HashAssetName(std::string_view((const char*)GetStoredData(entry), (size_t)entry.size));
+
+			std::vector<uint8_t> data;
+			return (ReadEntry(entry, data) && entry.contentHash == HashAssetName(std::string_view((const char*)data.data(), data.size())));
+		}
+
+		//loads a static mesh out of the pack, uncompressed entries are parsed straight out of the mapping
+		inline bool LoadStaticMesh(const PackEntry& entry, Smok::Asset::Mesh::StaticMesh& data) const
+		{
+			SMOK_PROFILE_ZONE("AssetPack::LoadStaticMesh");
+
+			if (entry.type != PackEntryType::StaticMesh)
+			{
+				fmt::print("Smok Asset Pack Error: AssetPack || LoadStaticMesh || \"{}\" in \"{}\" is not a static mesh.\n", GetName(entry), filepath);
+				return false;
+			}
+
+			const std::string label = fmt::format("{}:{}", filepath, GetName(entry));
+			if (entry.compression == PackCompression::None)
+				return Smok::Asset::Mesh::Serilize::LoadStaticMeshDataFromMemory(std::string_view(), GetStoredData(entry), (size_t)entry.size, label, data);
+
+			std::vector<uint8_t> payload;
+			return (ReadEntry(entry, payload) &&
+				Smok::Asset::Mesh::Serilize::LoadStaticMeshDataFromMemory(std::string_view(), payload.data(), payload.size(), label, data));
+		}
+
+		//gets the folder settings entries are extracted to, it's named by the table of contents hash so a changed pack never reads a older pack's files
+		inline std::filesystem::path GetExtractFolder() const
+		{
+			std::error_code error;
+			std::filesystem::path folder = std::filesystem::temp_directory_path(error);
+			if (error)
+				folder = std::filesystem::current_path(error);
+			return folder / "SmokPacks" / fmt::format("{:016x}", (header ? header->TOCHash : 0));
+		}
+
+		//extracts a entry to a file in the extract folder, a file already extracted is reused
+		//the file is written next to it's final path and moved into place, so threads extracting the same entry never see half a file
+		inline bool ExtractEntry(const PackEntry& entry, BTD::IO::FileInfo& extractedFile) const
+		{
+			SMOK_PROFILE_ZONE("AssetPack::ExtractEntry");
+
+			const std::filesystem::path folder = GetExtractFolder();
+			const std::filesystem::path path = folder / fmt::format("{:016x}_{}", entry.assetHash, (uint32_t)entry.type);
+			extractedFile = BTD::IO::FileInfo(path.string());
+
+			std::error_code error;
+			if (std::filesystem::exists(path, error) && std::filesystem::file_size(path, error) == entry.size && !error)
+				return true;
+
+			std::vector<uint8_t> data;
+			if (!ReadEntry(entry, data))
+				return false;
+
+			std::filesystem::create_directories(folder, error);
+			const std::filesystem::path tempPath = path.string() + fmt::format(".{}.tmp", std::hash<std::thread::id>()(std::this_thread::get_id()));
+			{
+				std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+				file.write((const char*)data.data(), (std::streamsize)data.size());
+				if (!file.good())
+				{
+					fmt::print("Smok Asset Pack Error: AssetPack || ExtractEntry || Failed to extract \"{}\" from \"{}\" to \"{}\".\n", GetName(entry), filepath, tempPath.string());
+					file.close();
+					std::filesystem::remove(tempPath, error);
+					return false;
+				}
+			}
+
+			std::filesystem::rename(tempPath, path, error);
+			if (error)
+			{
+				fmt::print("Smok Asset Pack Error: AssetPack || ExtractEntry || Failed to move \"{}\" to \"{}\", {}.\n", tempPath.string(), path.string(), error.message());
+				std::filesystem::remove(tempPath, error);
+				return false;
+			}
+
+			return true;
+		}
+
+		//extracts a graphics pipeline's settings files, so Wireframe can parse them
+		inline bool ExtractGraphicsPipelineSettings(const std::string& name, BTD::IO::FileInfo& pipelineFile, BTD::IO::FileInfo& vertexShaderFile, BTD::IO::FileInfo& fragmentShaderFile) const
+		{
+			const PackEntry* pipeline = Find(PackEntryType::PipelineSettings, AssetID(name));
+			const PackEntry* vertex = Find(PackEntryType::ShaderSettings, AssetID(GetPackVertexShaderName(name)));
+			const PackEntry* fragment = Find(PackEntryType::ShaderSettings, AssetID(GetPackFragmentShaderName(name)));
+			if (!pipeline || !vertex || !fragment)
+			{
+				fmt::print("Smok Asset Pack Error: AssetPack || ExtractGraphicsPipelineSettings || \"{}\" does not have the pipeline and shader settings for \"{}\".\n", filepath, name);
+				return false;
+			}
+
+			return (ExtractEntry(*pipeline, pipelineFile) && ExtractEntry(*vertex, vertexShaderFile) && ExtractEntry(*fragment, fragmentShaderFile));
+		}
+
+		//finds the SPIR-V for a shader binary path, nullptr if the pack does not have it
+		inline const PackEntry* FindShaderBinary(const std::string& binaryFilepath) const
+		{
+			const PackEntry* entry = Find(PackEntryType::ShaderBinary, AssetID(binaryFilepath));
+			return (entry && GetName(*entry) == binaryFilepath ? entry : nullptr);
+		}
+	};
+
+	//defines the results of writing a pack
+	struct PackWriteStats
+	{
+		size_t entries = 0;
+		size_t compressedEntries = 0; //entries that got smaller when compressed, the rest are stored as is
+		uint64_t bytesIn = 0; //the decompressed size of every payload
+		uint64_t bytesStored = 0; //the size of every payload in the pack
+	};
+
+	//defines a writer making a asset pack
+	//payloads are streamed to disk as they're added, only the table of contents is kept in memory
+	//the pack is written to a temp file and moved over the path in "Finish", so a failed pack never replaces a good one
+	struct AssetPackWriter
+	{
+		uint64_t payloadAlignment = PACK_DEFAULT_ALIGNMENT; //a power of two, at least 16
+		PackCompression compression = PackCompression::None; //the compression tried on every payload
+		int compressionLevel = 0; //0 uses the codec's default, for LZ4 anything above 0 uses LZ4 HC
+
+		PackWriteStats stats;
+
+		std::ofstream file;
+		std::string filepath; //the pack being written
+		std::string tempFilepath; //where it's written until it's finished
+		uint64_t offset = 0; //the end of the last payload
+		std::vector<PackEntry> entries;
+		std::string names;
+		std::unordered_map<uint64_t, size_t> entriesByHash[(size_t)PackEntryType::Count]; //catches names added twice or that hash the same
+
+		AssetPackWriter() = default;
+		AssetPackWriter(const AssetPackWriter&) = delete;
+		AssetPackWriter& operator=(const AssetPackWriter&) = delete;
+		~AssetPackWriter() { Abort(); }
+
+		//is a pack being written
+		inline bool IsOpen() const { return file.is_open(); }
+
+		//starts writing a pack
+		inline bool Begin(const BTD::IO::FileInfo& packFile)
+		{
+			Abort();
+			if (payloadAlignment < 16 || (payloadAlignment & (payloadAlignment - 1)) != 0)
+			{
+				fmt::print("Smok Asset Pack Error: AssetPackWriter || Begin || The payload alignment {} is not a power of two of at least 16.\n", payloadAlignment);
+				return false;
+			}
+
+			if (!PackCompressionIsSupported(compression))
+			{
+				fmt::print("Smok Asset Pack Warning: AssetPackWriter || Begin || This build of Smok was not compiled with {} compression, payloads will be stored as is.\n",
+					GetPackCompressionStr(compression));
+				compression = PackCompression::None;
+			}
+
+			filepath = packFile.GetPathStr();
+			tempFilepath = filepath + ".tmp";
+			file.open(tempFilepath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				fmt::print("Smok Asset Pack Error: AssetPackWriter || Begin || Failed to open \"{}\" for writing.\n", tempFilepath);
+				return false;
+			}
+
+			//the header is written for real once the table of contents is known
+			const PackHeader header;
+			file.write((const char*)&header, sizeof(header));
+			offset = sizeof(header);
+			stats = PackWriteStats();
+			return file.good();
+		}
+
+		//adds a payload to the pack
+		inline bool AddEntry(const PackEntryType& type, const std::string& name, const uint8_t* data, const size_t& size)
+		{
+			if (!IsOpen())
+			{
+				fmt::print("Smok Asset Pack Error: AssetPackWriter || AddEntry || No pack is being written, call \"Begin\" first.\n");
+				return false;
+			}
+
+			const AssetID ID(name);
+			auto existing = entriesByHash[(size_t)type].find(ID.hash);
+			if (existing != entriesByHash[(size_t)type].end())
+			{
+				const PackEntry& other = entries[existing->second];
+				const std::string_view otherName(names.data() + other.nameOffset, other.nameSize);
+				if (otherName == name)
+					fmt::print("Smok Asset Pack Error: AssetPackWriter || AddEntry || \"{}\" was already added to \"{}\".\n", name, filepath);
+				else
+					fmt::print("Smok Asset Pack Error: AssetPackWriter || AddEntry || \"{}\" has the same hash as \"{}\", rename one of them.\n", name, otherName);
+				return false;
+			}
+
+			PackEntry entry;
+			entry.assetHash = ID.hash;
+			entry.type = type;
+			entry.size = size;
+			entry.contentHash = HashAssetName(std::string_view((const char*)data, size));
+			entry.nameOffset = (uint32_t)names.size();
+			entry.nameSize = (uint32_t)name.size();
+
+			//keeps the payload as is unless compressing saves space
+			std::vector<uint8_t> compressed;
+			const uint8_t* stored = data;
+			entry.storedSize = size;
+			if (compression != PackCompression::None && CompressPayload(compression, compressionLevel, data, size, compressed) && compressed.size() < size)
+			{
+				entry.compression = compression;
+				entry.storedSize = compressed.size();
+				stored = compressed.data();
+				stats.compressedEntries++;
+			}
+
+			//pads up to the payload
+			static const char zeros[256] = {};
+			for (uint64_t padding = AlignPackOffset(offset, payloadAlignment) - offset; padding > 0;)
+			{
+				const uint64_t chunk = std::min<uint64_t>(padding, sizeof(zeros));
+				file.write(zeros, (std::streamsize)chunk);
+				padding -= chunk;
+			}
+			entry.offset = AlignPackOffset(offset, payloadAlignment);
+			file.write((const char*)stored, (std::streamsize)entry.storedSize);
+			offset = entry.offset + entry.storedSize;
+			if (!file.good())
+			{
+				fmt::print("Smok Asset Pack Error: AssetPackWriter || AddEntry || Failed to write \"{}\" to \"{}\".\n", name, tempFilepath);
+				return false;
+			}
+
+			entriesByHash[(size_t)type][ID.hash] = entries.size();
+			entries.emplace_back(entry);
+			names += name;
+			stats.entries++;
+			stats.bytesIn += size;
+			stats.bytesStored += entry.storedSize;
+			return true;
+		}
+
+		//adds a static mesh, it's written as a v2 smesh binary in the given vertex layout and MeshEncoding
+		inline bool AddStaticMesh(const std::string& name, const Smok::Asset::Mesh::StaticMesh& mesh,
+			const Smok::Asset::Mesh::VertexLayout& vertexLayout = Smok::Asset::Mesh::VertexLayout::Float, const uint32_t& encoding = Smok::Asset::Mesh::MeshEncoding_None)
+		{
+			std::ostringstream binary(std::ios::binary);
+			std::vector<Smok::Asset::Mesh::Bounds> bounds;
+			if (!Smok::Asset::Mesh::Serilize::WriteStaticMeshBinary(binary, mesh, vertexLayout, bounds, encoding))
+			{
+				fmt::print("Smok Asset Pack Error: AssetPackWriter || AddStaticMesh || Failed to write \"{}\" as a smesh binary.\n", name);
+				return false;
+			}
+
+			const std::string data = binary.str();
+			return AddEntry(PackEntryType::StaticMesh, name, (const uint8_t*)data.data(), data.size());
+		}
+
+		//adds a static mesh from it's files, v2 binaries are copied as is and v1 ones are loaded and written as v2
+		inline bool AddStaticMeshFiles(const std::string& name, const BTD::IO::FileInfo& declFile, const BTD::IO::FileInfo& binaryFile)
+		{
+			if (Smok::Asset::Mesh::Serilize::BinaryFileIsV2(binaryFile))
+			{
+				IO::MappedFile binary;
+				if (!binary.Open(binaryFile))
+					return false;
+
+				//checked here so a bad file fails the pack instead of every load of it
+				Smok::Asset::Mesh::Serilize::MappedStaticMesh view;
+				if (!Smok::Asset::Mesh::Serilize::ParseStaticMeshBinary(binary.data, binary.size, binaryFile.GetPathStr(), view))
+					return false;
+
+				return AddEntry(PackEntryType::StaticMesh, name, binary.data, binary.size);
+			}
+
+			Smok::Asset::Mesh::StaticMesh mesh;
+			if (!Smok::Asset::Mesh::Serilize::LoadStaticMeshDataFromFile(declFile, binaryFile, mesh))
+				return false;
+			return AddStaticMesh(name, mesh);
+		}
+
+		//adds a file as is
+		inline bool AddFile(const PackEntryType& type, const std::string& name, const BTD::IO::FileInfo& fileToAdd)
+		{
+			IO::MappedFile data;
+			if (!data.Open(fileToAdd))
+				return false;
+			return AddEntry(type, name, data.data, data.size);
+		}
+
+		//adds a shader's settings file and it's SPIR-V, the SPIR-V is only added once however many pipelines use it
+		inline bool AddShaderFiles(const std::string& name, const BTD::IO::FileInfo& shaderFile)
+		{
+			Wireframe::Shader::Serilize::ShaderSerilizeData shader;
+			Wireframe::Shader::Serilize::LoadShaderDataFromFile(shaderFile, shader, false);
+			if (shader.binaryFilepath.empty())
+			{
+				fmt::print("Smok Asset Pack Error: AssetPackWriter || AddShaderFiles || \"{}\" does not name a shader binary.\n", shaderFile.GetPathStr());
+				return false;
+			}
+
+			if (!AddFile(PackEntryType::ShaderSettings, name, shaderFile))
+				return false;
+
+			auto existing = entriesByHash[(size_t)PackEntryType::ShaderBinary].find(AssetID(shader.binaryFilepath).hash);
+			if (existing != entriesByHash[(size_t)PackEntryType::ShaderBinary].end())
+			{
+				const PackEntry& other = entries[existing->second];
+				if (std::string_view(names.data() + other.nameOffset, other.nameSize) == shader.binaryFilepath)
+					return true;
+			}
+
+			//checked here so a bad binary fails the pack instead of every pipeline create
+			IO::MappedFile binary;
+			if (!binary.Open(BTD::IO::FileInfo(shader.binaryFilepath)))
+				return false;
+			if (binary.size == 0 || binary.size % sizeof(uint32_t) != 0)
+			{
+				fmt::print("Smok Asset Pack Error: AssetPackWriter || AddShaderFiles || \"{}\" is not a SPIR-V binary, it's size is not a multiple of 4.\n", shader.binaryFilepath);
+				return false;
+			}
+
+			return AddEntry(PackEntryType::ShaderBinary, shader.binaryFilepath, binary.data, binary.size);
+		}
+
+		//adds a graphics pipeline from it's settings files, the shaders' SPIR-V is packed too
+		inline bool AddGraphicsPipelineFiles(const std::string& name, const BTD::IO::FileInfo& pipelineFile, const BTD::IO::FileInfo& vertexShaderFile, const BTD::IO::FileInfo& fragmentShaderFile)
+		{
+			return (AddFile(PackEntryType::PipelineSettings, name, pipelineFile) &&
+				AddShaderFiles(GetPackVertexShaderName(name), vertexShaderFile) &&
+				AddShaderFiles(GetPackFragmentShaderName(name), fragmentShaderFile));
+		}
+
+		//writes the table of contents and moves the pack into place
+		inline bool Finish()
+		{
+			if (!IsOpen())
+			{
+				fmt::print("Smok Asset Pack Error: AssetPackWriter || Finish || No pack is being written, call \"Begin\" first.\n");
+				return false;
+			}
+
+			std::sort(entries.begin(), entries.end(), [](const PackEntry& a, const PackEntry& b) { return PackEntryIsBefore(a, b.type, b.assetHash); });
+
+			PackHeader header;
+			header.headerSize = sizeof(PackHeader);
+			header.entryCount = (uint32_t)entries.size();
+			header.payloadAlignment = payloadAlignment;
+			header.TOCOffset = AlignPackOffset(offset, alignof(PackEntry));
+			header.namesSize = names.size();
+			header.fileSize = header.TOCOffset + entries.size() * sizeof(PackEntry) + names.size();
+
+			std::string TOC(sizeof(PackEntry) * entries.size(), '\0');
+			if (!entries.empty())
+				std::memcpy(TOC.data(), entries.data(), TOC.size());
+			TOC += names;
+			header.TOCHash = HashAssetName(TOC);
+
+			static const char zeros[alignof(PackEntry)] = {};
+			file.write(zeros, (std::streamsize)(header.TOCOffset - offset));
+			file.write(TOC.data(), (std::streamsize)TOC.size());
+			file.seekp(0);
+			file.write((const char*)&header, sizeof(header));
+			file.close();
+			if (file.fail())
+			{
+				fmt::print("Smok Asset Pack Error: AssetPackWriter || Finish || Failed to write the table of contents to \"{}\".\n", tempFilepath);
+				Abort();
+				return false;
+			}
+
+			std::error_code error;
+			std::filesystem::rename(tempFilepath, filepath, error);
+			if (error)
+			{
+				fmt::print("Smok Asset Pack Error: AssetPackWriter || Finish || Failed to move \"{}\" to \"{}\", {}.\n", tempFilepath, filepath, error.message());
+				Abort();
+				return false;
+			}
+
+			Reset();
+			return true;
+		}
+
+		//stops writing and deletes the unfinished pack
+		inline void Abort()
+		{
+			if (file.is_open())
+				file.close();
+			if (!tempFilepath.empty())
+			{
+				std::error_code error;
+				std::filesystem::remove(tempFilepath, error);
+			}
+			Reset();
+		}
+
+		//---internal
+
+		//clears the state of the pack being written, the stats are kept
+		inline void Reset()
+		{
+			filepath.clear();
+			tempFilepath.clear();
+			offset = 0;
+			entries.clear();
+			names.clear();
+			for (auto& map : entriesByHash)
+				map.clear();
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+//defines the residency tracking used by the asset manager to keep static meshes inside a memory budget
+//meshes are reference counted by their users, once nothing uses a mesh it goes on a least recently used list
+//when a budget is passed the meshes at the front of the list lose their GPU buffers or CPU arrays, and are reloaded the next time they're used
+
+#include <Smok/Assets/AssetManagerAssets.hpp>
+
+namespace Smok::Asset::AssetManager
+{
+	//defines the memory budgets, 0 means no limit
+	struct ResidencyBudget
+	{
+		uint64_t CPUBytes = 0; //vertex and index arrays
+		uint64_t GPUBytes = 0; //vertex and index buffers
+	};
+
+	//defines the residency stats
+	struct ResidencyStats
+	{
+		uint64_t CPUBytesResident = 0;
+		uint64_t GPUBytesResident = 0;
+
+		uint64_t hits = 0; //uses of a mesh that was ready
+		uint64_t misses = 0; //uses of a mesh that was not, a reload is queued if it was evicted
+		uint64_t CPUEvictions = 0;
+		uint64_t GPUEvictions = 0;
+
+		uint64_t reloads = 0; //evicted meshes made resident again
+		double reloadMilliseconds = 0.0; //the total time from asking for a evicted mesh to it being created
+		double maxReloadMilliseconds = 0.0;
+
+		//gets the average reload time
+		inline double GetAverageReloadMilliseconds() const { return (reloads > 0 ? reloadMilliseconds / (double)reloads : 0.0); }
+	};
+
+	//defines the least recently used list of static meshes, it's intrusive so adding, removing and touching are O(1)
+	struct StaticMeshLRU
+	{
+		Asset_StaticMesh* head = nullptr; //the least recently used
+		Asset_StaticMesh* tail = nullptr; //the most recently used
+		size_t count = 0;
+
+		//adds a mesh as the most recently used
+		inline void PushBack(Asset_StaticMesh* mesh)
+		{
+			if (mesh->isInLRU)
+				return;
+
+			mesh->LRUPrev = tail;
+			mesh->LRUNext = nullptr;
+			if (tail)
+				tail->LRUNext = mesh;
+			else
+				head = mesh;
+			tail = mesh;
+			mesh->isInLRU = true;
+			count++;
+		}
+
+		//takes a mesh off the list
+		inline void Remove(Asset_StaticMesh* mesh)
+		{
+			if (!mesh->isInLRU)
+				return;
+
+			if (mesh->LRUPrev)
+				mesh->LRUPrev->LRUNext = mesh->LRUNext;
+			else
+				head = mesh->LRUNext;
+			if (mesh->LRUNext)
+				mesh->LRUNext->LRUPrev = mesh->LRUPrev;
+			else
+				tail = mesh->LRUPrev;
+
+			mesh->LRUPrev = nullptr;
+			mesh->LRUNext = nullptr;
+			mesh->isInLRU = false;
+			count--;
+		}
+
+		//moves a mesh on the list to the most recently used end
+		inline void Touch(Asset_StaticMesh* mesh)
+		{
+			if (!mesh->isInLRU || mesh == tail)
+				return;
+			Remove(mesh);
+			PushBack(mesh);
+		}
+
+		//empties the list
+		inline void Clear()
+		{
+			while (head)
+				Remove(head);
+		}
+	};
+}
\ No newline at end of file
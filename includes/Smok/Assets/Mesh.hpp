@@ -10,9 +10,24 @@
 #include <BTDSTD/IO/FileInfo.hpp>
 #include <BTDSTD/IO/File.hpp>
 
+#include <Smok/Assets/SmeshBinary.hpp>
+#include <Smok/Assets/MeshBounds.hpp>
+#include <Smok/Assets/MeshCodec.hpp>
+#include <Smok/Assets/Meshlet.hpp>
+#include <Smok/Assets/VertexFormats.hpp>
+#include <Smok/IO/MappedFile.hpp>
+#include <Smok/Memory/GPUBuffer.hpp>
+#include <Smok/Memory/OffsetAllocator.hpp>
+#include <Smok/Profiling/Profiler.hpp>
+
 #include <glm/vec3.hpp>
 #include <glm/vec2.hpp>
 
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <string_view>
+
 namespace Smok::Asset::Mesh
 {
 	//defines a vertex
@@ -25,12 +40,12 @@ namespace Smok::Asset::Mesh
 
 		bool operator==(const Vertex& other)
 		{
-			return (position == other.position && normal == other.normal && color == other.color);
+			return (position == other.position && normal == other.normal && color == other.color && textureCoords == other.textureCoords);
 		}
 
 		bool operator==(const Vertex& other) const
 		{
-			return (position == other.position && normal == other.normal && color == other.color);
+			return (position == other.position && normal == other.normal && color == other.color && textureCoords == other.textureCoords);
 		}
 
 		//generates the vertex input description
@@ -82,7 +97,16 @@ namespace Smok::Asset::Mesh
 		}
 	};
 
+	static_assert(sizeof(Vertex) == 44, "GetVertexLayoutStride expects the float Vertex to be 44 bytes");
+
+	//generates the vertex input description for any vertex layout
+	static inline Wireframe::Pipeline::VertexInputDescription GenerateVertexInputDescription(const VertexLayout& layout)
+	{
+		return (layout == VertexLayout::Float ? Vertex::GenerateVertexInputDescription() : GenerateVertexInputDescription_Packed(layout));
+	}
+
 	//checks if a vertex already exists in the list
+	//this is a linear search, use WeldStaticMesh or WeldTriangleSoup in "Smok/Assets/VertexWeld.hpp" when deduplicating whole meshes
 	static inline bool VertexIsAlreadyInArray(const Vertex* verticesAlreadySorted, const size_t& verticesCount, const Vertex& vertex, size_t& arrayIndex)
 	{
 		for (size_t i = 0; i < verticesCount; ++i)
@@ -102,15 +126,26 @@ namespace Smok::Asset::Mesh
 	{
 		bool canRender = true; //is the mesh enabled for rendering
 		uint32_t LODIndex = 0; //the LOD level of this mesh
+		uint32_t LODSourceIndex = UINT32_MAX; //the sub-mesh this is a simplified version of, UINT32_MAX if it's not a generated LOD
+		float LODError = 0.0f; //the geometric error of this LOD in mesh units, 0 for a source mesh
 
 		std::vector<uint32_t> indices; //the indices
+		Bounds bounds; //the bounds of the vertices this mesh uses
+
+		//the meshlets this mesh is split into, empty unless they were built, see "BuildStaticMeshMeshlets"
+		std::vector<Meshlet> meshlets;
+		std::vector<uint32_t> meshletVertices; //every meshlet's vertices, indices into the static mesh's vertices
+		std::vector<uint8_t> meshletTriangles; //every meshlet's triangles, 3 indices into the meshlet's vertices each
 		
 		Wireframe::MeshBuffers::IndexBuffer indexBuffer; //the allocated index buffer
+		uint32_t firstIndex = 0; //where this mesh's indices start in the packed or geometry pool index buffer, only used with batched uploads
+		uint32_t indexCount = 0; //the number of indices uploaded, kept if the CPU copy is deleted
 
 		//creates a mesh
 		inline bool CreateIndexBuffers(VmaAllocator& allocator)
 		{
 			indexBuffer.Create(allocator, indices.data(), indices.size());
+			indexCount = (uint32_t)indices.size();
 
 			canRender = true;
 			return true;
@@ -135,12 +170,38 @@ namespace Smok::Asset::Mesh
 
 		std::vector<Vertex> vertices; //the total vertices making up all submeshes
 
+		VertexLayout vertexLayout = VertexLayout::Float; //the layout of the vertex data, anything but Float lives in packedVertices
+		std::vector<uint8_t> packedVertices; //the vertices in a packed layout
+		VertexQuantization quantization; //the ranges used to rebuild quantized attributes
+
 		std::vector<Mesh> meshes; //the individual meshes storing the indices
+		Bounds bounds; //the bounds of every vertex
+
+		//batched uploads put the vertices and every sub-mesh's indices into one device local buffer each, see "Smok::Rendering::MeshUploader"
+		//when these are created they replace vertexBuffer and the per mesh indexBuffer, draw sub-meshes with their firstIndex
+		Memory::GPUBuffer packedVertexBuffer;
+		Memory::GPUBuffer packedIndexBuffer;
+
+		//the ranges held in the shared geometry pool, see "Smok::Rendering::GeometryPool"
+		//the vertex range is in vertices so it's offset is the draw's vertex offset, sub-mesh firstIndex values already include the index range
+		Memory::OffsetAllocation poolVertices;
+		Memory::OffsetAllocation poolIndices;
+		uint32_t poolGeneration = 0; //the pool generation the ranges belong to
+		uint32_t poolResidentIndex = UINT32_MAX; //where the mesh is in the pool's resident list
+
+		//gets the number of vertices
+		inline size_t GetVertexCount() const
+		{
+			return (vertexLayout == VertexLayout::Float ? vertices.size() : packedVertices.size() / GetVertexLayoutStride(vertexLayout));
+		}
 
 		//creates a vertex buffer
 		inline bool CreateVertexBuffers(VmaAllocator& allocator)
 		{
-			vertexBuffer.Create(allocator, sizeof(Vertex), vertices.data(), vertices.size());
+			if (vertexLayout == VertexLayout::Float)
+				vertexBuffer.Create(allocator, sizeof(Vertex), vertices.data(), vertices.size());
+			else
+				vertexBuffer.Create(allocator, GetVertexLayoutStride(vertexLayout), packedVertices.data(), GetVertexCount());
 			return true;
 		}
 
@@ -149,13 +210,241 @@ namespace Smok::Asset::Mesh
 		{
 			vertexBuffer.Destroy(allocator);
 		}
+
+		//does the mesh use the packed buffers made by a batched upload
+		inline bool UsesPackedBuffers() const { return packedVertexBuffer.IsCreated(); }
+
+		//does the mesh live in the shared geometry pool
+		inline bool UsesGeometryPool() const { return poolVertices.IsValid(); }
+
+		//gets the size in bytes of the vertex data
+		inline size_t GetVertexDataSize() const
+		{
+			return (vertexLayout == VertexLayout::Float ? vertices.size() * sizeof(Vertex) : packedVertices.size());
+		}
+
+		//destroys the packed buffers made by a batched upload
+		inline void DestroyPackedBuffers(VmaAllocator& allocator)
+		{
+			packedVertexBuffer.Destroy(allocator);
+			packedIndexBuffer.Destroy(allocator);
+		}
+	};
+
+	//calculates the position and texture coord ranges of a set of vertices
+	static inline VertexQuantization CalculateVertexQuantization(const Vertex* vertices, const size_t& vertexCount)
+	{
+		VertexQuantization quantization;
+		if (vertexCount == 0)
+			return quantization;
+
+		glm::vec3 positionMin = vertices[0].position, positionMax = vertices[0].position;
+		glm::vec2 uvMin = vertices[0].textureCoords, uvMax = vertices[0].textureCoords;
+		for (size_t i = 1; i < vertexCount; ++i)
+		{
+			positionMin = glm::min(positionMin, vertices[i].position);
+			positionMax = glm::max(positionMax, vertices[i].position);
+			uvMin = glm::min(uvMin, vertices[i].textureCoords);
+			uvMax = glm::max(uvMax, vertices[i].textureCoords);
+		}
+
+		quantization.positionMin = positionMin;
+		quantization.positionExtent = positionMax - positionMin;
+		quantization.textureCoordsMin = uvMin;
+		quantization.textureCoordsExtent = uvMax - uvMin;
+		return quantization;
+	}
+
+	//packs float vertices into a packed layout, out is resized to fit
+	static inline void PackVertices(const Vertex* vertices, const size_t& vertexCount, const VertexLayout& layout, const VertexQuantization& quantization, std::vector<uint8_t>& out)
+	{
+		const uint32_t stride = GetVertexLayoutStride(layout);
+		out.resize((size_t)stride * vertexCount);
+
+		if (layout == VertexLayout::Float)
+		{
+			if (vertexCount > 0)
+				std::memcpy(out.data(), vertices, out.size());
+			return;
+		}
+
+		const bool quantizedPositions = VertexLayoutQuantizesPositions(layout);
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			const Vertex& vertex = vertices[i];
+			uint8_t* dst = out.data() + (size_t)stride * i;
+
+			if (quantizedPositions)
+			{
+				CompactVertex packed;
+				for (uint32_t c = 0; c < 3; ++c)
+					packed.position[c] = EncodeRangedUNorm16(vertex.position[c], quantization.positionMin[c], quantization.positionExtent[c]);
+				packed.position[3] = 0;
+				EncodeOctahedralNormal(vertex.normal, packed.normal);
+				packed.color[0] = EncodeUNorm8(vertex.color.x); packed.color[1] = EncodeUNorm8(vertex.color.y); packed.color[2] = EncodeUNorm8(vertex.color.z); packed.color[3] = 255;
+				EncodeTextureCoords(vertex.textureCoords, layout, quantization, packed.textureCoords);
+				std::memcpy(dst, &packed, sizeof(packed));
+			}
+			else
+			{
+				PackedVertex packed;
+				packed.position = vertex.position;
+				EncodeOctahedralNormal(vertex.normal, packed.normal);
+				packed.color[0] = EncodeUNorm8(vertex.color.x); packed.color[1] = EncodeUNorm8(vertex.color.y); packed.color[2] = EncodeUNorm8(vertex.color.z); packed.color[3] = 255;
+				EncodeTextureCoords(vertex.textureCoords, layout, quantization, packed.textureCoords);
+				std::memcpy(dst, &packed, sizeof(packed));
+			}
+		}
+	}
+
+	//unpacks vertices in a packed layout back into float vertices
+	static inline void UnpackVertices(const uint8_t* data, const size_t& vertexCount, const VertexLayout& layout, const VertexQuantization& quantization, std::vector<Vertex>& out)
+	{
+		out.resize(vertexCount);
+		if (layout == VertexLayout::Float)
+		{
+			if (vertexCount > 0)
+				std::memcpy(out.data(), data, vertexCount * sizeof(Vertex));
+			return;
+		}
+
+		const uint32_t stride = GetVertexLayoutStride(layout);
+		const bool quantizedPositions = VertexLayoutQuantizesPositions(layout);
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			const uint8_t* src = data + (size_t)stride * i;
+			Vertex& vertex = out[i];
+
+			if (quantizedPositions)
+			{
+				CompactVertex packed;
+				std::memcpy(&packed, src, sizeof(packed));
+				for (uint32_t c = 0; c < 3; ++c)
+					vertex.position[c] = DecodeRangedUNorm16(packed.position[c], quantization.positionMin[c], quantization.positionExtent[c]);
+				vertex.normal = DecodeOctahedralNormal(packed.normal);
+				vertex.color = { packed.color[0] / 255.0f, packed.color[1] / 255.0f, packed.color[2] / 255.0f };
+				vertex.textureCoords = DecodeTextureCoords(packed.textureCoords, layout, quantization);
+			}
+			else
+			{
+				PackedVertex packed;
+				std::memcpy(&packed, src, sizeof(packed));
+				vertex.position = packed.position;
+				vertex.normal = DecodeOctahedralNormal(packed.normal);
+				vertex.color = { packed.color[0] / 255.0f, packed.color[1] / 255.0f, packed.color[2] / 255.0f };
+				vertex.textureCoords = DecodeTextureCoords(packed.textureCoords, layout, quantization);
+			}
+		}
+	}
+
+	//cooks a static mesh's float vertices into a packed layout, the float vertices are freed
+	static inline void PackStaticMesh(StaticMesh& mesh, const VertexLayout& layout)
+	{
+		if (layout == mesh.vertexLayout)
+			return;
+
+		//always pack from floats so we never quantize twice
+		if (mesh.vertexLayout != VertexLayout::Float)
+			UnpackVertices(mesh.packedVertices.data(), mesh.GetVertexCount(), mesh.vertexLayout, mesh.quantization, mesh.vertices);
+
+		if (layout == VertexLayout::Float)
+		{
+			mesh.packedVertices.clear();
+			mesh.packedVertices.shrink_to_fit();
+			mesh.quantization = VertexQuantization();
+			mesh.vertexLayout = VertexLayout::Float;
+			return;
+		}
+
+		mesh.quantization = CalculateVertexQuantization(mesh.vertices.data(), mesh.vertices.size());
+		PackVertices(mesh.vertices.data(), mesh.vertices.size(), layout, mesh.quantization, mesh.packedVertices);
+		mesh.vertexLayout = layout;
+		mesh.vertices.clear();
+		mesh.vertices.shrink_to_fit();
+	}
+
+	//unpacks a static mesh back into float vertices, for tools and CPU side processing
+	static inline void UnpackStaticMesh(StaticMesh& mesh) { PackStaticMesh(mesh, VertexLayout::Float); }
+
+	//calculates the bounds of a static mesh and every sub-mesh, out gets the whole mesh's bounds first then one per sub-mesh
+	//float and packed layouts are read in place, quantized positions are decoded first
+	static inline void CalculateStaticMeshBounds(const StaticMesh& mesh, std::vector<Bounds>& out)
+	{
+		const size_t vertexCount = mesh.GetVertexCount();
+		const uint8_t* positions = (const uint8_t*)mesh.vertices.data();
+		size_t stride = sizeof(Vertex);
+		std::vector<Vertex> unpacked;
+		if (VertexLayoutQuantizesPositions(mesh.vertexLayout))
+		{
+			UnpackVertices(mesh.packedVertices.data(), vertexCount, mesh.vertexLayout, mesh.quantization, unpacked);
+			positions = (const uint8_t*)unpacked.data();
+		}
+		else if (mesh.vertexLayout != VertexLayout::Float)
+		{
+			positions = mesh.packedVertices.data() + offsetof(PackedVertex, position);
+			stride = sizeof(PackedVertex);
+		}
+
+		out.resize(mesh.meshes.size() + 1);
+		out[0] = CalculateBounds(positions, stride, vertexCount);
+		for (size_t m = 0; m < mesh.meshes.size(); ++m)
+			out[m + 1] = CalculateBounds(positions, stride, vertexCount, mesh.meshes[m].indices.data(), mesh.meshes[m].indices.size());
+	}
+
+	//calculates and stores the bounds of a static mesh and every sub-mesh
+	static inline void CalculateStaticMeshBounds(StaticMesh& mesh)
+	{
+		std::vector<Bounds> bounds;
+		CalculateStaticMeshBounds((const StaticMesh&)mesh, bounds);
+		mesh.bounds = bounds[0];
+		for (size_t m = 0; m < mesh.meshes.size(); ++m)
+			mesh.meshes[m].bounds = bounds[m + 1];
+	}
+
+	//defines the worst error introduced by packing vertices
+	struct VertexPackingError
+	{
+		float maxPositionError = 0.0f; //in mesh units
+		float maxNormalAngleError = 0.0f; //in radians
+		float maxColorError = 0.0f;
+		float maxTextureCoordsError = 0.0f;
 	};
+
+	//packs and unpacks vertices, measuring how far each attribute moved from the float data
+	static inline VertexPackingError MeasureVertexPackingError(const Vertex* vertices, const size_t& vertexCount, const VertexLayout& layout)
+	{
+		const VertexQuantization quantization = CalculateVertexQuantization(vertices, vertexCount);
+		std::vector<uint8_t> packed;
+		PackVertices(vertices, vertexCount, layout, quantization, packed);
+		std::vector<Vertex> unpacked;
+		UnpackVertices(packed.data(), vertexCount, layout, quantization, unpacked);
+
+		VertexPackingError error;
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			error.maxPositionError = glm::max(error.maxPositionError, glm::length(vertices[i].position - unpacked[i].position));
+			error.maxColorError = glm::max(error.maxColorError, glm::length(vertices[i].color - unpacked[i].color));
+			error.maxTextureCoordsError = glm::max(error.maxTextureCoordsError, glm::length(vertices[i].textureCoords - unpacked[i].textureCoords));
+
+			const float normalLength = glm::length(vertices[i].normal);
+			if (normalLength > 0.0f)
+			{
+				const float cosAngle = glm::clamp(glm::dot(vertices[i].normal / normalLength, unpacked[i].normal), -1.0f, 1.0f);
+				error.maxNormalAngleError = glm::max(error.maxNormalAngleError, std::acos(cosAngle));
+			}
+		}
+
+		return error;
+	}
 }
 
 namespace Smok::Asset::Mesh::Serilize
 {
 	//gets the version of this serilize API
-	static inline std::string GetAPIVersionStr() { return "1"; }
+	static inline std::string GetAPIVersionStr() { return "2"; }
+
+	//gets the version of the old json based serilize API, we can still load these files
+	static inline std::string GetLegacyAPIVersionStr() { return "1"; }
 
 	//gets the file extension for a binary smesh file
 	static inline std::string GetSmeshBinaryFileExtensionStr() { return "smesh"; }
@@ -163,9 +452,584 @@ namespace Smok::Asset::Mesh::Serilize
 	//gets the file extension for a decl smesh file
 	static inline std::string GetSmeshDeclFileExtensionStr() { return "smeshdecl"; }
 
+	//defines a read-only view of a v2 smesh file mapped into memory
+	//the pointers point straight into the mapping, so vertex and index data can be uploaded or copied without parsing
+	//encoded vertex and index streams are the exception, they are decoded once into buffers the view owns
+	struct MappedStaticMesh
+	{
+		Smok::IO::MappedFile file; //the mapped file
+
+		const Binary::FileHeader* header = nullptr; //the header
+		const Binary::SubMeshEntry* subMeshes = nullptr; //the sub-mesh table
+		const uint8_t* vertexData = nullptr; //the vertices in the file's vertex layout
+		const VertexQuantization* quantization = nullptr; //the quantization ranges, only set for packed layouts
+		const Bounds* bounds = nullptr; //the static mesh's bounds followed by every sub-mesh's, null for files written before bounds were added
+		const Binary::LODEntry* LODs = nullptr; //every sub-mesh's LOD data, null if the file has no generated LODs
+		const uint32_t* indices = nullptr; //every sub-mesh's indices
+		const Binary::MeshletRangeEntry* meshletRanges = nullptr; //where every sub-mesh's meshlets are, null if the file has no meshlets
+		const Meshlet* meshlets = nullptr; //every sub-mesh's meshlets
+		const uint32_t* meshletVertices = nullptr; //every sub-mesh's meshlet vertices
+		const uint8_t* meshletTriangles = nullptr; //every sub-mesh's meshlet triangles
+
+		std::vector<uint8_t> decodedVertices; //the vertices, only used if the file's vertex stream is encoded
+		std::vector<uint32_t> decodedIndices; //the indices, only used if the file's index stream is encoded
+
+		//gets the number of vertices
+		inline size_t GetVertexCount() const { return (header ? (size_t)header->vertexCount : 0); }
+
+		//gets the vertex layout
+		inline VertexLayout GetVertexLayout() const { return (header ? (VertexLayout)header->vertexLayout : VertexLayout::Float); }
+
+		//gets the vertices, only valid for the float layout
+		inline const Vertex* GetVertices() const { return (GetVertexLayout() == VertexLayout::Float ? (const Vertex*)vertexData : nullptr); }
+
+		//gets the number of sub-meshes
+		inline size_t GetSubMeshCount() const { return (header ? (size_t)header->subMeshCount : 0); }
+
+		//gets the indices of a sub-mesh
+		inline const uint32_t* GetSubMeshIndices(const size_t& subMesh) const { return indices + subMeshes[subMesh].firstIndex; }
+
+		//gets the number of meshlets a sub-mesh has, 0 if the file has no meshlets
+		inline size_t GetSubMeshMeshletCount(const size_t& subMesh) const { return (meshletRanges ? (size_t)meshletRanges[subMesh].meshletCount : 0); }
+
+		//gets the meshlets of a sub-mesh, their offsets are into GetSubMeshMeshletVertices and GetSubMeshMeshletTriangles
+		inline const Meshlet* GetSubMeshMeshlets(const size_t& subMesh) const { return (meshletRanges ? meshlets + meshletRanges[subMesh].firstMeshlet : nullptr); }
+
+		//gets the meshlet vertices of a sub-mesh
+		inline const uint32_t* GetSubMeshMeshletVertices(const size_t& subMesh) const { return (meshletRanges ? meshletVertices + meshletRanges[subMesh].firstVertex : nullptr); }
+
+		//gets the meshlet triangles of a sub-mesh
+		inline const uint8_t* GetSubMeshMeshletTriangles(const size_t& subMesh) const { return (meshletRanges ? meshletTriangles + meshletRanges[subMesh].firstTriangle : nullptr); }
+
+		//gets the bounds of the whole static mesh, null if the file has none
+		inline const Bounds* GetStaticMeshBounds() const { return bounds; }
+
+		//gets the bounds of a sub-mesh, null if the file has none
+		inline const Bounds* GetSubMeshBounds(const size_t& subMesh) const { return (bounds ? bounds + 1 + subMesh : nullptr); }
+
+		//closes the mapping, all pointers are invalid after this
+		inline void Close()
+		{
+			header = nullptr;
+			subMeshes = nullptr;
+			vertexData = nullptr;
+			quantization = nullptr;
+			bounds = nullptr;
+			LODs = nullptr;
+			indices = nullptr;
+			meshletRanges = nullptr;
+			meshlets = nullptr;
+			meshletVertices = nullptr;
+			meshletTriangles = nullptr;
+			decodedVertices.clear();
+			decodedIndices.clear();
+			file.Close();
+		}
+
+		//copies the mapped data into a static mesh, each section is copied in one go
+		inline void CopyToStaticMesh(StaticMesh& data) const
+		{
+			SMOK_PROFILE_ZONE("MappedStaticMesh::CopyToStaticMesh");
+
+			const size_t vertexCount = GetVertexCount();
+			data.vertexLayout = GetVertexLayout();
+			if (data.vertexLayout == VertexLayout::Float)
+			{
+				data.vertices.resize(vertexCount);
+				if (vertexCount > 0)
+					std::memcpy(data.vertices.data(), vertexData, vertexCount * sizeof(Vertex));
+				data.packedVertices.clear();
+				data.quantization = VertexQuantization();
+			}
+			else
+			{
+				data.packedVertices.assign(vertexData, vertexData + vertexCount * GetVertexLayoutStride(data.vertexLayout));
+				data.quantization = *quantization;
+				data.vertices.clear();
+			}
+
+			const size_t subMeshCount = GetSubMeshCount();
+			data.meshes.resize(subMeshCount);
+			for (size_t m = 0; m < subMeshCount; ++m)
+			{
+				const Binary::SubMeshEntry& entry = subMeshes[m];
+				data.meshes[m].LODIndex = entry.LODIndex;
+				data.meshes[m].canRender = (entry.flags & Binary::SubMeshFlag_CanRender);
+				data.meshes[m].indices.assign(GetSubMeshIndices(m), GetSubMeshIndices(m) + entry.indexCount);
+				data.meshes[m].LODSourceIndex = (LODs ? LODs[m].sourceSubMesh : UINT32_MAX);
+				data.meshes[m].LODError = (LODs ? LODs[m].geometricError : 0.0f);
+				if (bounds)
+					data.meshes[m].bounds = *GetSubMeshBounds(m);
+
+				const size_t meshletCount = GetSubMeshMeshletCount(m);
+				data.meshes[m].meshlets.assign(GetSubMeshMeshlets(m), GetSubMeshMeshlets(m) + meshletCount);
+				data.meshes[m].meshletVertices.assign(GetSubMeshMeshletVertices(m), GetSubMeshMeshletVertices(m) + (meshletCount > 0 ? meshletRanges[m].vertexCount : 0));
+				data.meshes[m].meshletTriangles.assign(GetSubMeshMeshletTriangles(m), GetSubMeshMeshletTriangles(m) + (meshletCount > 0 ? meshletRanges[m].triangleSize : 0));
+			}
+
+			//older files did not store bounds
+			if (bounds)
+				data.bounds = *bounds;
+			else
+				CalculateStaticMeshBounds(data);
+		}
+	};
+
+	//checks if every index points at a vertex, a bad one would read past the vertex buffer on the GPU
+	static inline bool IndicesAreInRange(const uint32_t* indices, const uint64_t& indexCount, const uint64_t& vertexCount)
+	{
+		uint32_t largest = 0;
+		for (uint64_t i = 0; i < indexCount; ++i)
+			largest = (indices[i] > largest ? indices[i] : largest);
+		return (indexCount == 0 || largest < vertexCount);
+	}
+
+	//checks if a section fits in the file and has the element size we expect
+	static inline bool SectionIsValid(const Binary::SectionEntry* section, const size_t& fileSize, const uint64_t& elementSize, const uint64_t& count)
+	{
+		if (!section)
+			return count == 0;
+
+		//the count is checked against the size first, a crafted count could wrap the multiply
+		return (section->elementSize == elementSize && section->count == count && count <= section->size / elementSize && section->size == elementSize * count &&
+			section->offset % Binary::SMESH_SECTION_ALIGNMENT == 0 && section->offset <= fileSize && section->size <= fileSize - section->offset);
+	}
+
+	//validates a v2 smesh binary already in memory and points a view at it's sections, the view does not own the data
+	//data must be aligned to at least 16 bytes and outlive the view, filepath is only used for errors
+	//encoded vertex and index streams are decoded into the view here, so callers never see the difference
+	static inline bool ParseStaticMeshBinary(const uint8_t* data, const size_t& size, const std::string& filepath, MappedStaticMesh& mapped)
+	{
+		//checks the header
+		if (size < sizeof(Binary::FileHeader))
+		{
+			fmt::print("Smok Asset Mesh Error: Serilize || ParseStaticMeshBinary || \"{}\" is too small to be a v{} smesh file.\n",
+				filepath, Binary::SMESH_BINARY_VERSION);
+			return false;
+		}
+
+		const Binary::FileHeader* header = (const Binary::FileHeader*)data;
+		if (header->magic != Binary::SMESH_MAGIC || header->version != Binary::SMESH_BINARY_VERSION || header->headerSize != sizeof(Binary::FileHeader))
+		{
+			fmt::print("Smok Asset Mesh Error: Serilize || ParseStaticMeshBinary || \"{}\" does not have a valid v{} smesh header. The function \"WriteStaticMeshDataToFile\" can be used to generate valid Smok Mesh files.\n",
+				filepath, Binary::SMESH_BINARY_VERSION);
+			return false;
+		}
+
+		const VertexLayout layout = (VertexLayout)header->vertexLayout;
+		if (header->fileSize != size || layout >= VertexLayout::Count || header->vertexStride != GetVertexLayoutStride(layout))
+		{
+			fmt::print("Smok Asset Mesh Error: Serilize || ParseStaticMeshBinary || \"{}\" is truncated or has a unknown vertex layout. Expected {} bytes, got {} bytes with vertex layout {} and a stride of {}.\n",
+				filepath, header->fileSize, size, header->vertexLayout, header->vertexStride);
+			return false;
+		}
+
+		//checks the sections
+		const Binary::SectionEntry* subMeshSection = Binary::FindSection(*header, Binary::SectionType::SubMeshTable);
+		const Binary::SectionEntry* vertexSection = Binary::FindSection(*header, Binary::SectionType::Vertices);
+		const Binary::SectionEntry* indexSection = Binary::FindSection(*header, Binary::SectionType::Indices);
+		const Binary::SectionEntry* encodedVertexSection = (vertexSection ? nullptr : Binary::FindSection(*header, Binary::SectionType::EncodedVertices));
+		const Binary::SectionEntry* encodedIndexSection = (indexSection ? nullptr : Binary::FindSection(*header, Binary::SectionType::EncodedIndices));
+		const Binary::SectionEntry* quantizationSection = Binary::FindSection(*header, Binary::SectionType::VertexQuantization);
+		const Binary::SectionEntry* boundsSection = Binary::FindSection(*header, Binary::SectionType::Bounds);
+		const Binary::SectionEntry* LODSection = Binary::FindSection(*header, Binary::SectionType::LODTable);
+		const Binary::SectionEntry* meshletRangeSection = Binary::FindSection(*header, Binary::SectionType::MeshletRanges);
+		const Binary::SectionEntry* meshletSection = Binary::FindSection(*header, Binary::SectionType::Meshlets);
+		const Binary::SectionEntry* meshletVertexSection = Binary::FindSection(*header, Binary::SectionType::MeshletVertices);
+		const Binary::SectionEntry* meshletTriangleSection = Binary::FindSection(*header, Binary::SectionType::MeshletTriangles);
+		if (!SectionIsValid(subMeshSection, size, sizeof(Binary::SubMeshEntry), header->subMeshCount) ||
+			(encodedVertexSection ? !SectionIsValid(encodedVertexSection, size, sizeof(uint8_t), encodedVertexSection->count) :
+				!SectionIsValid(vertexSection, size, header->vertexStride, header->vertexCount)) ||
+			(encodedIndexSection ? !SectionIsValid(encodedIndexSection, size, sizeof(uint8_t), encodedIndexSection->count) :
+				!SectionIsValid(indexSection, size, sizeof(uint32_t), header->indexCount)) ||
+			!SectionIsValid(quantizationSection, size, sizeof(VertexQuantization), (layout == VertexLayout::Float ? 0 : 1)) ||
+			(boundsSection && !SectionIsValid(boundsSection, size, sizeof(Bounds), header->subMeshCount + 1)) ||
+			(LODSection && !SectionIsValid(LODSection, size, sizeof(Binary::LODEntry), header->subMeshCount)) ||
+			(meshletRangeSection && (!meshletSection || !meshletVertexSection || !meshletTriangleSection ||
+				!SectionIsValid(meshletRangeSection, size, sizeof(Binary::MeshletRangeEntry), header->subMeshCount) ||
+				!SectionIsValid(meshletSection, size, sizeof(Meshlet), meshletSection->count) ||
+				!SectionIsValid(meshletVertexSection, size, sizeof(uint32_t), meshletVertexSection->count) ||
+				!SectionIsValid(meshletTriangleSection, size, sizeof(uint8_t), meshletTriangleSection->count))))
+		{
+			fmt::print("Smok Asset Mesh Error: Serilize || ParseStaticMeshBinary || \"{}\" has a section that is out of bounds or does not match the header.\n",
+				filepath);
+			return false;
+		}
+
+		mapped.header = header;
+		mapped.subMeshes = (subMeshSection ? (const Binary::SubMeshEntry*)(data + subMeshSection->offset) : nullptr);
+		mapped.vertexData = (vertexSection ? data + vertexSection->offset : nullptr);
+		mapped.quantization = (quantizationSection ? (const VertexQuantization*)(data + quantizationSection->offset) : nullptr);
+		mapped.bounds = (boundsSection ? (const Bounds*)(data + boundsSection->offset) : nullptr);
+		mapped.LODs = (LODSection ? (const Binary::LODEntry*)(data + LODSection->offset) : nullptr);
+		mapped.indices = (indexSection ? (const uint32_t*)(data + indexSection->offset) : nullptr);
+		mapped.meshletRanges = (meshletRangeSection ? (const Binary::MeshletRangeEntry*)(data + meshletRangeSection->offset) : nullptr);
+		mapped.meshlets = (meshletSection ? (const Meshlet*)(data + meshletSection->offset) : nullptr);
+		mapped.meshletVertices = (meshletVertexSection ? (const uint32_t*)(data + meshletVertexSection->offset) : nullptr);
+		mapped.meshletTriangles = (meshletTriangleSection ? data + meshletTriangleSection->offset : nullptr);
+
+		//decodes the encoded streams
+		if (encodedVertexSection)
+		{
+			SMOK_PROFILE_ZONE("Serilize::ParseStaticMeshBinary::DecodeVertices");
+
+			if (!Codec::VertexStreamCanHold((size_t)encodedVertexSection->size, header->vertexCount, header->vertexStride))
+			{
+				fmt::print("Smok Asset Mesh Error: Serilize || ParseStaticMeshBinary || \"{}\" says it has {} vertices, which do not fit in it's {} byte encoded vertex stream.\n",
+					filepath, header->vertexCount, encodedVertexSection->size);
+				return false;
+			}
+
+			mapped.decodedVertices.resize((size_t)header->vertexCount * header->vertexStride);
+			if (!Codec::DecodeVertices(data + encodedVertexSection->offset, encodedVertexSection->size, mapped.decodedVertices.data(), header->vertexCount, header->vertexStride))
+			{
+				fmt::print("Smok Asset Mesh Error: Serilize || ParseStaticMeshBinary || \"{}\" has a encoded vertex stream that failed to decode.\n",
+					filepath);
+				return false;
+			}
+			mapped.vertexData = mapped.decodedVertices.data();
+		}
+		if (encodedIndexSection)
+		{
+			SMOK_PROFILE_ZONE("Serilize::ParseStaticMeshBinary::DecodeIndices");
+
+			if (!Codec::IndexStreamCanHold((size_t)encodedIndexSection->size, header->indexCount))
+			{
+				fmt::print("Smok Asset Mesh Error: Serilize || ParseStaticMeshBinary || \"{}\" says it has {} indices, which do not fit in it's {} byte encoded index stream.\n",
+					filepath, header->indexCount, encodedIndexSection->size);
+				return false;
+			}
+
+			mapped.decodedIndices.resize((size_t)header->indexCount);
+			if (!Codec::DecodeIndices(data + encodedIndexSection->offset, encodedIndexSection->size, mapped.decodedIndices.data(), header->indexCount))
+			{
+				fmt::print("Smok Asset Mesh Error: Serilize || ParseStaticMeshBinary || \"{}\" has a encoded index stream that failed to decode.\n",
+					filepath);
+				return false;
+			}
+			mapped.indices = mapped.decodedIndices.data();
+		}
+
+		if (!IndicesAreInRange(mapped.indices, header->indexCount, header->vertexCount))
+		{
+			fmt::print("Smok Asset Mesh Error: Serilize || ParseStaticMeshBinary || \"{}\" has a index past it's {} vertices.\n",
+				filepath, header->vertexCount);
+			return false;
+		}
+
+		//checks every sub-mesh's index range
+		for (uint64_t m = 0; m < header->subMeshCount; ++m)
+		{
+			if (mapped.subMeshes[m].firstIndex > header->indexCount || mapped.subMeshes[m].indexCount > header->indexCount - mapped.subMeshes[m].firstIndex)
+			{
+				fmt::print("Smok Asset Mesh Error: Serilize || ParseStaticMeshBinary || \"{}\" sub-mesh {} has a index range outside the index section.\n",
+					filepath, m);
+				return false;
+			}
+
+			if (mapped.LODs && mapped.LODs[m].sourceSubMesh != UINT32_MAX && mapped.LODs[m].sourceSubMesh >= header->subMeshCount)
+			{
+				fmt::print("Smok Asset Mesh Error: Serilize || ParseStaticMeshBinary || \"{}\" sub-mesh {} is a LOD of sub-mesh {}, which is not in the file.\n",
+					filepath, m, mapped.LODs[m].sourceSubMesh);
+				return false;
+			}
+
+			//every meshlet has to stay inside it's sub-mesh's ranges, so reading one can never walk off the sections
+			if (mapped.meshletRanges)
+			{
+				const Binary::MeshletRangeEntry& range = mapped.meshletRanges[m];
+				bool isValid = (range.firstMeshlet <= meshletSection->count && range.meshletCount <= meshletSection->count - range.firstMeshlet &&
+					range.firstVertex <= meshletVertexSection->count && range.vertexCount <= meshletVertexSection->count - range.firstVertex &&
+					range.firstTriangle <= meshletTriangleSection->count && range.triangleSize <= meshletTriangleSection->count - range.firstTriangle);
+				for (uint32_t l = 0; isValid && l < range.meshletCount; ++l)
+				{
+					const Meshlet& meshlet = mapped.meshlets[range.firstMeshlet + l];
+					isValid = (meshlet.vertexCount <= MESHLET_MAX_VERTICES && meshlet.triangleCount <= MESHLET_MAX_TRIANGLES &&
+						meshlet.vertexOffset <= range.vertexCount && meshlet.vertexCount <= range.vertexCount - meshlet.vertexOffset &&
+						meshlet.triangleOffset <= range.triangleSize && meshlet.triangleCount * 3 <= range.triangleSize - meshlet.triangleOffset);
+				}
+				if (!isValid)
+				{
+					fmt::print("Smok Asset Mesh Error: Serilize || ParseStaticMeshBinary || \"{}\" sub-mesh {} has a meshlet range outside the meshlet sections.\n",
+						filepath, m);
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	//maps a v2 smesh binary file and validates it's header and sections
+	static inline bool MapStaticMeshBinaryFile(const BTD::IO::FileInfo& binaryFile, MappedStaticMesh& mapped)
+	{
+		SMOK_PROFILE_ZONE("Serilize::MapStaticMeshBinaryFile");
+
+		mapped.Close();
+		if (!mapped.file.Open(binaryFile))
+			return false;
+
+		if (!ParseStaticMeshBinary(mapped.file.data, mapped.file.size, binaryFile.GetPathStr(), mapped))
+		{
+			mapped.Close();
+			return false;
+		}
+
+		return true;
+	}
+
+	//checks if a binary file starts with the v2 smesh magic
+	static inline bool BinaryFileIsV2(const BTD::IO::FileInfo& binaryFile)
+	{
+		std::ifstream file(binaryFile.GetPathStr(), std::ios::binary);
+		uint32_t magic = 0;
+		if (!file.read((char*)&magic, sizeof(magic)))
+			return false;
+		return magic == Binary::SMESH_MAGIC;
+	}
+
+	//checks if a binary already in memory starts with the v2 smesh magic
+	static inline bool BinaryDataIsV2(const uint8_t* data, const size_t& size)
+	{
+		uint32_t magic = 0;
+		if (size < sizeof(magic))
+			return false;
+		std::memcpy(&magic, data, sizeof(magic));
+		return magic == Binary::SMESH_MAGIC;
+	}
+
+	//writes the padding needed to get to the next section
+	static inline void WriteSectionPadding(std::ostream& file, uint64_t& offset)
+	{
+		static const char zeros[Binary::SMESH_SECTION_ALIGNMENT] = {};
+		const uint64_t alignedOffset = Binary::AlignSectionOffset(offset);
+		file.write(zeros, (std::streamsize)(alignedOffset - offset));
+		offset = alignedOffset;
+	}
+
+	//gets the MeshEncoding a static mesh will actually be written with
+	//the index codec works a triangle at a time, so if any sub-mesh is not a whole number of triangles the indices are stored raw
+	static inline uint32_t GetUsableMeshEncoding(const StaticMesh& data, const uint32_t& encoding)
+	{
+		for (size_t m = 0; m < data.meshes.size(); ++m)
+		{
+			if (data.meshes[m].indices.size() % 3 != 0)
+				return encoding & ~(uint32_t)MeshEncoding_Indices;
+		}
+
+		return encoding & MeshEncoding_All;
+	}
+
+	//writes a static mesh as a v2 smesh binary to a stream, used by "WriteStaticMeshDataToFile" and the asset packer
+	//vertexLayout picks the layout the vertices are cooked into, bounds gets the bounds that were written, the whole mesh first then every sub-mesh's
+	//encoding is a mix of MeshEncoding flags, the streams it names are run through the codec in "Smok/Assets/MeshCodec.hpp"
+	static inline bool WriteStaticMeshBinary(std::ostream& file, const StaticMesh& data, const VertexLayout& vertexLayout, std::vector<Bounds>& bounds,
+		const uint32_t& encoding = MeshEncoding_None)
+	{
+		//cooks the vertices into the layout we want, if they are already in it they are written as is
+		const size_t vertexCount = data.GetVertexCount();
+		const uint32_t vertexStride = GetVertexLayoutStride(vertexLayout);
+		const uint8_t* vertexData = (data.vertexLayout == VertexLayout::Float ? (const uint8_t*)data.vertices.data() : data.packedVertices.data());
+		VertexQuantization quantization = data.quantization;
+		std::vector<uint8_t> cookedVertices;
+		if (vertexLayout != data.vertexLayout)
+		{
+			std::vector<Vertex> floatVertices;
+			const Vertex* source = data.vertices.data();
+			if (data.vertexLayout != VertexLayout::Float)
+			{
+				UnpackVertices(data.packedVertices.data(), vertexCount, data.vertexLayout, data.quantization, floatVertices);
+				source = floatVertices.data();
+			}
+
+			quantization = CalculateVertexQuantization(source, vertexCount);
+			PackVertices(source, vertexCount, vertexLayout, quantization, cookedVertices);
+			vertexData = cookedVertices.data();
+		}
+
+		//the bounds are always recalculated so the file can never carry stale ones
+		CalculateStaticMeshBounds(data, bounds);
+
+		//lays out the sections
+		const size_t subMeshCount = data.meshes.size();
+		bool hasLODs = false;
+		for (size_t m = 0; m < subMeshCount; ++m)
+			hasLODs |= (data.meshes[m].LODSourceIndex != UINT32_MAX);
+		uint64_t indexCount = 0;
+		for (size_t m = 0; m < subMeshCount; ++m)
+			indexCount += data.meshes[m].indices.size();
+		uint64_t meshletCount = 0, meshletVertexCount = 0, meshletTriangleSize = 0;
+		for (size_t m = 0; m < subMeshCount; ++m)
+		{
+			meshletCount += data.meshes[m].meshlets.size();
+			meshletVertexCount += data.meshes[m].meshletVertices.size();
+			meshletTriangleSize += data.meshes[m].meshletTriangles.size();
+		}
+
+		//encodes the streams we were asked to, the indices are encoded as one stream so it can be decoded in one go
+		const uint32_t usableEncoding = GetUsableMeshEncoding(data, encoding);
+		std::vector<uint8_t> encodedVertices, encodedIndices;
+		if (usableEncoding & MeshEncoding_Vertices)
+			Codec::EncodeVertices(vertexData, vertexCount, vertexStride, encodedVertices);
+		if (usableEncoding & MeshEncoding_Indices)
+		{
+			std::vector<uint32_t> indices;
+			indices.reserve(indexCount);
+			for (size_t m = 0; m < subMeshCount; ++m)
+				indices.insert(indices.end(), data.meshes[m].indices.begin(), data.meshes[m].indices.end());
+			Codec::EncodeIndices(indices.data(), indices.size(), encodedIndices);
+		}
+
+		Binary::FileHeader header;
+		header.headerSize = sizeof(Binary::FileHeader);
+		header.vertexStride = vertexStride;
+		header.vertexLayout = (uint32_t)vertexLayout;
+		header.vertexCount = vertexCount;
+		header.subMeshCount = subMeshCount;
+		header.indexCount = indexCount;
+
+		uint64_t offset = sizeof(Binary::FileHeader);
+		auto addSection = [&](const Binary::SectionType type, const uint64_t elementSize, const uint64_t count) {
+			Binary::SectionEntry& section = header.sections[header.sectionCount++];
+			section.type = type;
+			section.elementSize = (uint32_t)elementSize;
+			section.count = count;
+			section.size = elementSize * count;
+			section.offset = Binary::AlignSectionOffset(offset);
+			offset = section.offset + section.size;
+		};
+		addSection(Binary::SectionType::SubMeshTable, sizeof(Binary::SubMeshEntry), subMeshCount);
+		if (usableEncoding & MeshEncoding_Vertices)
+			addSection(Binary::SectionType::EncodedVertices, sizeof(uint8_t), encodedVertices.size());
+		else
+			addSection(Binary::SectionType::Vertices, vertexStride, vertexCount);
+		if (usableEncoding & MeshEncoding_Indices)
+			addSection(Binary::SectionType::EncodedIndices, sizeof(uint8_t), encodedIndices.size());
+		else
+			addSection(Binary::SectionType::Indices, sizeof(uint32_t), indexCount);
+		if (vertexLayout != VertexLayout::Float)
+			addSection(Binary::SectionType::VertexQuantization, sizeof(VertexQuantization), 1);
+		addSection(Binary::SectionType::Bounds, sizeof(Bounds), bounds.size());
+		if (hasLODs)
+			addSection(Binary::SectionType::LODTable, sizeof(Binary::LODEntry), subMeshCount);
+		if (meshletCount > 0)
+		{
+			addSection(Binary::SectionType::MeshletRanges, sizeof(Binary::MeshletRangeEntry), subMeshCount);
+			addSection(Binary::SectionType::Meshlets, sizeof(Meshlet), meshletCount);
+			addSection(Binary::SectionType::MeshletVertices, sizeof(uint32_t), meshletVertexCount);
+			addSection(Binary::SectionType::MeshletTriangles, sizeof(uint8_t), meshletTriangleSize);
+		}
+		header.fileSize = offset;
+
+		//sections are streamed straight from the mesh so nothing is copied into a temp buffer
+		file.write((const char*)&header, sizeof(header));
+		offset = sizeof(header);
+
+		WriteSectionPadding(file, offset);
+		uint64_t firstIndex = 0;
+		for (size_t m = 0; m < subMeshCount; ++m)
+		{
+			Binary::SubMeshEntry entry;
+			entry.firstIndex = firstIndex;
+			entry.indexCount = (uint32_t)data.meshes[m].indices.size();
+			entry.LODIndex = data.meshes[m].LODIndex;
+			entry.flags = (data.meshes[m].canRender ? (uint32_t)Binary::SubMeshFlag_CanRender : 0u);
+			file.write((const char*)&entry, sizeof(entry));
+			firstIndex += entry.indexCount;
+		}
+		offset += sizeof(Binary::SubMeshEntry) * subMeshCount;
+
+		WriteSectionPadding(file, offset);
+		if (usableEncoding & MeshEncoding_Vertices)
+		{
+			file.write((const char*)encodedVertices.data(), (std::streamsize)encodedVertices.size());
+			offset += encodedVertices.size();
+		}
+		else
+		{
+			file.write((const char*)vertexData, (std::streamsize)((uint64_t)vertexStride * vertexCount));
+			offset += (uint64_t)vertexStride * vertexCount;
+		}
+
+		WriteSectionPadding(file, offset);
+		if (usableEncoding & MeshEncoding_Indices)
+		{
+			file.write((const char*)encodedIndices.data(), (std::streamsize)encodedIndices.size());
+			offset += encodedIndices.size();
+		}
+		else
+		{
+			for (size_t m = 0; m < subMeshCount; ++m)
+				file.write((const char*)data.meshes[m].indices.data(), (std::streamsize)(sizeof(uint32_t) * data.meshes[m].indices.size()));
+			offset += sizeof(uint32_t) * indexCount;
+		}
+
+		if (vertexLayout != VertexLayout::Float)
+		{
+			WriteSectionPadding(file, offset);
+			file.write((const char*)&quantization, sizeof(quantization));
+			offset += sizeof(quantization);
+		}
+
+		WriteSectionPadding(file, offset);
+		file.write((const char*)bounds.data(), (std::streamsize)(sizeof(Bounds) * bounds.size()));
+		offset += sizeof(Bounds) * bounds.size();
+
+		if (hasLODs)
+		{
+			WriteSectionPadding(file, offset);
+			for (size_t m = 0; m < subMeshCount; ++m)
+			{
+				Binary::LODEntry entry;
+				entry.sourceSubMesh = data.meshes[m].LODSourceIndex;
+				entry.geometricError = data.meshes[m].LODError;
+				file.write((const char*)&entry, sizeof(entry));
+			}
+			offset += sizeof(Binary::LODEntry) * subMeshCount;
+		}
+
+		if (meshletCount > 0)
+		{
+			WriteSectionPadding(file, offset);
+			Binary::MeshletRangeEntry range;
+			for (size_t m = 0; m < subMeshCount; ++m)
+			{
+				range.meshletCount = (uint32_t)data.meshes[m].meshlets.size();
+				range.vertexCount = (uint32_t)data.meshes[m].meshletVertices.size();
+				range.triangleSize = (uint32_t)data.meshes[m].meshletTriangles.size();
+				file.write((const char*)&range, sizeof(range));
+				range.firstMeshlet += range.meshletCount;
+				range.firstVertex += range.vertexCount;
+				range.firstTriangle += range.triangleSize;
+			}
+			offset += sizeof(Binary::MeshletRangeEntry) * subMeshCount;
+
+			WriteSectionPadding(file, offset);
+			for (size_t m = 0; m < subMeshCount; ++m)
+				file.write((const char*)data.meshes[m].meshlets.data(), (std::streamsize)(sizeof(Meshlet) * data.meshes[m].meshlets.size()));
+			offset += sizeof(Meshlet) * meshletCount;
+
+			WriteSectionPadding(file, offset);
+			for (size_t m = 0; m < subMeshCount; ++m)
+				file.write((const char*)data.meshes[m].meshletVertices.data(), (std::streamsize)(sizeof(uint32_t) * data.meshes[m].meshletVertices.size()));
+			offset += sizeof(uint32_t) * meshletVertexCount;
+
+			WriteSectionPadding(file, offset);
+			for (size_t m = 0; m < subMeshCount; ++m)
+				file.write((const char*)data.meshes[m].meshletTriangles.data(), (std::streamsize)data.meshes[m].meshletTriangles.size());
+		}
+
+		return file.good();
+	}
+
 	//writes a static mesh to file
-	static inline bool WriteStaticMeshDataToFile(const BTD::IO::FileInfo& _declFile, const BTD::IO::FileInfo& _binaryFile, const StaticMesh& data)
+	//vertexLayout picks the layout the vertices are cooked into, the mesh it's self is not changed
+	//encoding is a mix of MeshEncoding flags for the streams to compress, loading decodes them without being told
+	static inline bool WriteStaticMeshDataToFile(const BTD::IO::FileInfo& _declFile, const BTD::IO::FileInfo& _binaryFile, const StaticMesh& data,
+		const VertexLayout& vertexLayout = VertexLayout::Float, const uint32_t& encoding = MeshEncoding_None)
 	{
+		SMOK_PROFILE_ZONE("Serilize::WriteStaticMeshDataToFile");
+
 		////checks if the file has the right extension, if not throw a warning and add it ourself
 		BTD::IO::FileInfo declFile = _declFile;
 		if (declFile.extension != GetSmeshDeclFileExtensionStr())
@@ -186,28 +1050,61 @@ namespace Smok::Asset::Mesh::Serilize
 			binaryFile.AppendFileExtension(GetSmeshBinaryFileExtensionStr());
 		}
 
-		//calculates the binary and decl blobs
-		const size_t vertexCount = data.vertices.size();
-		BTD::IO::File::WriteWholeBinaryFile(binaryFile, data.vertices.data(), sizeof(Smok::Asset::Mesh::Vertex), vertexCount);
+		//writes the binary
+		std::ofstream file(binaryFile.GetPathStr(), std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			fmt::print("Smok Asset Mesh Error: Serilize || WriteStaticMeshDataToFile || Failed to open \"{}\" for writing.\n",
+				binaryFile.GetPathStr());
+			return false;
+		}
 
-		//build json and write to file
-		nlohmann::json declData;
-		declData["version"] = GetAPIVersionStr();
-		declData["vertexCount"] = vertexCount;
+		std::vector<Bounds> bounds;
+		if (!WriteStaticMeshBinary(file, data, vertexLayout, bounds, encoding))
+		{
+			fmt::print("Smok Asset Mesh Error: Serilize || WriteStaticMeshDataToFile || Failed to write \"{}\".\n",
+				binaryFile.GetPathStr());
+			return false;
+		}
+		file.close();
 
-		//stores the array of meshes
+		const size_t vertexCount = data.GetVertexCount();
 		const size_t subMeshCount = data.meshes.size();
-		std::vector<std::vector<uint32_t>> submeshIndices;
+		bool hasLODs = false;
+		uint64_t indexCount = 0, meshletCount = 0;
 		for (size_t m = 0; m < subMeshCount; ++m)
 		{
-			std::vector<uint32_t> indices;
-			const size_t indicesCount = data.meshes[m].indices.size();
-			for (size_t index = 0; index < indicesCount; ++index)
-				indices.emplace_back(data.meshes[m].indices[index]);
-			submeshIndices.emplace_back(indices);
+			hasLODs |= (data.meshes[m].LODSourceIndex != UINT32_MAX);
+			indexCount += data.meshes[m].indices.size();
+			meshletCount += data.meshes[m].meshlets.size();
 		}
+
+		//the decl is only a small readable summary now, the binary carries everything needed to load
+		nlohmann::json declData;
+		declData["version"] = GetAPIVersionStr();
+		declData["vertexCount"] = vertexCount;
 		declData["meshCount"] = subMeshCount;
-		declData["meshes"] = submeshIndices;
+		declData["indexCount"] = indexCount;
+		declData["vertexLayout"] = (uint32_t)vertexLayout;
+		if (meshletCount > 0)
+			declData["meshletCount"] = meshletCount;
+		if (GetUsableMeshEncoding(data, encoding) != MeshEncoding_None)
+			declData["encoding"] = GetUsableMeshEncoding(data, encoding);
+		for (size_t b = 0; b < bounds.size(); ++b)
+		{
+			nlohmann::json& boundsData = (b == 0 ? declData["bounds"] : declData["subMeshBounds"][b - 1]);
+			boundsData["min"] = { bounds[b].min.x, bounds[b].min.y, bounds[b].min.z };
+			boundsData["max"] = { bounds[b].max.x, bounds[b].max.y, bounds[b].max.z };
+			boundsData["sphereCenter"] = { bounds[b].sphereCenter.x, bounds[b].sphereCenter.y, bounds[b].sphereCenter.z };
+			boundsData["sphereRadius"] = bounds[b].sphereRadius;
+		}
+		for (size_t m = 0; hasLODs && m < subMeshCount; ++m)
+		{
+			nlohmann::json& LODData = declData["subMeshLODs"][m];
+			LODData["LODIndex"] = data.meshes[m].LODIndex;
+			LODData["sourceSubMesh"] = (data.meshes[m].LODSourceIndex == UINT32_MAX ? -1 : (int64_t)data.meshes[m].LODSourceIndex);
+			LODData["geometricError"] = data.meshes[m].LODError;
+		}
 		
 		//writes decl data
 		BTD::IO::File::WriteWholeTextFile(declFile, declData.dump());
@@ -215,9 +1112,119 @@ namespace Smok::Asset::Mesh::Serilize
 		return true;
 	}
 
+	//loads a static mesh from the old json decl format, with the decl text and binary already in memory
+	//filepath is only used for errors
+	static inline bool LoadStaticMeshDataFromMemory_Legacy(const std::string_view& declText, const uint8_t* binaryData, const size_t& binarySize,
+		const std::string& filepath, StaticMesh& data)
+	{
+		SMOK_PROFILE_ZONE("Serilize::LoadStaticMeshDataFromMemory_Legacy");
+
+		nlohmann::json decl;
+		{
+			SMOK_PROFILE_ZONE("json::parse");
+			decl = nlohmann::json::parse(declText.begin(), declText.end());
+		}
+		if (decl["version"] != GetLegacyAPIVersionStr())
+		{
+			const std::string ver = decl["version"];
+			fmt::print("Smok Asset Mesh Warning: Serilize || LoadStaticMeshDataFromMemory || \"{}\" is not the same version as the version of Smok you are using. The file's version is \"{}\", while the version you are using to load the file is \"{}\". We can not say there won't be issues loading this data. The function \"WriteStaticMeshDataToFile\" can be used to generate valid Smok Mesh files, matching this version of Smok.\n",
+				filepath, ver, GetAPIVersionStr());
+		}
+
+		//gets the mesh data
+		const size_t vertexCount = decl["vertexCount"];
+		if (vertexCount > binarySize / sizeof(Smok::Asset::Mesh::Vertex))
+		{
+			fmt::print("Smok Asset Mesh Error: Serilize || LoadStaticMeshDataFromMemory || \"{}\" is truncated, the decl lists {} vertices but the binary only holds {} bytes.\n",
+				filepath, vertexCount, binarySize);
+			return false;
+		}
+
+		data.vertexLayout = VertexLayout::Float;
+		data.packedVertices.clear();
+		data.vertices.resize(vertexCount);
+		if (vertexCount > 0)
+			std::memcpy(data.vertices.data(), binaryData, vertexCount * sizeof(Smok::Asset::Mesh::Vertex));
+
+		//generates the sub-meshes, reading each index list straight into the sub-mesh
+		const size_t subMeshCount = decl["meshCount"];
+		const nlohmann::json& submeshes = decl["meshes"];
+		if (!submeshes.is_array() || submeshes.size() != subMeshCount)
+		{
+			fmt::print("Smok Asset Mesh Error: Serilize || LoadStaticMeshDataFromMemory || \"{}\" lists {} sub-meshes but it's decl has {}.\n",
+				filepath, subMeshCount, (submeshes.is_array() ? submeshes.size() : 0));
+			return false;
+		}
+
+		data.meshes.resize(subMeshCount);
+		for (size_t m = 0; m < subMeshCount; ++m)
+		{
+			submeshes[m].get_to(data.meshes[m].indices);
+			if (!IndicesAreInRange(data.meshes[m].indices.data(), data.meshes[m].indices.size(), vertexCount))
+			{
+				fmt::print("Smok Asset Mesh Error: Serilize || LoadStaticMeshDataFromMemory || \"{}\" sub-mesh {} has a index past it's {} vertices.\n",
+					filepath, m, vertexCount);
+				return false;
+			}
+		}
+
+		//v1 files never stored bounds
+		CalculateStaticMeshBounds(data);
+
+		return true;
+	}
+
+	//loads a static mesh from a binary already in memory, used when many files are read in one batch, see "AssetManager::LoadStaticMeshesBulk"
+	//v2 binaries do not need the decl, declText is only read for v1 binaries. filepath is only used for errors
+	//binaryData must be aligned to at least 16 bytes
+	static inline bool LoadStaticMeshDataFromMemory(const std::string_view& declText, const uint8_t* binaryData, const size_t& binarySize,
+		const std::string& filepath, StaticMesh& data)
+	{
+		if (!BinaryDataIsV2(binaryData, binarySize))
+		{
+			if (declText.empty())
+			{
+				fmt::print("Smok Asset Mesh Error: Serilize || LoadStaticMeshDataFromMemory || \"{}\" is a v1 smesh binary, it's decl is needed to load it.\n", filepath);
+				return false;
+			}
+
+			return LoadStaticMeshDataFromMemory_Legacy(declText, binaryData, binarySize, filepath, data);
+		}
+
+		MappedStaticMesh view;
+		if (!ParseStaticMeshBinary(binaryData, binarySize, filepath, view))
+			return false;
+
+		view.CopyToStaticMesh(data);
+		return true;
+	}
+
+	//loads a static mesh from the old json decl format
+	static inline bool LoadStaticMeshDataFromFile_Legacy(const BTD::IO::FileInfo& declFile, const BTD::IO::FileInfo& binaryFile, StaticMesh& data)
+	{
+		SMOK_PROFILE_ZONE("Serilize::LoadStaticMeshDataFromFile_Legacy");
+
+		const auto declText = BTD::IO::File::ReadWholeTextFile(declFile);
+
+		//a mesh with no vertices has a empty binary, which can't be mapped, so it's loaded from no data
+		std::error_code error;
+		const bool binaryIsEmpty = (std::filesystem::file_size(binaryFile.GetPathStr(), error) == 0 && !error);
+		IO::MappedFile binary;
+		if (!binaryIsEmpty)
+		{
+			SMOK_PROFILE_ZONE("MappedFile::Open");
+			if (!binary.Open(binaryFile))
+				return false;
+		}
+
+		return LoadStaticMeshDataFromMemory_Legacy(std::string_view(declText.data), binary.data, binary.size, binaryFile.GetPathStr(), data);
+	}
+
 	//laods a static mesh from file
 	static inline bool LoadStaticMeshDataFromFile(const BTD::IO::FileInfo& declFile, const BTD::IO::FileInfo& binaryFile, StaticMesh& data)
 	{
+		SMOK_PROFILE_ZONE("Serilize::LoadStaticMeshDataFromFile");
+
 		//checks if the file has the right extension, if not throw a warning and add it ourself
 		if (declFile.extension != GetSmeshDeclFileExtensionStr())
 		{
@@ -250,27 +1257,16 @@ namespace Smok::Asset::Mesh::Serilize
 			return false;
 		}
 
-		//loads the decl file and check it's version, throw a warning
-		nlohmann::json decl = nlohmann::json::parse(BTD::IO::File::ReadWholeTextFile(declFile).data);
-		if (decl["version"] != GetAPIVersionStr())
-		{
-			const std::string ver = decl["version"];
-			fmt::print("Smok Asset Mesh Warning: Serilize || LoadStaticMeshDataFromFile || \"{}\" is not the same version as the version of Smok you are using. The file's version is \"{}\", while the version you are using to load the file is \"{}\". We can not say there won't be issues loading this data. The function \"WriteStaticMeshDataToFile\" can be used to generate valid Smok Mesh files, matching this version of Smok.\n",
-				binaryFile.GetPathStr(), ver, GetAPIVersionStr());
-		}
-
-		//gets the mesh data
-		const size_t vertexCount = decl["vertexCount"];
-		data.vertices.resize(vertexCount);
-		BTD::IO::File::ReadWholeBinaryFile(binaryFile, data.vertices.data(), sizeof(Smok::Asset::Mesh::Vertex), vertexCount);
+		//v1 files keep the indices in the json decl
+		if (!BinaryFileIsV2(binaryFile))
+			return LoadStaticMeshDataFromFile_Legacy(declFile, binaryFile, data);
 
-		//generates the sub-meshes
-		const size_t subMeshCount = decl["meshCount"];
-		std::vector<std::vector<uint32_t>> submeshes = decl["meshes"].get<std::vector<std::vector<uint32_t>>>();
-		data.meshes.resize(subMeshCount);
-		for (size_t m = 0; m < subMeshCount; ++m)
-			data.meshes[m].indices = submeshes[m];
+		//v2 files are mapped and copied out section by section, the decl is never parsed
+		MappedStaticMesh mapped;
+		if (!MapStaticMeshBinaryFile(binaryFile, mapped))
+			return false;
 
+		mapped.CopyToStaticMesh(data);
 		return true;
 	}
 }
\ No newline at end of file
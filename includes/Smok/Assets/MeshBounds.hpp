@@ -0,0 +1,84 @@
+#pragma once
+
+//defines bounding volumes for meshes
+//every static mesh and sub-mesh carries a AABB and a bounding sphere, calculated when the mesh is written or loaded
+
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/geometric.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+namespace Smok::Asset::Mesh
+{
+	//defines a AABB and a bounding sphere
+	struct Bounds
+	{
+		glm::vec3 min = { 0.0f, 0.0f, 0.0f };
+		glm::vec3 max = { 0.0f, 0.0f, 0.0f };
+		glm::vec3 sphereCenter = { 0.0f, 0.0f, 0.0f };
+		float sphereRadius = 0.0f;
+
+		//gets the center of the AABB
+		inline glm::vec3 GetCenter() const { return (min + max) * 0.5f; }
+
+		//gets the half size of the AABB
+		inline glm::vec3 GetExtents() const { return (max - min) * 0.5f; }
+	};
+	static_assert(sizeof(Bounds) == 40, "Bounds is written to disk, it's size can not change");
+
+	//calculates the bounds of a set of positions, stride is the distance in bytes between each position
+	//indices can be null to use every position, otherwise only the indexed positions are used
+	static inline Bounds CalculateBounds(const uint8_t* positions, const size_t& stride, const size_t& positionCount, const uint32_t* indices = nullptr, const size_t& indexCount = 0)
+	{
+		Bounds bounds;
+		const size_t count = (indices ? indexCount : positionCount);
+		if (count == 0)
+			return bounds;
+
+		auto getPosition = [&](const size_t& i) -> const glm::vec3& {
+			return *(const glm::vec3*)(positions + stride * (indices ? indices[i] : i));
+		};
+
+		//the AABB
+		bounds.min = getPosition(0);
+		bounds.max = bounds.min;
+		for (size_t i = 1; i < count; ++i)
+		{
+			const glm::vec3& p = getPosition(i);
+			bounds.min = glm::min(bounds.min, p);
+			bounds.max = glm::max(bounds.max, p);
+		}
+
+		//the sphere is centered on the AABB, with the radius reaching the furthest point, tighter than the AABB's corner
+		bounds.sphereCenter = bounds.GetCenter();
+		float radiusSquared = 0.0f;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const glm::vec3 offset = getPosition(i) - bounds.sphereCenter;
+			const float distanceSquared = glm::dot(offset, offset);
+			if (distanceSquared > radiusSquared)
+				radiusSquared = distanceSquared;
+		}
+		bounds.sphereRadius = std::sqrt(radiusSquared);
+
+		return bounds;
+	}
+
+	//gets the largest axis scale of a model matrix
+	static inline float GetMaxAxisScale(const glm::mat4& modelMatrix)
+	{
+		const glm::vec3 axisX(modelMatrix[0]), axisY(modelMatrix[1]), axisZ(modelMatrix[2]);
+		return std::sqrt(glm::max(glm::dot(axisX, axisX), glm::max(glm::dot(axisY, axisY), glm::dot(axisZ, axisZ))));
+	}
+
+	//transforms a bounding sphere into world space, the radius is scaled by the largest axis scale
+	static inline void TransformBoundingSphere(const Bounds& bounds, const glm::mat4& modelMatrix, glm::vec3& worldCenter, float& worldRadius)
+	{
+		const glm::vec4 center = modelMatrix * glm::vec4(bounds.sphereCenter, 1.0f);
+		worldCenter = { center.x, center.y, center.z };
+		worldRadius = bounds.sphereRadius * GetMaxAxisScale(modelMatrix);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,623 @@
+#pragma once
+
+//defines the index and vertex stream codec for smesh files
+//indices are coded a triangle at a time against a FIFO of recent edges and vertices, most triangles take a single byte
+//vertices are split into byte planes in blocks, each plane is delta coded against the vertex before it and bit packed in groups of 16
+//the output is smaller than the raw streams and compresses better with LZ4 or zstd, the vertex decoder uses SSE2 when the build has it
+
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define SMOK_MESH_CODEC_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Smok::Asset::Mesh
+{
+	//defines what streams a smesh binary is written with the codec, anything not set is stored raw
+	enum MeshEncoding : uint32_t
+	{
+		MeshEncoding_None = 0,
+		MeshEncoding_Indices = 1 << 0,
+		MeshEncoding_Vertices = 1 << 1,
+
+		MeshEncoding_All = MeshEncoding_Indices | MeshEncoding_Vertices
+	};
+}
+
+namespace Smok::Asset::Mesh::Codec
+{
+	//the first byte of every encoded stream, bump it whenever the format changes
+	static constexpr uint8_t INDEX_CODEC_VERSION = 1;
+	static constexpr uint8_t VERTEX_CODEC_VERSION = 1;
+
+	//the number of vertices coded together, each byte plane of a block is 16 byte aligned in the decoder's scratch
+	static constexpr size_t VERTEX_CODEC_BLOCK_SIZE = 256;
+
+	//the largest vertex stride the codec takes
+	static constexpr size_t VERTEX_CODEC_MAX_STRIDE = 256;
+
+	//---internal
+
+	//zigzags a byte delta so small negative and positive steps both become small numbers
+	static inline uint8_t ZigzagByte(const uint8_t& delta) { return (uint8_t)((delta << 1) ^ (uint8_t)((int8_t)delta >> 7)); }
+
+	//undoes ZigzagByte
+	static inline uint8_t UnzigzagByte(const uint8_t& value) { return (uint8_t)((value >> 1) ^ (uint8_t)(0 - (value & 1))); }
+
+	//writes a unsigned LEB128 varint
+	static inline void WriteVarint(std::vector<uint8_t>& out, uint32_t value)
+	{
+		while (value >= 0x80)
+		{
+			out.emplace_back((uint8_t)(value | 0x80));
+			value >>= 7;
+		}
+		out.emplace_back((uint8_t)value);
+	}
+
+	//reads a unsigned LEB128 varint, fails if it runs past the end or is longer than 5 bytes
+	static inline bool ReadVarint(const uint8_t*& data, const uint8_t* end, uint32_t& value)
+	{
+		value = 0;
+		for (uint32_t shift = 0; shift < 35; shift += 7)
+		{
+			if (data >= end)
+				return false;
+
+			const uint8_t byte = *data++;
+			value |= (uint32_t)(byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+				return true;
+		}
+
+		return false;
+	}
+
+	//defines the state both sides of the index codec keep in step
+	//edges are stored backwards as a neighbouring triangle walks them, the vertex FIFO holds every vertex that was not already in it
+	struct IndexCodecState
+	{
+		uint32_t edges[16][2] = {};
+		uint32_t edgeOffset = 0;
+		uint32_t vertices[16] = {};
+		uint32_t vertexOffset = 0;
+		uint32_t next = 0; //the vertex a "new" vertex code means, indices ordered by first use are mostly these
+		uint32_t last = 0; //the last explicitly coded vertex, explicit vertices are a delta from it
+
+		//adds a emitted triangle's edges
+		inline void PushTriangle(const uint32_t& a, const uint32_t& b, const uint32_t& c)
+		{
+			edges[edgeOffset & 15][0] = b; edges[edgeOffset & 15][1] = a; edgeOffset++;
+			edges[edgeOffset & 15][0] = c; edges[edgeOffset & 15][1] = b; edgeOffset++;
+			edges[edgeOffset & 15][0] = a; edges[edgeOffset & 15][1] = c; edgeOffset++;
+		}
+
+		//adds a vertex to the FIFO
+		inline void PushVertex(const uint32_t& vertex) { vertices[vertexOffset++ & 15] = vertex; }
+
+		//gets a edge, 0 is the newest
+		inline const uint32_t* GetEdge(const uint32_t& index) const { return edges[(edgeOffset - 1 - index) & 15]; }
+
+		//gets a vertex from the FIFO, 1 is the newest
+		inline uint32_t GetVertex(const uint32_t& index) const { return vertices[(vertexOffset - index) & 15]; }
+
+		//finds a vertex in the FIFO, returns 1 - 14 or 0 if it's not there
+		inline uint32_t FindVertex(const uint32_t& vertex) const
+		{
+			for (uint32_t i = 1; i < 15; ++i)
+			{
+				if (GetVertex(i) == vertex)
+					return i;
+			}
+			return 0;
+		}
+	};
+
+	//codes a vertex in a varint, 0 is the next new vertex, 1 - 14 is the FIFO, anything above is a zigzag delta from the last explicit vertex
+	static inline uint32_t CodeFreeVertex(IndexCodecState& state, const uint32_t& vertex)
+	{
+		if (vertex == state.next)
+		{
+			state.next++;
+			state.PushVertex(vertex);
+			return 0;
+		}
+
+		const uint32_t cached = state.FindVertex(vertex);
+		if (cached)
+			return cached;
+
+		const int32_t delta = (int32_t)(vertex - state.last);
+		state.last = vertex;
+		state.PushVertex(vertex);
+		return 15 + (((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));
+	}
+
+	//undoes CodeFreeVertex
+	static inline uint32_t DecodeFreeVertex(IndexCodecState& state, const uint32_t& code)
+	{
+		if (code == 0)
+		{
+			state.PushVertex(state.next);
+			return state.next++;
+		}
+
+		if (code < 15)
+			return state.GetVertex(code);
+
+		const uint32_t zigzag = code - 15;
+		state.last += (zigzag >> 1) ^ (0 - (zigzag & 1));
+		state.PushVertex(state.last);
+		return state.last;
+	}
+
+	//---internal
+
+	//encodes a triangle list, triangles that share a edge with a recent one may come back rotated, the winding and triangle order are kept
+	//the stream is a version byte, one code byte per triangle and then the varints the codes need
+	//returns false if the index count is not a multiple of 3
+	static inline bool EncodeIndices(const uint32_t* indices, const size_t& indexCount, std::vector<uint8_t>& out)
+	{
+		out.clear();
+		if (indexCount % 3 != 0)
+			return false;
+
+		const size_t triangleCount = indexCount / 3;
+		out.resize(1 + triangleCount);
+		out[0] = INDEX_CODEC_VERSION;
+
+		IndexCodecState state;
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			const uint32_t* triangle = indices + t * 3;
+
+			//looks for a edge of the triangle in the FIFO, in any rotation
+			uint32_t edge = 15, rotation = 0;
+			for (uint32_t e = 0; e < 15 && edge == 15; ++e)
+			{
+				const uint32_t* candidate = state.GetEdge(e);
+				for (uint32_t r = 0; r < 3; ++r)
+				{
+					if (candidate[0] == triangle[r] && candidate[1] == triangle[(r + 1) % 3])
+					{
+						edge = e;
+						rotation = r;
+						break;
+					}
+				}
+			}
+
+			//no shared edge, every vertex goes in the varints
+			if (edge == 15)
+			{
+				out[1 + t] = 0xF0;
+				for (uint32_t c = 0; c < 3; ++c)
+					WriteVarint(out, CodeFreeVertex(state, triangle[c]));
+				state.PushTriangle(triangle[0], triangle[1], triangle[2]);
+				continue;
+			}
+
+			//the edge gives two vertices, the third is new, in the FIFO or a explicit delta
+			const uint32_t a = triangle[rotation], b = triangle[(rotation + 1) % 3], c = triangle[(rotation + 2) % 3];
+			uint32_t third = 0;
+			if (c == state.next)
+			{
+				state.next++;
+				state.PushVertex(c);
+			}
+			else if ((third = state.FindVertex(c)) == 0)
+			{
+				third = 15;
+				const int32_t delta = (int32_t)(c - state.last);
+				state.last = c;
+				state.PushVertex(c);
+				WriteVarint(out, ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));
+			}
+
+			out[1 + t] = (uint8_t)((edge << 4) | third);
+			state.PushTriangle(a, b, c);
+		}
+
+		return true;
+	}
+
+	//gets if a index stream of size bytes could hold indexCount indices, every triangle costs at least it's code byte
+	//check it before allocating the output so a bad count can't ask for more memory than the stream could fill
+	static inline bool IndexStreamCanHold(const size_t& size, const uint64_t& indexCount)
+	{
+		return (size >= 1 && indexCount % 3 == 0 && indexCount / 3 <= size - 1 && indexCount <= SIZE_MAX / sizeof(uint32_t));
+	}
+
+	//decodes a triangle list made by EncodeIndices, indexCount must be the count that was encoded
+	//returns false if the stream is truncated or not a index stream
+	static inline bool DecodeIndices(const uint8_t* data, const size_t& size, uint32_t* indices, const size_t& indexCount)
+	{
+		const size_t triangleCount = indexCount / 3;
+		if (indexCount % 3 != 0 || size < 1 + triangleCount || data[0] != INDEX_CODEC_VERSION)
+			return false;
+
+		const uint8_t* codes = data + 1;
+		const uint8_t* extra = codes + triangleCount;
+		const uint8_t* end = data + size;
+
+		IndexCodecState state;
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			uint32_t* triangle = indices + t * 3;
+			const uint32_t code = codes[t];
+			const uint32_t edge = code >> 4, third = code & 15;
+			if (edge == 15)
+			{
+				for (uint32_t c = 0; c < 3; ++c)
+				{
+					uint32_t value;
+					if (!ReadVarint(extra, end, value))
+						return false;
+					triangle[c] = DecodeFreeVertex(state, value);
+				}
+			}
+			else
+			{
+				const uint32_t* shared = state.GetEdge(edge);
+				triangle[0] = shared[0];
+				triangle[1] = shared[1];
+				if (third == 0)
+				{
+					triangle[2] = state.next++;
+					state.PushVertex(triangle[2]);
+				}
+				else if (third < 15)
+					triangle[2] = state.GetVertex(third);
+				else
+				{
+					uint32_t zigzag;
+					if (!ReadVarint(extra, end, zigzag))
+						return false;
+					state.last += (zigzag >> 1) ^ (0 - (zigzag & 1));
+					triangle[2] = state.last;
+					state.PushVertex(triangle[2]);
+				}
+			}
+
+			state.PushTriangle(triangle[0], triangle[1], triangle[2]);
+		}
+
+		return true;
+	}
+
+	//encodes a vertex stream, any layout works as only bytes are looked at
+	//every block of VERTEX_CODEC_BLOCK_SIZE vertices is written one byte plane at a time, each plane is 2 bit group widths then the groups
+	//a group is 16 zigzagged byte deltas stored in 0, 2, 4 or 8 bits each, the smallest that fits them all
+	//returns false if the stride is not a multiple of 4 or is over VERTEX_CODEC_MAX_STRIDE
+	static inline bool EncodeVertices(const uint8_t* vertices, const size_t& vertexCount, const size_t& stride, std::vector<uint8_t>& out)
+	{
+		out.clear();
+		if (stride == 0 || stride % 4 != 0 || stride > VERTEX_CODEC_MAX_STRIDE)
+			return false;
+
+		out.emplace_back(VERTEX_CODEC_VERSION);
+
+		uint8_t last[VERTEX_CODEC_MAX_STRIDE] = {};
+		uint8_t deltas[VERTEX_CODEC_BLOCK_SIZE];
+		for (size_t blockStart = 0; blockStart < vertexCount; blockStart += VERTEX_CODEC_BLOCK_SIZE)
+		{
+			const size_t count = (vertexCount - blockStart < VERTEX_CODEC_BLOCK_SIZE ? vertexCount - blockStart : VERTEX_CODEC_BLOCK_SIZE);
+			const size_t groupCount = (count + 15) / 16;
+			const uint8_t* block = vertices + blockStart * stride;
+			for (size_t k = 0; k < stride; ++k)
+			{
+				uint8_t previous = last[k];
+				for (size_t i = 0; i < count; ++i)
+				{
+					deltas[i] = ZigzagByte((uint8_t)(block[i * stride + k] - previous));
+					previous = block[i * stride + k];
+				}
+				std::memset(deltas + count, 0, groupCount * 16 - count);
+				last[k] = previous;
+
+				const size_t header = out.size();
+				out.resize(out.size() + (groupCount + 3) / 4, 0);
+				for (size_t g = 0; g < groupCount; ++g)
+				{
+					const uint8_t* group = deltas + g * 16;
+					uint8_t largest = 0;
+					for (uint32_t i = 0; i < 16; ++i)
+						largest = (group[i] > largest ? group[i] : largest);
+
+					const uint32_t width = (largest == 0 ? 0 : largest < 4 ? 1 : largest < 16 ? 2 : 3);
+					out[header + g / 4] |= (uint8_t)(width << ((g % 4) * 2));
+					if (width == 1)
+					{
+						for (uint32_t i = 0; i < 16; i += 4)
+							out.emplace_back((uint8_t)((group[i] << 6) | (group[i + 1] << 4) | (group[i + 2] << 2) | group[i + 3]));
+					}
+					else if (width == 2)
+					{
+						for (uint32_t i = 0; i < 16; i += 2)
+							out.emplace_back((uint8_t)((group[i] << 4) | group[i + 1]));
+					}
+					else if (width == 3)
+						out.insert(out.end(), group, group + 16);
+				}
+			}
+		}
+
+		return true;
+	}
+
+	//unpacks a byte plane's groups into zigzagged deltas, returns the first byte past the plane or null if it runs past the end
+	static inline const uint8_t* UnpackVertexPlane_Scalar(const uint8_t* data, const uint8_t* end, const size_t& groupCount, uint8_t* deltas)
+	{
+		const uint8_t* header = data;
+		data += (groupCount + 3) / 4;
+		if (data > end)
+			return nullptr;
+
+		for (size_t g = 0; g < groupCount; ++g)
+		{
+			const uint32_t width = (header[g / 4] >> ((g % 4) * 2)) & 3;
+			uint8_t* group = deltas + g * 16;
+			const size_t size = (width == 0 ? 0 : (size_t)2 << width);
+			if ((size_t)(end - data) < size)
+				return nullptr;
+
+			if (width == 0)
+				std::memset(group, 0, 16);
+			else if (width == 1)
+			{
+				for (uint32_t i = 0; i < 4; ++i)
+				{
+					group[i * 4] = data[i] >> 6;
+					group[i * 4 + 1] = (data[i] >> 4) & 3;
+					group[i * 4 + 2] = (data[i] >> 2) & 3;
+					group[i * 4 + 3] = data[i] & 3;
+				}
+			}
+			else if (width == 2)
+			{
+				for (uint32_t i = 0; i < 8; ++i)
+				{
+					group[i * 2] = data[i] >> 4;
+					group[i * 2 + 1] = data[i] & 15;
+				}
+			}
+			else
+				std::memcpy(group, data, 16);
+			data += size;
+		}
+
+		return data;
+	}
+
+	//decodes a vertex stream made by EncodeVertices one byte at a time
+	static inline bool DecodeVertices_Scalar(const uint8_t* data, const size_t& size, uint8_t* vertices, const size_t& vertexCount, const size_t& stride)
+	{
+		if (size < 1 || data[0] != VERTEX_CODEC_VERSION || stride == 0 || stride % 4 != 0 || stride > VERTEX_CODEC_MAX_STRIDE)
+			return false;
+
+		const uint8_t* end = data + size;
+		data++;
+
+		uint8_t last[VERTEX_CODEC_MAX_STRIDE] = {};
+		uint8_t deltas[VERTEX_CODEC_BLOCK_SIZE];
+		for (size_t blockStart = 0; blockStart < vertexCount; blockStart += VERTEX_CODEC_BLOCK_SIZE)
+		{
+			const size_t count = (vertexCount - blockStart < VERTEX_CODEC_BLOCK_SIZE ? vertexCount - blockStart : VERTEX_CODEC_BLOCK_SIZE);
+			uint8_t* block = vertices + blockStart * stride;
+			for (size_t k = 0; k < stride; ++k)
+			{
+				data = UnpackVertexPlane_Scalar(data, end, (count + 15) / 16, deltas);
+				if (!data)
+					return false;
+
+				uint8_t value = last[k];
+				for (size_t i = 0; i < count; ++i)
+				{
+					value = (uint8_t)(value + UnzigzagByte(deltas[i]));
+					block[i * stride + k] = value;
+				}
+				last[k] = value;
+			}
+		}
+
+		return data == end;
+	}
+
+#ifdef SMOK_MESH_CODEC_SSE
+	//stores the 4 byte words of a register into 4 vertices in a row
+	static inline void StoreVertexWords_SSE(uint8_t* out, const size_t& stride, const __m128i& words)
+	{
+		const int32_t w0 = _mm_cvtsi128_si32(words), w1 = _mm_cvtsi128_si32(_mm_shuffle_epi32(words, 0x55)),
+			w2 = _mm_cvtsi128_si32(_mm_shuffle_epi32(words, 0xAA)), w3 = _mm_cvtsi128_si32(_mm_shuffle_epi32(words, 0xFF));
+		std::memcpy(out, &w0, sizeof(w0));
+		std::memcpy(out + stride, &w1, sizeof(w1));
+		std::memcpy(out + stride * 2, &w2, sizeof(w2));
+		std::memcpy(out + stride * 3, &w3, sizeof(w3));
+	}
+
+	//transposes 16 byte planes of 16 vertices each into the vertices, planes are VERTEX_CODEC_BLOCK_SIZE apart
+	static inline void TransposeVertexPlanes16_SSE(const uint8_t* planes, uint8_t* out, const size_t& stride)
+	{
+		__m128i a[16], b[16];
+		for (uint32_t j = 0; j < 16; ++j)
+			a[j] = _mm_load_si128((const __m128i*)(planes + j * VERTEX_CODEC_BLOCK_SIZE));
+
+		//each pass doubles the run of bytes that belong to one vertex, 1 to 2 to 4 to 8 to 16
+		for (uint32_t j = 0; j < 8; ++j)
+		{
+			b[j] = _mm_unpacklo_epi8(a[j * 2], a[j * 2 + 1]);
+			b[j + 8] = _mm_unpackhi_epi8(a[j * 2], a[j * 2 + 1]);
+		}
+		for (uint32_t j = 0; j < 4; ++j)
+		{
+			a[j] = _mm_unpacklo_epi16(b[j * 2], b[j * 2 + 1]);
+			a[j + 4] = _mm_unpackhi_epi16(b[j * 2], b[j * 2 + 1]);
+			a[j + 8] = _mm_unpacklo_epi16(b[j * 2 + 8], b[j * 2 + 9]);
+			a[j + 12] = _mm_unpackhi_epi16(b[j * 2 + 8], b[j * 2 + 9]);
+		}
+		for (uint32_t j = 0; j < 16; j += 4)
+		{
+			b[j] = _mm_unpacklo_epi32(a[j], a[j + 1]);
+			b[j + 1] = _mm_unpackhi_epi32(a[j], a[j + 1]);
+			b[j + 2] = _mm_unpacklo_epi32(a[j + 2], a[j + 3]);
+			b[j + 3] = _mm_unpackhi_epi32(a[j + 2], a[j + 3]);
+		}
+		for (uint32_t j = 0; j < 16; j += 4)
+		{
+			_mm_storeu_si128((__m128i*)(out + (j + 0) * stride), _mm_unpacklo_epi64(b[j], b[j + 2]));
+			_mm_storeu_si128((__m128i*)(out + (j + 1) * stride), _mm_unpackhi_epi64(b[j], b[j + 2]));
+			_mm_storeu_si128((__m128i*)(out + (j + 2) * stride), _mm_unpacklo_epi64(b[j + 1], b[j + 3]));
+			_mm_storeu_si128((__m128i*)(out + (j + 3) * stride), _mm_unpackhi_epi64(b[j + 1], b[j + 3]));
+		}
+	}
+
+	//decodes a vertex stream made by EncodeVertices with SSE2
+	//each group is unpacked, unzigzagged and prefix summed in registers, then 4 byte planes at a time are transposed back into 16 vertices
+	static inline bool DecodeVertices_SSE(const uint8_t* data, const size_t& size, uint8_t* vertices, const size_t& vertexCount, const size_t& stride)
+	{
+		if (size < 1 || data[0] != VERTEX_CODEC_VERSION || stride == 0 || stride % 4 != 0 || stride > VERTEX_CODEC_MAX_STRIDE)
+			return false;
+
+		const uint8_t* end = data + size;
+		data++;
+
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i one = _mm_set1_epi8(1);
+		const __m128i lowBits7 = _mm_set1_epi8(0x7F);
+		const __m128i lowBits4 = _mm_set1_epi8(0x0F);
+		const __m128i lowBits2 = _mm_set1_epi8(0x03);
+
+		//the decoded planes of a block, plane k's vertex i is at k * VERTEX_CODEC_BLOCK_SIZE + i
+		std::vector<uint8_t> scratch(stride * VERTEX_CODEC_BLOCK_SIZE + 15);
+		uint8_t* planes = (uint8_t*)(((uintptr_t)scratch.data() + 15) & ~(uintptr_t)15);
+
+		uint8_t last[VERTEX_CODEC_MAX_STRIDE] = {};
+		for (size_t blockStart = 0; blockStart < vertexCount; blockStart += VERTEX_CODEC_BLOCK_SIZE)
+		{
+			const size_t count = (vertexCount - blockStart < VERTEX_CODEC_BLOCK_SIZE ? vertexCount - blockStart : VERTEX_CODEC_BLOCK_SIZE);
+			const size_t groupCount = (count + 15) / 16;
+			for (size_t k = 0; k < stride; ++k)
+			{
+				const uint8_t* header = data;
+				data += (groupCount + 3) / 4;
+				if (data > end)
+					return false;
+
+				__m128i carry = _mm_set1_epi8((char)last[k]);
+				uint8_t* plane = planes + k * VERTEX_CODEC_BLOCK_SIZE;
+				for (size_t g = 0; g < groupCount; ++g)
+				{
+					const uint32_t width = (header[g / 4] >> ((g % 4) * 2)) & 3;
+					const size_t groupSize = (width == 0 ? 0 : (size_t)2 << width);
+					if ((size_t)(end - data) < groupSize)
+						return false;
+
+					__m128i group;
+					if (width == 0)
+						group = zero;
+					else if (width == 1)
+					{
+						int32_t packed;
+						std::memcpy(&packed, data, sizeof(packed));
+						const __m128i bytes = _mm_cvtsi32_si128(packed);
+						const __m128i nibbles = _mm_unpacklo_epi8(_mm_and_si128(_mm_srli_epi16(bytes, 4), lowBits4), _mm_and_si128(bytes, lowBits4));
+						group = _mm_unpacklo_epi8(_mm_and_si128(_mm_srli_epi16(nibbles, 2), lowBits2), _mm_and_si128(nibbles, lowBits2));
+					}
+					else if (width == 2)
+					{
+						const __m128i bytes = _mm_loadl_epi64((const __m128i*)data);
+						group = _mm_unpacklo_epi8(_mm_and_si128(_mm_srli_epi16(bytes, 4), lowBits4), _mm_and_si128(bytes, lowBits4));
+					}
+					else
+						group = _mm_loadu_si128((const __m128i*)data);
+					data += groupSize;
+
+					//unzigzags then sums the deltas across the 16 lanes, carrying the last vertex's byte in
+					group = _mm_xor_si128(_mm_and_si128(_mm_srli_epi16(group, 1), lowBits7), _mm_sub_epi8(zero, _mm_and_si128(group, one)));
+					group = _mm_add_epi8(group, _mm_slli_si128(group, 1));
+					group = _mm_add_epi8(group, _mm_slli_si128(group, 2));
+					group = _mm_add_epi8(group, _mm_slli_si128(group, 4));
+					group = _mm_add_epi8(group, _mm_slli_si128(group, 8));
+					group = _mm_add_epi8(group, carry);
+					_mm_store_si128((__m128i*)(plane + g * 16), group);
+
+					//broadcasts lane 15 for the next group
+					carry = _mm_unpackhi_epi8(group, group);
+					carry = _mm_shufflehi_epi16(carry, 0xFF);
+					carry = _mm_unpackhi_epi64(carry, carry);
+				}
+				last[k] = plane[count - 1];
+			}
+
+			//transposes 16 planes x 16 vertices into 16 vertices x 16 bytes, what is left of the stride is done 4 planes at a time
+			uint8_t* block = vertices + blockStart * stride;
+			const size_t fullCount = count & ~(size_t)15;
+			for (size_t i = 0; i < fullCount; i += 16)
+			{
+				size_t k = 0;
+				for (; k + 16 <= stride; k += 16)
+					TransposeVertexPlanes16_SSE(planes + k * VERTEX_CODEC_BLOCK_SIZE + i, block + i * stride + k, stride);
+
+				for (; k < stride; k += 4)
+				{
+					const __m128i p0 = _mm_load_si128((const __m128i*)(planes + k * VERTEX_CODEC_BLOCK_SIZE + i));
+					const __m128i p1 = _mm_load_si128((const __m128i*)(planes + (k + 1) * VERTEX_CODEC_BLOCK_SIZE + i));
+					const __m128i p2 = _mm_load_si128((const __m128i*)(planes + (k + 2) * VERTEX_CODEC_BLOCK_SIZE + i));
+					const __m128i p3 = _mm_load_si128((const __m128i*)(planes + (k + 3) * VERTEX_CODEC_BLOCK_SIZE + i));
+					const __m128i t0 = _mm_unpacklo_epi8(p0, p1), t1 = _mm_unpackhi_epi8(p0, p1);
+					const __m128i t2 = _mm_unpacklo_epi8(p2, p3), t3 = _mm_unpackhi_epi8(p2, p3);
+
+					uint8_t* out = block + i * stride + k;
+					StoreVertexWords_SSE(out, stride, _mm_unpacklo_epi16(t0, t2));
+					StoreVertexWords_SSE(out + 4 * stride, stride, _mm_unpackhi_epi16(t0, t2));
+					StoreVertexWords_SSE(out + 8 * stride, stride, _mm_unpacklo_epi16(t1, t3));
+					StoreVertexWords_SSE(out + 12 * stride, stride, _mm_unpackhi_epi16(t1, t3));
+				}
+			}
+
+			//the vertices past the last full group
+			for (size_t i = fullCount; i < count; ++i)
+			{
+				for (size_t k = 0; k < stride; ++k)
+					block[i * stride + k] = planes[k * VERTEX_CODEC_BLOCK_SIZE + i];
+			}
+		}
+
+		return data == end;
+	}
+#endif
+
+	//gets if a vertex stream of size bytes could hold vertexCount vertices, every byte plane of a block costs at least it's group widths
+	//check it before allocating the output so a bad count can't ask for more memory than the stream could fill
+	static inline bool VertexStreamCanHold(const size_t& size, const uint64_t& vertexCount, const size_t& stride)
+	{
+		if (size < 1 || stride == 0 || stride > VERTEX_CODEC_MAX_STRIDE)
+			return false;
+
+		//a full block has VERTEX_CODEC_BLOCK_SIZE / 16 groups, so 4 width bytes per plane
+		const uint64_t fullBlocks = vertexCount / VERTEX_CODEC_BLOCK_SIZE;
+		const uint64_t lastBlockCount = vertexCount % VERTEX_CODEC_BLOCK_SIZE;
+		const uint64_t fullBlockSize = stride * ((VERTEX_CODEC_BLOCK_SIZE / 16 + 3) / 4);
+		const uint64_t lastBlockSize = (lastBlockCount == 0 ? 0 : stride * (((lastBlockCount + 15) / 16 + 3) / 4));
+		if (size - 1 < lastBlockSize || fullBlocks > (size - 1 - lastBlockSize) / fullBlockSize)
+			return false;
+
+		return vertexCount <= SIZE_MAX / stride;
+	}
+
+	//decodes a vertex stream made by EncodeVertices with the best path for this build, vertexCount and stride must be what was encoded
+	//returns false if the stream is truncated, has bytes left over or is not a vertex stream
+	static inline bool DecodeVertices(const uint8_t* data, const size_t& size, uint8_t* vertices, const size_t& vertexCount, const size_t& stride)
+	{
+#ifdef SMOK_MESH_CODEC_SSE
+		return DecodeVertices_SSE(data, size, vertices, vertexCount, stride);
+#else
+		return DecodeVertices_Scalar(data, size, vertices, vertexCount, stride);
+#endif
+	}
+}
\ No newline at end of file
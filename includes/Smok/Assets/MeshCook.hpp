@@ -0,0 +1,431 @@
+#pragma once
+
+//defines the offline cook step for static meshes, source smesh files are welded, given LODs, optimized, split into meshlets and written in their final vertex layout
+//every output is keyed on a hash of it's source data and cook settings, cooked artifacts are kept in a cache folder so a unchanged mesh is never cooked twice
+//a manifest remembers the size and write time of every source, so a output whose source and settings have not changed is skipped without reading anything
+
+#include <Smok/Assets/AssetID.hpp>
+#include <Smok/Assets/Mesh.hpp>
+#include <Smok/Assets/SmeshBinary.hpp>
+#include <Smok/Assets/MeshCodec.hpp>
+#include <Smok/Assets/VertexWeld.hpp>
+#include <Smok/Assets/MeshSimplify.hpp>
+#include <Smok/Assets/MeshOptimize.hpp>
+#include <Smok/Assets/MeshletBuild.hpp>
+#include <Smok/IO/BulkFileReader.hpp>
+#include <Smok/Profiling/Profiler.hpp>
+
+#include <BTDSTD/Formats/json.hpp>
+#include <BTDSTD/IO/FileInfo.hpp>
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Smok::Asset::Mesh
+{
+	//the version of the cook step, bump it whenever cooking changes so every cached artifact is made again
+	static constexpr uint32_t MESH_COOK_VERSION = 1;
+
+	//defines the settings a static mesh is cooked with, every field is part of the cache key
+	struct MeshCookSettings
+	{
+		VertexLayout vertexLayout = VertexLayout::Float; //the layout the vertices are written in
+
+		bool weldVertices = false; //deduplicates the vertices, see "WeldStaticMesh"
+		WeldSettings weldSettings;
+
+		bool generateLODs = false; //replaces the source's LODs with generated ones, see "GenerateStaticMeshLODs"
+		LODGenerationSettings LODSettings;
+
+		bool optimize = false; //reorders the indices and vertices for the vertex cache, overdraw and fetch, see "OptimizeStaticMesh"
+		MeshOptimizeSettings optimizeSettings;
+
+		bool buildMeshlets = false; //splits every sub-mesh into meshlets with culling data, see "BuildStaticMeshMeshlets"
+		MeshletSettings meshletSettings;
+
+		uint32_t encoding = MeshEncoding_None; //the MeshEncoding flags for the streams to compress, see "Smok/Assets/MeshCodec.hpp"
+
+		//hashes the settings, the smesh and codec versions are in it too so a format change cooks everything again
+		inline uint64_t Hash() const
+		{
+			std::string key;
+			auto add = [&](const auto& value) { key.append((const char*)&value, sizeof(value)); };
+			add(MESH_COOK_VERSION);
+			add(Binary::SMESH_BINARY_VERSION);
+			add(Codec::INDEX_CODEC_VERSION);
+			add(Codec::VERTEX_CODEC_VERSION);
+			add(vertexLayout);
+			add(weldVertices);
+			if (weldVertices)
+			{
+				add(weldSettings.positionEpsilon);
+				add(weldSettings.normalEpsilon);
+				add(weldSettings.colorEpsilon);
+				add(weldSettings.textureCoordsEpsilon);
+			}
+			add(generateLODs);
+			if (generateLODs)
+			{
+				add((uint64_t)LODSettings.targetRatios.size()); //so ratios moving between fields never hash the same
+				for (const float& ratio : LODSettings.targetRatios)
+					add(ratio);
+				add(LODSettings.maxError);
+				add(LODSettings.minReduction);
+				add(LODSettings.lockBorders);
+			}
+			add(optimize);
+			if (optimize)
+			{
+				add(optimizeSettings.cacheSize);
+				add(optimizeSettings.optimizeOverdraw);
+				add(optimizeSettings.overdrawThreshold);
+				add(optimizeSettings.optimizeVertexFetch);
+			}
+			add(buildMeshlets);
+			if (buildMeshlets)
+			{
+				add(meshletSettings.maxVertices);
+				add(meshletSettings.maxTriangles);
+				add(meshletSettings.coneWeight);
+			}
+			add(encoding);
+			return HashAssetName(key);
+		}
+	};
+
+	//defines a mesh to cook
+	struct MeshCookJob
+	{
+		BTD::IO::FileInfo sourceDeclFile; //only read if the source binary is v1
+		BTD::IO::FileInfo sourceBinaryFile;
+
+		BTD::IO::FileInfo outputDeclFile;
+		BTD::IO::FileInfo outputBinaryFile;
+
+		MeshCookSettings settings;
+	};
+
+	//defines the results of a cook
+	struct MeshCookStats
+	{
+		size_t upToDate = 0; //outputs whose source and settings have not changed, nothing was read
+		size_t cacheHits = 0; //outputs copied from a artifact already in the cache
+		size_t cooked = 0; //outputs cooked and added to the cache
+		size_t failed = 0;
+
+		uint64_t bytesRead = 0; //the source data read to hash or cook
+		double milliseconds = 0.0;
+	};
+
+	//defines what the cooker remembers about a output between runs
+	struct MeshCookRecord
+	{
+		uint64_t sourceSize = 0;
+		int64_t sourceWriteTime = 0;
+		uint64_t declSize = 0; //only kept for v1 sources, their decl is part of the key
+		int64_t declWriteTime = 0;
+		uint64_t settingsHash = 0;
+		uint64_t key = 0; //the cache key the output was made from
+	};
+
+	//defines a incremental mesh cooker
+	struct MeshCooker
+	{
+		std::string cacheDirectory; //where the cooked artifacts and the manifest live
+		uint32_t threadCount = 0; //the threads cooking, 0 uses every hardware thread
+
+		std::unordered_map<std::string, MeshCookRecord> records; //by the output binary's path
+		std::mutex recordsMutex;
+
+		//inits the cooker, loading the manifest of the last cook if there is one
+		inline bool Init(const std::string& _cacheDirectory)
+		{
+			cacheDirectory = _cacheDirectory;
+			records.clear();
+
+			std::error_code error;
+			std::filesystem::create_directories(cacheDirectory, error);
+			if (error)
+			{
+				fmt::print("Smok Asset Mesh Error: MeshCooker || Init || Failed to create the cache folder \"{}\", {}.\n", cacheDirectory, error.message());
+				return false;
+			}
+
+			//no manifest is a normal first cook, a bad one just means every output is checked again
+			std::ifstream file(GetManifestPath());
+			if (!file.is_open())
+				return true;
+
+			const nlohmann::json manifest = nlohmann::json::parse(file, nullptr, false);
+			if (manifest.is_discarded() || !manifest.is_object() || manifest.value("version", 0u) != MESH_COOK_VERSION || !manifest.contains("outputs"))
+			{
+				fmt::print("Smok Asset Mesh Warning: MeshCooker || Init || \"{}\" is from a different version or is corrupt, every output will be checked.\n", GetManifestPath());
+				return true;
+			}
+
+			for (auto& output : manifest["outputs"].items())
+			{
+				const nlohmann::json& values = output.value();
+				if (!values.is_array() || values.size() != 6)
+					continue;
+
+				MeshCookRecord& record = records[output.key()];
+				record.sourceSize = values[0];
+				record.sourceWriteTime = values[1];
+				record.declSize = values[2];
+				record.declWriteTime = values[3];
+				record.settingsHash = values[4];
+				record.key = values[5];
+			}
+
+			return true;
+		}
+
+		//saves the manifest, "Cook" calls this once it's done
+		inline bool SaveManifest()
+		{
+			nlohmann::json manifest;
+			manifest["version"] = MESH_COOK_VERSION;
+			manifest["outputs"] = nlohmann::json::object();
+			for (auto& record : records)
+			{
+				const MeshCookRecord& r = record.second;
+				manifest["outputs"][record.first] = { r.sourceSize, r.sourceWriteTime, r.declSize, r.declWriteTime, r.settingsHash, r.key };
+			}
+
+			//written to a temp file first so a cook killed part way keeps the old manifest
+			const std::string path = GetManifestPath();
+			{
+				std::ofstream file(path + ".tmp", std::ios::trunc);
+				file << manifest.dump();
+				if (!file.good())
+				{
+					fmt::print("Smok Asset Mesh Error: MeshCooker || SaveManifest || Failed to write \"{}\".\n", path);
+					return false;
+				}
+			}
+
+			std::error_code error;
+			std::filesystem::rename(path + ".tmp", path, error);
+			return !error;
+		}
+
+		//cooks every job whose source or settings changed since the last cook
+		//sources are read in one batch and cooked across threadCount threads as they arrive, every output is written straight to disk
+		inline MeshCookStats Cook(const std::vector<MeshCookJob>& jobs)
+		{
+			SMOK_PROFILE_ZONE("MeshCooker::Cook");
+			const auto start = std::chrono::high_resolution_clock::now();
+			MeshCookStats stats;
+
+			//skips outputs that are up to date without reading their source
+			std::vector<size_t> pending;
+			std::vector<MeshCookRecord> stamps(jobs.size());
+			for (size_t j = 0; j < jobs.size(); ++j)
+			{
+				const MeshCookJob& job = jobs[j];
+				MeshCookRecord& stamp = stamps[j];
+				if (!GetFileStamp(job.sourceBinaryFile.GetPathStr(), stamp.sourceSize, stamp.sourceWriteTime))
+				{
+					fmt::print("Smok Asset Mesh Error: MeshCooker || Cook || \"{}\" does not exist.\n", job.sourceBinaryFile.GetPathStr());
+					stats.failed++;
+					continue;
+				}
+				GetFileStamp(job.sourceDeclFile.GetPathStr(), stamp.declSize, stamp.declWriteTime);
+				stamp.settingsHash = job.settings.Hash();
+
+				auto record = records.find(job.outputBinaryFile.GetPathStr());
+				if (record != records.end() && record->second.sourceSize == stamp.sourceSize && record->second.sourceWriteTime == stamp.sourceWriteTime &&
+					(record->second.declSize == 0 || (record->second.declSize == stamp.declSize && record->second.declWriteTime == stamp.declWriteTime)) &&
+					record->second.settingsHash == stamp.settingsHash && job.outputBinaryFile.Exists() && job.outputDeclFile.Exists())
+				{
+					stats.upToDate++;
+					continue;
+				}
+
+				pending.emplace_back(j);
+			}
+
+			std::vector<std::string> paths(pending.size());
+			for (size_t p = 0; p < pending.size(); ++p)
+				paths[p] = jobs[pending[p]].sourceBinaryFile.GetPathStr();
+
+			IO::BulkFileReader reader;
+			std::vector<IO::BulkReadResult> sources;
+			std::atomic<size_t> cacheHits = 0, cooked = 0, failed = 0;
+			const IO::BulkReadStats readStats = reader.ReadAndProcessFiles(paths, sources, [&](const size_t& p) {
+				const MeshCookJob& job = jobs[pending[p]];
+				MeshCookRecord stamp = stamps[pending[p]];
+				IO::BulkReadResult& source = sources[p];
+				SMOK_PROFILE_ZONE("MeshCooker::CookJob");
+
+				bool succeeded = false, wasCooked = false;
+				if (source.succeeded)
+				{
+					//v2 decls are only a summary of the binary, so only v1 decls are part of the key
+					std::string declText;
+					if (!Serilize::BinaryDataIsV2(source.data.get(), source.size))
+					{
+						std::ifstream declFile(job.sourceDeclFile.GetPathStr(), std::ios::binary);
+						declText.assign(std::istreambuf_iterator<char>(declFile), std::istreambuf_iterator<char>());
+					}
+					else
+					{
+						stamp.declSize = 0;
+						stamp.declWriteTime = 0;
+					}
+
+					stamp.key = HashCookKey(HashAssetName(std::string_view((const char*)source.data.get(), source.size)), HashAssetName(declText), stamp.settingsHash);
+					wasCooked = !ArtifactExists(stamp.key);
+					succeeded = (!wasCooked || CookArtifact(job, declText, source, stamp.key)) && CopyArtifact(job, stamp.key);
+				}
+				source.data.reset();
+
+				if (!succeeded)
+				{
+					failed++;
+					return;
+				}
+
+				(wasCooked ? cooked : cacheHits)++;
+				std::lock_guard<std::mutex> lock(recordsMutex);
+				records[job.outputBinaryFile.GetPathStr()] = stamp;
+			}, threadCount);
+
+			stats.cacheHits = cacheHits;
+			stats.cooked = cooked;
+			stats.failed += failed;
+			stats.bytesRead = readStats.bytesRead;
+			SaveManifest();
+
+			stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			return stats;
+		}
+
+		//---internal
+
+		//gets the path of the manifest
+		inline std::string GetManifestPath() const { return (std::filesystem::path(cacheDirectory) / "MeshCook.manifest").string(); }
+
+		//gets the path of a cached artifact
+		inline std::string GetArtifactPath(const uint64_t& key, const std::string& extension) const
+		{
+			return (std::filesystem::path(cacheDirectory) / fmt::format("{:016x}.{}", key, extension)).string();
+		}
+
+		//does the cache have a artifact
+		inline bool ArtifactExists(const uint64_t& key) const
+		{
+			std::error_code error;
+			return std::filesystem::exists(GetArtifactPath(key, Serilize::GetSmeshBinaryFileExtensionStr()), error) &&
+				std::filesystem::exists(GetArtifactPath(key, Serilize::GetSmeshDeclFileExtensionStr()), error);
+		}
+
+		//gets the size and write time of a file, false if it does not exist
+		static inline bool GetFileStamp(const std::string& path, uint64_t& size, int64_t& writeTime)
+		{
+			std::error_code error;
+			size = std::filesystem::file_size(path, error);
+			if (error)
+			{
+				size = 0;
+				writeTime = 0;
+				return false;
+			}
+
+			writeTime = (int64_t)std::filesystem::last_write_time(path, error).time_since_epoch().count();
+			return !error;
+		}
+
+		//combines the hashes making up a cache key
+		static inline uint64_t HashCookKey(const uint64_t& sourceHash, const uint64_t& declHash, const uint64_t& settingsHash)
+		{
+			const uint64_t hashes[3] = { sourceHash, declHash, settingsHash };
+			return HashAssetName(std::string_view((const char*)hashes, sizeof(hashes)));
+		}
+
+		//cooks a source into the cache, it's written under a temp name and renamed so a artifact is never seen half written
+		inline bool CookArtifact(const MeshCookJob& job, const std::string& declText, const IO::BulkReadResult& source, const uint64_t& key)
+		{
+			SMOK_PROFILE_ZONE("MeshCooker::CookArtifact");
+
+			StaticMesh mesh;
+			if (!Serilize::LoadStaticMeshDataFromMemory(declText, source.data.get(), source.size, job.sourceBinaryFile.GetPathStr(), mesh))
+				return false;
+
+			if (job.settings.weldVertices || job.settings.generateLODs)
+			{
+				//welding works on float vertices, they are packed again when written
+				if (mesh.vertexLayout != VertexLayout::Float)
+					UnpackStaticMesh(mesh);
+				if (job.settings.weldVertices)
+					WeldStaticMesh(mesh, job.settings.weldSettings);
+				if (job.settings.generateLODs)
+					GenerateStaticMeshLODs(mesh, job.settings.LODSettings);
+			}
+
+			//runs after LODs so the generated indices are ordered too, meshlets go last so they are built from the final indices
+			if (job.settings.optimize)
+				OptimizeStaticMesh(mesh, job.settings.optimizeSettings);
+			if (job.settings.buildMeshlets)
+				BuildStaticMeshMeshlets(mesh, job.settings.meshletSettings);
+
+			const std::string tempName = fmt::format("{:016x}.{}", key, std::hash<std::thread::id>()(std::this_thread::get_id()));
+			const std::filesystem::path tempDecl = std::filesystem::path(cacheDirectory) / (tempName + "." + Serilize::GetSmeshDeclFileExtensionStr());
+			const std::filesystem::path tempBinary = std::filesystem::path(cacheDirectory) / (tempName + "." + Serilize::GetSmeshBinaryFileExtensionStr());
+			if (!Serilize::WriteStaticMeshDataToFile(BTD::IO::FileInfo(tempDecl.string()), BTD::IO::FileInfo(tempBinary.string()), mesh, job.settings.vertexLayout, job.settings.encoding))
+				return false;
+
+			//the binary goes last as it's what "ArtifactExists" sees first
+			std::error_code error;
+			std::filesystem::rename(tempDecl, GetArtifactPath(key, Serilize::GetSmeshDeclFileExtensionStr()), error);
+			if (!error)
+				std::filesystem::rename(tempBinary, GetArtifactPath(key, Serilize::GetSmeshBinaryFileExtensionStr()), error);
+			if (error)
+			{
+				fmt::print("Smok Asset Mesh Error: MeshCooker || CookArtifact || Failed to move \"{}\" into the cache, {}.\n", tempBinary.string(), error.message());
+				std::filesystem::remove(tempDecl, error);
+				std::filesystem::remove(tempBinary, error);
+				return false;
+			}
+
+			return true;
+		}
+
+		//copies a cached artifact to a job's outputs
+		inline bool CopyArtifact(const MeshCookJob& job, const uint64_t& key)
+		{
+			std::error_code error;
+			for (const std::filesystem::path& output : { std::filesystem::path(job.outputDeclFile.GetPathStr()), std::filesystem::path(job.outputBinaryFile.GetPathStr()) })
+			{
+				if (output.has_parent_path())
+					std::filesystem::create_directories(output.parent_path(), error);
+			}
+
+			std::filesystem::copy_file(GetArtifactPath(key, Serilize::GetSmeshDeclFileExtensionStr()), job.outputDeclFile.GetPathStr(),
+				std::filesystem::copy_options::overwrite_existing, error);
+			if (!error)
+				std::filesystem::copy_file(GetArtifactPath(key, Serilize::GetSmeshBinaryFileExtensionStr()), job.outputBinaryFile.GetPathStr(),
+					std::filesystem::copy_options::overwrite_existing, error);
+			if (error)
+			{
+				fmt::print("Smok Asset Mesh Error: MeshCooker || CopyArtifact || Failed to copy the cooked \"{}\" to \"{}\", {}.\n",
+					job.sourceBinaryFile.GetPathStr(), job.outputBinaryFile.GetPathStr(), error.message());
+				return false;
+			}
+
+			return true;
+		}
+	};
+}
\ No newline at end of file
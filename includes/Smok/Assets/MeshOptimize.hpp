@@ -0,0 +1,413 @@
+#pragma once
+
+//defines the cook time index and vertex ordering passes for Smok meshes
+//triangles are reordered for the post-transform vertex cache with Tipsify, the cache friendly clusters are then sorted so outer facing geometry draws first to cut overdraw
+//last the shared vertices are remapped into the order the indices first use them, so vertex fetch walks memory forward
+//a FIFO cache simulator gives the ACMR and ATVR before and after, so the passes can be measured without a GPU
+
+#include <Smok/Assets/Mesh.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace Smok::Asset::Mesh
+{
+	//the cache size most desktop GPUs behave like, used when nothing else is given
+	static constexpr uint32_t VERTEX_CACHE_DEFAULT_SIZE = 16;
+
+	//defines the results of running indices through the cache simulator
+	struct VertexCacheStats
+	{
+		size_t triangleCount = 0; //the number of triangles drawn
+		size_t vertexCount = 0; //the number of unique vertices the triangles use
+		size_t transformCount = 0; //the number of times a vertex missed the cache and was shaded
+
+		float ACMR = 0.0f; //average cache miss ratio, transforms per triangle, 0.5 is the best a regular grid gets and 3.0 is no reuse at all
+		float ATVR = 0.0f; //average transform to vertex ratio, transforms per unique vertex, 1.0 is perfect
+	};
+
+	//defines the settings for optimizing a static mesh
+	struct MeshOptimizeSettings
+	{
+		uint32_t cacheSize = VERTEX_CACHE_DEFAULT_SIZE; //the FIFO cache size the triangles are ordered for
+
+		bool optimizeOverdraw = true; //sorts the cache clusters so outer facing geometry draws first
+		float overdrawThreshold = 1.05f; //how much worse the ACMR is allowed to get so the clusters can be split smaller, 1.0 keeps the cache order as is
+
+		bool optimizeVertexFetch = true; //remaps the vertices into the order they are first used, vertices no sub-mesh uses are dropped
+	};
+
+	//defines the results of optimizing a static mesh, the cache stats are summed over every sub-mesh
+	struct MeshOptimizeStats
+	{
+		VertexCacheStats before;
+		VertexCacheStats after;
+
+		size_t clusterCount = 0; //the number of clusters the overdraw pass sorted
+		size_t droppedVertexCount = 0; //the number of vertices no sub-mesh used
+	};
+
+	//runs indices through a FIFO post-transform cache, counting every vertex that misses
+	static inline VertexCacheStats SimulateVertexCache(const uint32_t* indices, const size_t& indexCount, const size_t& vertexCount,
+		const uint32_t& cacheSize = VERTEX_CACHE_DEFAULT_SIZE)
+	{
+		VertexCacheStats stats;
+		stats.triangleCount = indexCount / 3;
+
+		//a vertex is in the cache while fewer than cacheSize misses have happened since it was loaded
+		std::vector<uint32_t> timestamps(vertexCount, 0);
+		uint32_t time = cacheSize + 1;
+		for (size_t i = 0; i < stats.triangleCount * 3; ++i)
+		{
+			const uint32_t index = indices[i];
+			if (index >= vertexCount)
+				continue;
+
+			if (timestamps[index] == 0)
+				stats.vertexCount++;
+			if (time - timestamps[index] > cacheSize)
+			{
+				timestamps[index] = time++;
+				stats.transformCount++;
+			}
+		}
+
+		stats.ACMR = (stats.triangleCount == 0 ? 0.0f : (float)stats.transformCount / (float)stats.triangleCount);
+		stats.ATVR = (stats.vertexCount == 0 ? 0.0f : (float)stats.transformCount / (float)stats.vertexCount);
+		return stats;
+	}
+
+	//adds cache stats together, the ratios are rebuilt from the sums
+	static inline void AddVertexCacheStats(VertexCacheStats& total, const VertexCacheStats& stats)
+	{
+		total.triangleCount += stats.triangleCount;
+		total.vertexCount += stats.vertexCount;
+		total.transformCount += stats.transformCount;
+		total.ACMR = (total.triangleCount == 0 ? 0.0f : (float)total.transformCount / (float)total.triangleCount);
+		total.ATVR = (total.vertexCount == 0 ? 0.0f : (float)total.transformCount / (float)total.vertexCount);
+	}
+
+	//reorders triangles for the post-transform cache with Tipsify, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw", Sander et al. 2007
+	//fans around a vertex until it's triangles are used up, then moves to the cached vertex that will stay in the cache longest
+	//if hardBoundaries is given it gets the first triangle of every run that had to restart away from the cache, these are where the overdraw pass may cut clusters
+	static inline void OptimizeVertexCache(const uint32_t* indices, const size_t& indexCount, const size_t& vertexCount, std::vector<uint32_t>& outIndices,
+		const uint32_t& cacheSize = VERTEX_CACHE_DEFAULT_SIZE, std::vector<uint32_t>* hardBoundaries = nullptr)
+	{
+		const size_t triangleCount = indexCount / 3;
+		outIndices.clear();
+		outIndices.reserve(triangleCount * 3);
+		if (hardBoundaries)
+			hardBoundaries->clear();
+		if (triangleCount == 0 || vertexCount == 0)
+			return;
+
+		//builds the triangles around every vertex, flat with a offset per vertex
+		std::vector<uint32_t> liveTriangles(vertexCount, 0);
+		for (size_t i = 0; i < triangleCount * 3; ++i)
+		{
+			if (indices[i] >= vertexCount)
+			{
+				fmt::print("Smok Asset Mesh Error: OptimizeVertexCache || Index {} is past the {} vertices, the indices were left as is.\n", indices[i], vertexCount);
+				outIndices.assign(indices, indices + triangleCount * 3);
+				return;
+			}
+			liveTriangles[indices[i]]++;
+		}
+
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+		for (size_t v = 0; v < vertexCount; ++v)
+			adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+		std::vector<uint32_t> adjacency(adjacencyOffsets[vertexCount]);
+		{
+			std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t t = 0; t < triangleCount; ++t)
+			{
+				for (uint32_t c = 0; c < 3; ++c)
+					adjacency[fill[indices[t * 3 + c]]++] = (uint32_t)t;
+			}
+		}
+
+		std::vector<uint32_t> timestamps(vertexCount, 0);
+		std::vector<uint8_t> emitted(triangleCount, 0);
+		std::vector<uint32_t> deadEnds; //vertices that were touched recently, used to restart near the cache
+		std::vector<uint32_t> candidates;
+		uint32_t time = cacheSize + 1;
+		size_t cursor = 0; //where the in order scan for a unused vertex picks up
+
+		int64_t fanning = 0;
+		bool restarted = true;
+		while (fanning >= 0)
+		{
+			//emits every triangle left around the fanning vertex
+			candidates.clear();
+			for (uint32_t a = adjacencyOffsets[fanning]; a < adjacencyOffsets[fanning + 1]; ++a)
+			{
+				const uint32_t t = adjacency[a];
+				if (emitted[t])
+					continue;
+
+				if (restarted && hardBoundaries)
+					hardBoundaries->emplace_back((uint32_t)(outIndices.size() / 3));
+				restarted = false;
+
+				for (uint32_t c = 0; c < 3; ++c)
+				{
+					const uint32_t v = indices[t * 3 + c];
+					outIndices.emplace_back(v);
+					deadEnds.emplace_back(v);
+					candidates.emplace_back(v);
+					liveTriangles[v]--;
+					if (time - timestamps[v] > cacheSize)
+						timestamps[v] = time++;
+				}
+				emitted[t] = 1;
+			}
+
+			//picks the candidate that will still be cached after it's remaining triangles are drawn, the oldest one wins
+			int64_t next = -1;
+			int64_t bestPriority = -1;
+			for (const uint32_t v : candidates)
+			{
+				if (liveTriangles[v] == 0)
+					continue;
+
+				int64_t priority = 0;
+				if ((int64_t)time - (int64_t)timestamps[v] + 2 * (int64_t)liveTriangles[v] <= (int64_t)cacheSize)
+					priority = (int64_t)time - (int64_t)timestamps[v];
+				if (priority > bestPriority)
+				{
+					bestPriority = priority;
+					next = v;
+				}
+			}
+
+			//dead end, walks back through recently used vertices then scans for anything left
+			if (next == -1)
+			{
+				while (!deadEnds.empty())
+				{
+					const uint32_t v = deadEnds.back();
+					deadEnds.pop_back();
+					if (liveTriangles[v] > 0)
+					{
+						next = v;
+						break;
+					}
+				}
+
+				if (next == -1)
+				{
+					while (cursor < vertexCount && liveTriangles[cursor] == 0)
+						cursor++;
+					if (cursor < vertexCount)
+						next = (int64_t)cursor;
+				}
+
+				restarted = true;
+			}
+
+			fanning = next;
+		}
+	}
+
+	//sorts the cache clusters of already cache optimized indices so geometry facing out from the mesh's center draws first, hiding what's behind it
+	//the hard boundaries from OptimizeVertexCache are split further where the ACMR up to that point stays within the threshold of the cluster's own ACMR
+	//returns the number of clusters sorted
+	static inline size_t OptimizeOverdraw(const uint32_t* indices, const size_t& indexCount, const Vertex* vertices, const size_t& vertexCount,
+		const std::vector<uint32_t>& hardBoundaries, std::vector<uint32_t>& outIndices, const uint32_t& cacheSize = VERTEX_CACHE_DEFAULT_SIZE, const float& threshold = 1.05f)
+	{
+		const size_t triangleCount = indexCount / 3;
+		outIndices.assign(indices, indices + triangleCount * 3);
+		if (triangleCount == 0 || hardBoundaries.empty())
+			return 0;
+
+		//splits every hard cluster where restarting the cache would cost little
+		std::vector<uint32_t> clusters;
+		std::vector<uint32_t> timestamps(vertexCount, 0);
+		uint32_t time = cacheSize + 1;
+		auto missCount = [&](const size_t& t) {
+			uint32_t misses = 0;
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				const uint32_t v = indices[t * 3 + c];
+				if (time - timestamps[v] > cacheSize)
+				{
+					timestamps[v] = time++;
+					misses++;
+				}
+			}
+			return misses;
+		};
+		auto flushCache = [&]() { time += cacheSize + 1; };
+
+		for (size_t h = 0; h < hardBoundaries.size(); ++h)
+		{
+			const size_t start = hardBoundaries[h];
+			const size_t end = (h + 1 < hardBoundaries.size() ? hardBoundaries[h + 1] : triangleCount);
+			if (start >= end)
+				continue;
+
+			flushCache();
+			size_t clusterMisses = 0;
+			for (size_t t = start; t < end; ++t)
+				clusterMisses += missCount(t);
+			const float clusterThreshold = threshold * (float)clusterMisses / (float)(end - start);
+
+			flushCache();
+			clusters.emplace_back((uint32_t)start);
+			size_t clusterStart = start, misses = 0;
+			for (size_t t = start; t < end; ++t)
+			{
+				misses += missCount(t);
+				if (t + 1 < end && (float)misses / (float)(t - clusterStart + 1) <= clusterThreshold)
+				{
+					clusters.emplace_back((uint32_t)(t + 1));
+					clusterStart = t + 1;
+					misses = 0;
+					flushCache();
+				}
+			}
+		}
+
+		//the area weighted center of the whole mesh
+		std::vector<glm::vec3> triangleNormals(triangleCount);
+		std::vector<glm::vec3> triangleCenters(triangleCount);
+		std::vector<float> triangleAreas(triangleCount);
+		glm::vec3 meshCenter = glm::vec3(0.0f);
+		float meshArea = 0.0f;
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			const glm::vec3& a = vertices[indices[t * 3]].position;
+			const glm::vec3& b = vertices[indices[t * 3 + 1]].position;
+			const glm::vec3& c = vertices[indices[t * 3 + 2]].position;
+			triangleNormals[t] = glm::cross(b - a, c - a);
+			triangleAreas[t] = glm::length(triangleNormals[t]);
+			triangleCenters[t] = (a + b + c) / 3.0f;
+			meshCenter += triangleCenters[t] * triangleAreas[t];
+			meshArea += triangleAreas[t];
+		}
+		if (meshArea > 0.0f)
+			meshCenter /= meshArea;
+
+		//scores every cluster by how far it's center sits along it's average normal, outward facing clusters score highest
+		std::vector<float> scores(clusters.size());
+		for (size_t k = 0; k < clusters.size(); ++k)
+		{
+			const size_t end = (k + 1 < clusters.size() ? clusters[k + 1] : triangleCount);
+			glm::vec3 center = glm::vec3(0.0f), normal = glm::vec3(0.0f);
+			float area = 0.0f;
+			for (size_t t = clusters[k]; t < end; ++t)
+			{
+				center += triangleCenters[t] * triangleAreas[t];
+				normal += triangleNormals[t];
+				area += triangleAreas[t];
+			}
+
+			const float normalLength = glm::length(normal);
+			scores[k] = (area > 0.0f && normalLength > 0.0f ? glm::dot(center / area - meshCenter, normal / normalLength) : 0.0f);
+		}
+
+		std::vector<uint32_t> order(clusters.size());
+		for (size_t k = 0; k < order.size(); ++k)
+			order[k] = (uint32_t)k;
+		std::stable_sort(order.begin(), order.end(), [&](const uint32_t& a, const uint32_t& b) { return scores[a] > scores[b]; });
+
+		outIndices.clear();
+		for (const uint32_t k : order)
+		{
+			const size_t end = (k + 1 < clusters.size() ? clusters[k + 1] : triangleCount);
+			outIndices.insert(outIndices.end(), indices + clusters[k] * 3, indices + end * 3);
+		}
+
+		return clusters.size();
+	}
+
+	//remaps a static mesh's vertices into the order every sub-mesh first uses them, in sub-mesh order, rewriting the indices and meshlet vertices to match
+	//works on float and packed layouts, vertices no sub-mesh uses are dropped and their count returned
+	static inline size_t OptimizeVertexFetch(StaticMesh& mesh)
+	{
+		const size_t vertexCount = mesh.GetVertexCount();
+		std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+		uint32_t next = 0;
+		auto remapIndex = [&](uint32_t& index) {
+			if (index >= vertexCount)
+				return;
+
+			if (remap[index] == UINT32_MAX)
+				remap[index] = next++;
+			index = remap[index];
+		};
+		for (Mesh& subMesh : mesh.meshes)
+		{
+			for (uint32_t& index : subMesh.indices)
+				remapIndex(index);
+			for (uint32_t& index : subMesh.meshletVertices)
+				remapIndex(index);
+		}
+
+		if (mesh.vertexLayout == VertexLayout::Float)
+		{
+			std::vector<Vertex> vertices(next);
+			for (size_t v = 0; v < vertexCount; ++v)
+			{
+				if (remap[v] != UINT32_MAX)
+					vertices[remap[v]] = mesh.vertices[v];
+			}
+			mesh.vertices = std::move(vertices);
+		}
+		else
+		{
+			const size_t stride = GetVertexLayoutStride(mesh.vertexLayout);
+			std::vector<uint8_t> packedVertices(next * stride);
+			for (size_t v = 0; v < vertexCount; ++v)
+			{
+				if (remap[v] != UINT32_MAX)
+					std::memcpy(&packedVertices[remap[v] * stride], &mesh.packedVertices[v * stride], stride);
+			}
+			mesh.packedVertices = std::move(packedVertices);
+		}
+
+		return vertexCount - next;
+	}
+
+	//optimizes every sub-mesh's indices for the vertex cache and overdraw, then remaps the shared vertices for fetch
+	//generated LODs are optimized like any other sub-mesh, packed meshes are decoded into a temp copy for the overdraw pass
+	static inline MeshOptimizeStats OptimizeStaticMesh(StaticMesh& mesh, const MeshOptimizeSettings& settings = MeshOptimizeSettings())
+	{
+		MeshOptimizeStats stats;
+		const size_t vertexCount = mesh.GetVertexCount();
+
+		std::vector<Vertex> unpacked;
+		const Vertex* vertices = mesh.vertices.data();
+		if (settings.optimizeOverdraw && mesh.vertexLayout != VertexLayout::Float)
+		{
+			UnpackVertices(mesh.packedVertices.data(), vertexCount, mesh.vertexLayout, mesh.quantization, unpacked);
+			vertices = unpacked.data();
+		}
+
+		std::vector<uint32_t> cacheIndices, hardBoundaries, overdrawIndices;
+		for (Mesh& subMesh : mesh.meshes)
+		{
+			AddVertexCacheStats(stats.before, SimulateVertexCache(subMesh.indices.data(), subMesh.indices.size(), vertexCount, settings.cacheSize));
+
+			OptimizeVertexCache(subMesh.indices.data(), subMesh.indices.size(), vertexCount, cacheIndices, settings.cacheSize,
+				(settings.optimizeOverdraw ? &hardBoundaries : nullptr));
+			if (settings.optimizeOverdraw && cacheIndices.size() == subMesh.indices.size())
+			{
+				stats.clusterCount += OptimizeOverdraw(cacheIndices.data(), cacheIndices.size(), vertices, vertexCount, hardBoundaries, overdrawIndices,
+					settings.cacheSize, settings.overdrawThreshold);
+				subMesh.indices.swap(overdrawIndices);
+			}
+			else
+				subMesh.indices.swap(cacheIndices);
+		}
+
+		if (settings.optimizeVertexFetch)
+			stats.droppedVertexCount = OptimizeVertexFetch(mesh);
+
+		for (const Mesh& subMesh : mesh.meshes)
+			AddVertexCacheStats(stats.after, SimulateVertexCache(subMesh.indices.data(), subMesh.indices.size(), mesh.GetVertexCount(), settings.cacheSize));
+		return stats;
+	}
+}
\ No newline at end of file
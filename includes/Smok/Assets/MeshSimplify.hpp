@@ -0,0 +1,461 @@
+#pragma once
+
+//defines mesh simplification and LOD generation
+//simplification is quadric error edge collapse, a vertex is always collapsed onto one of it's neighbours so LODs only need new indices and share the static mesh's vertices
+
+#include <Smok/Assets/Mesh.hpp>
+
+#include <glm/vec4.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iterator>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace Smok::Asset::Mesh
+{
+	//defines a error quadric, the sum of squared distances to a set of planes
+	struct Quadric
+	{
+		double a2 = 0.0, ab = 0.0, ac = 0.0, ad = 0.0;
+		double b2 = 0.0, bc = 0.0, bd = 0.0;
+		double c2 = 0.0, cd = 0.0;
+		double d2 = 0.0;
+		double weight = 0.0; //the total weight of the planes, used to turn the error back into a distance
+
+		//adds a plane, normal must be unit length
+		inline void AddPlane(const glm::vec3& normal, const float& distance, const double& planeWeight)
+		{
+			const double a = normal.x, b = normal.y, c = normal.z, d = distance;
+			a2 += a * a * planeWeight; ab += a * b * planeWeight; ac += a * c * planeWeight; ad += a * d * planeWeight;
+			b2 += b * b * planeWeight; bc += b * c * planeWeight; bd += b * d * planeWeight;
+			c2 += c * c * planeWeight; cd += c * d * planeWeight;
+			d2 += d * d * planeWeight;
+			weight += planeWeight;
+		}
+
+		//adds another quadric
+		inline void Add(const Quadric& other)
+		{
+			a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+			b2 += other.b2; bc += other.bc; bd += other.bd;
+			c2 += other.c2; cd += other.cd;
+			d2 += other.d2;
+			weight += other.weight;
+		}
+
+		//gets the weighted squared distance of a point to every plane
+		inline double Evaluate(const glm::vec3& p) const
+		{
+			const double x = p.x, y = p.y, z = p.z;
+			const double error = a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x +
+				b2 * y * y + 2.0 * bc * y * z + 2.0 * bd * y +
+				c2 * z * z + 2.0 * cd * z + d2;
+			return (error > 0.0 ? error : 0.0);
+		}
+	};
+
+	//defines the settings for simplifying a mesh
+	struct SimplifySettings
+	{
+		size_t targetIndexCount = 0; //stop once the mesh has this many indices or less
+		float maxError = FLT_MAX; //stop before a collapse would move the surface further than this, in mesh units
+		bool lockBorders = false; //never move vertices on open edges, keeps meshes that have to line up with other meshes crack free
+	};
+
+	//simplifies a triangle list, the simplified indices are written to out and the geometric error is returned
+	//the error is the furthest any kept vertex ended up from the planes of the source triangles it was merged from, in mesh units
+	//vertices sharing a position are treated as one so UV and normal seams do not tear, each corner keeps the duplicate whose attributes match best
+	static inline float SimplifyIndices(const Vertex* vertices, const size_t& vertexCount, const uint32_t* indices, const size_t& indexCount,
+		const SimplifySettings& settings, std::vector<uint32_t>& out)
+	{
+		constexpr uint32_t NONE = UINT32_MAX;
+		constexpr double BORDER_WEIGHT = 10.0; //how hard open edges resist being moved, relative to the surface
+
+		out.clear();
+		const size_t triangleCount = indexCount / 3;
+		if (triangleCount == 0 || vertexCount == 0)
+			return 0.0f;
+
+		//welds vertices by position, seams share a canonical vertex so collapses keep both sides together
+		std::vector<uint32_t> canonical(vertexCount);
+		std::vector<uint32_t> canonicalFirstDuplicate, duplicateNext(vertexCount, NONE);
+		{
+			struct PositionHash
+			{
+				inline size_t operator()(const glm::vec3& p) const
+				{
+					uint32_t bits[3];
+					std::memcpy(bits, &p, sizeof(bits));
+					return (size_t)((bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u));
+				}
+			};
+			struct PositionEqual
+			{
+				inline bool operator()(const glm::vec3& a, const glm::vec3& b) const { return a.x == b.x && a.y == b.y && a.z == b.z; }
+			};
+
+			std::unordered_map<glm::vec3, uint32_t, PositionHash, PositionEqual> positions;
+			positions.reserve(vertexCount);
+			for (size_t v = 0; v < vertexCount; ++v)
+			{
+				auto result = positions.try_emplace(vertices[v].position, (uint32_t)canonicalFirstDuplicate.size());
+				if (result.second)
+					canonicalFirstDuplicate.emplace_back((uint32_t)v);
+				else
+				{
+					const uint32_t c = result.first->second;
+					duplicateNext[v] = canonicalFirstDuplicate[c];
+					canonicalFirstDuplicate[c] = (uint32_t)v;
+				}
+				canonical[v] = result.first->second;
+			}
+		}
+		const size_t canonicalCount = canonicalFirstDuplicate.size();
+		auto positionOf = [&](const uint32_t& c) -> const glm::vec3& { return vertices[canonicalFirstDuplicate[c]].position; };
+
+		//the triangles, by canonical vertex and by the real vertex each corner uses
+		std::vector<uint32_t> triangleCorners, triangleVertices;
+		triangleCorners.reserve(triangleCount * 3);
+		triangleVertices.reserve(triangleCount * 3);
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			const uint32_t i0 = indices[t * 3], i1 = indices[t * 3 + 1], i2 = indices[t * 3 + 2];
+			if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount)
+				continue;
+
+			const uint32_t c0 = canonical[i0], c1 = canonical[i1], c2 = canonical[i2];
+			if (c0 == c1 || c1 == c2 || c2 == c0)
+				continue;
+
+			triangleCorners.insert(triangleCorners.end(), { c0, c1, c2 });
+			triangleVertices.insert(triangleVertices.end(), { i0, i1, i2 });
+		}
+		size_t liveTriangles = triangleCorners.size() / 3;
+		const size_t targetTriangles = settings.targetIndexCount / 3;
+
+		//counts how many triangles use each edge, edges used once are open borders
+		auto edgeKey = [](const uint32_t& a, const uint32_t& b) -> uint64_t { return (a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a); };
+		std::unordered_map<uint64_t, uint32_t> edgeUseCounts;
+		edgeUseCounts.reserve(liveTriangles * 3);
+		for (size_t t = 0; t < liveTriangles; ++t)
+		{
+			for (uint32_t e = 0; e < 3; ++e)
+				edgeUseCounts[edgeKey(triangleCorners[t * 3 + e], triangleCorners[t * 3 + (e + 1) % 3])]++;
+		}
+
+		//builds the quadrics, every triangle adds it's plane weighted by area, every border edge adds a plane standing along it
+		std::vector<Quadric> quadrics(canonicalCount);
+		std::vector<uint8_t> onBorder(canonicalCount, 0);
+		for (size_t t = 0; t < liveTriangles; ++t)
+		{
+			const glm::vec3& p0 = positionOf(triangleCorners[t * 3]);
+			const glm::vec3& p1 = positionOf(triangleCorners[t * 3 + 1]);
+			const glm::vec3& p2 = positionOf(triangleCorners[t * 3 + 2]);
+			const glm::vec3 cross = glm::cross(p1 - p0, p2 - p0);
+			const float doubleArea = glm::length(cross);
+			if (doubleArea <= 0.0f)
+				continue;
+
+			const glm::vec3 normal = cross / doubleArea;
+			for (uint32_t c = 0; c < 3; ++c)
+				quadrics[triangleCorners[t * 3 + c]].AddPlane(normal, -glm::dot(normal, p0), doubleArea * 0.5);
+
+			for (uint32_t e = 0; e < 3; ++e)
+			{
+				const uint32_t a = triangleCorners[t * 3 + e], b = triangleCorners[t * 3 + (e + 1) % 3];
+				if (edgeUseCounts[edgeKey(a, b)] != 1)
+					continue;
+
+				onBorder[a] = 1;
+				onBorder[b] = 1;
+				const glm::vec3 edge = positionOf(b) - positionOf(a);
+				const float edgeLength = glm::length(edge);
+				if (edgeLength <= 0.0f)
+					continue;
+
+				const glm::vec3 borderNormal = glm::normalize(glm::cross(edge, normal));
+				const float borderDistance = -glm::dot(borderNormal, positionOf(a));
+				quadrics[a].AddPlane(borderNormal, borderDistance, (double)edgeLength * edgeLength * BORDER_WEIGHT);
+				quadrics[b].AddPlane(borderNormal, borderDistance, (double)edgeLength * edgeLength * BORDER_WEIGHT);
+			}
+		}
+
+		//the triangles around each vertex, dead triangles are left in and skipped
+		std::vector<std::vector<uint32_t>> vertexTriangles(canonicalCount);
+		for (size_t t = 0; t < liveTriangles; ++t)
+		{
+			for (uint32_t c = 0; c < 3; ++c)
+				vertexTriangles[triangleCorners[t * 3 + c]].emplace_back((uint32_t)t);
+		}
+
+		//the plane of every source triangle and the source triangles each vertex stands for, the quadrics only give a average distance to them
+		std::vector<glm::vec4> trianglePlanes(liveTriangles, glm::vec4(0.0f));
+		for (size_t t = 0; t < liveTriangles; ++t)
+		{
+			const glm::vec3& p0 = positionOf(triangleCorners[t * 3]);
+			const glm::vec3 cross = glm::cross(positionOf(triangleCorners[t * 3 + 1]) - p0, positionOf(triangleCorners[t * 3 + 2]) - p0);
+			const float doubleArea = glm::length(cross);
+			if (doubleArea > 0.0f)
+				trianglePlanes[t] = glm::vec4(cross / doubleArea, -glm::dot(cross / doubleArea, p0));
+		}
+		std::vector<std::vector<uint32_t>> vertexPlanes = vertexTriangles;
+		std::vector<uint32_t> mergedPlanes;
+		std::vector<uint8_t> triangleAlive(liveTriangles, 1);
+		std::vector<uint8_t> removed(canonicalCount, 0);
+		std::vector<uint32_t> versions(canonicalCount, 0);
+
+		//defines a possible collapse, from is merged into to
+		struct Collapse
+		{
+			double cost = 0.0;
+			uint32_t from = 0, to = 0;
+			uint32_t fromVersion = 0, toVersion = 0;
+
+			inline bool operator>(const Collapse& other) const { return cost > other.cost; }
+		};
+		std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> collapses;
+
+		//border vertices can only slide along the border, so they never pull a open edge inwards
+		auto canCollapse = [&](const uint32_t& from, const uint32_t& to) -> bool {
+			if (!onBorder[from])
+				return true;
+			if (settings.lockBorders || !onBorder[to])
+				return false;
+
+			auto it = edgeUseCounts.find(edgeKey(from, to));
+			return (it != edgeUseCounts.end() && it->second == 1);
+		};
+
+		auto pushCollapse = [&](const uint32_t& from, const uint32_t& to) {
+			if (!canCollapse(from, to))
+				return;
+
+			Quadric merged = quadrics[from];
+			merged.Add(quadrics[to]);
+			collapses.push({ merged.Evaluate(positionOf(to)), from, to, versions[from], versions[to] });
+		};
+
+		for (const auto& edge : edgeUseCounts)
+		{
+			const uint32_t a = (uint32_t)(edge.first >> 32), b = (uint32_t)(edge.first & 0xFFFFFFFF);
+			pushCollapse(a, b);
+			pushCollapse(b, a);
+		}
+
+		//collapses the cheapest edge until we hit the target
+		const double maxErrorSquared = (settings.maxError < FLT_MAX ? (double)settings.maxError * settings.maxError : DBL_MAX);
+		double worstError = 0.0;
+		std::vector<uint32_t> neighbours;
+		while (liveTriangles > targetTriangles && !collapses.empty())
+		{
+			const Collapse collapse = collapses.top();
+			collapses.pop();
+
+			const uint32_t from = collapse.from, to = collapse.to;
+			if (removed[from] || removed[to] || versions[from] != collapse.fromVersion || versions[to] != collapse.toVersion)
+				continue;
+
+			//turns the quadric error back into a average distance, the max distance is never less so every collapse after this one is over too
+			const double weight = quadrics[from].weight + quadrics[to].weight;
+			const double errorSquared = (weight > 0.0 ? collapse.cost / weight : 0.0);
+			if (errorSquared > maxErrorSquared)
+				break;
+
+			//rejects collapses that would flip a triangle over
+			bool flips = false;
+			for (const uint32_t t : vertexTriangles[from])
+			{
+				if (!triangleAlive[t])
+					continue;
+
+				const uint32_t* corners = &triangleCorners[t * 3];
+				if (corners[0] == to || corners[1] == to || corners[2] == to)
+					continue;
+
+				glm::vec3 before[3], after[3];
+				for (uint32_t c = 0; c < 3; ++c)
+				{
+					before[c] = positionOf(corners[c]);
+					after[c] = (corners[c] == from ? positionOf(to) : before[c]);
+				}
+
+				const glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+				const glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+				if (glm::dot(normalBefore, normalAfter) <= 0.0f)
+				{
+					flips = true;
+					break;
+				}
+			}
+			if (flips)
+				continue;
+
+			//the real error of the collapse, how far "to" is from the furthest plane either vertex stood for
+			//both lists are kept sorted so they merge in one pass
+			mergedPlanes.clear();
+			std::set_union(vertexPlanes[to].begin(), vertexPlanes[to].end(), vertexPlanes[from].begin(), vertexPlanes[from].end(),
+				std::back_inserter(mergedPlanes));
+			double collapseError = 0.0;
+			const glm::vec4 target = glm::vec4(positionOf(to), 1.0f);
+			for (const uint32_t t : mergedPlanes)
+				collapseError = std::max(collapseError, (double)std::abs(glm::dot(trianglePlanes[t], target)));
+			if (collapseError > settings.maxError)
+				continue;
+
+			//moves every triangle from "from" to "to", triangles using both become degenerate and are removed
+			for (const uint32_t t : vertexTriangles[from])
+			{
+				if (!triangleAlive[t])
+					continue;
+
+				uint32_t* corners = &triangleCorners[t * 3];
+				if (corners[0] == to || corners[1] == to || corners[2] == to)
+				{
+					triangleAlive[t] = 0;
+					liveTriangles--;
+					continue;
+				}
+
+				//picks the duplicate of "to" whose attributes are closest to the one the corner used
+				for (uint32_t c = 0; c < 3; ++c)
+				{
+					if (corners[c] != from)
+						continue;
+
+					const Vertex& original = vertices[triangleVertices[t * 3 + c]];
+					uint32_t best = canonicalFirstDuplicate[to];
+					float bestDistance = FLT_MAX;
+					for (uint32_t d = canonicalFirstDuplicate[to]; d != NONE; d = duplicateNext[d])
+					{
+						const glm::vec3 normalOffset = vertices[d].normal - original.normal;
+						const glm::vec3 colorOffset = vertices[d].color - original.color;
+						const glm::vec2 uvOffset = vertices[d].textureCoords - original.textureCoords;
+						const float distance = glm::dot(normalOffset, normalOffset) + glm::dot(colorOffset, colorOffset) + glm::dot(uvOffset, uvOffset);
+						if (distance < bestDistance)
+						{
+							bestDistance = distance;
+							best = d;
+						}
+					}
+
+					corners[c] = to;
+					triangleVertices[t * 3 + c] = best;
+				}
+				vertexTriangles[to].emplace_back(t);
+			}
+
+			removed[from] = 1;
+			vertexTriangles[from].clear();
+			quadrics[to].Add(quadrics[from]);
+			versions[to]++;
+			vertexPlanes[to].swap(mergedPlanes);
+			vertexPlanes[from].clear();
+			if (collapseError > worstError)
+				worstError = collapseError;
+
+			//the new edges around "to", also drops it's dead triangles
+			neighbours.clear();
+			std::vector<uint32_t>& toTriangles = vertexTriangles[to];
+			toTriangles.erase(std::remove_if(toTriangles.begin(), toTriangles.end(), [&](const uint32_t& t) { return !triangleAlive[t]; }), toTriangles.end());
+			for (const uint32_t t : toTriangles)
+			{
+				for (uint32_t c = 0; c < 3; ++c)
+				{
+					const uint32_t corner = triangleCorners[t * 3 + c];
+					if (corner != to)
+						neighbours.emplace_back(corner);
+				}
+
+				//new edges made by the collapse need their use count, border edges only ever move along the border so the count carries over
+				for (uint32_t e = 0; e < 3; ++e)
+				{
+					const uint32_t a = triangleCorners[t * 3 + e], b = triangleCorners[t * 3 + (e + 1) % 3];
+					edgeUseCounts.try_emplace(edgeKey(a, b), 2);
+				}
+			}
+			std::sort(neighbours.begin(), neighbours.end());
+			neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+			for (const uint32_t n : neighbours)
+			{
+				pushCollapse(n, to);
+				pushCollapse(to, n);
+			}
+		}
+
+		//writes the surviving triangles
+		out.reserve(liveTriangles * 3);
+		for (size_t t = 0; t < triangleAlive.size(); ++t)
+		{
+			if (triangleAlive[t])
+				out.insert(out.end(), { triangleVertices[t * 3], triangleVertices[t * 3 + 1], triangleVertices[t * 3 + 2] });
+		}
+
+		return (float)worstError;
+	}
+
+	//defines the settings for generating LODs
+	struct LODGenerationSettings
+	{
+		std::vector<float> targetRatios = { 0.5f, 0.25f, 0.125f }; //the triangle ratio of each LOD level relative to the source sub-mesh
+		float maxError = FLT_MAX; //LODs stop being generated once a level would move the surface further than this, in mesh units
+		float minReduction = 0.9f; //a level is dropped if it could not get below this ratio of the previous level's triangles
+		bool lockBorders = false; //see SimplifySettings::lockBorders
+	};
+
+	//generates LOD levels for every source sub-mesh of a static mesh, replacing any LODs it already had
+	//the LODs are added after the source sub-meshes with LODSourceIndex and LODError set, the vertices are shared and not changed
+	static inline void GenerateStaticMeshLODs(StaticMesh& mesh, const LODGenerationSettings& settings = LODGenerationSettings())
+	{
+		//drops old generated LODs, keeping the source sub-meshes in order
+		std::vector<Mesh> sources;
+		sources.reserve(mesh.meshes.size());
+		for (size_t m = 0; m < mesh.meshes.size(); ++m)
+		{
+			if (mesh.meshes[m].LODSourceIndex == UINT32_MAX)
+				sources.emplace_back(std::move(mesh.meshes[m]));
+		}
+		mesh.meshes = std::move(sources);
+
+		//simplification reads float vertices, packed meshes are decoded into a temp copy
+		std::vector<Vertex> unpacked;
+		const Vertex* vertices = mesh.vertices.data();
+		const size_t vertexCount = mesh.GetVertexCount();
+		if (mesh.vertexLayout != VertexLayout::Float)
+		{
+			UnpackVertices(mesh.packedVertices.data(), vertexCount, mesh.vertexLayout, mesh.quantization, unpacked);
+			vertices = unpacked.data();
+		}
+
+		const size_t sourceCount = mesh.meshes.size();
+		for (size_t m = 0; m < sourceCount; ++m)
+		{
+			size_t previousIndexCount = mesh.meshes[m].indices.size();
+			for (size_t level = 0; level < settings.targetRatios.size(); ++level)
+			{
+				const std::vector<uint32_t>& sourceIndices = mesh.meshes[m].indices;
+
+				SimplifySettings simplifySettings;
+				simplifySettings.targetIndexCount = (size_t)((float)(sourceIndices.size() / 3) * settings.targetRatios[level]) * 3;
+				simplifySettings.maxError = settings.maxError;
+				simplifySettings.lockBorders = settings.lockBorders;
+
+				Mesh LOD;
+				LOD.LODError = SimplifyIndices(vertices, vertexCount, sourceIndices.data(), sourceIndices.size(), simplifySettings, LOD.indices);
+				if (LOD.indices.empty() || (float)LOD.indices.size() > (float)previousIndexCount * settings.minReduction)
+					break;
+
+				LOD.LODIndex = mesh.meshes[m].LODIndex + (uint32_t)level + 1;
+				LOD.LODSourceIndex = (uint32_t)m;
+				LOD.canRender = mesh.meshes[m].canRender;
+				previousIndexCount = LOD.indices.size();
+				mesh.meshes.emplace_back(std::move(LOD));
+			}
+		}
+
+		CalculateStaticMeshBounds(mesh);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+//defines meshlets, small clusters of a sub-mesh's triangles with their own culling data
+//each meshlet has a bounding sphere and a normal cone, so clusters outside the frustum or facing away from the camera can be rejected below the sub-mesh level
+//meshlets are built at cook time, see "Smok/Assets/MeshletBuild.hpp", and culled with "Smok/Rendering/MeshletCulling.hpp"
+
+#include <glm/vec3.hpp>
+#include <glm/geometric.hpp>
+
+#include <cstdint>
+#include <type_traits>
+
+namespace Smok::Asset::Mesh
+{
+	//the most vertices a meshlet can use, it's triangles index them with a single byte
+	static constexpr uint32_t MESHLET_MAX_VERTICES = 256;
+
+	//the most triangles a meshlet can hold
+	static constexpr uint32_t MESHLET_MAX_TRIANGLES = 512;
+
+	//defines a meshlet, the offsets are into the arrays of the sub-mesh it belongs to
+	//this is written to disk as is, it's size can not change without bumping the smesh version
+	struct Meshlet
+	{
+		uint32_t vertexOffset = 0; //where the meshlet's vertices start in the sub-mesh's meshletVertices
+		uint32_t triangleOffset = 0; //where the meshlet's triangles start in the sub-mesh's meshletTriangles, in bytes
+		uint32_t vertexCount = 0; //the number of vertices
+		uint32_t triangleCount = 0; //the number of triangles, each is 3 bytes
+
+		glm::vec3 sphereCenter = { 0.0f, 0.0f, 0.0f }; //the bounding sphere
+		float sphereRadius = 0.0f;
+
+		glm::vec3 coneAxis = { 0.0f, 0.0f, 0.0f }; //the average facing of the triangles
+		float coneCutoff = 1.0f; //the sine of the cone's half angle, 1.0 when the triangles face too many ways for the cone to ever cull
+
+		//is every triangle facing away from a camera, the camera must be in the same space as the meshlet
+		//conservative, the whole bounding sphere has to be behind the cone for it to pass
+		inline bool ConeIsBackfacing(const glm::vec3& cameraPosition) const
+		{
+			if (coneCutoff >= 1.0f)
+				return false;
+
+			const glm::vec3 offset = sphereCenter - cameraPosition;
+			return glm::dot(offset, coneAxis) >= coneCutoff * glm::length(offset) + sphereRadius;
+		}
+	};
+	static_assert(sizeof(Meshlet) == 48, "Meshlet is written to disk, it's size can not change");
+	static_assert(std::is_trivially_copyable_v<Meshlet>, "Meshlet must be trivially copyable");
+}
\ No newline at end of file
@@ -0,0 +1,317 @@
+#pragma once
+
+//defines the cook time meshlet builder for Smok meshes
+//each sub-mesh is split into meshlets with bounded vertex and triangle counts, grown greedily across shared vertices so they stay compact
+//every meshlet gets a bounding sphere and a normal cone for culling, triangles are taken as counter-clockwise when seen from the front
+
+#include <Smok/Assets/Mesh.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+namespace Smok::Asset::Mesh
+{
+	//defines the settings for building meshlets
+	//the defaults match what mesh shading hardware is fastest with, 124 keeps the triangle bytes a multiple of 4
+	struct MeshletSettings
+	{
+		uint32_t maxVertices = 64; //clamped to 3 - MESHLET_MAX_VERTICES
+		uint32_t maxTriangles = 124; //clamped to 1 - MESHLET_MAX_TRIANGLES
+		float coneWeight = 0.25f; //0.0 grows meshlets only by distance, up to 1.0 favours triangles facing the same way so the cones cull more
+	};
+
+	//defines the results of building meshlets
+	struct MeshletBuildStats
+	{
+		size_t meshletCount = 0;
+		size_t triangleCount = 0;
+		size_t vertexCount = 0; //the meshlet vertices, vertices on the edge of a meshlet are counted once per meshlet
+
+		//gets the average number of triangles in a meshlet
+		inline float AverageTriangleCount() const { return (meshletCount == 0 ? 0.0f : (float)triangleCount / (float)meshletCount); }
+
+		//gets the average number of vertices in a meshlet
+		inline float AverageVertexCount() const { return (meshletCount == 0 ? 0.0f : (float)vertexCount / (float)meshletCount); }
+	};
+
+	//calculates a meshlet's bounding sphere and normal cone from it's vertices and triangles
+	static inline void CalculateMeshletBounds(const Vertex* vertices, const uint32_t* meshletVertices, const uint8_t* meshletTriangles, Meshlet& meshlet)
+	{
+		const Bounds bounds = CalculateBounds((const uint8_t*)&vertices[0].position, sizeof(Vertex), 0, meshletVertices + meshlet.vertexOffset, meshlet.vertexCount);
+		meshlet.sphereCenter = bounds.sphereCenter;
+		meshlet.sphereRadius = bounds.sphereRadius;
+
+		//the axis is the average facing, the cone has to open wide enough for the triangle facing furthest from it
+		std::vector<glm::vec3> normals;
+		normals.reserve(meshlet.triangleCount);
+		glm::vec3 axis = glm::vec3(0.0f);
+		for (uint32_t t = 0; t < meshlet.triangleCount; ++t)
+		{
+			const uint8_t* corners = meshletTriangles + meshlet.triangleOffset + t * 3;
+			const glm::vec3& a = vertices[meshletVertices[meshlet.vertexOffset + corners[0]]].position;
+			const glm::vec3& b = vertices[meshletVertices[meshlet.vertexOffset + corners[1]]].position;
+			const glm::vec3& c = vertices[meshletVertices[meshlet.vertexOffset + corners[2]]].position;
+			const glm::vec3 normal = glm::cross(b - a, c - a);
+			const float length = glm::length(normal);
+			if (length <= 0.0f)
+				continue;
+
+			normals.emplace_back(normal / length);
+			axis += normals.back();
+		}
+
+		meshlet.coneAxis = glm::vec3(0.0f);
+		meshlet.coneCutoff = 1.0f;
+		const float axisLength = glm::length(axis);
+		if (normals.empty() || axisLength <= 0.0f)
+			return;
+
+		axis /= axisLength;
+		float minDot = 1.0f;
+		for (const glm::vec3& normal : normals)
+			minDot = glm::min(minDot, glm::dot(normal, axis));
+
+		//a cone opening 90 degrees or more always has a triangle facing the camera
+		meshlet.coneAxis = axis;
+		if (minDot > 0.0f)
+			meshlet.coneCutoff = std::sqrt(glm::max(0.0f, 1.0f - minDot * minDot));
+	}
+
+	//splits a sub-mesh's indices into meshlets, the outputs are cleared first
+	//starts from a triangle and keeps adding the neighbouring triangle that needs the fewest new vertices, ties go to the one closest to the meshlet and facing most like it
+	//when the best neighbour does not fit the meshlet is closed and the neighbour starts the next one, so meshlets stay next to each other
+	//a meshlet with no neighbours left takes in leftover triangles beside the last closed meshlets if they are close, else it's closed and the next one starts there
+	//returns the number of meshlets, indices past the vertices are a error and build nothing
+	static inline size_t BuildMeshlets(const Vertex* vertices, const size_t& vertexCount, const uint32_t* indices, const size_t& indexCount,
+		std::vector<Meshlet>& meshlets, std::vector<uint32_t>& meshletVertices, std::vector<uint8_t>& meshletTriangles, const MeshletSettings& settings = MeshletSettings())
+	{
+		meshlets.clear();
+		meshletVertices.clear();
+		meshletTriangles.clear();
+
+		const size_t triangleCount = indexCount / 3;
+		if (triangleCount == 0 || vertexCount == 0)
+			return 0;
+
+		const uint32_t maxVertices = std::clamp(settings.maxVertices, 3u, MESHLET_MAX_VERTICES);
+		const uint32_t maxTriangles = std::clamp(settings.maxTriangles, 1u, MESHLET_MAX_TRIANGLES);
+		const float coneWeight = std::clamp(settings.coneWeight, 0.0f, 1.0f);
+
+		//builds the triangles around every vertex, flat with a offset per vertex
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+		for (size_t i = 0; i < triangleCount * 3; ++i)
+		{
+			if (indices[i] >= vertexCount)
+			{
+				fmt::print("Smok Asset Mesh Error: BuildMeshlets || Index {} is past the {} vertices, no meshlets were built.\n", indices[i], vertexCount);
+				return 0;
+			}
+			adjacencyOffsets[indices[i] + 1]++;
+		}
+		std::vector<uint32_t> liveTriangles(vertexCount); //the unused triangles around every vertex
+		for (size_t v = 0; v < vertexCount; ++v)
+			liveTriangles[v] = adjacencyOffsets[v + 1];
+		for (size_t v = 0; v < vertexCount; ++v)
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+		std::vector<uint32_t> adjacency(adjacencyOffsets[vertexCount]);
+		{
+			std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t t = 0; t < triangleCount; ++t)
+			{
+				for (uint32_t c = 0; c < 3; ++c)
+					adjacency[fill[indices[t * 3 + c]]++] = (uint32_t)t;
+			}
+		}
+
+		//the center and facing of every triangle, distances are scaled by the size of the sub-mesh so the cone weight means the same on any mesh
+		std::vector<glm::vec3> triangleCenters(triangleCount), triangleNormals(triangleCount);
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			const glm::vec3& a = vertices[indices[t * 3]].position;
+			const glm::vec3& b = vertices[indices[t * 3 + 1]].position;
+			const glm::vec3& c = vertices[indices[t * 3 + 2]].position;
+			triangleCenters[t] = (a + b + c) / 3.0f;
+			const glm::vec3 normal = glm::cross(b - a, c - a);
+			const float length = glm::length(normal);
+			triangleNormals[t] = (length > 0.0f ? normal / length : glm::vec3(0.0f));
+		}
+		const Bounds bounds = CalculateBounds((const uint8_t*)&vertices[0].position, sizeof(Vertex), 0, indices, triangleCount * 3);
+		const float inverseSize = (bounds.sphereRadius > 0.0f ? 1.0f / bounds.sphereRadius : 1.0f);
+
+		std::vector<uint32_t> localIndices(vertexCount, UINT32_MAX); //where a vertex is in the open meshlet
+		std::vector<uint8_t> used(triangleCount, 0);
+		std::vector<uint32_t> deadEnds; //vertices of closed meshlets, a meshlet that runs out of neighbours restarts next to one of these
+		Meshlet meshlet;
+		glm::vec3 centerSum = glm::vec3(0.0f), normalSum = glm::vec3(0.0f);
+		size_t usedCount = 0, cursor = 0;
+
+		//closes the open meshlet
+		auto finishMeshlet = [&]() {
+			if (meshlet.triangleCount == 0)
+				return;
+
+			for (uint32_t v = 0; v < meshlet.vertexCount; ++v)
+			{
+				localIndices[meshletVertices[meshlet.vertexOffset + v]] = UINT32_MAX;
+				deadEnds.emplace_back(meshletVertices[meshlet.vertexOffset + v]);
+			}
+			CalculateMeshletBounds(vertices, meshletVertices.data(), meshletTriangles.data(), meshlet);
+			meshlets.emplace_back(meshlet);
+
+			meshlet = Meshlet();
+			meshlet.vertexOffset = (uint32_t)meshletVertices.size();
+			meshlet.triangleOffset = (uint32_t)meshletTriangles.size();
+			centerSum = glm::vec3(0.0f);
+			normalSum = glm::vec3(0.0f);
+		};
+
+		//counts the vertices a triangle would add to the open meshlet
+		auto newVertexCount = [&](const size_t& t) {
+			uint32_t count = 0;
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				const uint32_t v = indices[t * 3 + c];
+				count += (localIndices[v] == UINT32_MAX && (c == 0 || v != indices[t * 3]) && (c < 2 || v != indices[t * 3 + 1]));
+			}
+			return count;
+		};
+
+		//walks back through the closed meshlets for a unused triangle next to them
+		auto findDeadEndTriangle = [&]() -> int64_t {
+			while (!deadEnds.empty())
+			{
+				const uint32_t vertex = deadEnds.back();
+				for (uint32_t a = adjacencyOffsets[vertex]; a < adjacencyOffsets[vertex + 1]; ++a)
+				{
+					if (!used[adjacency[a]])
+						return adjacency[a];
+				}
+				deadEnds.pop_back();
+			}
+			return -1;
+		};
+
+		int64_t seed = -1;
+		while (usedCount < triangleCount)
+		{
+			int64_t next = -1;
+			if (meshlet.triangleCount == 0)
+			{
+				next = (seed >= 0 && !used[seed] ? seed : findDeadEndTriangle());
+				if (next == -1)
+				{
+					while (used[cursor])
+						cursor++;
+					next = (int64_t)cursor;
+				}
+			}
+			else
+			{
+				//picks the best unused triangle touching the open meshlet
+				const glm::vec3 center = centerSum / (float)meshlet.triangleCount;
+				const float normalLength = glm::length(normalSum);
+				const glm::vec3 facing = (normalLength > 0.0f ? normalSum / normalLength : glm::vec3(0.0f));
+				uint32_t bestNewVertices = UINT32_MAX;
+				float bestScore = FLT_MAX;
+				for (uint32_t v = 0; v < meshlet.vertexCount; ++v)
+				{
+					const uint32_t vertex = meshletVertices[meshlet.vertexOffset + v];
+					for (uint32_t a = adjacencyOffsets[vertex]; a < adjacencyOffsets[vertex + 1]; ++a)
+					{
+						const uint32_t t = adjacency[a];
+						if (used[t])
+							continue;
+
+						//triangles that are the last one left on a vertex get a bonus, skipping them leaves pockets that become tiny meshlets
+						const uint32_t newVertices = newVertexCount(t);
+						const uint32_t lastTriangles = (liveTriangles[indices[t * 3]] == 1) + (liveTriangles[indices[t * 3 + 1]] == 1) + (liveTriangles[indices[t * 3 + 2]] == 1);
+						const float score = (1.0f - coneWeight) * glm::length(triangleCenters[t] - center) * inverseSize +
+							coneWeight * (1.0f - glm::dot(triangleNormals[t], facing)) * 0.5f - (float)lastTriangles * 0.1f;
+						if (newVertices < bestNewVertices || (newVertices == bestNewVertices && score < bestScore))
+						{
+							bestNewVertices = newVertices;
+							bestScore = score;
+							next = t;
+						}
+					}
+				}
+
+				//nothing touches the meshlet, pockets of triangles left between closed meshlets are pulled in if they are within 3 times it's radius so they do not become tiny meshlets of their own
+				if (next == -1 && meshlet.vertexCount + 3 <= maxVertices && meshlet.triangleCount < maxTriangles)
+				{
+					const int64_t pocket = findDeadEndTriangle();
+					float radiusSquared = 0.0f;
+					for (uint32_t v = 0; pocket != -1 && v < meshlet.vertexCount; ++v)
+					{
+						const glm::vec3 offset = vertices[meshletVertices[meshlet.vertexOffset + v]].position - center;
+						radiusSquared = glm::max(radiusSquared, glm::dot(offset, offset));
+					}
+
+					const glm::vec3 offset = (pocket != -1 ? triangleCenters[pocket] - center : glm::vec3(0.0f));
+					if (pocket != -1 && glm::dot(offset, offset) <= radiusSquared * 9.0f)
+					{
+						next = pocket;
+						bestNewVertices = newVertexCount(pocket);
+					}
+				}
+
+				//nothing is left close to the meshlet or the best neighbour does not fit, the neighbour starts the next meshlet
+				if (next == -1 || meshlet.vertexCount + bestNewVertices > maxVertices || meshlet.triangleCount + 1 > maxTriangles)
+				{
+					finishMeshlet();
+					seed = next;
+					continue;
+				}
+			}
+
+			//adds the triangle
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				const uint32_t v = indices[next * 3 + c];
+				liveTriangles[v]--;
+				if (localIndices[v] == UINT32_MAX)
+				{
+					localIndices[v] = meshlet.vertexCount++;
+					meshletVertices.emplace_back(v);
+				}
+				meshletTriangles.emplace_back((uint8_t)localIndices[v]);
+			}
+			meshlet.triangleCount++;
+			centerSum += triangleCenters[next];
+			normalSum += triangleNormals[next];
+			used[next] = 1;
+			usedCount++;
+		}
+		finishMeshlet();
+
+		return meshlets.size();
+	}
+
+	//builds the meshlets of every sub-mesh, replacing any it already had
+	//packed meshes are decoded into a temp copy, the meshlets index the static mesh's vertices so they stay valid in any layout
+	static inline MeshletBuildStats BuildStaticMeshMeshlets(StaticMesh& mesh, const MeshletSettings& settings = MeshletSettings())
+	{
+		MeshletBuildStats stats;
+
+		std::vector<Vertex> unpacked;
+		const Vertex* vertices = mesh.vertices.data();
+		const size_t vertexCount = mesh.GetVertexCount();
+		if (mesh.vertexLayout != VertexLayout::Float)
+		{
+			UnpackVertices(mesh.packedVertices.data(), vertexCount, mesh.vertexLayout, mesh.quantization, unpacked);
+			vertices = unpacked.data();
+		}
+
+		for (Mesh& subMesh : mesh.meshes)
+		{
+			stats.meshletCount += BuildMeshlets(vertices, vertexCount, subMesh.indices.data(), subMesh.indices.size(),
+				subMesh.meshlets, subMesh.meshletVertices, subMesh.meshletTriangles, settings);
+			stats.triangleCount += subMesh.meshletTriangles.size() / 3;
+			stats.vertexCount += subMesh.meshletVertices.size();
+		}
+
+		return stats;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,298 @@
+#pragma once
+
+//defines the pipeline caches used when creating graphics pipelines
+//ShaderModuleCache keeps shader modules alive across a batch of pipeline creates, keyed by a hash of the SPIR-V so pipelines sharing shaders share modules
+//PipelineCache wraps a VkPipelineCache that is saved to disk and only reloaded on the same device and driver, pipelines made through it hit the cache
+//both take the Vulkan device handles they're given, they never look inside Wireframe's GPU
+
+#include <Smok/Assets/AssetID.hpp>
+#include <Smok/Assets/AssetPack.hpp>
+#include <Smok/IO/MappedFile.hpp>
+#include <Smok/Profiling/Profiler.hpp>
+
+#include <BTDSTD/Wireframe/Pipeline/GraphicsPipeline.hpp>
+#include <BTDSTD/IO/FileInfo.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Smok::Asset::AssetManager
+{
+	//defines a cache of shader modules, use it for a batch of pipeline creates then destroy it to free the modules
+	struct ShaderModuleCache
+	{
+		VkDevice device = VK_NULL_HANDLE; //the device modules are made on, set before the first "Get"
+
+		std::unordered_map<uint64_t, VkShaderModule> modulesByHash; //the modules by the hash of their SPIR-V
+		std::unordered_map<std::string, uint64_t> hashesByPath; //the SPIR-V hash of every file seen, so a path is only read once
+		std::mutex mutex; //pipelines can be created on many threads, only the maps are locked so reads and module creates run at the same time
+
+		size_t modulesCreated = 0; //the number of modules made
+		size_t modulesReused = 0; //the number of times a existing module was handed out
+
+		//gets the module for a SPIR-V file, creating it if no file with the same contents has been seen
+		//the file is mapped once, the same bytes are hashed and handed to the driver
+		//with a pack the SPIR-V is read out of it when it has the binary, otherwise from the file
+		inline VkShaderModule Get(const std::string& binaryFilepath, const Pack::AssetPack* pack = nullptr)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				auto path = hashesByPath.find(binaryFilepath);
+				if (path != hashesByPath.end())
+				{
+					auto it = modulesByHash.find(path->second);
+					if (it != modulesByHash.end())
+					{
+						modulesReused++;
+						return it->second;
+					}
+				}
+			}
+
+			IO::MappedFile file;
+			std::vector<uint8_t> packed;
+			const uint8_t* data = nullptr;
+			size_t size = 0;
+			const Pack::PackEntry* entry = (pack ? pack->FindShaderBinary(binaryFilepath) : nullptr);
+			if (entry && entry->compression == Pack::PackCompression::None)
+			{
+				data = pack->GetStoredData(*entry); //payloads are at least 16 byte aligned
+				size = (size_t)entry->size;
+			}
+			else if (entry)
+			{
+				if (!pack->ReadEntry(*entry, packed))
+					return VK_NULL_HANDLE;
+				data = packed.data();
+				size = packed.size();
+			}
+			else
+			{
+				if (!file.Open(BTD::IO::FileInfo(binaryFilepath)))
+				{
+					fmt::print("Smok Asset Manager Error: ShaderModuleCache || Get || Failed to read shader binary at \"{}\".\n", binaryFilepath);
+					return VK_NULL_HANDLE;
+				}
+				data = file.data;
+				size = file.size;
+			}
+
+			//hashes the contents, two paths with the same SPIR-V get the same module
+			const uint64_t hash = HashAssetName(std::string_view((const char*)data, size)); //same FNV-1a used for asset names
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				hashesByPath[binaryFilepath] = hash;
+				auto it = modulesByHash.find(hash);
+				if (it != modulesByHash.end())
+				{
+					modulesReused++;
+					return it->second;
+				}
+			}
+
+			//SPIR-V is a stream of 32 bit words
+			if (size == 0 || size % sizeof(uint32_t) != 0)
+			{
+				fmt::print("Smok Asset Manager Error: ShaderModuleCache || Get || \"{}\" is not a SPIR-V binary, it's size is not a multiple of 4.\n", binaryFilepath);
+				return VK_NULL_HANDLE;
+			}
+
+			VkShaderModule module = VK_NULL_HANDLE;
+			{
+				SMOK_PROFILE_ZONE("ShaderModule::Create");
+				VkShaderModuleCreateInfo info = {};
+				info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+				info.codeSize = size;
+				info.pCode = (const uint32_t*)data; //mappings are page aligned
+				if (vkCreateShaderModule(device, &info, nullptr, &module) != VK_SUCCESS)
+				{
+					fmt::print("Smok Asset Manager Error: ShaderModuleCache || Get || Failed to create shader module from \"{}\".\n", binaryFilepath);
+					return VK_NULL_HANDLE;
+				}
+			}
+
+			//another thread may have made the same SPIR-V while this one was, the first one in is kept
+			std::lock_guard<std::mutex> lock(mutex);
+			auto it = modulesByHash.find(hash);
+			if (it != modulesByHash.end())
+			{
+				vkDestroyShaderModule(device, module, nullptr);
+				modulesReused++;
+				return it->second;
+			}
+
+			modulesCreated++;
+			return (modulesByHash[hash] = module);
+		}
+
+		//gets the stage info for a module made by the cache, the entry point is "main" the same as Wireframe's shaders
+		static inline VkPipelineShaderStageCreateInfo GetStageInfo(VkShaderModule module, const VkShaderStageFlagBits& stage)
+		{
+			VkPipelineShaderStageCreateInfo info = {};
+			info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+			info.stage = stage;
+			info.module = module;
+			info.pName = "main";
+			return info;
+		}
+
+		//destroys every module, pipelines made from them are not affected
+		inline void Destroy()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			for (auto& m : modulesByHash)
+				vkDestroyShaderModule(device, m.second, nullptr);
+			modulesByHash.clear();
+			hashesByPath.clear();
+		}
+	};
+
+	//defines the header written in front of the Vulkan pipeline cache data on disk
+	struct PipelineCacheFileHeader
+	{
+		static constexpr uint32_t MAGIC = 0x48435053; //"SPCH"
+		static constexpr uint32_t VERSION = 1;
+
+		uint32_t magic = MAGIC;
+		uint32_t version = VERSION;
+
+		uint32_t vendorID = 0;
+		uint32_t deviceID = 0;
+		uint32_t driverVersion = 0;
+		uint8_t pipelineCacheUUID[VK_UUID_SIZE] = {};
+		uint32_t padding = 0;
+
+		uint64_t dataSize = 0; //the size of the Vulkan cache data after the header
+		uint64_t dataHash = 0; //a hash of the Vulkan cache data, catches truncated or corrupt files
+	};
+	static_assert(sizeof(PipelineCacheFileHeader) == 56, "PipelineCacheFileHeader is written to disk, it's size can not change");
+
+	//defines a Vulkan pipeline cache that persists between runs
+	//pipelines hit it by passing "cache" to Wireframe's GraphicsPipeline::Create
+	struct PipelineCache
+	{
+		VkPipelineCache cache = VK_NULL_HANDLE;
+		BTD::IO::FileInfo cacheFile; //where the cache is saved
+
+		VkPhysicalDevice physicalDevice = VK_NULL_HANDLE; //the device and driver the saved data is checked against
+		VkDevice device = VK_NULL_HANDLE;
+
+		bool loadedFromDisk = false; //was the cache warm when created
+		double loadMilliseconds = 0.0; //how long reading and creating the cache took
+
+		//gets the header the current device would write
+		static inline PipelineCacheFileHeader GetDeviceHeader(VkPhysicalDevice physicalDevice)
+		{
+			VkPhysicalDeviceProperties properties;
+			vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+			PipelineCacheFileHeader header;
+			header.vendorID = properties.vendorID;
+			header.deviceID = properties.deviceID;
+			header.driverVersion = properties.driverVersion;
+			std::memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+			return header;
+		}
+
+		//creates the cache, using the data saved in _cacheFile if it was made by the same device and driver
+		inline bool Create(VkPhysicalDevice _physicalDevice, VkDevice _device, const BTD::IO::FileInfo& _cacheFile)
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+			Destroy();
+			physicalDevice = _physicalDevice;
+			device = _device;
+			cacheFile = _cacheFile;
+			loadedFromDisk = false;
+
+			//reads and validates the saved data, a mismatch just means starting cold
+			std::vector<uint8_t> initialData;
+			{
+				//no file is a normal first run
+				IO::MappedFile file;
+				if (std::filesystem::exists(cacheFile.GetPathStr()) && file.Open(cacheFile) && file.size >= sizeof(PipelineCacheFileHeader))
+				{
+					PipelineCacheFileHeader saved;
+					std::memcpy(&saved, file.data, sizeof(saved));
+					const PipelineCacheFileHeader current = GetDeviceHeader(physicalDevice);
+					const uint8_t* data = file.data + sizeof(saved);
+
+					if (saved.magic != PipelineCacheFileHeader::MAGIC || saved.version != PipelineCacheFileHeader::VERSION)
+						fmt::print("Smok Asset Manager Warning: PipelineCache || Create || \"{}\" is not a Smok pipeline cache, starting cold.\n", cacheFile.GetPathStr());
+					else if (saved.vendorID != current.vendorID || saved.deviceID != current.deviceID || saved.driverVersion != current.driverVersion ||
+						std::memcmp(saved.pipelineCacheUUID, current.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+						fmt::print("Smok Asset Manager Warning: PipelineCache || Create || \"{}\" was made by a different device or driver, starting cold.\n", cacheFile.GetPathStr());
+					else if (saved.dataSize != file.size - sizeof(saved) || saved.dataHash != HashAssetName(std::string_view((const char*)data, (size_t)saved.dataSize)))
+						fmt::print("Smok Asset Manager Warning: PipelineCache || Create || \"{}\" is truncated or corrupt, starting cold.\n", cacheFile.GetPathStr());
+					else
+						initialData.assign(data, data + saved.dataSize);
+				}
+			}
+
+			VkPipelineCacheCreateInfo info = {};
+			info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+			info.initialDataSize = initialData.size();
+			info.pInitialData = (initialData.empty() ? nullptr : initialData.data());
+			if (vkCreatePipelineCache(device, &info, nullptr, &cache) != VK_SUCCESS)
+			{
+				//the driver may still reject data it wrote, try again empty
+				info.initialDataSize = 0;
+				info.pInitialData = nullptr;
+				initialData.clear();
+				if (vkCreatePipelineCache(device, &info, nullptr, &cache) != VK_SUCCESS)
+				{
+					fmt::print("Smok Asset Manager Error: PipelineCache || Create || Failed to create a pipeline cache.\n");
+					cache = VK_NULL_HANDLE;
+					return false;
+				}
+			}
+
+			loadedFromDisk = !initialData.empty();
+			loadMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			return true;
+		}
+
+		//saves the cache to it's file
+		inline bool Save()
+		{
+			if (cache == VK_NULL_HANDLE)
+				return false;
+
+			size_t dataSize = 0;
+			if (vkGetPipelineCacheData(device, cache, &dataSize, nullptr) != VK_SUCCESS)
+				return false;
+			std::vector<uint8_t> data(dataSize);
+			if (dataSize > 0 && vkGetPipelineCacheData(device, cache, &dataSize, data.data()) != VK_SUCCESS)
+				return false;
+
+			PipelineCacheFileHeader header = GetDeviceHeader(physicalDevice);
+			header.dataSize = dataSize;
+			header.dataHash = HashAssetName(std::string_view((const char*)data.data(), dataSize));
+
+			std::ofstream file(cacheFile.GetPathStr(), std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				fmt::print("Smok Asset Manager Error: PipelineCache || Save || Failed to open \"{}\" for writing.\n", cacheFile.GetPathStr());
+				return false;
+			}
+
+			file.write((const char*)&header, sizeof(header));
+			file.write((const char*)data.data(), dataSize);
+			return file.good();
+		}
+
+		//destroys the cache, does not save it
+		inline void Destroy()
+		{
+			if (cache != VK_NULL_HANDLE)
+				vkDestroyPipelineCache(device, cache, nullptr);
+			cache = VK_NULL_HANDLE;
+			loadedFromDisk = false;
+		}
+	};
+}
\ No newline at end of file
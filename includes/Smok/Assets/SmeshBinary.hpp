@@ -0,0 +1,134 @@
+#pragma once
+
+//defines the layout of the v2 binary smesh container
+//the file is a fixed header, a table of sections and then 64 byte aligned payloads
+//every struct here is written to disk as is, so they must stay trivially copyable and their sizes must not change without bumping the version
+
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+namespace Smok::Asset::Mesh::Binary
+{
+	//the magic at the start of every v2 smesh file, reads "SMSH" in a hex editor
+	static constexpr uint32_t SMESH_MAGIC = 0x48534D53;
+
+	//the version of the binary container
+	static constexpr uint32_t SMESH_BINARY_VERSION = 2;
+
+	//the alignment of every section payload, a cache line so mapped sections can be handed straight to SIMD code and GPU uploads
+	static constexpr uint64_t SMESH_SECTION_ALIGNMENT = 64;
+
+	//the max number of sections a file can have
+	static constexpr uint32_t SMESH_MAX_SECTIONS = 16;
+
+	//defines the types of sections
+	enum class SectionType : uint32_t
+	{
+		None = 0,
+
+		SubMeshTable, //array of SubMeshEntry
+		Vertices, //the raw vertex stream
+		Indices, //every sub-mesh's indices packed back to back as uint32_t
+		VertexQuantization, //a single VertexQuantization, only in files using a packed vertex layout
+		Bounds, //array of Bounds, the whole static mesh first then one per sub-mesh
+		LODTable, //array of LODEntry, one per sub-mesh, only in files with generated LODs
+		MeshletRanges, //array of MeshletRangeEntry, one per sub-mesh, only in files with meshlets
+		Meshlets, //every sub-mesh's Meshlet array packed back to back
+		MeshletVertices, //every sub-mesh's meshlet vertices packed back to back as uint32_t
+		MeshletTriangles, //every sub-mesh's meshlet triangles packed back to back, 3 uint8_t per triangle
+		EncodedVertices, //the vertex stream run through "Codec::EncodeVertices", replaces Vertices
+		EncodedIndices, //every sub-mesh's indices run through "Codec::EncodeIndices" as one stream, replaces Indices
+
+		Count
+	};
+
+	//defines a section in the file
+	struct SectionEntry
+	{
+		SectionType type = SectionType::None;
+		uint32_t elementSize = 0; //the size of a single element in the section
+		uint64_t offset = 0; //the offset from the start of the file, always aligned to SMESH_SECTION_ALIGNMENT
+		uint64_t size = 0; //the size in bytes
+		uint64_t count = 0; //the number of elements
+	};
+	static_assert(sizeof(SectionEntry) == 32, "SectionEntry is written to disk, it's size can not change");
+
+	//defines the fixed header at the start of the file
+	struct FileHeader
+	{
+		uint32_t magic = SMESH_MAGIC;
+		uint32_t version = SMESH_BINARY_VERSION;
+		uint32_t headerSize = 0; //the size of this header, used to validate the file was written with the same layout
+		uint32_t sectionCount = 0; //the number of used sections
+		uint64_t fileSize = 0; //the total size of the file, used to detect truncated files
+
+		uint32_t vertexStride = 0; //the size of a single vertex
+		uint32_t flags = 0; //reserved
+		uint64_t vertexCount = 0; //the number of vertices
+		uint64_t subMeshCount = 0; //the number of sub-meshes
+		uint64_t indexCount = 0; //the total number of indices across every sub-mesh
+		uint32_t vertexLayout = 0; //the VertexLayout the vertex section is stored in
+		uint32_t reserved = 0;
+
+		SectionEntry sections[SMESH_MAX_SECTIONS];
+	};
+	static_assert(sizeof(FileHeader) == 64 + 32 * SMESH_MAX_SECTIONS, "FileHeader is written to disk, it's size can not change");
+	static_assert(std::is_trivially_copyable_v<FileHeader>, "FileHeader must be trivially copyable");
+
+	//defines a sub-mesh in the sub-mesh table
+	struct SubMeshEntry
+	{
+		uint64_t firstIndex = 0; //the index into the index section this sub-mesh starts at
+		uint32_t indexCount = 0; //the number of indices
+		uint32_t LODIndex = 0; //the LOD level
+		uint32_t flags = 0; //see SubMeshFlags
+		uint32_t reserved = 0;
+	};
+	static_assert(sizeof(SubMeshEntry) == 24, "SubMeshEntry is written to disk, it's size can not change");
+
+	//defines a sub-mesh's place in a LOD chain
+	struct LODEntry
+	{
+		uint32_t sourceSubMesh = UINT32_MAX; //the sub-mesh this is a simplified version of, UINT32_MAX for a source sub-mesh
+		float geometricError = 0.0f; //the max distance the simplified surface moved from the source, in mesh units
+	};
+	static_assert(sizeof(LODEntry) == 8, "LODEntry is written to disk, it's size can not change");
+
+	//defines where a sub-mesh's meshlet data sits in the meshlet sections
+	struct MeshletRangeEntry
+	{
+		uint64_t firstMeshlet = 0; //the index into the meshlet section this sub-mesh starts at
+		uint64_t firstVertex = 0; //the index into the meshlet vertex section this sub-mesh starts at
+		uint64_t firstTriangle = 0; //the byte into the meshlet triangle section this sub-mesh starts at
+		uint32_t meshletCount = 0;
+		uint32_t vertexCount = 0;
+		uint32_t triangleSize = 0; //the number of triangle bytes, 3 per triangle
+		uint32_t reserved = 0;
+	};
+	static_assert(sizeof(MeshletRangeEntry) == 40, "MeshletRangeEntry is written to disk, it's size can not change");
+
+	//defines the flags for a sub-mesh
+	enum SubMeshFlags : uint32_t
+	{
+		SubMeshFlag_CanRender = 1 << 0
+	};
+
+	//aligns a offset up to the section alignment
+	static inline constexpr uint64_t AlignSectionOffset(const uint64_t offset)
+	{
+		return (offset + (SMESH_SECTION_ALIGNMENT - 1)) & ~(SMESH_SECTION_ALIGNMENT - 1);
+	}
+
+	//finds a section in the header, returns nullptr if it's not in the file
+	static inline const SectionEntry* FindSection(const FileHeader& header, const SectionType type)
+	{
+		for (uint32_t i = 0; i < header.sectionCount && i < SMESH_MAX_SECTIONS; ++i)
+		{
+			if (header.sections[i].type == type)
+				return &header.sections[i];
+		}
+
+		return nullptr;
+	}
+}
\ No newline at end of file
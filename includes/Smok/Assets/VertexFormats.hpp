@@ -0,0 +1,222 @@
+#pragma once
+
+//defines the compact vertex layouts a static mesh can be cooked into
+//normals are octahedral encoded, colors are unorm8 and texture coords are half floats or unorm16
+//the quantized layouts also store positions as unorm16 relative to the mesh bounds
+
+#include <BTDSTD/Wireframe/Pipeline/VertexInputDesc.hpp>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+namespace Smok::Asset::Mesh
+{
+	//defines the vertex layouts
+	enum class VertexLayout : uint32_t
+	{
+		Float = 0, //the full float Vertex, 44 bytes
+
+		Packed_HalfUV, //PackedVertex with half float texture coords, 24 bytes
+		Packed_UNorm16UV, //PackedVertex with unorm16 texture coords relative to the UV bounds, 24 bytes
+
+		Quantized_HalfUV, //CompactVertex with half float texture coords, 20 bytes
+		Quantized_UNorm16UV, //CompactVertex with unorm16 texture coords relative to the UV bounds, 20 bytes
+
+		Count
+	};
+
+	//defines a vertex with a full float position and packed attributes
+	struct PackedVertex
+	{
+		glm::vec3 position;
+		int16_t normal[2]; //octahedral encoded, snorm16
+		uint8_t color[4]; //unorm8, alpha is always 255
+		uint16_t textureCoords[2]; //half float or unorm16 depending on the layout
+	};
+	static_assert(sizeof(PackedVertex) == 24, "PackedVertex is uploaded as is, it's size can not change");
+
+	//defines a vertex with every attribute quantized
+	struct CompactVertex
+	{
+		uint16_t position[4]; //unorm16 relative to the position bounds, w is padding
+		int16_t normal[2]; //octahedral encoded, snorm16
+		uint8_t color[4]; //unorm8, alpha is always 255
+		uint16_t textureCoords[2]; //half float or unorm16 depending on the layout
+	};
+	static_assert(sizeof(CompactVertex) == 20, "CompactVertex is uploaded as is, it's size can not change");
+
+	//defines the ranges used to dequantize positions and texture coords
+	//shaders rebuild a attribute as min + value * extent, for positions this can be folded into the model matrix
+	struct VertexQuantization
+	{
+		glm::vec3 positionMin = { 0.0f, 0.0f, 0.0f };
+		glm::vec3 positionExtent = { 1.0f, 1.0f, 1.0f };
+		glm::vec2 textureCoordsMin = { 0.0f, 0.0f };
+		glm::vec2 textureCoordsExtent = { 1.0f, 1.0f };
+	};
+	static_assert(sizeof(VertexQuantization) == 40, "VertexQuantization is written to disk, it's size can not change");
+
+	//gets the size of a vertex in the layout
+	static inline uint32_t GetVertexLayoutStride(const VertexLayout& layout)
+	{
+		switch (layout)
+		{
+		case VertexLayout::Packed_HalfUV:
+		case VertexLayout::Packed_UNorm16UV:
+			return sizeof(PackedVertex);
+
+		case VertexLayout::Quantized_HalfUV:
+		case VertexLayout::Quantized_UNorm16UV:
+			return sizeof(CompactVertex);
+
+		default:
+			return 44; //sizeof(Vertex), checked in Mesh.hpp
+		}
+	}
+
+	//does the layout store positions relative to the bounds
+	static inline bool VertexLayoutQuantizesPositions(const VertexLayout& layout)
+	{
+		return (layout == VertexLayout::Quantized_HalfUV || layout == VertexLayout::Quantized_UNorm16UV);
+	}
+
+	//does the layout store texture coords as unorm16 relative to the UV bounds
+	static inline bool VertexLayoutUsesUNorm16UV(const VertexLayout& layout)
+	{
+		return (layout == VertexLayout::Packed_UNorm16UV || layout == VertexLayout::Quantized_UNorm16UV);
+	}
+
+	//encodes a unit vector into octahedral snorm16
+	static inline void EncodeOctahedralNormal(const glm::vec3& normal, int16_t out[2])
+	{
+		const float length = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+		float x = (length > 0.0f ? normal.x / length : 0.0f);
+		float y = (length > 0.0f ? normal.y / length : 0.0f);
+		if (normal.z < 0.0f)
+		{
+			const float foldedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+			const float foldedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+			x = foldedX;
+			y = foldedY;
+		}
+
+		out[0] = (int16_t)std::lround(glm::clamp(x, -1.0f, 1.0f) * 32767.0f);
+		out[1] = (int16_t)std::lround(glm::clamp(y, -1.0f, 1.0f) * 32767.0f);
+	}
+
+	//decodes a octahedral snorm16 normal
+	static inline glm::vec3 DecodeOctahedralNormal(const int16_t in[2])
+	{
+		const float x = glm::max((float)in[0] / 32767.0f, -1.0f);
+		const float y = glm::max((float)in[1] / 32767.0f, -1.0f);
+		glm::vec3 normal = { x, y, 1.0f - std::fabs(x) - std::fabs(y) };
+		if (normal.z < 0.0f)
+		{
+			const float unfoldedX = (1.0f - std::fabs(normal.y)) * (normal.x >= 0.0f ? 1.0f : -1.0f);
+			const float unfoldedY = (1.0f - std::fabs(normal.x)) * (normal.y >= 0.0f ? 1.0f : -1.0f);
+			normal.x = unfoldedX;
+			normal.y = unfoldedY;
+		}
+
+		return glm::normalize(normal);
+	}
+
+	//encodes a float from 0.0 to 1.0 into unorm8
+	static inline uint8_t EncodeUNorm8(const float& value) { return (uint8_t)std::lround(glm::clamp(value, 0.0f, 1.0f) * 255.0f); }
+
+	//encodes a float from 0.0 to 1.0 into unorm16
+	static inline uint16_t EncodeUNorm16(const float& value) { return (uint16_t)std::lround(glm::clamp(value, 0.0f, 1.0f) * 65535.0f); }
+
+	//encodes a value into unorm16 relative to a range
+	static inline uint16_t EncodeRangedUNorm16(const float& value, const float& min, const float& extent)
+	{
+		return EncodeUNorm16(extent > 0.0f ? (value - min) / extent : 0.0f);
+	}
+
+	//decodes a unorm16 relative to a range
+	static inline float DecodeRangedUNorm16(const uint16_t& value, const float& min, const float& extent)
+	{
+		return min + ((float)value / 65535.0f) * extent;
+	}
+
+	//encodes texture coords for the layout
+	static inline void EncodeTextureCoords(const glm::vec2& uv, const VertexLayout& layout, const VertexQuantization& quantization, uint16_t out[2])
+	{
+		if (VertexLayoutUsesUNorm16UV(layout))
+		{
+			out[0] = EncodeRangedUNorm16(uv.x, quantization.textureCoordsMin.x, quantization.textureCoordsExtent.x);
+			out[1] = EncodeRangedUNorm16(uv.y, quantization.textureCoordsMin.y, quantization.textureCoordsExtent.y);
+		}
+		else
+		{
+			out[0] = glm::packHalf1x16(uv.x);
+			out[1] = glm::packHalf1x16(uv.y);
+		}
+	}
+
+	//decodes texture coords from the layout
+	static inline glm::vec2 DecodeTextureCoords(const uint16_t in[2], const VertexLayout& layout, const VertexQuantization& quantization)
+	{
+		if (VertexLayoutUsesUNorm16UV(layout))
+			return { DecodeRangedUNorm16(in[0], quantization.textureCoordsMin.x, quantization.textureCoordsExtent.x),
+				DecodeRangedUNorm16(in[1], quantization.textureCoordsMin.y, quantization.textureCoordsExtent.y) };
+
+		return { glm::unpackHalf1x16(in[0]), glm::unpackHalf1x16(in[1]) };
+	}
+
+	//generates the vertex input description for a packed or quantized layout
+	//the float layout is described by Vertex::GenerateVertexInputDescription
+	static inline Wireframe::Pipeline::VertexInputDescription GenerateVertexInputDescription_Packed(const VertexLayout& layout)
+	{
+		Wireframe::Pipeline::VertexInputDescription description;
+
+		const bool quantizedPositions = VertexLayoutQuantizesPositions(layout);
+
+		//we will have just 1 vertex buffer binding, with a per-vertex rate
+		VkVertexInputBindingDescription mainBinding = {};
+		mainBinding.binding = 0;
+		mainBinding.stride = GetVertexLayoutStride(layout);
+		mainBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+		description.bindings.push_back(mainBinding);
+
+		//Position will be stored at Location 0, quantized positions come in as 0.0 to 1.0 and are rebuilt with the VertexQuantization
+		VkVertexInputAttributeDescription positionAttribute = {};
+		positionAttribute.binding = 0;
+		positionAttribute.location = 0;
+		positionAttribute.format = (quantizedPositions ? VK_FORMAT_R16G16B16A16_UNORM : VK_FORMAT_R32G32B32_SFLOAT);
+		positionAttribute.offset = (quantizedPositions ? offsetof(CompactVertex, position) : offsetof(PackedVertex, position));
+
+		//Normal will be stored at Location 1, shaders need to decode the octahedral normal
+		VkVertexInputAttributeDescription normalAttribute = {};
+		normalAttribute.binding = 0;
+		normalAttribute.location = 1;
+		normalAttribute.format = VK_FORMAT_R16G16_SNORM;
+		normalAttribute.offset = (quantizedPositions ? offsetof(CompactVertex, normal) : offsetof(PackedVertex, normal));
+
+		//Color will be stored at Location 2
+		VkVertexInputAttributeDescription colorAttribute = {};
+		colorAttribute.binding = 0;
+		colorAttribute.location = 2;
+		colorAttribute.format = VK_FORMAT_R8G8B8A8_UNORM;
+		colorAttribute.offset = (quantizedPositions ? offsetof(CompactVertex, color) : offsetof(PackedVertex, color));
+
+		//Texture Coords will be stored at Location 3
+		VkVertexInputAttributeDescription texCordsAttribute = {};
+		texCordsAttribute.binding = 0;
+		texCordsAttribute.location = 3;
+		texCordsAttribute.format = (VertexLayoutUsesUNorm16UV(layout) ? VK_FORMAT_R16G16_UNORM : VK_FORMAT_R16G16_SFLOAT);
+		texCordsAttribute.offset = (quantizedPositions ? offsetof(CompactVertex, textureCoords) : offsetof(PackedVertex, textureCoords));
+
+		description.attributes.push_back(positionAttribute);
+		description.attributes.push_back(normalAttribute);
+		description.attributes.push_back(colorAttribute);
+		description.attributes.push_back(texCordsAttribute);
+		return description;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,247 @@
+#pragma once
+
+//defines hashed vertex welding for Smok meshes
+//replaces the linear VertexIsAlreadyInArray search when deduplicating imported meshes, runs in near linear time
+
+#include <Smok/Assets/Mesh.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace Smok::Asset::Mesh
+{
+	//defines the settings for welding
+	//a epsilon of 0 only merges bit exact attributes, anything above snaps the attribute to a grid of that size before comparing
+	struct WeldSettings
+	{
+		float positionEpsilon = 0.0f;
+		float normalEpsilon = 0.0f;
+		float colorEpsilon = 0.0f;
+		float textureCoordsEpsilon = 0.0f;
+	};
+
+	//defines the results of a weld
+	struct WeldStats
+	{
+		size_t inputVertexCount = 0; //the number of vertices going in
+		size_t outputVertexCount = 0; //the number of unique vertices left
+
+		//gets the number of vertices removed
+		inline size_t RemovedVertexCount() const { return inputVertexCount - outputVertexCount; }
+
+		//gets how much the vertex count shrunk, 0.0 to 1.0
+		inline float ReductionRatio() const { return (inputVertexCount == 0 ? 0.0f : (float)RemovedVertexCount() / (float)inputVertexCount); }
+	};
+
+	//defines a vertex hashed by it's quantized attributes
+	struct QuantizedVertex
+	{
+		uint32_t keys[11];
+
+		inline bool operator==(const QuantizedVertex& other) const { return std::memcmp(keys, other.keys, sizeof(keys)) == 0; }
+	};
+
+	//defines a open addressing hash table that maps quantized vertices to indices in the welded vertex array
+	struct VertexWelder
+	{
+		WeldSettings settings;
+
+		std::vector<Vertex>* vertices = nullptr; //the welded vertices being written to
+		std::vector<QuantizedVertex> keys; //the quantized key of every welded vertex
+		std::vector<uint32_t> table; //the hash table storing indices into vertices, UINT32_MAX is a empty slot
+		size_t tableMask = 0;
+
+		WeldStats stats;
+
+		//quantizes a single float
+		static inline uint32_t QuantizeFloat(const float& value, const float& epsilon)
+		{
+			if (epsilon > 0.0f)
+				return (uint32_t)(int32_t)std::floor(value / epsilon + 0.5f);
+
+			//-0.0 and 0.0 are the same vertex
+			const float v = (value == 0.0f ? 0.0f : value);
+			uint32_t bits;
+			std::memcpy(&bits, &v, sizeof(bits));
+			return bits;
+		}
+
+		//quantizes a vertex
+		inline QuantizedVertex Quantize(const Vertex& vertex) const
+		{
+			return { {
+				QuantizeFloat(vertex.position.x, settings.positionEpsilon), QuantizeFloat(vertex.position.y, settings.positionEpsilon), QuantizeFloat(vertex.position.z, settings.positionEpsilon),
+				QuantizeFloat(vertex.normal.x, settings.normalEpsilon), QuantizeFloat(vertex.normal.y, settings.normalEpsilon), QuantizeFloat(vertex.normal.z, settings.normalEpsilon),
+				QuantizeFloat(vertex.color.x, settings.colorEpsilon), QuantizeFloat(vertex.color.y, settings.colorEpsilon), QuantizeFloat(vertex.color.z, settings.colorEpsilon),
+				QuantizeFloat(vertex.textureCoords.x, settings.textureCoordsEpsilon), QuantizeFloat(vertex.textureCoords.y, settings.textureCoordsEpsilon) } };
+		}
+
+		//hashes a quantized vertex
+		static inline uint64_t Hash(const QuantizedVertex& key)
+		{
+			uint64_t hash = 0xcbf29ce484222325ull;
+			for (uint32_t i = 0; i < 11; ++i)
+			{
+				hash ^= key.keys[i];
+				hash *= 0x100000001b3ull;
+				hash ^= hash >> 29;
+			}
+
+			return hash;
+		}
+
+		//starts a weld writing into the vertex array, expectedVertexCount is used to size the table so it never has to grow
+		inline void Begin(std::vector<Vertex>& outVertices, const size_t& expectedVertexCount, const WeldSettings& weldSettings)
+		{
+			settings = weldSettings;
+			vertices = &outVertices;
+			vertices->clear();
+			vertices->reserve(expectedVertexCount);
+			keys.clear();
+			keys.reserve(expectedVertexCount);
+
+			//keep the load factor under 50%
+			size_t capacity = 16;
+			while (capacity < expectedVertexCount * 2)
+				capacity <<= 1;
+			table.assign(capacity, UINT32_MAX);
+			tableMask = capacity - 1;
+
+			stats = WeldStats();
+		}
+
+		//adds a vertex, returning the index of the welded vertex it maps to
+		inline uint32_t AddVertex(const Vertex& vertex)
+		{
+			stats.inputVertexCount++;
+
+			const QuantizedVertex key = Quantize(vertex);
+			size_t slot = (size_t)Hash(key) & tableMask;
+			while (table[slot] != UINT32_MAX)
+			{
+				if (keys[table[slot]] == key)
+					return table[slot];
+				slot = (slot + 1) & tableMask;
+			}
+
+			const uint32_t index = (uint32_t)vertices->size();
+			vertices->emplace_back(vertex);
+			keys.emplace_back(key);
+			table[slot] = index;
+			stats.outputVertexCount++;
+
+			//a input bigger than the expected count would overfill the table, grow it and re-insert
+			if (keys.size() * 2 > table.size())
+				Rehash(table.size() * 2);
+
+			return index;
+		}
+
+		//grows the hash table
+		inline void Rehash(const size_t& capacity)
+		{
+			table.assign(capacity, UINT32_MAX);
+			tableMask = capacity - 1;
+			for (uint32_t i = 0; i < (uint32_t)keys.size(); ++i)
+			{
+				size_t slot = (size_t)Hash(keys[i]) & tableMask;
+				while (table[slot] != UINT32_MAX)
+					slot = (slot + 1) & tableMask;
+				table[slot] = i;
+			}
+		}
+	};
+
+	//welds a triangle soup, every 3 vertices is a triangle. Outputs a static mesh with a single sub-mesh
+	static inline WeldStats WeldTriangleSoup(const Vertex* soup, const size_t& vertexCount, StaticMesh& mesh, const WeldSettings& settings = WeldSettings())
+	{
+		VertexWelder welder;
+		welder.Begin(mesh.vertices, vertexCount, settings);
+
+		mesh.meshes.resize(1);
+		mesh.meshes[0].indices.resize(vertexCount);
+		for (size_t i = 0; i < vertexCount; ++i)
+			mesh.meshes[0].indices[i] = welder.AddVertex(soup[i]);
+
+		mesh.vertices.shrink_to_fit();
+		return welder.stats;
+	}
+
+	//welds a triangle soup per sub-mesh, all sub-meshes share the welded vertices of the static mesh
+	static inline WeldStats WeldTriangleSoups(const std::vector<std::vector<Vertex>>& subMeshSoups, StaticMesh& mesh, const WeldSettings& settings = WeldSettings())
+	{
+		size_t vertexCount = 0;
+		for (size_t m = 0; m < subMeshSoups.size(); ++m)
+			vertexCount += subMeshSoups[m].size();
+
+		VertexWelder welder;
+		welder.Begin(mesh.vertices, vertexCount, settings);
+
+		mesh.meshes.resize(subMeshSoups.size());
+		for (size_t m = 0; m < subMeshSoups.size(); ++m)
+		{
+			const std::vector<Vertex>& soup = subMeshSoups[m];
+			std::vector<uint32_t>& indices = mesh.meshes[m].indices;
+			indices.resize(soup.size());
+			for (size_t i = 0; i < soup.size(); ++i)
+				indices[i] = welder.AddVertex(soup[i]);
+		}
+
+		mesh.vertices.shrink_to_fit();
+		return welder.stats;
+	}
+
+	//welds a already indexed static mesh in place, vertices are deduplicated and every sub-mesh's indices are remapped
+	//packed meshes are welded on their decoded vertices, the packed bytes of the first vertex in each group are kept so nothing is quantized twice
+	static inline WeldStats WeldStaticMesh(StaticMesh& mesh, const WeldSettings& settings = WeldSettings())
+	{
+		std::vector<Vertex> unpacked;
+		const Vertex* vertices = mesh.vertices.data();
+		const size_t vertexCount = mesh.GetVertexCount();
+		if (mesh.vertexLayout != VertexLayout::Float)
+		{
+			UnpackVertices(mesh.packedVertices.data(), vertexCount, mesh.vertexLayout, mesh.quantization, unpacked);
+			vertices = unpacked.data();
+		}
+
+		std::vector<Vertex> welded;
+		VertexWelder welder;
+		welder.Begin(welded, vertexCount, settings);
+
+		std::vector<uint32_t> remap(vertexCount);
+		std::vector<uint32_t> firstSources; //the source vertex each welded vertex came from
+		firstSources.reserve(vertexCount);
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			remap[i] = welder.AddVertex(vertices[i]);
+			if (remap[i] == firstSources.size())
+				firstSources.emplace_back((uint32_t)i);
+		}
+
+		for (size_t m = 0; m < mesh.meshes.size(); ++m)
+		{
+			std::vector<uint32_t>& indices = mesh.meshes[m].indices;
+			for (size_t i = 0; i < indices.size(); ++i)
+				indices[i] = remap[indices[i]];
+
+			std::vector<uint32_t>& meshletVertices = mesh.meshes[m].meshletVertices;
+			for (size_t i = 0; i < meshletVertices.size(); ++i)
+				meshletVertices[i] = remap[meshletVertices[i]];
+		}
+
+		if (mesh.vertexLayout != VertexLayout::Float)
+		{
+			const size_t stride = GetVertexLayoutStride(mesh.vertexLayout);
+			std::vector<uint8_t> packed(firstSources.size() * stride);
+			for (size_t v = 0; v < firstSources.size(); ++v)
+				std::memcpy(packed.data() + v * stride, mesh.packedVertices.data() + (size_t)firstSources[v] * stride, stride);
+			mesh.packedVertices = std::move(packed);
+			return welder.stats;
+		}
+
+		welded.shrink_to_fit();
+		mesh.vertices = std::move(welded);
+		return welder.stats;
+	}
+}
\ No newline at end of file
@@ -4,6 +4,8 @@
 
 #include <BTDSTD/ECS/IComponent.hpp>
 
+#include <Smok/Rendering/Frustum.hpp>
+
 #include <glm/gtx/transform.hpp>
 
 namespace Smok::ECS::Comp
@@ -32,5 +34,13 @@ namespace Smok::ECS::Comp
 		}
 
 		//generates perspective * view
+		inline glm::mat4 GeneratePV()
+		{
+			PV = projection * view;
+			return PV;
+		}
+
+		//extracts the view frustum from the last generated perspective * view
+		inline Smok::Rendering::Frustum ExtractFrustum() const { return Smok::Rendering::Frustum::FromMatrix(PV); }
 	};
 }
\ No newline at end of file
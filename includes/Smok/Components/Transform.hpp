@@ -24,10 +24,12 @@ namespace Smok::ECS::Comp
 
 		glm::mat4 modelMatrix = glm::mat4(1.0f);
 
+		uint32_t storeIndex = UINT32_MAX; //the index in a TransformStore this component is bound to, if any
+
 		//generates the model matrix regardless of dirty flag, does not reset dirty flag
 		inline glm::mat4 GenerateModelMatrix_Forced()
 		{
-			modelMatrix = glm::translate(glm::mat4(1.0f), position) * glm::toMat4(rotation);
+			modelMatrix = glm::translate(glm::mat4(1.0f), position) * glm::toMat4(rotation) * glm::scale(glm::mat4(1.0f), scale);
 			return modelMatrix;
 		}
 
@@ -44,10 +46,10 @@ namespace Smok::ECS::Comp
 		}
 
 		//gets the eular rotation in radians
-		inline glm::vec3 GetEularRotation_Radians() const {(rotationDataIsInRadians == true ? eularRotation : glm::radians(eularRotation));}
+		inline glm::vec3 GetEularRotation_Radians() const { return (rotationDataIsInRadians == true ? eularRotation : glm::radians(eularRotation));}
 
 		//gets the eular rotation in degrees
-		inline glm::vec3 GetEularRotation_Degrees() const { (rotationDataIsInRadians == false ? eularRotation : glm::degrees(eularRotation)); }
+		inline glm::vec3 GetEularRotation_Degrees() const { return (rotationDataIsInRadians == false ? eularRotation : glm::degrees(eularRotation)); }
 
 		//gets eular rotation from quaterion rotation || returned eular WILL BE in radians
 		inline glm::vec3 GetEularRotationFromQuaterion() const { return glm::eulerAngles(rotation); }
@@ -0,0 +1,287 @@
+#pragma once
+
+//defines a parent/child hierarchy of transforms
+//nodes are kept in depth first order so every subtree is a contiguous range and a parent always comes before it's children
+//changing a node only marks it's subtree dirty, world matrices are rebuilt with a linear sweep over the dirty ranges, no recursion
+
+#include <Smok/Components/Transform.hpp>
+#include <Smok/Profiling/Profiler.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace Smok::ECS::Comp
+{
+	//defines a hierarchy of transforms
+	struct TransformHierarchy
+	{
+		//defines a invalid node handle, used for root nodes parent
+		static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+		//---data stored by handle, handles never move
+
+		std::vector<uint32_t> parentHandles; //the parent of each node
+		std::vector<uint32_t> firstChildHandles; //the first child of each node
+		std::vector<uint32_t> nextSiblingHandles; //the next sibling of each node
+		std::vector<uint32_t> handleToIndex; //where each node lives in the depth first arrays, NO_NODE if the handle is free
+		std::vector<uint32_t> freeHandles; //handles that can be reused
+		uint32_t firstRootHandle = NO_NODE; //the first root node, roots are linked through nextSiblingHandles
+
+		//---data stored in depth first order
+
+		std::vector<Transform> locals; //the local transform of each node, relative to it's parent
+		std::vector<glm::mat4> worldMatrices; //the world matrix of each node
+		std::vector<uint32_t> parentIndices; //the index of each node's parent, always less than the node's index
+		std::vector<uint32_t> subtreeSizes; //the number of nodes in each node's subtree, including it's self
+		std::vector<uint32_t> indexToHandle; //the handle of each node
+
+		//---dirty tracking
+
+		std::vector<uint32_t> dirtyHandles; //nodes changed since the last update
+		std::vector<uint8_t> dirtyQueued; //by handle, is the node already in dirtyHandles
+		std::vector<uint32_t> dirtyIndicesScratch; //reused every update
+		bool orderIsDirty = false; //nodes were added, removed or reparented
+
+		//gets the number of nodes
+		inline size_t GetNodeCount() const { return parentHandles.size() - freeHandles.size(); }
+
+		//is a handle a live node
+		inline bool IsValid(const uint32_t& handle) const { return handle < parentHandles.size() && dirtyQueued[handle] != 2; }
+
+		//marks a node dirty, it and it's subtree will be rebuilt in the next update
+		inline void MarkDirty(const uint32_t& handle)
+		{
+			if (dirtyQueued[handle] != 0)
+				return;
+
+			dirtyQueued[handle] = 1;
+			dirtyHandles.emplace_back(handle);
+		}
+
+		//adds a node, parent can be NO_NODE for a root
+		inline uint32_t AddNode(const Transform& local, const uint32_t& parent = NO_NODE)
+		{
+			uint32_t handle;
+			if (!freeHandles.empty())
+			{
+				handle = freeHandles.back();
+				freeHandles.pop_back();
+			}
+			else
+			{
+				handle = (uint32_t)parentHandles.size();
+				parentHandles.emplace_back(NO_NODE);
+				firstChildHandles.emplace_back(NO_NODE);
+				nextSiblingHandles.emplace_back(NO_NODE);
+				handleToIndex.emplace_back(NO_NODE);
+				dirtyQueued.emplace_back(0);
+			}
+
+			parentHandles[handle] = NO_NODE;
+			firstChildHandles[handle] = NO_NODE;
+			dirtyQueued[handle] = 0;
+			LinkToParent(handle, parent);
+
+			//new nodes go on the end until the next update sorts them into place
+			handleToIndex[handle] = (uint32_t)locals.size();
+			locals.emplace_back(local);
+			locals.back().isDirty = true;
+			worldMatrices.emplace_back(1.0f);
+			parentIndices.emplace_back(NO_NODE);
+			subtreeSizes.emplace_back(1);
+			indexToHandle.emplace_back(handle);
+
+			orderIsDirty = true;
+			MarkDirty(handle);
+			return handle;
+		}
+
+		//removes a node and it's whole subtree
+		inline void RemoveNode(const uint32_t& handle)
+		{
+			UnlinkFromParent(handle);
+
+			//walk the subtree with a explicit stack and free every handle
+			std::vector<uint32_t> stack = { handle };
+			while (!stack.empty())
+			{
+				const uint32_t node = stack.back();
+				stack.pop_back();
+				for (uint32_t child = firstChildHandles[node]; child != NO_NODE; child = nextSiblingHandles[child])
+					stack.emplace_back(child);
+
+				parentHandles[node] = NO_NODE;
+				firstChildHandles[node] = NO_NODE;
+				nextSiblingHandles[node] = NO_NODE;
+				dirtyQueued[node] = 2; //marks the handle dead, stale dirty entries are skipped
+				freeHandles.emplace_back(node);
+			}
+
+			orderIsDirty = true;
+		}
+
+		//moves a node and it's subtree under a new parent, NO_NODE makes it a root
+		inline void SetParent(const uint32_t& handle, const uint32_t& parent)
+		{
+			//can not parent a node to it's self or it's own subtree
+			for (uint32_t p = parent; p != NO_NODE; p = parentHandles[p])
+			{
+				if (p == handle)
+					return;
+			}
+
+			UnlinkFromParent(handle);
+			LinkToParent(handle, parent);
+			orderIsDirty = true;
+			MarkDirty(handle);
+		}
+
+		//gets a node's parent
+		inline uint32_t GetParent(const uint32_t& handle) const { return parentHandles[handle]; }
+
+		//gets a node's local transform for reading
+		inline const Transform& GetLocal(const uint32_t& handle) const { return locals[handleToIndex[handle]]; }
+
+		//gets a node's local transform for editing and marks it dirty
+		inline Transform& EditLocal(const uint32_t& handle)
+		{
+			MarkDirty(handle);
+			Transform& local = locals[handleToIndex[handle]];
+			local.isDirty = true;
+			return local;
+		}
+
+		//gets a node's world matrix, up to date after UpdateWorldMatrices
+		inline const glm::mat4& GetWorldMatrix(const uint32_t& handle) const { return worldMatrices[handleToIndex[handle]]; }
+
+		//rebuilds the world matrices of every dirty subtree, returns the number of nodes rebuilt
+		inline size_t UpdateWorldMatrices()
+		{
+			SMOK_PROFILE_ZONE("TransformHierarchy::UpdateWorldMatrices");
+
+			if (orderIsDirty)
+				RebuildOrder();
+
+			if (dirtyHandles.empty())
+				return 0;
+
+			//sort the dirty nodes so nested dirty subtrees are covered by their dirty ancestor's sweep
+			dirtyIndicesScratch.clear();
+			for (size_t i = 0; i < dirtyHandles.size(); ++i)
+			{
+				const uint32_t handle = dirtyHandles[i];
+				if (dirtyQueued[handle] == 2)
+					continue;
+				dirtyQueued[handle] = 0;
+				dirtyIndicesScratch.emplace_back(handleToIndex[handle]);
+			}
+			dirtyHandles.clear();
+			std::sort(dirtyIndicesScratch.begin(), dirtyIndicesScratch.end());
+
+			size_t updated = 0;
+			uint32_t sweptEnd = 0;
+			for (size_t d = 0; d < dirtyIndicesScratch.size(); ++d)
+			{
+				const uint32_t first = dirtyIndicesScratch[d];
+				if (first < sweptEnd)
+					continue;
+
+				const uint32_t end = first + subtreeSizes[first];
+				for (uint32_t i = first; i < end; ++i)
+				{
+					const uint32_t parent = parentIndices[i];
+					worldMatrices[i] = (parent == NO_NODE ? locals[i].ModelMatrix() : worldMatrices[parent] * locals[i].ModelMatrix());
+				}
+
+				updated += end - first;
+				sweptEnd = end;
+			}
+
+			return updated;
+		}
+
+		//---internal
+
+		//links a node as the first child of a parent, or as a root
+		inline void LinkToParent(const uint32_t& handle, const uint32_t& parent)
+		{
+			parentHandles[handle] = parent;
+			if (parent == NO_NODE)
+			{
+				nextSiblingHandles[handle] = firstRootHandle;
+				firstRootHandle = handle;
+			}
+			else
+			{
+				nextSiblingHandles[handle] = firstChildHandles[parent];
+				firstChildHandles[parent] = handle;
+			}
+		}
+
+		//unlinks a node from it's parent's child list, or from the root list
+		inline void UnlinkFromParent(const uint32_t& handle)
+		{
+			const uint32_t parent = parentHandles[handle];
+			uint32_t* link = (parent == NO_NODE ? &firstRootHandle : &firstChildHandles[parent]);
+			while (*link != NO_NODE && *link != handle)
+				link = &nextSiblingHandles[*link];
+			if (*link == handle)
+				*link = nextSiblingHandles[handle];
+
+			nextSiblingHandles[handle] = NO_NODE;
+			parentHandles[handle] = NO_NODE;
+		}
+
+		//re-sorts every node into depth first order, only runs after the structure changed
+		inline void RebuildOrder()
+		{
+			const size_t liveCount = parentHandles.size() - freeHandles.size();
+			std::vector<Transform> newLocals;
+			std::vector<glm::mat4> newWorlds;
+			newLocals.reserve(liveCount);
+			newWorlds.reserve(liveCount);
+			parentIndices.assign(liveCount, NO_NODE);
+			subtreeSizes.assign(liveCount, 1);
+			indexToHandle.assign(liveCount, NO_NODE);
+
+			//iterative pre-order walk, the stack holds handles still to visit
+			std::vector<uint32_t> stack;
+			for (uint32_t root = firstRootHandle; root != NO_NODE; root = nextSiblingHandles[root])
+				stack.emplace_back(root);
+			std::reverse(stack.begin(), stack.end());
+
+			std::vector<uint32_t> newHandleToIndex(handleToIndex.size(), NO_NODE);
+			while (!stack.empty())
+			{
+				const uint32_t handle = stack.back();
+				stack.pop_back();
+
+				const uint32_t index = (uint32_t)newLocals.size();
+				newLocals.emplace_back(locals[handleToIndex[handle]]);
+				newWorlds.emplace_back(worldMatrices[handleToIndex[handle]]);
+				newHandleToIndex[handle] = index;
+				indexToHandle[index] = handle;
+
+				const uint32_t parent = parentHandles[handle];
+				parentIndices[index] = (parent == NO_NODE ? NO_NODE : newHandleToIndex[parent]);
+
+				const size_t childStart = stack.size();
+				for (uint32_t child = firstChildHandles[handle]; child != NO_NODE; child = nextSiblingHandles[child])
+					stack.emplace_back(child);
+				std::reverse(stack.begin() + childStart, stack.end());
+			}
+
+			//subtree sizes are accumulated back to front, children always come after their parent
+			for (size_t i = liveCount; i-- > 0;)
+			{
+				if (parentIndices[i] != NO_NODE)
+					subtreeSizes[parentIndices[i]] += subtreeSizes[i];
+			}
+
+			locals = std::move(newLocals);
+			worldMatrices = std::move(newWorlds);
+			handleToIndex = std::move(newHandleToIndex);
+			orderIsDirty = false;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,471 @@
+#pragma once
+
+//defines a structure of arrays store for transforms
+//companion storage for Smok::ECS::Comp::Transform, positions, rotations and scales are kept in their own arrays
+//so every dirty model matrix can be rebuilt in one SIMD pass instead of one at a time behind a per object branch
+
+#include <Smok/Components/Transform.hpp>
+#include <Smok/Profiling/Profiler.hpp>
+
+#include <glm/mat4x4.hpp>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define SMOK_TRANSFORM_STORE_SSE
+#include <immintrin.h>
+#endif
+
+namespace Smok::ECS::Comp
+{
+	struct TransformStore;
+
+	//defines the worker threads a transform store splits UpdateDirtyMatrices across, they are started once and sleep between updates
+	struct TransformStoreWorkers
+	{
+		std::vector<std::thread> threads;
+
+		std::mutex mutex;
+		std::condition_variable jobCondition; //signaled when a update is handed out || the workers are shutting down
+		std::condition_variable doneCondition; //signaled when the last worker finishes it's share
+
+		//the current update, worker t rebuilds the dirty words of share t + 1, the calling thread does share 0
+		TransformStore* store = nullptr;
+		size_t wordsPerThread = 0;
+		size_t wordCount = 0;
+		size_t* groupsUpdated = nullptr;
+		uint32_t jobWorkerCount = 0; //the number of workers taking part in the current update
+		uint32_t workersDone = 0;
+		uint64_t jobGeneration = 0; //bumped every update so a worker never runs the same one twice
+
+		bool isRunning = true;
+
+		TransformStoreWorkers() = default;
+		TransformStoreWorkers(const TransformStoreWorkers&) = delete;
+		TransformStoreWorkers& operator=(const TransformStoreWorkers&) = delete;
+
+		//stops and joins the workers
+		inline ~TransformStoreWorkers()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				isRunning = false;
+			}
+			jobCondition.notify_all();
+			for (size_t i = 0; i < threads.size(); ++i)
+				threads[i].join();
+		}
+
+		//starts workers until there are at least workerCount
+		inline void Reserve(const uint32_t& workerCount)
+		{
+			while (threads.size() < workerCount)
+			{
+				const uint32_t index = (uint32_t)threads.size();
+				threads.emplace_back([this, index]() { WorkerLoop(index); });
+			}
+		}
+
+		//runs a update split into workerCount + 1 shares, blocks until every share is done
+		inline void Run(TransformStore* _store, const uint32_t& workerCount, const size_t& _wordsPerThread, const size_t& _wordCount, size_t* _groupsUpdated);
+
+		//the worker thread loop
+		inline void WorkerLoop(const uint32_t& index);
+	};
+
+	//owns a store's workers, a copied store starts it's own instead of sharing them
+	struct TransformStoreWorkersHandle
+	{
+		std::unique_ptr<TransformStoreWorkers> workers;
+
+		TransformStoreWorkersHandle() = default;
+		TransformStoreWorkersHandle(const TransformStoreWorkersHandle&) {}
+		TransformStoreWorkersHandle(TransformStoreWorkersHandle&&) = default;
+		TransformStoreWorkersHandle& operator=(const TransformStoreWorkersHandle&) { return *this; }
+		TransformStoreWorkersHandle& operator=(TransformStoreWorkersHandle&&) = default;
+	};
+
+	//defines a SoA transform store
+	struct TransformStore
+	{
+		//transforms are processed in groups of this many, the arrays are always padded to it
+		static constexpr uint32_t GROUP_SIZE = 8;
+
+		//below this many transforms per thread it is not worth spinning up threads
+		static constexpr size_t MIN_TRANSFORMS_PER_THREAD = 16384;
+
+		size_t count = 0; //the number of transforms
+
+		std::vector<float> positionX, positionY, positionZ;
+		std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+		std::vector<float> scaleX, scaleY, scaleZ;
+
+		std::vector<glm::mat4> modelMatrices; //the generated model matrices
+
+		std::vector<uint64_t> dirtyBits; //one bit per transform, set when it's matrix needs rebuilding
+
+		TransformStoreWorkersHandle workers; //created the first time a update is split across threads
+
+		//gets the padded size of the arrays
+		static inline size_t PaddedSize(const size_t& size) { return (size + GROUP_SIZE - 1) & ~(size_t)(GROUP_SIZE - 1); }
+
+		//reserves space for transforms
+		inline void Reserve(const size_t& capacity)
+		{
+			const size_t padded = PaddedSize(capacity);
+			for (std::vector<float>* array : { &positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &rotationW, &scaleX, &scaleY, &scaleZ })
+				array->reserve(padded);
+			modelMatrices.reserve(padded);
+			dirtyBits.reserve((padded + 63) / 64);
+		}
+
+		//clears all transforms
+		inline void Clear()
+		{
+			count = 0;
+			for (std::vector<float>* array : { &positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &rotationW, &scaleX, &scaleY, &scaleZ })
+				array->clear();
+			modelMatrices.clear();
+			dirtyBits.clear();
+		}
+
+		//marks a transform as dirty
+		inline void MarkDirty(const uint32_t& index) { dirtyBits[index >> 6] |= (1ull << (index & 63)); }
+
+		//is a transform dirty
+		inline bool IsDirty(const uint32_t& index) const { return (dirtyBits[index >> 6] >> (index & 63)) & 1ull; }
+
+		//adds a transform, returns it's index in the store
+		inline uint32_t Add(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+		{
+			const uint32_t index = (uint32_t)count++;
+
+			//grow by a whole group so SIMD loads never run past the end, padding transforms are identity
+			if (index >= positionX.size())
+			{
+				const size_t padded = PaddedSize(count);
+				positionX.resize(padded, 0.0f); positionY.resize(padded, 0.0f); positionZ.resize(padded, 0.0f);
+				rotationX.resize(padded, 0.0f); rotationY.resize(padded, 0.0f); rotationZ.resize(padded, 0.0f); rotationW.resize(padded, 1.0f);
+				scaleX.resize(padded, 1.0f); scaleY.resize(padded, 1.0f); scaleZ.resize(padded, 1.0f);
+				modelMatrices.resize(padded, glm::mat4(1.0f));
+				dirtyBits.resize((padded + 63) / 64, 0);
+			}
+
+			SetTRS(index, position, rotation, scale);
+			return index;
+		}
+
+		//adds a transform component, the component is bound to the store through it's storeIndex
+		inline uint32_t Add(Transform& transform)
+		{
+			transform.storeIndex = Add(transform.position, transform.rotation, transform.scale);
+			return transform.storeIndex;
+		}
+
+		//removes a transform by swapping the last one into it's place
+		//returns the old index of the transform that was moved into the slot, or the removed index if it was the last one
+		//returns UINT32_MAX and does nothing if the index is not in the store
+		inline uint32_t Remove(const uint32_t& index)
+		{
+			if (index >= count)
+				return UINT32_MAX;
+
+			const uint32_t last = (uint32_t)count - 1;
+			if (index != last)
+			{
+				SetTRS(index, { positionX[last], positionY[last], positionZ[last] }, glm::quat(rotationW[last], rotationX[last], rotationY[last], rotationZ[last]),
+					{ scaleX[last], scaleY[last], scaleZ[last] });
+				modelMatrices[index] = modelMatrices[last];
+			}
+
+			//reset the freed slot to identity so it is valid padding
+			SetTRS(last, { 0.0f, 0.0f, 0.0f }, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), { 1.0f, 1.0f, 1.0f });
+			dirtyBits[last >> 6] &= ~(1ull << (last & 63));
+			count--;
+			return last;
+		}
+
+		//sets position, rotation and scale
+		inline void SetTRS(const uint32_t& index, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+		{
+			positionX[index] = position.x; positionY[index] = position.y; positionZ[index] = position.z;
+			rotationX[index] = rotation.x; rotationY[index] = rotation.y; rotationZ[index] = rotation.z; rotationW[index] = rotation.w;
+			scaleX[index] = scale.x; scaleY[index] = scale.y; scaleZ[index] = scale.z;
+			MarkDirty(index);
+		}
+
+		//sets the position
+		inline void SetPosition(const uint32_t& index, const glm::vec3& position)
+		{
+			positionX[index] = position.x; positionY[index] = position.y; positionZ[index] = position.z;
+			MarkDirty(index);
+		}
+
+		//sets the rotation
+		inline void SetRotation(const uint32_t& index, const glm::quat& rotation)
+		{
+			rotationX[index] = rotation.x; rotationY[index] = rotation.y; rotationZ[index] = rotation.z; rotationW[index] = rotation.w;
+			MarkDirty(index);
+		}
+
+		//sets the scale
+		inline void SetScale(const uint32_t& index, const glm::vec3& scale)
+		{
+			scaleX[index] = scale.x; scaleY[index] = scale.y; scaleZ[index] = scale.z;
+			MarkDirty(index);
+		}
+
+		//gets a model matrix, only up to date after UpdateDirtyMatrices
+		inline const glm::mat4& GetModelMatrix(const uint32_t& index) const { return modelMatrices[index]; }
+
+		//copies every dirty component bound to this store into the arrays
+		inline void SyncFromComponents(Transform* transforms, const size_t& transformCount)
+		{
+			for (size_t i = 0; i < transformCount; ++i)
+			{
+				if (transforms[i].isDirty && transforms[i].storeIndex < count)
+					SetTRS(transforms[i].storeIndex, transforms[i].position, transforms[i].rotation, transforms[i].scale);
+			}
+		}
+
+		//copies the rebuilt matrices back into every dirty component bound to this store and clears their dirty flag
+		inline void WriteBackToComponents(Transform* transforms, const size_t& transformCount) const
+		{
+			for (size_t i = 0; i < transformCount; ++i)
+			{
+				if (transforms[i].isDirty && transforms[i].storeIndex < count)
+				{
+					transforms[i].modelMatrix = modelMatrices[transforms[i].storeIndex];
+					transforms[i].isDirty = false;
+				}
+			}
+		}
+
+		//builds a single model matrix, translation * rotation * scale
+		inline void BuildModelMatrix_Scalar(const size_t& i)
+		{
+			const float x = rotationX[i], y = rotationY[i], z = rotationZ[i], w = rotationW[i];
+			const float xx = x * x, yy = y * y, zz = z * z;
+			const float xy = x * y, xz = x * z, yz = y * z;
+			const float wx = w * x, wy = w * y, wz = w * z;
+
+			glm::mat4& m = modelMatrices[i];
+			m[0] = { (1.0f - 2.0f * (yy + zz)) * scaleX[i], 2.0f * (xy + wz) * scaleX[i], 2.0f * (xz - wy) * scaleX[i], 0.0f };
+			m[1] = { 2.0f * (xy - wz) * scaleY[i], (1.0f - 2.0f * (xx + zz)) * scaleY[i], 2.0f * (yz + wx) * scaleY[i], 0.0f };
+			m[2] = { 2.0f * (xz + wy) * scaleZ[i], 2.0f * (yz - wx) * scaleZ[i], (1.0f - 2.0f * (xx + yy)) * scaleZ[i], 0.0f };
+			m[3] = { positionX[i], positionY[i], positionZ[i], 1.0f };
+		}
+
+#ifdef SMOK_TRANSFORM_STORE_SSE
+		//transposes 4 matrices stored as one element per register and writes them out starting at i
+		inline void StoreMatrices_SSE(const size_t& i, __m128 c0x, __m128 c0y, __m128 c0z, __m128 c1x, __m128 c1y, __m128 c1z,
+			__m128 c2x, __m128 c2y, __m128 c2z, __m128 c3x, __m128 c3y, __m128 c3z)
+		{
+			__m128 c0w = _mm_setzero_ps(), c1w = _mm_setzero_ps(), c2w = _mm_setzero_ps(), c3w = _mm_set1_ps(1.0f);
+
+			//transpose so each register is one column of one matrix
+			_MM_TRANSPOSE4_PS(c0x, c0y, c0z, c0w);
+			_MM_TRANSPOSE4_PS(c1x, c1y, c1z, c1w);
+			_MM_TRANSPOSE4_PS(c2x, c2y, c2z, c2w);
+			_MM_TRANSPOSE4_PS(c3x, c3y, c3z, c3w);
+
+			float* out = &modelMatrices[i][0][0];
+			_mm_storeu_ps(out + 0, c0x); _mm_storeu_ps(out + 4, c1x); _mm_storeu_ps(out + 8, c2x); _mm_storeu_ps(out + 12, c3x);
+			_mm_storeu_ps(out + 16, c0y); _mm_storeu_ps(out + 20, c1y); _mm_storeu_ps(out + 24, c2y); _mm_storeu_ps(out + 28, c3y);
+			_mm_storeu_ps(out + 32, c0z); _mm_storeu_ps(out + 36, c1z); _mm_storeu_ps(out + 40, c2z); _mm_storeu_ps(out + 44, c3z);
+			_mm_storeu_ps(out + 48, c0w); _mm_storeu_ps(out + 52, c1w); _mm_storeu_ps(out + 56, c2w); _mm_storeu_ps(out + 60, c3w);
+		}
+
+		//builds the model matrices of 4 transforms starting at i
+		inline void BuildModelMatrices_SSE(const size_t& i)
+		{
+			const __m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f);
+
+			const __m128 x = _mm_loadu_ps(&rotationX[i]), y = _mm_loadu_ps(&rotationY[i]), z = _mm_loadu_ps(&rotationZ[i]), w = _mm_loadu_ps(&rotationW[i]);
+			const __m128 sx = _mm_loadu_ps(&scaleX[i]), sy = _mm_loadu_ps(&scaleY[i]), sz = _mm_loadu_ps(&scaleZ[i]);
+
+			const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+			const __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+			const __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+			//each register holds one matrix element for 4 transforms
+			StoreMatrices_SSE(i,
+				_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx),
+				_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx),
+				_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx),
+
+				_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy),
+				_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy),
+				_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy),
+
+				_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz),
+				_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz),
+				_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz),
+
+				_mm_loadu_ps(&positionX[i]), _mm_loadu_ps(&positionY[i]), _mm_loadu_ps(&positionZ[i]));
+		}
+
+#ifdef __AVX__
+		//builds the model matrices of 8 transforms starting at i
+		inline void BuildModelMatrices_AVX(const size_t& i)
+		{
+			const __m256 one = _mm256_set1_ps(1.0f), two = _mm256_set1_ps(2.0f);
+
+			const __m256 x = _mm256_loadu_ps(&rotationX[i]), y = _mm256_loadu_ps(&rotationY[i]), z = _mm256_loadu_ps(&rotationZ[i]), w = _mm256_loadu_ps(&rotationW[i]);
+			const __m256 sx = _mm256_loadu_ps(&scaleX[i]), sy = _mm256_loadu_ps(&scaleY[i]), sz = _mm256_loadu_ps(&scaleZ[i]);
+
+			const __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+			const __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+			const __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+			__m256 e[12] = {
+				_mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))), sx),
+				_mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx),
+				_mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx),
+
+				_mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy),
+				_mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))), sy),
+				_mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy),
+
+				_mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz),
+				_mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz),
+				_mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))), sz),
+
+				_mm256_loadu_ps(&positionX[i]), _mm256_loadu_ps(&positionY[i]), _mm256_loadu_ps(&positionZ[i]) };
+
+			//the transpose is done per 128 bit half
+			StoreMatrices_SSE(i, _mm256_castps256_ps128(e[0]), _mm256_castps256_ps128(e[1]), _mm256_castps256_ps128(e[2]),
+				_mm256_castps256_ps128(e[3]), _mm256_castps256_ps128(e[4]), _mm256_castps256_ps128(e[5]),
+				_mm256_castps256_ps128(e[6]), _mm256_castps256_ps128(e[7]), _mm256_castps256_ps128(e[8]),
+				_mm256_castps256_ps128(e[9]), _mm256_castps256_ps128(e[10]), _mm256_castps256_ps128(e[11]));
+			StoreMatrices_SSE(i + 4, _mm256_extractf128_ps(e[0], 1), _mm256_extractf128_ps(e[1], 1), _mm256_extractf128_ps(e[2], 1),
+				_mm256_extractf128_ps(e[3], 1), _mm256_extractf128_ps(e[4], 1), _mm256_extractf128_ps(e[5], 1),
+				_mm256_extractf128_ps(e[6], 1), _mm256_extractf128_ps(e[7], 1), _mm256_extractf128_ps(e[8], 1),
+				_mm256_extractf128_ps(e[9], 1), _mm256_extractf128_ps(e[10], 1), _mm256_extractf128_ps(e[11], 1));
+		}
+#endif
+#endif
+
+		//rebuilds the dirty matrices in a range of dirty words, returns the number of groups rebuilt
+		inline size_t UpdateDirtyMatrices_Range(const size_t& firstWord, const size_t& lastWord)
+		{
+			size_t groupsUpdated = 0;
+			for (size_t word = firstWord; word < lastWord; ++word)
+			{
+				uint64_t bits = dirtyBits[word];
+				if (bits == 0)
+					continue;
+
+				//any dirty bit in a group rebuilds the whole group, clean neighbours just get the same matrix again
+				for (uint32_t group = 0; group < 64; group += GROUP_SIZE)
+				{
+					if (((bits >> group) & ((1ull << GROUP_SIZE) - 1)) == 0)
+						continue;
+
+					const size_t i = word * 64 + group;
+#if defined(SMOK_TRANSFORM_STORE_SSE) && defined(__AVX__)
+					BuildModelMatrices_AVX(i);
+#elif defined(SMOK_TRANSFORM_STORE_SSE)
+					BuildModelMatrices_SSE(i);
+					BuildModelMatrices_SSE(i + 4);
+#else
+					for (size_t g = 0; g < GROUP_SIZE; ++g)
+						BuildModelMatrix_Scalar(i + g);
+#endif
+					groupsUpdated++;
+				}
+
+				dirtyBits[word] = 0;
+			}
+
+			return groupsUpdated;
+		}
+
+		//rebuilds every dirty model matrix, threadCount above 1 splits the work when there is enough of it
+		inline size_t UpdateDirtyMatrices(uint32_t threadCount = 1)
+		{
+			SMOK_PROFILE_ZONE("TransformStore::UpdateDirtyMatrices");
+
+			const size_t wordCount = dirtyBits.size();
+			const size_t maxThreads = count / MIN_TRANSFORMS_PER_THREAD;
+			if (threadCount > maxThreads)
+				threadCount = (uint32_t)maxThreads;
+			if (threadCount <= 1)
+				return UpdateDirtyMatrices_Range(0, wordCount);
+
+			if (!workers.workers)
+				workers.workers = std::make_unique<TransformStoreWorkers>();
+			workers.workers->Reserve(threadCount - 1);
+
+			//each thread owns whole dirty words so no two threads touch the same bits
+			std::vector<size_t> groupsUpdated(threadCount, 0);
+			const size_t wordsPerThread = (wordCount + threadCount - 1) / threadCount;
+			workers.workers->Run(this, threadCount - 1, wordsPerThread, wordCount, groupsUpdated.data());
+
+			size_t total = 0;
+			for (uint32_t t = 0; t < threadCount; ++t)
+				total += groupsUpdated[t];
+
+			return total;
+		}
+
+		//rebuilds the dirty words of one share of a split update
+		inline void UpdateDirtyMatrices_Share(const uint32_t& share, const size_t& wordsPerThread, const size_t& wordCount, size_t* groupsUpdated)
+		{
+			const size_t first = (wordsPerThread * share < wordCount ? wordsPerThread * share : wordCount);
+			const size_t last = (first + wordsPerThread < wordCount ? first + wordsPerThread : wordCount);
+			groupsUpdated[share] = UpdateDirtyMatrices_Range(first, last);
+		}
+	};
+
+	inline void TransformStoreWorkers::Run(TransformStore* _store, const uint32_t& workerCount, const size_t& _wordsPerThread, const size_t& _wordCount, size_t* _groupsUpdated)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			store = _store;
+			wordsPerThread = _wordsPerThread;
+			wordCount = _wordCount;
+			groupsUpdated = _groupsUpdated;
+			jobWorkerCount = workerCount;
+			workersDone = 0;
+			jobGeneration++;
+		}
+		jobCondition.notify_all();
+
+		_store->UpdateDirtyMatrices_Share(0, _wordsPerThread, _wordCount, _groupsUpdated);
+
+		std::unique_lock<std::mutex> lock(mutex);
+		doneCondition.wait(lock, [this]() { return workersDone == jobWorkerCount; });
+		store = nullptr;
+	}
+
+	inline void TransformStoreWorkers::WorkerLoop(const uint32_t& index)
+	{
+		uint64_t lastGeneration = 0;
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true)
+		{
+			jobCondition.wait(lock, [this, lastGeneration]() { return !isRunning || jobGeneration != lastGeneration; });
+			if (!isRunning)
+				return;
+
+			lastGeneration = jobGeneration;
+			if (index >= jobWorkerCount) //this update needs fewer workers than are running
+				continue;
+
+			TransformStore* const jobStore = store;
+			const size_t jobWordsPerThread = wordsPerThread, jobWordCount = wordCount;
+			size_t* const jobGroupsUpdated = groupsUpdated;
+			lock.unlock();
+			jobStore->UpdateDirtyMatrices_Share(index + 1, jobWordsPerThread, jobWordCount, jobGroupsUpdated);
+			lock.lock();
+
+			if (++workersDone == jobWorkerCount)
+				doneCondition.notify_one();
+		}
+	}
+}
\ No newline at end of file
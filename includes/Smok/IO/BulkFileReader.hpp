@@ -0,0 +1,613 @@
+#pragma once
+
+//defines a bulk file reader, reads many whole files at once so a level load is bound by disk bandwidth instead of per file latency
+//on Linux the reads go through io_uring, keeping up to queueDepth reads in flight from one thread with a syscall per batch
+//if io_uring is missing or blocked (older kernels, seccomp in containers) or on other platforms, a pool of threads reads with pread/ifstream instead
+//a callback is run as each file finishes so the caller can start decoding it while the rest are still being read
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef Linux_Build
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#elif !defined(Window_Build)
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Smok::IO
+{
+	//defines the contents of a file read in bulk
+	struct BulkReadResult
+	{
+		std::unique_ptr<uint8_t[]> data; //the file, new[] keeps it aligned for any fundamental type
+		size_t size = 0;
+		bool succeeded = false;
+	};
+
+	//defines the stats of a bulk read
+	struct BulkReadStats
+	{
+		size_t filesRead = 0;
+		size_t filesFailed = 0;
+		uint64_t bytesRead = 0;
+		bool usedIoUring = false; //false if the thread pool fallback was used
+		double milliseconds = 0.0;
+
+		//gets the read speed in MB/s
+		inline double GetMegabytesPerSecond() const { return (milliseconds > 0.0 ? ((double)bytesRead / (1024.0 * 1024.0)) / (milliseconds / 1000.0) : 0.0); }
+	};
+
+#ifdef Linux_Build
+	//defines a io_uring instance, made through the raw syscalls so liburing is not needed
+	struct IoUring
+	{
+		int ringDescriptor = -1;
+		uint32_t entries = 0;
+
+		void* SQRing = nullptr;
+		size_t SQRingSize = 0;
+		void* CQRing = nullptr;
+		size_t CQRingSize = 0;
+		io_uring_sqe* SQEs = nullptr;
+		size_t SQEsSize = 0;
+
+		uint32_t* SQHead = nullptr;
+		uint32_t* SQTail = nullptr;
+		uint32_t SQMask = 0;
+		uint32_t* SQArray = nullptr;
+		uint32_t* CQHead = nullptr;
+		uint32_t* CQTail = nullptr;
+		uint32_t CQMask = 0;
+		io_uring_cqe* CQEs = nullptr;
+
+		uint32_t pendingSubmits = 0; //SQEs written but not yet passed to the kernel
+
+		IoUring() = default;
+		IoUring(const IoUring&) = delete;
+		IoUring& operator=(const IoUring&) = delete;
+		~IoUring() { Destroy(); }
+
+		//makes the rings, fails quietly so the caller can fall back
+		inline bool Init(const uint32_t& queueDepth)
+		{
+			io_uring_params params;
+			std::memset(&params, 0, sizeof(params));
+			ringDescriptor = (int)syscall(__NR_io_uring_setup, queueDepth, &params);
+			if (ringDescriptor < 0)
+			{
+				ringDescriptor = -1;
+				return false;
+			}
+
+			//IORING_OP_READ came in the same kernel as probing (5.6), so no probe means no read op
+			std::vector<uint64_t> probeData((sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op)) / sizeof(uint64_t) + 1, 0);
+			io_uring_probe* probe = (io_uring_probe*)probeData.data();
+			if (syscall(__NR_io_uring_register, ringDescriptor, IORING_REGISTER_PROBE, probe, 256) < 0 ||
+				probe->last_op < IORING_OP_READ || !(probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED))
+			{
+				Destroy();
+				return false;
+			}
+
+			entries = params.sq_entries;
+			SQRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+			CQRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+			const bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP);
+			if (singleMapping)
+				SQRingSize = CQRingSize = std::max(SQRingSize, CQRingSize);
+
+			SQRing = mmap(nullptr, SQRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringDescriptor, IORING_OFF_SQ_RING);
+			if (SQRing == MAP_FAILED)
+			{
+				SQRing = nullptr;
+				Destroy();
+				return false;
+			}
+
+			if (singleMapping)
+				CQRing = SQRing;
+			else
+			{
+				CQRing = mmap(nullptr, CQRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringDescriptor, IORING_OFF_CQ_RING);
+				if (CQRing == MAP_FAILED)
+				{
+					CQRing = nullptr;
+					Destroy();
+					return false;
+				}
+			}
+
+			SQEsSize = params.sq_entries * sizeof(io_uring_sqe);
+			void* SQEMapping = mmap(nullptr, SQEsSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringDescriptor, IORING_OFF_SQES);
+			if (SQEMapping == MAP_FAILED)
+			{
+				Destroy();
+				return false;
+			}
+			SQEs = (io_uring_sqe*)SQEMapping;
+
+			uint8_t* SQ = (uint8_t*)SQRing;
+			SQHead = (uint32_t*)(SQ + params.sq_off.head);
+			SQTail = (uint32_t*)(SQ + params.sq_off.tail);
+			SQMask = *(uint32_t*)(SQ + params.sq_off.ring_mask);
+			SQArray = (uint32_t*)(SQ + params.sq_off.array);
+
+			uint8_t* CQ = (uint8_t*)CQRing;
+			CQHead = (uint32_t*)(CQ + params.cq_off.head);
+			CQTail = (uint32_t*)(CQ + params.cq_off.tail);
+			CQMask = *(uint32_t*)(CQ + params.cq_off.ring_mask);
+			CQEs = (io_uring_cqe*)(CQ + params.cq_off.cqes);
+			return true;
+		}
+
+		//unmaps the rings and closes the instance
+		inline void Destroy()
+		{
+			if (SQEs)
+				munmap(SQEs, SQEsSize);
+			if (CQRing && CQRing != SQRing)
+				munmap(CQRing, CQRingSize);
+			if (SQRing)
+				munmap(SQRing, SQRingSize);
+			if (ringDescriptor >= 0)
+				close(ringDescriptor);
+
+			ringDescriptor = -1;
+			SQRing = CQRing = nullptr;
+			SQEs = nullptr;
+			pendingSubmits = 0;
+		}
+
+		//queues a read of length bytes at offset into buffer, it's sent to the kernel on the next Submit
+		inline bool QueueRead(const int& fileDescriptor, void* buffer, const uint32_t& length, const uint64_t& offset, const uint64_t& userData)
+		{
+			const uint32_t tail = *SQTail;
+			if (tail - std::atomic_ref<uint32_t>(*SQHead).load(std::memory_order_acquire) >= entries)
+				return false; //full
+
+			const uint32_t index = tail & SQMask;
+			io_uring_sqe& SQE = SQEs[index];
+			std::memset(&SQE, 0, sizeof(SQE));
+			SQE.opcode = IORING_OP_READ;
+			SQE.fd = fileDescriptor;
+			SQE.addr = (uint64_t)(uintptr_t)buffer;
+			SQE.len = length;
+			SQE.off = offset;
+			SQE.user_data = userData;
+			SQArray[index] = index;
+
+			std::atomic_ref<uint32_t>(*SQTail).store(tail + 1, std::memory_order_release);
+			pendingSubmits++;
+			return true;
+		}
+
+		//sends the queued reads to the kernel and waits until at least waitCount have completed
+		//a busy kernel submits nothing and returns true, reap completions and call again
+		inline bool Submit(const uint32_t& waitCount)
+		{
+			while (true)
+			{
+				const int result = (int)syscall(__NR_io_uring_enter, ringDescriptor, pendingSubmits, waitCount, (waitCount > 0 ? IORING_ENTER_GETEVENTS : 0), nullptr, 0);
+				if (result >= 0)
+				{
+					pendingSubmits -= std::min((uint32_t)result, pendingSubmits);
+					return true;
+				}
+				if (errno == EAGAIN || errno == EBUSY)
+					return true;
+				if (errno != EINTR)
+					return false;
+			}
+		}
+
+		//runs function(userData, result) on every completed read
+		template<typename Func>
+		inline uint32_t ReapCompletions(Func&& function)
+		{
+			uint32_t head = *CQHead;
+			const uint32_t tail = std::atomic_ref<uint32_t>(*CQTail).load(std::memory_order_acquire);
+			uint32_t reaped = 0;
+			for (; head != tail; ++head, ++reaped)
+			{
+				const io_uring_cqe& CQE = CQEs[head & CQMask];
+				function(CQE.user_data, CQE.res);
+			}
+
+			std::atomic_ref<uint32_t>(*CQHead).store(head, std::memory_order_release);
+			return reaped;
+		}
+	};
+#endif
+
+	//defines a bulk file reader
+	struct BulkFileReader
+	{
+		static constexpr uint32_t MAX_READ_SIZE = 16 * 1024 * 1024; //bigger files are read in pieces so one file can't hold the whole queue
+
+		uint32_t queueDepth = 64; //the reads kept in flight with io_uring
+		uint32_t threadCount = 0; //the threads used by the fallback, 0 uses every hardware thread
+		bool allowIoUring = true; //turn off to force the fallback
+
+		//reads every file into results, results is resized to match paths
+		//onFileRead(index) is run as each file finishes or fails, from whichever thread did the read, it must be thread safe
+		inline BulkReadStats ReadFiles(const std::vector<std::string>& paths, std::vector<BulkReadResult>& results, const std::function<void(const size_t&)>& onFileRead = {})
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+			results.clear();
+			results.resize(paths.size());
+
+			BulkReadStats stats;
+#ifdef Linux_Build
+			stats.usedIoUring = (allowIoUring && ReadFiles_IoUring(paths, results, onFileRead));
+			if (!stats.usedIoUring)
+#endif
+				ReadFiles_Threaded(paths, results, onFileRead);
+
+			for (size_t i = 0; i < results.size(); ++i)
+			{
+				if (results[i].succeeded)
+				{
+					stats.filesRead++;
+					stats.bytesRead += results[i].size;
+				}
+				else
+					stats.filesFailed++;
+			}
+
+			stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			return stats;
+		}
+
+		//reads every file and runs process(index) on a pool of processThreadCount threads as each one finishes, so decoding overlaps the reads
+		//process is run for failed files too, check results[index].succeeded. 0 processThreadCount uses every hardware thread
+		inline BulkReadStats ReadAndProcessFiles(const std::vector<std::string>& paths, std::vector<BulkReadResult>& results,
+			const std::function<void(const size_t&)>& process, uint32_t processThreadCount = 0)
+		{
+			if (processThreadCount == 0)
+			{
+				const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+				processThreadCount = (hardwareThreads > 0 ? hardwareThreads : 1);
+			}
+			if (processThreadCount > paths.size())
+				processThreadCount = (uint32_t)(paths.empty() ? 1 : paths.size());
+
+			std::mutex readyMutex;
+			std::condition_variable readyCondition;
+			std::vector<size_t> ready; //used as a stack, the order files are processed in does not matter
+			bool readingIsDone = false;
+
+			std::vector<std::thread> workers;
+			for (uint32_t t = 0; t < processThreadCount; ++t)
+			{
+				workers.emplace_back([&]() {
+					while (true)
+					{
+						size_t index;
+						{
+							std::unique_lock<std::mutex> lock(readyMutex);
+							readyCondition.wait(lock, [&]() { return readingIsDone || !ready.empty(); });
+							if (ready.empty())
+								return;
+							index = ready.back();
+							ready.pop_back();
+						}
+
+						process(index);
+					}
+				});
+			}
+
+			const BulkReadStats stats = ReadFiles(paths, results, [&](const size_t& index) {
+				{
+					std::lock_guard<std::mutex> lock(readyMutex);
+					ready.emplace_back(index);
+				}
+				readyCondition.notify_one();
+			});
+
+			{
+				std::lock_guard<std::mutex> lock(readyMutex);
+				readingIsDone = true;
+			}
+			readyCondition.notify_all();
+			for (auto& worker : workers)
+				worker.join();
+
+			return stats;
+		}
+
+		//---internal
+
+#ifdef Linux_Build
+		//defines a file being read through io_uring
+		struct PendingFile
+		{
+			int fileDescriptor = -1;
+			uint64_t offset = 0; //the bytes queued so far
+			uint32_t readsInFlight = 0;
+			bool failed = false;
+		};
+
+		//defines a read handed to io_uring, it's index in the read table is the user data
+		struct PendingRead
+		{
+			size_t file = 0;
+			uint64_t offset = 0; //where in the file the read starts
+			uint32_t length = 0; //the bytes still wanted
+		};
+
+		//reads the files through io_uring, returns false without reading anything if io_uring can not be used
+		inline bool ReadFiles_IoUring(const std::vector<std::string>& paths, std::vector<BulkReadResult>& results, const std::function<void(const size_t&)>& onFileRead)
+		{
+			IoUring ring;
+			if (!ring.Init(queueDepth))
+				return false;
+
+			//files are opened as they are reached so thousands of them never hold thousands of descriptors
+			std::vector<PendingFile> files(paths.size());
+			size_t nextFile = 0, finishedFiles = 0, openFile = SIZE_MAX;
+			uint32_t inFlight = 0;
+
+			//every read in flight has a slot, the queue never holds more than ring.entries
+			std::vector<PendingRead> reads(ring.entries);
+			std::vector<uint32_t> freeReads(ring.entries);
+			for (uint32_t r = 0; r < ring.entries; ++r)
+				freeReads[r] = ring.entries - 1 - r;
+
+			auto finishFile = [&](const size_t& f) {
+				if (files[f].fileDescriptor >= 0)
+					close(files[f].fileDescriptor);
+				files[f].fileDescriptor = -1;
+				results[f].succeeded = !files[f].failed;
+				if (files[f].failed)
+					results[f].data.reset();
+				finishedFiles++;
+				if (onFileRead)
+					onFileRead(f);
+			};
+
+			while (finishedFiles < paths.size())
+			{
+				//fills the queue, a file is split into reads of at most MAX_READ_SIZE
+				while (inFlight < ring.entries)
+				{
+					if (openFile == SIZE_MAX)
+					{
+						if (nextFile >= paths.size())
+							break;
+
+						openFile = nextFile++;
+						if (!OpenFile(paths[openFile], files[openFile], results[openFile]))
+						{
+							finishFile(openFile);
+							openFile = SIZE_MAX;
+							continue;
+						}
+
+						//empty files have nothing to read
+						if (results[openFile].size == 0)
+						{
+							finishFile(openFile);
+							openFile = SIZE_MAX;
+							continue;
+						}
+					}
+
+					PendingFile& file = files[openFile];
+					const uint32_t length = (uint32_t)std::min<uint64_t>(MAX_READ_SIZE, results[openFile].size - file.offset);
+					const uint32_t slot = freeReads.back();
+					if (!ring.QueueRead(file.fileDescriptor, results[openFile].data.get() + file.offset, length, file.offset, slot))
+						break;
+
+					freeReads.pop_back();
+					reads[slot] = { openFile, file.offset, length };
+					file.offset += length;
+					file.readsInFlight++;
+					inFlight++;
+					if (file.offset >= results[openFile].size)
+						openFile = SIZE_MAX;
+				}
+
+				if (inFlight == 0)
+					continue; //every file left failed to open
+
+				if (!ring.Submit(1))
+				{
+					fmt::print("Smok IO Error: BulkFileReader || ReadFiles || io_uring_enter failed with errno {}, reading the rest of the files on this thread.\n", errno);
+
+					//the kernel may still write into the buffers of reads it has, so those are failed and their buffers leaked instead of freed
+					for (size_t f = 0; f < nextFile; ++f)
+					{
+						if (files[f].readsInFlight == 0 && f != openFile)
+							continue;
+						files[f].failed = true;
+						results[f].data.release();
+						finishFile(f);
+					}
+					for (size_t f = nextFile; f < paths.size(); ++f)
+					{
+						results[f].succeeded = ReadWholeFile(paths[f], results[f]);
+						if (!results[f].succeeded)
+							results[f].data.reset();
+						if (onFileRead)
+							onFileRead(f);
+					}
+					return true;
+				}
+
+				ring.ReapCompletions([&](const uint64_t& userData, const int32_t& result) {
+					const uint32_t slot = (uint32_t)userData;
+					PendingRead& read = reads[slot];
+					const size_t f = read.file;
+
+					//the kernel can return less than asked for, a signal or some file systems split reads, so the rest is read from where it stopped
+					//the completed read left the submit queue, so there is always room to queue the rest
+					const bool interrupted = (result == -EINTR || result == -EAGAIN);
+					if (!files[f].failed && (interrupted || (result > 0 && (uint32_t)result < read.length)))
+					{
+						if (!interrupted)
+						{
+							read.offset += (uint32_t)result;
+							read.length -= (uint32_t)result;
+						}
+						if (ring.QueueRead(files[f].fileDescriptor, results[f].data.get() + read.offset, read.length, read.offset, slot))
+							return;
+					}
+
+					inFlight--;
+					files[f].readsInFlight--;
+					freeReads.emplace_back(slot);
+
+					//reading nothing means the end of a file that shrank while we read it
+					if (result < 0 || (uint32_t)result != read.length)
+					{
+						if (!files[f].failed)
+							fmt::print("Smok IO Error: BulkFileReader || ReadFiles || Failed to read \"{}\", {}.\n", paths[f], (result < 0 ? std::strerror(-result) : (result == 0 ? "the file changed size" : "the rest could not be queued")));
+						files[f].failed = true;
+					}
+
+					if (files[f].readsInFlight == 0 && f != openFile)
+						finishFile(f);
+				});
+			}
+
+			return true;
+		}
+
+		//opens a file and allocates it's buffer
+		static inline bool OpenFile(const std::string& path, PendingFile& file, BulkReadResult& result)
+		{
+			file.fileDescriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (file.fileDescriptor < 0)
+			{
+				fmt::print("Smok IO Error: BulkFileReader || ReadFiles || Failed to open \"{}\".\n", path);
+				file.failed = true;
+				return false;
+			}
+
+			struct stat fileStats;
+			if (fstat(file.fileDescriptor, &fileStats) != 0)
+			{
+				fmt::print("Smok IO Error: BulkFileReader || ReadFiles || Failed to get the size of \"{}\".\n", path);
+				file.failed = true;
+				return false;
+			}
+
+			result.size = (size_t)fileStats.st_size;
+			result.data.reset(new uint8_t[result.size > 0 ? result.size : 1]);
+			posix_fadvise(file.fileDescriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+			return true;
+		}
+#endif
+
+		//reads a whole file on the calling thread
+		static inline bool ReadWholeFile(const std::string& path, BulkReadResult& result)
+		{
+#ifdef Window_Build
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file)
+			{
+				fmt::print("Smok IO Error: BulkFileReader || ReadFiles || Failed to open \"{}\".\n", path);
+				return false;
+			}
+
+			result.size = (size_t)file.tellg();
+			result.data.reset(new uint8_t[result.size > 0 ? result.size : 1]);
+			file.seekg(0);
+			if (result.size > 0 && !file.read((char*)result.data.get(), (std::streamsize)result.size))
+			{
+				fmt::print("Smok IO Error: BulkFileReader || ReadFiles || Failed to read \"{}\".\n", path);
+				return false;
+			}
+#else
+			const int fileDescriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fileDescriptor < 0)
+			{
+				fmt::print("Smok IO Error: BulkFileReader || ReadFiles || Failed to open \"{}\".\n", path);
+				return false;
+			}
+
+			struct stat fileStats;
+			if (fstat(fileDescriptor, &fileStats) != 0)
+			{
+				fmt::print("Smok IO Error: BulkFileReader || ReadFiles || Failed to get the size of \"{}\".\n", path);
+				close(fileDescriptor);
+				return false;
+			}
+
+			result.size = (size_t)fileStats.st_size;
+			result.data.reset(new uint8_t[result.size > 0 ? result.size : 1]);
+			size_t offset = 0;
+			while (offset < result.size)
+			{
+				const ssize_t read = pread(fileDescriptor, result.data.get() + offset, result.size - offset, (off_t)offset);
+				if (read < 0 && errno == EINTR)
+					continue;
+				if (read <= 0)
+				{
+					fmt::print("Smok IO Error: BulkFileReader || ReadFiles || Failed to read \"{}\".\n", path);
+					close(fileDescriptor);
+					return false;
+				}
+				offset += (size_t)read;
+			}
+			close(fileDescriptor);
+#endif
+
+			return true;
+		}
+
+		//reads the files on a pool of threads, each taking the next file as it finishes one
+		inline void ReadFiles_Threaded(const std::vector<std::string>& paths, std::vector<BulkReadResult>& results, const std::function<void(const size_t&)>& onFileRead)
+		{
+			uint32_t threads = threadCount;
+			if (threads == 0)
+			{
+				const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+				threads = (hardwareThreads > 0 ? hardwareThreads : 1);
+			}
+			if (threads > paths.size())
+				threads = (uint32_t)(paths.empty() ? 1 : paths.size());
+
+			std::atomic<size_t> nextFile = 0;
+			auto readFiles = [&]() {
+				for (size_t f = nextFile++; f < paths.size(); f = nextFile++)
+				{
+					results[f].succeeded = ReadWholeFile(paths[f], results[f]);
+					if (!results[f].succeeded)
+						results[f].data.reset();
+					if (onFileRead)
+						onFileRead(f);
+				}
+			};
+
+			std::vector<std::thread> workers;
+			for (uint32_t t = 1; t < threads; ++t)
+				workers.emplace_back(readFiles);
+			readFiles();
+			for (auto& worker : workers)
+				worker.join();
+		}
+	};
+}
\ No newline at end of file
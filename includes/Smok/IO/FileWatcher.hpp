@@ -0,0 +1,173 @@
+#pragma once
+
+//defines a file watcher, reports files that were written since the last poll
+//on Linux it's inotify watching the parent directory of each file, so editors that save by writing a temp file and renaming it are still caught
+//other platforms fall back to checking each file's write time every poll, which is fine for the few hundred files a hot reload session watches
+
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#ifdef Linux_Build
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace Smok::IO
+{
+	//defines a file watcher
+	struct FileWatcher
+	{
+		std::unordered_set<std::string> watchedFiles; //the normalized paths being watched
+
+#ifdef Linux_Build
+		int inotifyDescriptor = -1;
+		std::unordered_map<std::string, int> watchesByDirectory; //the inotify watch of each parent directory
+		std::unordered_map<int, std::string> directoriesByWatch;
+#else
+		std::unordered_map<std::string, std::filesystem::file_time_type> writeTimes; //the last write time seen for each file
+#endif
+
+		FileWatcher() = default;
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+		~FileWatcher() { Destroy(); }
+
+		//normalizes a path so a file is always watched and reported under the same string
+		static inline std::string NormalizePath(const std::string& path)
+		{
+			std::error_code error;
+			const std::filesystem::path normalized = std::filesystem::weakly_canonical(std::filesystem::absolute(path, error), error);
+			return (error ? std::filesystem::path(path).lexically_normal().string() : normalized.string());
+		}
+
+		//inits the watcher
+		inline bool Init()
+		{
+#ifdef Linux_Build
+			if (inotifyDescriptor != -1)
+				return true;
+
+			inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+			if (inotifyDescriptor == -1)
+			{
+				fmt::print("Smok IO Error: FileWatcher || Init || Failed to create a inotify instance, errno {}.\n", errno);
+				return false;
+			}
+#endif
+			return true;
+		}
+
+		//stops watching everything
+		inline void Destroy()
+		{
+#ifdef Linux_Build
+			if (inotifyDescriptor != -1)
+				close(inotifyDescriptor); //closing drops every watch
+			inotifyDescriptor = -1;
+			watchesByDirectory.clear();
+			directoriesByWatch.clear();
+#else
+			writeTimes.clear();
+#endif
+			watchedFiles.clear();
+		}
+
+		//starts watching a file, it does not have to exist yet but it's directory does
+		inline bool Watch(const std::string& filepath)
+		{
+			const std::string path = NormalizePath(filepath);
+			if (watchedFiles.count(path))
+				return true;
+
+#ifdef Linux_Build
+			if (inotifyDescriptor == -1 && !Init())
+				return false;
+
+			const std::string directory = std::filesystem::path(path).parent_path().string();
+			if (!watchesByDirectory.count(directory))
+			{
+				//written and closed, or moved into place by a editor's atomic save
+				const int watch = inotify_add_watch(inotifyDescriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+				if (watch == -1)
+				{
+					fmt::print("Smok IO Error: FileWatcher || Watch || Failed to watch the directory \"{}\", errno {}.\n", directory, errno);
+					return false;
+				}
+
+				watchesByDirectory[directory] = watch;
+				directoriesByWatch[watch] = directory;
+			}
+#else
+			std::error_code error;
+			writeTimes[path] = std::filesystem::last_write_time(path, error);
+#endif
+
+			watchedFiles.insert(path);
+			return true;
+		}
+
+		//stops watching a file, it's directory stays watched for any other files in it
+		inline void Unwatch(const std::string& filepath)
+		{
+			const std::string path = NormalizePath(filepath);
+			watchedFiles.erase(path);
+#ifndef Linux_Build
+			writeTimes.erase(path);
+#endif
+		}
+
+		//gets the watched files written since the last poll, each file is listed once, never blocks
+		inline size_t Poll(std::vector<std::string>& changedFiles)
+		{
+			changedFiles.clear();
+			std::unordered_set<std::string> seen;
+
+#ifdef Linux_Build
+			if (inotifyDescriptor == -1)
+				return 0;
+
+			alignas(inotify_event) char buffer[4096];
+			while (true)
+			{
+				const ssize_t length = read(inotifyDescriptor, buffer, sizeof(buffer));
+				if (length <= 0)
+					break; //EAGAIN, nothing left
+
+				for (ssize_t offset = 0; offset < length;)
+				{
+					const inotify_event* event = (const inotify_event*)(buffer + offset);
+					offset += sizeof(inotify_event) + event->len;
+
+					auto directory = directoriesByWatch.find(event->wd);
+					if (event->len == 0 || directory == directoriesByWatch.end())
+						continue;
+
+					const std::string path = (std::filesystem::path(directory->second) / event->name).string();
+					if (watchedFiles.count(path) && seen.insert(path).second)
+						changedFiles.emplace_back(path);
+				}
+			}
+#else
+			for (auto& file : writeTimes)
+			{
+				std::error_code error;
+				const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(file.first, error);
+				if (error || writeTime == file.second)
+					continue;
+
+				file.second = writeTime;
+				if (seen.insert(file.first).second)
+					changedFiles.emplace_back(file.first);
+			}
+#endif
+
+			return changedFiles.size();
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+#pragma once
+
+//defines a read-only memory mapped file
+//used by the asset loaders so binary data can be read straight out of the page cache without a copy into a staging buffer
+
+#include <BTDSTD/IO/FileInfo.hpp>
+
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+#ifdef Window_Build
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Smok::IO
+{
+	//defines a read-only file mapping
+	struct MappedFile
+	{
+		const uint8_t* data = nullptr; //the start of the mapping
+		size_t size = 0; //the size of the mapping in bytes
+
+#ifdef Window_Build
+		HANDLE fileHandle = INVALID_HANDLE_VALUE;
+		HANDLE mappingHandle = NULL;
+#else
+		int fileDescriptor = -1;
+#endif
+
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+		MappedFile& operator=(MappedFile&& other) noexcept
+		{
+			if (this == &other)
+				return *this;
+
+			Close();
+			data = std::exchange(other.data, nullptr);
+			size = std::exchange(other.size, 0);
+#ifdef Window_Build
+			fileHandle = std::exchange(other.fileHandle, INVALID_HANDLE_VALUE);
+			mappingHandle = std::exchange(other.mappingHandle, (HANDLE)NULL);
+#else
+			fileDescriptor = std::exchange(other.fileDescriptor, -1);
+#endif
+			return *this;
+		}
+		~MappedFile() { Close(); }
+
+		//is the file mapped
+		inline bool IsOpen() const { return data != nullptr; }
+
+		//maps the whole file as read-only
+		inline bool Open(const BTD::IO::FileInfo& file)
+		{
+			Close();
+			const std::string path = file.GetPathStr();
+
+#ifdef Window_Build
+			fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+			if (fileHandle == INVALID_HANDLE_VALUE)
+			{
+				fmt::print("Smok IO Error: MappedFile || Open || Failed to open \"{}\" for mapping.\n", path);
+				return false;
+			}
+
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+			{
+				fmt::print("Smok IO Error: MappedFile || Open || \"{}\" is empty or it's size could not be read.\n", path);
+				Close();
+				return false;
+			}
+			size = (size_t)fileSize.QuadPart;
+
+			mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (mappingHandle == NULL)
+			{
+				fmt::print("Smok IO Error: MappedFile || Open || Failed to create a file mapping for \"{}\".\n", path);
+				Close();
+				return false;
+			}
+
+			data = (const uint8_t*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+#else
+			fileDescriptor = open(path.c_str(), O_RDONLY);
+			if (fileDescriptor < 0)
+			{
+				fmt::print("Smok IO Error: MappedFile || Open || Failed to open \"{}\" for mapping.\n", path);
+				return false;
+			}
+
+			struct stat fileStats;
+			if (fstat(fileDescriptor, &fileStats) != 0 || fileStats.st_size == 0)
+			{
+				fmt::print("Smok IO Error: MappedFile || Open || \"{}\" is empty or it's size could not be read.\n", path);
+				Close();
+				return false;
+			}
+			size = (size_t)fileStats.st_size;
+
+			void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+			data = (mapping == MAP_FAILED ? nullptr : (const uint8_t*)mapping);
+
+			//we read mesh data front to back, let the kernel read ahead
+			if (data)
+			{
+				madvise(mapping, size, MADV_SEQUENTIAL);
+				madvise(mapping, size, MADV_WILLNEED);
+			}
+#endif
+
+			if (!data)
+			{
+				fmt::print("Smok IO Error: MappedFile || Open || Failed to map \"{}\" into memory.\n", path);
+				Close();
+				return false;
+			}
+
+			return true;
+		}
+
+		//unmaps the file
+		inline void Close()
+		{
+#ifdef Window_Build
+			if (data)
+				UnmapViewOfFile(data);
+			if (mappingHandle != NULL)
+				CloseHandle(mappingHandle);
+			if (fileHandle != INVALID_HANDLE_VALUE)
+				CloseHandle(fileHandle);
+			mappingHandle = NULL;
+			fileHandle = INVALID_HANDLE_VALUE;
+#else
+			if (data)
+				munmap((void*)data, size);
+			if (fileDescriptor >= 0)
+				close(fileDescriptor);
+			fileDescriptor = -1;
+#endif
+
+			data = nullptr;
+			size = 0;
+		}
+	};
+}
\ No newline at end of file
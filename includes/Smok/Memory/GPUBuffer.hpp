@@ -0,0 +1,68 @@
+#pragma once
+
+//defines a raw VMA allocated buffer, used by the Smok systems that manage their own GPU memory instead of going through Wireframe's mesh buffers
+
+#include <BTDSTD/Wireframe/MeshBuffer.hpp>
+
+#include <fmt/format.h>
+
+namespace Smok::Memory
+{
+	//defines a VMA allocated buffer
+	struct GPUBuffer
+	{
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VmaAllocation allocation = VK_NULL_HANDLE;
+		VkDeviceSize size = 0;
+		void* mapped = nullptr; //only set for buffers created persistently mapped
+
+		//is the buffer created
+		inline bool IsCreated() const { return buffer != VK_NULL_HANDLE; }
+
+		//creates the buffer, sharingQueueFamilies lists every queue family that uses it when there is more than one
+		inline bool Create(VmaAllocator& allocator, const VkDeviceSize& _size, const VkBufferUsageFlags& usage, const VmaMemoryUsage& memoryUsage,
+			const VmaAllocationCreateFlags& allocationFlags = 0, const uint32_t* sharingQueueFamilies = nullptr, const uint32_t& sharingQueueFamilyCount = 0)
+		{
+			VkBufferCreateInfo bufferInfo = {};
+			bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+			bufferInfo.size = _size;
+			bufferInfo.usage = usage;
+			if (sharingQueueFamilyCount > 1)
+			{
+				bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+				bufferInfo.queueFamilyIndexCount = sharingQueueFamilyCount;
+				bufferInfo.pQueueFamilyIndices = sharingQueueFamilies;
+			}
+			else
+				bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+			VmaAllocationCreateInfo allocationInfo = {};
+			allocationInfo.usage = memoryUsage;
+			allocationInfo.flags = allocationFlags;
+
+			VmaAllocationInfo result = {};
+			if (vmaCreateBuffer(allocator, &bufferInfo, &allocationInfo, &buffer, &allocation, &result) != VK_SUCCESS)
+			{
+				fmt::print("Smok Memory Error: GPUBuffer || Create || Failed to create a buffer of {} bytes.\n", (uint64_t)_size);
+				buffer = VK_NULL_HANDLE;
+				allocation = VK_NULL_HANDLE;
+				return false;
+			}
+
+			size = _size;
+			mapped = result.pMappedData;
+			return true;
+		}
+
+		//destroys the buffer
+		inline void Destroy(VmaAllocator& allocator)
+		{
+			if (buffer != VK_NULL_HANDLE)
+				vmaDestroyBuffer(allocator, buffer, allocation);
+			buffer = VK_NULL_HANDLE;
+			allocation = VK_NULL_HANDLE;
+			size = 0;
+			mapped = nullptr;
+		}
+	};
+}
\ No newline at end of file
@@ -1,28 +1,273 @@
 #pragma once
 
 //defines a queue for handling the deletion of objects when we are done with them
+//callbacks are stored in place in a reusable arena, so pushing a lambda does not heap allocate once the arena has warmed up
+//FrameDeletionQueue holds a queue per frame in flight and only runs a frame's deletions once the GPU can no longer be using them
 
-#include <deque>
+#include <Smok/Memory/GPUBuffer.hpp>
+#include <Smok/Profiling/Profiler.hpp>
+
+#include <BTDSTD/Wireframe/MeshBuffer.hpp>
+
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace Smok::Memory
 {
+	//defines a bump arena made of fixed blocks, reset keeps the blocks so it stops allocating after the first few frames
+	struct DeletionArena
+	{
+		static constexpr size_t BLOCK_SIZE = 16 * 1024;
+
+		//defines a block of memory
+		struct Block
+		{
+			std::unique_ptr<uint8_t[]> data;
+			size_t size = 0;
+		};
+
+		std::vector<Block> blocks;
+		size_t blockIndex = 0; //the block being allocated from
+		size_t blockOffset = 0; //the next free byte in that block
+
+		//allocates memory, anything bigger than a block gets a block of it's own
+		inline void* Allocate(const size_t& size, const size_t& alignment)
+		{
+			while (blockIndex < blocks.size())
+			{
+				const size_t alignedOffset = (blockOffset + alignment - 1) & ~(alignment - 1);
+				if (alignedOffset + size <= blocks[blockIndex].size)
+				{
+					blockOffset = alignedOffset + size;
+					return blocks[blockIndex].data.get() + alignedOffset;
+				}
+
+				blockIndex++;
+				blockOffset = 0;
+			}
+
+			Block block;
+			block.size = (size > BLOCK_SIZE ? size : BLOCK_SIZE);
+			block.data.reset(new uint8_t[block.size]);
+			blocks.emplace_back(std::move(block));
+			blockIndex = blocks.size() - 1;
+			blockOffset = size;
+			return blocks[blockIndex].data.get();
+		}
+
+		//frees everything allocated, the blocks are kept for reuse
+		inline void Reset()
+		{
+			blockIndex = 0;
+			blockOffset = 0;
+		}
+	};
+
+	//defines a list of type erased callbacks stored in a arena, run in reverse order like a stack
+	//callbacks still waiting when the list goes away are destroyed without being run
+	struct DeletionCallbackList
+	{
+		//defines a stored callback, run calls it and then destroys it, destroy only destroys it
+		struct Entry
+		{
+			void* callable = nullptr;
+			void (*run)(void*) = nullptr;
+			void (*destroy)(void*) = nullptr;
+		};
+
+		DeletionArena arena;
+		std::vector<Entry> entries; //keeps it's capacity between flushes
+
+		//the list being run by Flush, swapped with the live one so callbacks can push more deletions while it runs
+		DeletionArena flushingArena;
+		std::vector<Entry> flushingEntries;
+
+		DeletionCallbackList() = default;
+		DeletionCallbackList(const DeletionCallbackList&) = delete;
+		DeletionCallbackList& operator=(const DeletionCallbackList&) = delete;
+
+		//the entries point into the arena's blocks, which are heap allocated and move with it
+		DeletionCallbackList(DeletionCallbackList&& other) noexcept
+			: arena(std::move(other.arena)), entries(std::move(other.entries))
+		{
+			other.entries.clear();
+			other.arena.Reset();
+		}
+
+		DeletionCallbackList& operator=(DeletionCallbackList&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Destroy();
+				arena = std::move(other.arena);
+				entries = std::move(other.entries);
+				other.entries.clear();
+				other.arena.Reset();
+			}
+			return *this;
+		}
+
+		~DeletionCallbackList() { Destroy(); }
+
+		//adds a callback, the callable is moved into the arena
+		template<typename Func>
+		inline void Push(Func&& function)
+		{
+			using Callable = std::decay_t<Func>;
+			static_assert(alignof(Callable) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "Deletion callbacks can not be over aligned");
+
+			void* memory = arena.Allocate(sizeof(Callable), alignof(Callable));
+			new (memory) Callable(std::forward<Func>(function));
+			entries.push_back({ memory, [](void* callable) {
+				Callable* c = (Callable*)callable;
+				(*c)();
+				c->~Callable();
+			}, [](void* callable) {
+				((Callable*)callable)->~Callable();
+			} });
+		}
+
+		//runs every callback, last pushed first, and clears the list
+		//callbacks pushed while this runs are kept for the next flush
+		inline void Flush()
+		{
+			std::swap(entries, flushingEntries);
+			std::swap(arena, flushingArena);
+
+			for (size_t i = flushingEntries.size(); i-- > 0;)
+				flushingEntries[i].run(flushingEntries[i].callable);
+
+			flushingEntries.clear();
+			flushingArena.Reset();
+		}
+
+		//destroys every callback without running it
+		inline void Destroy()
+		{
+			for (size_t i = entries.size(); i-- > 0;)
+				entries[i].destroy(entries[i].callable);
+
+			entries.clear();
+			arena.Reset();
+		}
+
+		//gets the number of callbacks waiting
+		inline size_t GetCount() const { return entries.size(); }
+	};
+
 	//defines a deletion queue for handling lifetimes
 	struct DeletionQueue
 	{
-		std::deque<std::function<void()>> deletors;
+		DeletionCallbackList deletors;
 
+		//adds a std::function, kept for existing code, prefer push for lambdas so they are stored in place
 		void push_function(std::function<void()>&& function) {
-			deletors.push_back(function);
+			deletors.Push(std::move(function));
 		}
 
+		//adds a callable, stored in place with no heap allocation
+		template<typename Func>
+		inline void push(Func&& function) { deletors.Push(std::forward<Func>(function)); }
+
 		void flush() {
 			// reverse iterate the deletion queue to execute all the functions
-			for (auto it = deletors.rbegin(); it != deletors.rend(); it++) {
-				(*it)(); //call functors
-			}
+			deletors.Flush();
+		}
+	};
+
+	//defines the deletions queued during a single frame
+	struct FrameDeletions
+	{
+		DeletionCallbackList callbacks;
+
+		//mesh buffers are batched by type so freeing thousands of them is a flat loop with no callback per buffer
+		std::vector<Wireframe::MeshBuffers::VertexBuffer> vertexBuffers;
+		std::vector<Wireframe::MeshBuffers::IndexBuffer> indexBuffers;
+		std::vector<GPUBuffer> buffers;
+
+		//runs every deletion, the batches go first since nothing pushed as a callback can depend on a mesh buffer
+		inline void Flush(VmaAllocator& allocator)
+		{
+			for (size_t i = 0; i < vertexBuffers.size(); ++i)
+				vertexBuffers[i].Destroy(allocator);
+			vertexBuffers.clear();
+
+			for (size_t i = 0; i < indexBuffers.size(); ++i)
+				indexBuffers[i].Destroy(allocator);
+			indexBuffers.clear();
+
+			for (size_t i = 0; i < buffers.size(); ++i)
+				buffers[i].Destroy(allocator);
+			buffers.clear();
+
+			callbacks.Flush();
+		}
+
+		//gets the number of deletions waiting
+		inline size_t GetCount() const { return callbacks.GetCount() + vertexBuffers.size() + indexBuffers.size() + buffers.size(); }
+	};
+
+	//defines a deletion queue that holds deletions until the frames that could be using them are done
+	//call "BeginFrame" once a frame, after waiting on the fence of the frame slot being reused
+	struct FrameDeletionQueue
+	{
+		std::vector<FrameDeletions> frames; //one per frame in flight
+		uint64_t frameNumber = 0; //the current frame
+		size_t currentFrame = 0; //the slot deletions are being queued into
+
+		//sets up the queue, framesInFlight should match the renderer's frames in flight
+		inline void Init(const uint32_t& framesInFlight)
+		{
+			frames.clear();
+			frames.resize(framesInFlight > 0 ? framesInFlight : 1);
+			frameNumber = 0;
+			currentFrame = 0;
+		}
+
+		//moves to the next frame, running the deletions queued the last time this slot was used
+		//those were queued framesInFlight frames ago, and that frame's fence has been waited on
+		inline void BeginFrame(VmaAllocator& allocator)
+		{
+			SMOK_PROFILE_ZONE("FrameDeletionQueue::BeginFrame");
+
+			frameNumber++;
+			currentFrame = (size_t)(frameNumber % frames.size());
+			frames[currentFrame].Flush(allocator);
+		}
+
+		//queues a callable to run once the current frame has finished on the GPU
+		template<typename Func>
+		inline void Push(Func&& function) { frames[currentFrame].callbacks.Push(std::forward<Func>(function)); }
+
+		//queues a vertex buffer to be destroyed once the current frame has finished on the GPU
+		inline void RetireVertexBuffer(const Wireframe::MeshBuffers::VertexBuffer& buffer) { frames[currentFrame].vertexBuffers.emplace_back(buffer); }
+
+		//queues a index buffer to be destroyed once the current frame has finished on the GPU
+		inline void RetireIndexBuffer(const Wireframe::MeshBuffers::IndexBuffer& buffer) { frames[currentFrame].indexBuffers.emplace_back(buffer); }
+
+		//queues a raw buffer to be destroyed once the current frame has finished on the GPU
+		inline void RetireBuffer(const GPUBuffer& buffer) { frames[currentFrame].buffers.emplace_back(buffer); }
+
+		//runs every deletion in every frame, oldest first, only call once the GPU is idle
+		inline void FlushAll(VmaAllocator& allocator)
+		{
+			for (size_t i = 1; i <= frames.size(); ++i)
+				frames[(currentFrame + i) % frames.size()].Flush(allocator);
+		}
 
-			deletors.clear();
+		//gets the number of deletions waiting across every frame
+		inline size_t GetPendingCount() const
+		{
+			size_t count = 0;
+			for (size_t i = 0; i < frames.size(); ++i)
+				count += frames[i].GetCount();
+			return count;
 		}
 	};
 
@@ -0,0 +1,396 @@
+#pragma once
+
+//defines a offset allocator, hands out ranges of a fixed size space without touching the memory it's self
+//it's a two level segregated fit allocator (TLSF), free ranges are sorted into 256 bins by a 8 bit float of their size
+//a bitmask per level finds the smallest bin that fits with two bit scans, so allocating and freeing are O(1)
+//freed ranges merge with free neighbors straight away, "Compact" packs every live range to the front for defragmenting
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace Smok::Memory
+{
+	//defines a range handed out by a offset allocator
+	struct OffsetAllocation
+	{
+		static constexpr uint32_t NO_SPACE = 0xFFFFFFFF;
+
+		uint32_t offset = NO_SPACE; //the start of the range, in whatever unit the allocator was made with
+		uint32_t size = 0; //the size of the range
+		uint32_t node = NO_SPACE; //the allocator's node for the range, needed to free it
+
+		//is the allocation valid
+		inline bool IsValid() const { return offset != NO_SPACE; }
+	};
+
+	//defines a move made when compacting, copy size units from the old offset to the new one
+	struct OffsetMove
+	{
+		uint32_t oldOffset = 0;
+		uint32_t newOffset = 0;
+		uint32_t size = 0;
+	};
+
+	//defines the free space in a offset allocator
+	struct OffsetAllocatorReport
+	{
+		uint32_t totalFree = 0; //the free space
+		uint32_t largestFree = 0; //the largest range that is sure to fit, a rounded down bin size
+		uint32_t freeRanges = 0; //the number of free ranges, more ranges for the same free space means more fragmentation
+	};
+
+	//defines the offset allocator
+	struct OffsetAllocator
+	{
+		static constexpr uint32_t MANTISSA_BITS = 3;
+		static constexpr uint32_t MANTISSA_VALUE = 1 << MANTISSA_BITS;
+		static constexpr uint32_t MANTISSA_MASK = MANTISSA_VALUE - 1;
+
+		static constexpr uint32_t TOP_BIN_COUNT = 32;
+		static constexpr uint32_t BINS_PER_LEAF = 8;
+		static constexpr uint32_t LEAF_BIN_COUNT = TOP_BIN_COUNT * BINS_PER_LEAF;
+
+		static constexpr uint32_t UNUSED = 0xFFFFFFFF;
+
+		//defines a range in the space, free or used
+		struct Node
+		{
+			uint32_t offset = 0;
+			uint32_t size = 0;
+			uint32_t binListPrev = UNUSED; //the free ranges in the same bin
+			uint32_t binListNext = UNUSED;
+			uint32_t neighborPrev = UNUSED; //the ranges next to this one in the space
+			uint32_t neighborNext = UNUSED;
+			bool used = false;
+		};
+
+		uint32_t totalSize = 0;
+		uint32_t maxAllocations = 0;
+		uint32_t freeStorage = 0;
+		uint32_t allocationCount = 0;
+
+		uint32_t usedBinsTop = 0; //a bit per top bin, set when any of it's leaf bins has a free range
+		uint8_t usedBins[TOP_BIN_COUNT] = {}; //a bit per leaf bin, set when it has a free range
+		uint32_t binIndices[LEAF_BIN_COUNT] = {}; //the first free node in each bin
+
+		std::vector<Node> nodes;
+		std::vector<uint32_t> freeNodes; //nodes not in use, a stack
+
+		//converts a size into a bin, rounding up so any range in the bin fits it
+		static inline uint32_t SizeToBinRoundUp(const uint32_t& size)
+		{
+			if (size < MANTISSA_VALUE)
+				return size; //small sizes get a exact bin
+
+			const uint32_t highestSetBit = (uint32_t)std::bit_width(size) - 1;
+			const uint32_t mantissaStartBit = highestSetBit - MANTISSA_BITS;
+			const uint32_t exponent = mantissaStartBit + 1;
+			uint32_t mantissa = (size >> mantissaStartBit) & MANTISSA_MASK;
+			if ((size & ((1u << mantissaStartBit) - 1)) != 0)
+				mantissa++; //a overflow carries into the exponent, which is what we want
+
+			return (exponent << MANTISSA_BITS) + mantissa;
+		}
+
+		//converts a size into a bin, rounding down so the range is filed where it's at least as big as the bin
+		static inline uint32_t SizeToBinRoundDown(const uint32_t& size)
+		{
+			if (size < MANTISSA_VALUE)
+				return size;
+
+			const uint32_t highestSetBit = (uint32_t)std::bit_width(size) - 1;
+			const uint32_t mantissaStartBit = highestSetBit - MANTISSA_BITS;
+			const uint32_t exponent = mantissaStartBit + 1;
+			const uint32_t mantissa = (size >> mantissaStartBit) & MANTISSA_MASK;
+			return (exponent << MANTISSA_BITS) | mantissa;
+		}
+
+		//converts a bin back into the smallest size it holds
+		static inline uint32_t BinToSize(const uint32_t& bin)
+		{
+			const uint32_t exponent = bin >> MANTISSA_BITS;
+			const uint32_t mantissa = bin & MANTISSA_MASK;
+			return (exponent == 0 ? mantissa : (mantissa | MANTISSA_VALUE) << (exponent - 1));
+		}
+
+		//finds the lowest set bit at or after a index, UNUSED if there is none
+		static inline uint32_t FindLowestSetBitAfter(const uint32_t& mask, const uint32_t& start)
+		{
+			if (start >= 32)
+				return UNUSED;
+			const uint32_t after = mask & ~((1u << start) - 1);
+			return (after == 0 ? UNUSED : (uint32_t)std::countr_zero(after));
+		}
+
+		//inits the allocator over size units with room for maxAllocations live ranges
+		inline void Init(const uint32_t& size, const uint32_t& _maxAllocations = 128 * 1024)
+		{
+			totalSize = size;
+			maxAllocations = _maxAllocations;
+			Reset();
+		}
+
+		//frees every range
+		inline void Reset()
+		{
+			freeStorage = 0;
+			allocationCount = 0;
+			usedBinsTop = 0;
+			std::fill(std::begin(usedBins), std::end(usedBins), (uint8_t)0);
+			std::fill(std::begin(binIndices), std::end(binIndices), UNUSED);
+
+			nodes.assign(maxAllocations, Node());
+			freeNodes.resize(maxAllocations);
+			for (uint32_t i = 0; i < maxAllocations; ++i)
+				freeNodes[i] = maxAllocations - i - 1; //node 0 is popped first
+
+			if (totalSize > 0)
+				InsertNodeIntoBin(totalSize, 0);
+		}
+
+		//allocates a range of size units, the result is not valid if there is no space
+		//the size is rounded up to it's bin when searching, so a free range only a little bigger than the request may be skipped
+		inline OffsetAllocation Allocate(const uint32_t& size)
+		{
+			//a split may need a new node for what's left
+			if (size == 0 || freeNodes.empty())
+				return OffsetAllocation();
+
+			//finds the smallest bin with a free range that fits
+			const uint32_t minBin = SizeToBinRoundUp(size);
+			const uint32_t minTopBin = minBin >> MANTISSA_BITS;
+			const uint32_t minLeafBin = minBin & MANTISSA_MASK;
+
+			uint32_t topBin = minTopBin;
+			uint32_t leafBin = UNUSED;
+			if (minTopBin < TOP_BIN_COUNT && (usedBinsTop & (1u << topBin)))
+				leafBin = FindLowestSetBitAfter(usedBins[topBin], minLeafBin);
+
+			if (leafBin == UNUSED)
+			{
+				topBin = FindLowestSetBitAfter(usedBinsTop, minTopBin + 1);
+				if (topBin == UNUSED)
+					return OffsetAllocation();
+				leafBin = (uint32_t)std::countr_zero((uint32_t)usedBins[topBin]); //every range in a bigger top bin fits
+			}
+
+			//takes the first node out of the bin
+			const uint32_t bin = (topBin << MANTISSA_BITS) | leafBin;
+			const uint32_t nodeIndex = binIndices[bin];
+			Node& node = nodes[nodeIndex];
+			const uint32_t nodeTotalSize = node.size;
+			node.size = size;
+			node.used = true;
+			binIndices[bin] = node.binListNext;
+			if (node.binListNext != UNUSED)
+				nodes[node.binListNext].binListPrev = UNUSED;
+			freeStorage -= nodeTotalSize;
+			allocationCount++;
+
+			if (binIndices[bin] == UNUSED)
+			{
+				usedBins[topBin] &= ~(uint8_t)(1u << leafBin);
+				if (usedBins[topBin] == 0)
+					usedBinsTop &= ~(1u << topBin);
+			}
+
+			//puts what's left back as a free range right after the allocation
+			const uint32_t remainder = nodeTotalSize - size;
+			if (remainder > 0)
+			{
+				const uint32_t newNodeIndex = InsertNodeIntoBin(remainder, nodes[nodeIndex].offset + size);
+				Node& allocated = nodes[nodeIndex];
+				if (allocated.neighborNext != UNUSED)
+					nodes[allocated.neighborNext].neighborPrev = newNodeIndex;
+				nodes[newNodeIndex].neighborPrev = nodeIndex;
+				nodes[newNodeIndex].neighborNext = allocated.neighborNext;
+				allocated.neighborNext = newNodeIndex;
+			}
+
+			return { nodes[nodeIndex].offset, size, nodeIndex };
+		}
+
+		//frees a range, merging it with free neighbors
+		inline void Free(const OffsetAllocation& allocation)
+		{
+			if (allocation.node == OffsetAllocation::NO_SPACE || allocation.node >= nodes.size() || !nodes[allocation.node].used)
+				return;
+
+			const uint32_t nodeIndex = allocation.node;
+			Node& node = nodes[nodeIndex];
+			uint32_t offset = node.offset;
+			uint32_t size = node.size;
+
+			if (node.neighborPrev != UNUSED && !nodes[node.neighborPrev].used)
+			{
+				const Node& prev = nodes[node.neighborPrev];
+				offset = prev.offset;
+				size += prev.size;
+				const uint32_t prevPrev = prev.neighborPrev;
+				RemoveNodeFromBin(node.neighborPrev);
+				node.neighborPrev = prevPrev;
+			}
+
+			if (node.neighborNext != UNUSED && !nodes[node.neighborNext].used)
+			{
+				const Node& next = nodes[node.neighborNext];
+				size += next.size;
+				const uint32_t nextNext = next.neighborNext;
+				RemoveNodeFromBin(node.neighborNext);
+				node.neighborNext = nextNext;
+			}
+
+			const uint32_t neighborPrev = node.neighborPrev;
+			const uint32_t neighborNext = node.neighborNext;
+			node = Node();
+			freeNodes.emplace_back(nodeIndex);
+			allocationCount--;
+
+			//the merged range is filed as one free node
+			const uint32_t combinedIndex = InsertNodeIntoBin(size, offset);
+			if (neighborNext != UNUSED)
+			{
+				nodes[combinedIndex].neighborNext = neighborNext;
+				nodes[neighborNext].neighborPrev = combinedIndex;
+			}
+			if (neighborPrev != UNUSED)
+			{
+				nodes[combinedIndex].neighborPrev = neighborPrev;
+				nodes[neighborPrev].neighborNext = combinedIndex;
+			}
+		}
+
+		//gets the free space
+		inline OffsetAllocatorReport GetReport() const
+		{
+			OffsetAllocatorReport report;
+			if (freeNodes.empty())
+				return report; //nothing can be allocated
+
+			report.totalFree = freeStorage;
+			if (usedBinsTop != 0)
+			{
+				const uint32_t topBin = 31 - (uint32_t)std::countl_zero(usedBinsTop);
+				const uint32_t leafBin = 31 - (uint32_t)std::countl_zero((uint32_t)usedBins[topBin]);
+				report.largestFree = BinToSize((topBin << MANTISSA_BITS) | leafBin);
+			}
+			report.freeRanges = maxAllocations - (uint32_t)freeNodes.size() - allocationCount;
+			return report;
+		}
+
+		//gets the number of live allocations
+		inline uint32_t GetAllocationCount() const { return allocationCount; }
+
+		//gets if the allocations are already packed to the front of the space in offset order, "Compact" would not move any of them
+		static inline bool IsPacked(OffsetAllocation* const* allocations, const size_t& allocationCount)
+		{
+			std::vector<const OffsetAllocation*> sorted(allocations, allocations + allocationCount);
+			std::sort(sorted.begin(), sorted.end(), [](const OffsetAllocation* a, const OffsetAllocation* b) { return a->offset < b->offset; });
+
+			uint32_t end = 0;
+			for (const OffsetAllocation* allocation : sorted)
+			{
+				if (!allocation->IsValid())
+					continue;
+				if (allocation->offset != end)
+					return false;
+				end += allocation->size;
+			}
+
+			return true;
+		}
+
+		//packs every allocation in allocations to the front of the space, in offset order
+		//the allocations are updated in place, moves gets a entry per range sorted by the new offset, oldOffset == newOffset if it stayed put
+		//anything not in the list is freed, returns if any range moved
+		inline bool Compact(OffsetAllocation* const* allocations, const size_t& allocationCount, std::vector<OffsetMove>& moves)
+		{
+			std::vector<OffsetAllocation*> sorted(allocations, allocations + allocationCount);
+			std::sort(sorted.begin(), sorted.end(), [](const OffsetAllocation* a, const OffsetAllocation* b) { return a->offset < b->offset; });
+
+			//a empty allocator is one free range, allocating in order takes each range from it's front
+			Reset();
+			moves.clear();
+			bool moved = false;
+			for (OffsetAllocation* allocation : sorted)
+			{
+				if (!allocation->IsValid())
+					continue;
+
+				const uint32_t oldOffset = allocation->offset;
+				*allocation = Allocate(allocation->size);
+				moves.push_back({ oldOffset, allocation->offset, allocation->size });
+				moved |= (allocation->offset != oldOffset);
+			}
+
+			return moved;
+		}
+
+		//---internal
+
+		//files a free range in it's bin, returns it's node
+		inline uint32_t InsertNodeIntoBin(const uint32_t& size, const uint32_t& offset)
+		{
+			const uint32_t bin = SizeToBinRoundDown(size);
+			const uint32_t topBin = bin >> MANTISSA_BITS;
+			const uint32_t leafBin = bin & MANTISSA_MASK;
+
+			if (binIndices[bin] == UNUSED)
+			{
+				usedBins[topBin] |= (uint8_t)(1u << leafBin);
+				usedBinsTop |= 1u << topBin;
+			}
+
+			const uint32_t topNodeIndex = binIndices[bin];
+			const uint32_t nodeIndex = freeNodes.back();
+			freeNodes.pop_back();
+
+			nodes[nodeIndex] = Node();
+			nodes[nodeIndex].offset = offset;
+			nodes[nodeIndex].size = size;
+			nodes[nodeIndex].binListNext = topNodeIndex;
+			if (topNodeIndex != UNUSED)
+				nodes[topNodeIndex].binListPrev = nodeIndex;
+			binIndices[bin] = nodeIndex;
+
+			freeStorage += size;
+			return nodeIndex;
+		}
+
+		//takes a free range out of it's bin and gives it's node back
+		inline void RemoveNodeFromBin(const uint32_t& nodeIndex)
+		{
+			Node& node = nodes[nodeIndex];
+			if (node.binListPrev != UNUSED)
+			{
+				//in the middle of the list, just unlink it
+				nodes[node.binListPrev].binListNext = node.binListNext;
+				if (node.binListNext != UNUSED)
+					nodes[node.binListNext].binListPrev = node.binListPrev;
+			}
+			else
+			{
+				//the head of the list, the bin may go empty
+				const uint32_t bin = SizeToBinRoundDown(node.size);
+				const uint32_t topBin = bin >> MANTISSA_BITS;
+				const uint32_t leafBin = bin & MANTISSA_MASK;
+
+				binIndices[bin] = node.binListNext;
+				if (node.binListNext != UNUSED)
+					nodes[node.binListNext].binListPrev = UNUSED;
+
+				if (binIndices[bin] == UNUSED)
+				{
+					usedBins[topBin] &= ~(uint8_t)(1u << leafBin);
+					if (usedBins[topBin] == 0)
+						usedBinsTop &= ~(1u << topBin);
+				}
+			}
+
+			freeStorage -= node.size;
+			freeNodes.emplace_back(nodeIndex);
+		}
+	};
+}
\ No newline at end of file
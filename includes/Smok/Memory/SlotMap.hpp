@@ -0,0 +1,148 @@
+#pragma once
+
+//defines a slot map, a pool of objects found by a generational handle
+//handles are a 32 bit slot index and a 32 bit generation, removing a object bumps the generation so old handles stop resolving
+//objects live in fixed size chunks, they never move once added so pointers can be handed to other threads
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Smok::Memory
+{
+	//defines a handle into a slot map
+	struct SlotHandle
+	{
+		uint32_t index = UINT32_MAX; //the slot
+		uint32_t generation = 0; //the generation of the slot when the handle was made
+
+		//packs the handle into a 64 bit ID, the generation is the high half
+		inline uint64_t Pack() const { return ((uint64_t)generation << 32) | index; }
+
+		//unpacks a handle from a 64 bit ID
+		static inline SlotHandle Unpack(const uint64_t& ID) { return { (uint32_t)(ID & 0xFFFFFFFF), (uint32_t)(ID >> 32) }; }
+
+		inline bool operator==(const SlotHandle& other) const { return index == other.index && generation == other.generation; }
+		inline bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+	};
+
+	//defines a invalid handle, no slot ever has generation 0 so it can not resolve
+	static constexpr uint64_t INVALID_SLOT_ID = 0xFFFFFFFF;
+
+	//defines a slot map, CHUNK_SIZE objects are stored contiguously per chunk
+	template<typename T, size_t CHUNK_SIZE = 64>
+	struct SlotMap
+	{
+		static_assert((CHUNK_SIZE & (CHUNK_SIZE - 1)) == 0, "CHUNK_SIZE must be a power of 2");
+
+		std::vector<std::unique_ptr<T[]>> chunks; //the objects, never reallocated
+		std::vector<uint32_t> generations; //the current generation of each slot, starts at 1
+		std::vector<uint8_t> alive; //is each slot in use
+		std::vector<uint32_t> freeSlots; //slots that can be reused
+		size_t count = 0; //the number of live objects
+
+		//gets the object in a slot, does not check if it's alive
+		inline T& GetSlot(const uint32_t& index) { return chunks[index / CHUNK_SIZE][index & (CHUNK_SIZE - 1)]; }
+		inline const T& GetSlot(const uint32_t& index) const { return chunks[index / CHUNK_SIZE][index & (CHUNK_SIZE - 1)]; }
+
+		//reserves room for a number of objects
+		inline void Reserve(const size_t& capacity)
+		{
+			while (chunks.size() * CHUNK_SIZE < capacity)
+				chunks.emplace_back(new T[CHUNK_SIZE]);
+			generations.reserve(capacity);
+			alive.reserve(capacity);
+		}
+
+		//adds a object, reusing a free slot if there is one
+		inline SlotHandle Insert(T&& value)
+		{
+			uint32_t index;
+			if (!freeSlots.empty())
+			{
+				index = freeSlots.back();
+				freeSlots.pop_back();
+			}
+			else
+			{
+				index = (uint32_t)generations.size();
+				if (index / CHUNK_SIZE >= chunks.size())
+					chunks.emplace_back(new T[CHUNK_SIZE]);
+				generations.emplace_back(1);
+				alive.emplace_back(0);
+			}
+
+			GetSlot(index) = std::move(value);
+			alive[index] = 1;
+			count++;
+			return { index, generations[index] };
+		}
+
+		//gets a object by handle, nullptr if the handle is stale or was never valid
+		inline T* Get(const SlotHandle& handle)
+		{
+			if (handle.index >= generations.size() || generations[handle.index] != handle.generation || !alive[handle.index])
+				return nullptr;
+			return &GetSlot(handle.index);
+		}
+
+		inline const T* Get(const SlotHandle& handle) const
+		{
+			if (handle.index >= generations.size() || generations[handle.index] != handle.generation || !alive[handle.index])
+				return nullptr;
+			return &GetSlot(handle.index);
+		}
+
+		//is a handle pointing at a live object
+		inline bool IsValid(const SlotHandle& handle) const { return Get(handle) != nullptr; }
+
+		//removes a object, it's slot is reset and every handle to it goes stale
+		inline bool Remove(const SlotHandle& handle)
+		{
+			T* object = Get(handle);
+			if (!object)
+				return false;
+
+			*object = T();
+			alive[handle.index] = 0;
+			generations[handle.index]++;
+			if (generations[handle.index] == 0) //skip 0 on wrap so a default handle never resolves
+				generations[handle.index] = 1;
+			freeSlots.emplace_back(handle.index);
+			count--;
+			return true;
+		}
+
+		//runs a function on every live object in slot order, func takes (const SlotHandle&, T&)
+		template<typename Func>
+		inline void ForEach(Func&& func)
+		{
+			const uint32_t slotCount = (uint32_t)generations.size();
+			for (uint32_t i = 0; i < slotCount; ++i)
+			{
+				if (alive[i])
+					func(SlotHandle{ i, generations[i] }, GetSlot(i));
+			}
+		}
+
+		//gets the number of live objects
+		inline size_t GetCount() const { return count; }
+
+		//removes every object, the chunks are kept and every handle goes stale
+		inline void Clear()
+		{
+			freeSlots.clear();
+			for (uint32_t i = (uint32_t)generations.size(); i-- > 0;)
+			{
+				if (alive[i])
+				{
+					GetSlot(i) = T();
+					alive[i] = 0;
+					generations[i] = (generations[i] + 1 == 0 ? 1 : generations[i] + 1);
+				}
+				freeSlots.emplace_back(i);
+			}
+			count = 0;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,455 @@
+#pragma once
+
+//defines a scoped zone profiler for finding where load and frame time goes
+//every thread writes zones into it's own ring buffer with no locks, the only lock is taken once when a thread first records and once when it exits
+//the rings of exited threads are kept until their zones are exported, then handed to new threads so short lived workers don't grow memory
+//zones are exported in the Chrome trace event format, open the file in chrome://tracing or ui.perfetto.dev
+//the SMOK_PROFILE_* macros compile to nothing in BTD_DIST, or anywhere SMOK_PROFILER_DISABLE is defined
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if !defined(BTD_DIST) && !defined(SMOK_PROFILER_DISABLE)
+#define SMOK_PROFILER_ENABLED
+#endif
+
+namespace Smok::Profiling
+{
+	//gets the time in nanoseconds, only the difference between two calls means anything
+	static inline uint64_t GetTimestampNanoseconds()
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	//writes a string as the inside of a JSON string, quotes, backslashes and control characters are escaped
+	static inline void WriteJSONEscaped(fmt::memory_buffer& json, const char* str)
+	{
+		if (!str)
+			return;
+
+		for (; *str; ++str)
+		{
+			const unsigned char c = (unsigned char)*str;
+			if (c == '"' || c == '\\')
+			{
+				json.push_back('\\');
+				json.push_back((char)c);
+			}
+			else if (c < 0x20)
+				fmt::format_to(std::back_inserter(json), "\\u{:04x}", (uint32_t)c);
+			else
+				json.push_back((char)c);
+		}
+	}
+
+	//defines the asset stages tracked in the load time table
+	enum class AssetStage : uint8_t
+	{
+		None = 0, //a zone not counted in the table
+
+		Decode, //reading and parsing the files, on a loader worker
+		Create, //making the GPU side, on the thread owning the asset manager
+
+		Count
+	};
+
+	//defines a finished zone
+	struct ProfileZone
+	{
+		static constexpr uint64_t NO_ASSET = 0xFFFFFFFFFFFFFFFFull;
+
+		const char* name = nullptr; //must be a string literal or outlive the export
+		uint64_t start = 0; //nanoseconds
+		uint64_t end = 0;
+		uint64_t assetID = NO_ASSET; //the asset the zone worked on, if any
+	};
+
+	//defines a zone in a ring buffer, the fields are atomic as a export can read a slot while the owning thread overwrites it
+	struct ProfileZoneSlot
+	{
+		std::atomic<const char*> name = nullptr;
+		std::atomic<uint64_t> start = 0;
+		std::atomic<uint64_t> end = 0;
+		std::atomic<uint64_t> assetID = ProfileZone::NO_ASSET;
+
+		//writes a zone
+		inline void Store(const ProfileZone& zone)
+		{
+			name.store(zone.name, std::memory_order_relaxed);
+			start.store(zone.start, std::memory_order_relaxed);
+			end.store(zone.end, std::memory_order_relaxed);
+			assetID.store(zone.assetID, std::memory_order_relaxed);
+		}
+
+		//reads a zone, it may be torn if the slot is being written, see "ProfileThreadBuffer::CopyZones"
+		inline ProfileZone Load() const
+		{
+			ProfileZone zone;
+			zone.name = name.load(std::memory_order_relaxed);
+			zone.start = start.load(std::memory_order_relaxed);
+			zone.end = end.load(std::memory_order_relaxed);
+			zone.assetID = assetID.load(std::memory_order_relaxed);
+			return zone;
+		}
+	};
+
+	//defines the ring buffer of a thread, only the owning thread writes to it
+	struct ProfileThreadBuffer
+	{
+		static constexpr uint64_t CAPACITY = 16 * 1024; //must be a power of 2, the oldest zones are overwritten once it's full
+
+		uint32_t threadIndex = 0; //the tid in the trace
+		std::string threadName;
+		bool hasExited = false; //the owning thread is gone, the ring is kept until it's zones are exported
+		std::atomic<uint64_t> writeCount = 0; //the zones ever written, the next write goes to writeCount % CAPACITY
+		std::unique_ptr<ProfileZoneSlot[]> zones = std::make_unique<ProfileZoneSlot[]>(CAPACITY);
+
+		//adds a zone
+		inline void Push(const ProfileZone& zone)
+		{
+			const uint64_t count = writeCount.load(std::memory_order_relaxed);
+
+			//a export that reads any of this zone is then sure to see writeCount at count, so it knows the slot may be torn
+			std::atomic_thread_fence(std::memory_order_release);
+			zones[count & (CAPACITY - 1)].Store(zone);
+			writeCount.store(count + 1, std::memory_order_release);
+		}
+
+		//copies out the zones still in the ring, oldest first
+		//zones the owning thread may have overwritten during the copy are dropped, export while threads are idle for a full capture
+		inline void CopyZones(std::vector<ProfileZone>& out) const
+		{
+			const uint64_t end = writeCount.load(std::memory_order_acquire);
+			const uint64_t begin = (end > CAPACITY ? end - CAPACITY : 0);
+			const size_t first = out.size();
+			for (uint64_t i = begin; i < end; ++i)
+				out.emplace_back(zones[i & (CAPACITY - 1)].Load());
+
+			//the write of zone "after" may be half done, so every slot it and the writes before it reached is dropped
+			std::atomic_thread_fence(std::memory_order_acquire);
+			const uint64_t after = writeCount.load(std::memory_order_relaxed);
+			const uint64_t overwritten = (after + 1 > CAPACITY ? std::min(after + 1 - CAPACITY, end) : 0);
+			if (overwritten > begin)
+				out.erase(out.begin() + first, out.begin() + first + (size_t)(overwritten - begin));
+		}
+	};
+
+	//defines the load times of a asset
+	struct AssetLoadTime
+	{
+		uint64_t assetID = 0;
+		uint32_t loadCount = 0; //the number of times a decode was recorded, reloads count again
+		uint64_t decodeNanoseconds = 0; //the totals over every load
+		uint64_t createNanoseconds = 0;
+		uint64_t maxLoadNanoseconds = 0; //the slowest single decode or create
+
+		//gets the total time spent on the asset
+		inline uint64_t GetTotalNanoseconds() const { return decodeNanoseconds + createNanoseconds; }
+	};
+
+	struct Profiler;
+
+	//defines the calling thread's hold on it's ring buffer, the ring is retired when the thread exits
+	struct ProfileThreadBufferOwner
+	{
+		Profiler* profiler = nullptr;
+		ProfileThreadBuffer* buffer = nullptr;
+
+		inline ~ProfileThreadBufferOwner();
+	};
+
+	//defines the profiler, get the shared one with "GetProfiler"
+	struct Profiler
+	{
+		//the most exited threads kept for export, past this the oldest rings are reused without being exported
+		static constexpr size_t MAX_EXITED_THREADS = 32;
+
+		std::atomic<bool> isEnabled = true; //zones started while disabled are not recorded
+		uint64_t startTime = GetTimestampNanoseconds(); //the zero point of the trace
+
+		std::mutex threadsMutex;
+		std::vector<std::unique_ptr<ProfileThreadBuffer>> threads; //every running thread's ring, and exited ones whose zones are not exported yet, oldest first
+		std::vector<std::unique_ptr<ProfileThreadBuffer>> freeThreads; //rings of exited threads ready to be handed to new ones
+		size_t exitedThreadCount = 0; //the rings in threads with no owner
+		uint32_t nextThreadIndex = 1;
+
+		std::mutex assetTimesMutex;
+		std::unordered_map<uint64_t, AssetLoadTime> assetLoadTimes;
+
+		//gets the ring buffer of the calling thread, making it on the first call
+		inline ProfileThreadBuffer& GetThreadBuffer()
+		{
+			thread_local ProfileThreadBufferOwner owner;
+			if (!owner.buffer)
+			{
+				std::lock_guard<std::mutex> lock(threadsMutex);
+				std::unique_ptr<ProfileThreadBuffer> buffer;
+				if (!freeThreads.empty())
+				{
+					buffer = std::move(freeThreads.back());
+					freeThreads.pop_back();
+				}
+				else
+					buffer = std::make_unique<ProfileThreadBuffer>();
+
+				buffer->threadIndex = nextThreadIndex++;
+				buffer->threadName = fmt::format("Thread {}", buffer->threadIndex);
+				buffer->hasExited = false;
+				buffer->writeCount.store(0, std::memory_order_relaxed);
+
+				owner.profiler = this;
+				owner.buffer = buffer.get();
+				threads.emplace_back(std::move(buffer));
+			}
+
+			return *owner.buffer;
+		}
+
+		//marks a exited thread's ring, it is reused once exported or once too many exited threads are waiting
+		inline void RetireThreadBuffer(ProfileThreadBuffer* buffer)
+		{
+			std::lock_guard<std::mutex> lock(threadsMutex);
+			buffer->hasExited = true;
+			exitedThreadCount++;
+
+			for (size_t t = 0; t < threads.size() && exitedThreadCount > MAX_EXITED_THREADS;)
+			{
+				if (threads[t]->hasExited)
+					RecycleThreadBuffer(t);
+				else
+					++t;
+			}
+		}
+
+		//moves a exited thread's ring to the free list, threadsMutex must be held
+		inline void RecycleThreadBuffer(const size_t& index)
+		{
+			freeThreads.emplace_back(std::move(threads[index]));
+			threads.erase(threads.begin() + index);
+			exitedThreadCount--;
+		}
+
+		//recycles every exited thread's ring, threadsMutex must be held
+		inline void RecycleExitedThreadBuffers()
+		{
+			for (size_t t = 0; t < threads.size() && exitedThreadCount > 0;)
+			{
+				if (threads[t]->hasExited)
+					RecycleThreadBuffer(t);
+				else
+					++t;
+			}
+		}
+
+		//names the calling thread in the trace
+		inline void SetThreadName(const std::string& name)
+		{
+			ProfileThreadBuffer& buffer = GetThreadBuffer();
+			std::lock_guard<std::mutex> lock(threadsMutex);
+			buffer.threadName = name;
+		}
+
+		//records a finished zone on the calling thread
+		inline void Record(const ProfileZone& zone, const AssetStage& stage = AssetStage::None)
+		{
+			GetThreadBuffer().Push(zone);
+			if (stage != AssetStage::None && zone.assetID != ProfileZone::NO_ASSET)
+				RecordAssetStage(zone.assetID, stage, zone.end - zone.start);
+		}
+
+		//adds time to a asset in the load time table
+		inline void RecordAssetStage(const uint64_t& assetID, const AssetStage& stage, const uint64_t& nanoseconds)
+		{
+			std::lock_guard<std::mutex> lock(assetTimesMutex);
+			AssetLoadTime& time = assetLoadTimes[assetID];
+			time.assetID = assetID;
+			if (stage == AssetStage::Decode)
+			{
+				time.loadCount++;
+				time.decodeNanoseconds += nanoseconds;
+			}
+			else
+				time.createNanoseconds += nanoseconds;
+			time.maxLoadNanoseconds = std::max(time.maxLoadNanoseconds, nanoseconds);
+		}
+
+		//gets the load time table, slowest total first
+		inline std::vector<AssetLoadTime> GetAssetLoadTimes()
+		{
+			std::vector<AssetLoadTime> times;
+			{
+				std::lock_guard<std::mutex> lock(assetTimesMutex);
+				times.reserve(assetLoadTimes.size());
+				for (const auto& t : assetLoadTimes)
+					times.emplace_back(t.second);
+			}
+
+			std::sort(times.begin(), times.end(), [](const AssetLoadTime& a, const AssetLoadTime& b) { return a.GetTotalNanoseconds() > b.GetTotalNanoseconds(); });
+			return times;
+		}
+
+		//prints the slowest assets, 0 prints them all
+		inline void PrintAssetLoadTimes(const size_t& count = 20)
+		{
+			const std::vector<AssetLoadTime> times = GetAssetLoadTimes();
+			const size_t printed = (count == 0 ? times.size() : std::min(count, times.size()));
+
+			fmt::print("Smok Profiler: {} assets loaded, the slowest {}:\n", times.size(), printed);
+			for (size_t i = 0; i < printed; ++i)
+			{
+				fmt::print("	{:#018x} loads {} decode {:.3f} ms create {:.3f} ms max {:.3f} ms\n", times[i].assetID, times[i].loadCount,
+					(double)times[i].decodeNanoseconds / 1000000.0, (double)times[i].createNanoseconds / 1000000.0, (double)times[i].maxLoadNanoseconds / 1000000.0);
+			}
+		}
+
+		//writes every zone still in the rings to a Chrome trace event JSON file
+		inline bool ExportChromeTrace(const std::string& filepath)
+		{
+			std::vector<ProfileZone> zones;
+			std::vector<std::pair<uint32_t, std::string>> threadNames;
+			std::vector<size_t> threadEnds;
+			{
+				std::lock_guard<std::mutex> lock(threadsMutex);
+				for (size_t t = 0; t < threads.size(); ++t)
+				{
+					threads[t]->CopyZones(zones);
+					threadEnds.emplace_back(zones.size());
+					threadNames.emplace_back(threads[t]->threadIndex, threads[t]->threadName);
+				}
+
+				//exited threads are in this export, their rings can go to new threads
+				RecycleExitedThreadBuffers();
+			}
+
+			fmt::memory_buffer json;
+			auto out = std::back_inserter(json);
+			fmt::format_to(out, "{{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+			size_t z = 0;
+			for (size_t t = 0; t < threadNames.size(); ++t)
+			{
+				//names come from users and threads, so they are escaped
+				fmt::format_to(out, "{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":\"", (t == 0 ? "" : ",\n"), threadNames[t].first);
+				WriteJSONEscaped(json, threadNames[t].second.c_str());
+				fmt::format_to(out, "\"}}}}");
+
+				//ts and dur are in microseconds, the fraction keeps the nanoseconds
+				for (; z < threadEnds[t]; ++z)
+				{
+					const double start = (double)(zones[z].start - std::min(zones[z].start, startTime)) / 1000.0;
+					const double duration = (double)(zones[z].end - zones[z].start) / 1000.0;
+					fmt::format_to(out, ",\n{{\"name\":\"");
+					WriteJSONEscaped(json, zones[z].name);
+					fmt::format_to(out, "\",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}", threadNames[t].first, start, duration);
+					if (zones[z].assetID != ProfileZone::NO_ASSET)
+						fmt::format_to(out, ",\"args\":{{\"assetID\":\"{:#018x}\"}}", zones[z].assetID);
+					fmt::format_to(out, "}}");
+				}
+			}
+			fmt::format_to(out, "\n]}}\n");
+
+			std::ofstream file(filepath, std::ios::binary);
+			if (!file.write(json.data(), (std::streamsize)json.size()))
+			{
+				fmt::print("Smok Profiler Error: Profiler || ExportChromeTrace || Failed to write \"{}\".\n", filepath);
+				return false;
+			}
+
+			return true;
+		}
+
+		//drops every recorded zone and load time, threads keep their names and the rings of exited threads are recycled
+		//only call while no other thread is recording
+		inline void Clear()
+		{
+			{
+				std::lock_guard<std::mutex> lock(threadsMutex);
+				RecycleExitedThreadBuffers();
+				for (size_t t = 0; t < threads.size(); ++t)
+					threads[t]->writeCount.store(0, std::memory_order_release);
+			}
+
+			std::lock_guard<std::mutex> lock(assetTimesMutex);
+			assetLoadTimes.clear();
+			startTime = GetTimestampNanoseconds();
+		}
+	};
+
+	inline ProfileThreadBufferOwner::~ProfileThreadBufferOwner()
+	{
+		if (buffer)
+			profiler->RetireThreadBuffer(buffer);
+	}
+
+	//gets the profiler shared by every thread, not static so every translation unit gets the same one
+	inline Profiler& GetProfiler()
+	{
+		static Profiler profiler;
+		return profiler;
+	}
+
+	//defines a zone timed from construction to destruction
+	struct ProfileScope
+	{
+		ProfileZone zone;
+		AssetStage stage = AssetStage::None;
+		bool isRecording = false;
+
+		ProfileScope(const char* name, const uint64_t& assetID = ProfileZone::NO_ASSET, const AssetStage& _stage = AssetStage::None)
+		{
+			isRecording = GetProfiler().isEnabled.load(std::memory_order_relaxed);
+			if (!isRecording)
+				return;
+
+			zone.name = name;
+			zone.assetID = assetID;
+			stage = _stage;
+			zone.start = GetTimestampNanoseconds();
+		}
+
+		~ProfileScope()
+		{
+			if (!isRecording)
+				return;
+
+			zone.end = GetTimestampNanoseconds();
+			GetProfiler().Record(zone, stage);
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+	};
+}
+
+#define SMOK_PROFILE_CONCAT_INTERNAL(a, b) a##b
+#define SMOK_PROFILE_CONCAT(a, b) SMOK_PROFILE_CONCAT_INTERNAL(a, b)
+
+#ifdef SMOK_PROFILER_ENABLED
+
+//times the rest of the scope, name must be a string literal
+#define SMOK_PROFILE_ZONE(name) Smok::Profiling::ProfileScope SMOK_PROFILE_CONCAT(smokProfileZone_, __LINE__)(name)
+
+//times the rest of the scope as work on a asset, a stage other than None also adds it to the load time table
+#define SMOK_PROFILE_ASSET_ZONE(name, assetID, stage) Smok::Profiling::ProfileScope SMOK_PROFILE_CONCAT(smokProfileZone_, __LINE__)(name, assetID, stage)
+
+//names the calling thread in the trace
+#define SMOK_PROFILE_THREAD_NAME(name) Smok::Profiling::GetProfiler().SetThreadName(name)
+
+#else
+
+#define SMOK_PROFILE_ZONE(name)
+#define SMOK_PROFILE_ASSET_ZONE(name, assetID, stage)
+#define SMOK_PROFILE_THREAD_NAME(name)
+
+#endif
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+
+//defines a view frustum, extracted from a projection * view matrix
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/geometric.hpp>
+
+#include <cstdint>
+
+namespace Smok::Rendering
+{
+	//defines the frustum planes
+	enum FrustumPlane : uint32_t
+	{
+		FrustumPlane_Left = 0,
+		FrustumPlane_Right,
+		FrustumPlane_Bottom,
+		FrustumPlane_Top,
+		FrustumPlane_Near,
+		FrustumPlane_Far,
+
+		FrustumPlane_Count
+	};
+
+	//defines a view frustum
+	//each plane is xyz normal pointing into the frustum and w distance, a point is inside a plane when dot(normal, point) + w >= 0
+	struct Frustum
+	{
+		glm::vec4 planes[FrustumPlane_Count];
+
+		//extracts the planes from a projection * view matrix
+		static inline Frustum FromMatrix(const glm::mat4& PV)
+		{
+			//glm is column major, so the rows have to be gathered
+			const glm::vec4 row0 = { PV[0][0], PV[1][0], PV[2][0], PV[3][0] };
+			const glm::vec4 row1 = { PV[0][1], PV[1][1], PV[2][1], PV[3][1] };
+			const glm::vec4 row2 = { PV[0][2], PV[1][2], PV[2][2], PV[3][2] };
+			const glm::vec4 row3 = { PV[0][3], PV[1][3], PV[2][3], PV[3][3] };
+
+			Frustum frustum;
+			frustum.planes[FrustumPlane_Left] = row3 + row0;
+			frustum.planes[FrustumPlane_Right] = row3 - row0;
+			frustum.planes[FrustumPlane_Bottom] = row3 + row1;
+			frustum.planes[FrustumPlane_Top] = row3 - row1;
+#ifdef GLM_FORCE_DEPTH_ZERO_TO_ONE
+			frustum.planes[FrustumPlane_Near] = row2;
+#else
+			frustum.planes[FrustumPlane_Near] = row3 + row2;
+#endif
+			frustum.planes[FrustumPlane_Far] = row3 - row2;
+
+			//normalizes so plane distances are in world units and sphere radii can be tested against them
+			for (uint32_t i = 0; i < FrustumPlane_Count; ++i)
+			{
+				const float length = glm::length(glm::vec3(frustum.planes[i]));
+				if (length > 0.0f)
+					frustum.planes[i] /= length;
+			}
+
+			return frustum;
+		}
+
+		//is a sphere at least partly inside
+		inline bool SphereIsVisible(const glm::vec3& center, const float& radius) const
+		{
+			for (uint32_t i = 0; i < FrustumPlane_Count; ++i)
+			{
+				if (glm::dot(glm::vec3(planes[i]), center) + planes[i].w < -radius)
+					return false;
+			}
+
+			return true;
+		}
+
+		//is a AABB at least partly inside, tests the corner furthest along each plane's normal
+		inline bool AABBIsVisible(const glm::vec3& min, const glm::vec3& max) const
+		{
+			for (uint32_t i = 0; i < FrustumPlane_Count; ++i)
+			{
+				const glm::vec3 corner = { (planes[i].x >= 0.0f ? max.x : min.x), (planes[i].y >= 0.0f ? max.y : min.y), (planes[i].z >= 0.0f ? max.z : min.z) };
+				if (glm::dot(glm::vec3(planes[i]), corner) + planes[i].w < 0.0f)
+					return false;
+			}
+
+			return true;
+		}
+	};
+}
\ No newline at end of file
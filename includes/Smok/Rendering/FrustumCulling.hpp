@@ -0,0 +1,196 @@
+#pragma once
+
+//defines the frustum culling stage
+//instances are gathered into world space bounding spheres stored as SoA, then tested against the frustum 4 at a time with SSE
+//the spheres persist between frames, so instances that did not move only need the SIMD test and not a trip through their model matrix
+
+#include <Smok/Rendering/Frustum.hpp>
+#include <Smok/Components/MeshComponent.hpp>
+#include <Smok/Components/Transform.hpp>
+#include <Smok/Profiling/Profiler.hpp>
+
+#include <limits>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define SMOK_FRUSTUM_CULLING_SSE
+#include <immintrin.h>
+#endif
+
+namespace Smok::Rendering
+{
+	//tests spheres against the frustum one at a time, writes the index of every visible sphere and returns how many were written
+	static inline size_t CullSpheres_Scalar(const Frustum& frustum, const float* centerX, const float* centerY, const float* centerZ, const float* radii,
+		const size_t& begin, const size_t& end, uint32_t* outVisible)
+	{
+		size_t visibleCount = 0;
+		for (size_t i = begin; i < end; ++i)
+		{
+			outVisible[visibleCount] = (uint32_t)i;
+			visibleCount += frustum.SphereIsVisible({ centerX[i], centerY[i], centerZ[i] }, radii[i]);
+		}
+
+		return visibleCount;
+	}
+
+#ifdef SMOK_FRUSTUM_CULLING_SSE
+	//tests spheres against the frustum 4 at a time, writes the index of every visible sphere and returns how many were written
+	static inline size_t CullSpheres_SSE(const Frustum& frustum, const float* centerX, const float* centerY, const float* centerZ, const float* radii,
+		const size_t& count, uint32_t* outVisible)
+	{
+		__m128 planeX[FrustumPlane_Count], planeY[FrustumPlane_Count], planeZ[FrustumPlane_Count], planeW[FrustumPlane_Count];
+		for (uint32_t p = 0; p < FrustumPlane_Count; ++p)
+		{
+			planeX[p] = _mm_set1_ps(frustum.planes[p].x);
+			planeY[p] = _mm_set1_ps(frustum.planes[p].y);
+			planeZ[p] = _mm_set1_ps(frustum.planes[p].z);
+			planeW[p] = _mm_set1_ps(frustum.planes[p].w);
+		}
+
+		const __m128 zero = _mm_setzero_ps();
+		size_t visibleCount = 0;
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 x = _mm_loadu_ps(centerX + i);
+			const __m128 y = _mm_loadu_ps(centerY + i);
+			const __m128 z = _mm_loadu_ps(centerZ + i);
+			const __m128 negativeRadius = _mm_sub_ps(zero, _mm_loadu_ps(radii + i));
+
+			__m128 outside = zero;
+			for (uint32_t p = 0; p < FrustumPlane_Count; ++p)
+			{
+				const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], x), _mm_mul_ps(planeY[p], y)),
+					_mm_add_ps(_mm_mul_ps(planeZ[p], z), planeW[p]));
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negativeRadius));
+			}
+
+			//writes every lane's index but only advances past the visible ones, no branches
+			const int visibleMask = ~_mm_movemask_ps(outside) & 0xF;
+			outVisible[visibleCount] = (uint32_t)i; visibleCount += (visibleMask & 1);
+			outVisible[visibleCount] = (uint32_t)i + 1; visibleCount += ((visibleMask >> 1) & 1);
+			outVisible[visibleCount] = (uint32_t)i + 2; visibleCount += ((visibleMask >> 2) & 1);
+			outVisible[visibleCount] = (uint32_t)i + 3; visibleCount += ((visibleMask >> 3) & 1);
+		}
+
+		return visibleCount + CullSpheres_Scalar(frustum, centerX, centerY, centerZ, radii, i, count, outVisible + visibleCount);
+	}
+#endif
+
+	//tests spheres against the frustum with the best path for this build, outVisible must have room for count indices
+	static inline size_t CullSpheres(const Frustum& frustum, const float* centerX, const float* centerY, const float* centerZ, const float* radii,
+		const size_t& count, uint32_t* outVisible)
+	{
+#ifdef SMOK_FRUSTUM_CULLING_SSE
+		return CullSpheres_SSE(frustum, centerX, centerY, centerZ, radii, count, outVisible);
+#else
+		return CullSpheres_Scalar(frustum, centerX, centerY, centerZ, radii, 0, count, outVisible);
+#endif
+	}
+
+	//defines the culling stage, keeps it's arrays between frames so culling does not allocate once warmed up
+	struct FrustumCuller
+	{
+		//world space bounding spheres, SoA
+		std::vector<float> centerX, centerY, centerZ, radii;
+
+		std::vector<uint32_t> visibleIndices; //the index of every instance that passed the last cull, only the first visibleCount are valid
+		size_t visibleCount = 0; //the number of instances that passed the last cull
+
+		//resizes the sphere arrays, existing spheres are kept
+		inline void Resize(const size_t& count)
+		{
+			centerX.resize(count);
+			centerY.resize(count);
+			centerZ.resize(count);
+			radii.resize(count);
+			visibleIndices.resize(count);
+		}
+
+		//sets a instance's world space sphere
+		inline void SetSphere(const size_t& index, const glm::vec3& center, const float& radius)
+		{
+			centerX[index] = center.x;
+			centerY[index] = center.y;
+			centerZ[index] = center.z;
+			radii[index] = radius;
+		}
+
+		//transforms a instance's mesh bounds into it's world space sphere, call when the instance moves or changes mesh
+		//null bounds make the instance never culled
+		inline void UpdateSphere(const size_t& index, const Asset::Mesh::Bounds* bounds, const glm::mat4& modelMatrix)
+		{
+			if (!bounds)
+			{
+				SetSphere(index, { 0.0f, 0.0f, 0.0f }, std::numeric_limits<float>::infinity());
+				return;
+			}
+
+			glm::vec3 center;
+			float radius;
+			Asset::Mesh::TransformBoundingSphere(*bounds, modelMatrix, center, radius);
+			SetSphere(index, center, radius);
+		}
+
+		//culls the spheres already in the arrays, returns the number of visible instances
+		inline size_t Cull(const Frustum& frustum)
+		{
+			SMOK_PROFILE_ZONE("FrustumCuller::Cull");
+
+			//the buffer always keeps room for every instance, the kernels write past the visible count
+			if (visibleIndices.size() < centerX.size())
+				visibleIndices.resize(centerX.size());
+			visibleCount = CullSpheres(frustum, centerX.data(), centerY.data(), centerZ.data(), radii.data(), centerX.size(), visibleIndices.data());
+			return visibleCount;
+		}
+
+		//gathers the world space sphere of every instance and culls them, use UpdateSphere and Cull(frustum) instead when most instances are static, returns the number of visible instances
+		//getBounds is called as "const Smok::Asset::Mesh::Bounds* (const uint64_t& staticMeshID)", instances it returns null for are never culled
+		//modelMatrices can come straight from a TransformStore, which keeps them packed and is cheaper to stream than whole Transform components
+		template<typename BoundsLookup>
+		inline size_t Cull(const Frustum& frustum, const glm::mat4* modelMatrices, const uint64_t* staticMeshIDs, const size_t& count,
+			BoundsLookup&& getBounds)
+		{
+			Resize(count);
+			GatherSpheres(count, getBounds, [&](const size_t& i) -> const uint64_t& { return staticMeshIDs[i]; },
+				[&](const size_t& i) -> const glm::mat4& { return modelMatrices[i]; });
+			return Cull(frustum);
+		}
+
+		//gathers the world space sphere of every mesh render and culls them, returns the number of visible instances
+		//transforms must have their model matrix up to date
+		template<typename BoundsLookup>
+		inline size_t Cull(const Frustum& frustum, const ECS::Comp::MeshRender* renders, const ECS::Comp::Transform* transforms, const size_t& count,
+			BoundsLookup&& getBounds)
+		{
+			Resize(count);
+			GatherSpheres(count, getBounds, [&](const size_t& i) -> const uint64_t& { return renders[i].staticMeshID; },
+				[&](const size_t& i) -> const glm::mat4& { return transforms[i].modelMatrix; });
+			return Cull(frustum);
+		}
+
+		//---internal
+
+		//transforms every instance's mesh bounds into a world space sphere
+		template<typename BoundsLookup, typename GetMeshID, typename GetModelMatrix>
+		inline void GatherSpheres(const size_t& count, BoundsLookup& getBounds, GetMeshID&& getMeshID, GetModelMatrix&& getModelMatrix)
+		{
+			//instances are often grouped by mesh, so the last lookup is kept
+			uint64_t lastMeshID = 0;
+			const Asset::Mesh::Bounds* bounds = nullptr;
+			bool haveLookup = false;
+			for (size_t i = 0; i < count; ++i)
+			{
+				const uint64_t& meshID = getMeshID(i);
+				if (!haveLookup || meshID != lastMeshID)
+				{
+					lastMeshID = meshID;
+					bounds = getBounds(lastMeshID);
+					haveLookup = true;
+				}
+
+				UpdateSphere(i, bounds, getModelMatrix(i));
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,343 @@
+#pragma once
+
+//defines the geometry pool, a few large device buffers every static mesh's vertices and indices are sub-allocated from
+//meshes hold offset ranges instead of their own buffers, so one vertex and index buffer bind covers every mesh of a vertex layout
+//and the draws can be written straight into a indirect buffer for multi-draw-indirect
+//vertices get a pool per vertex layout so the range offsets are in whole vertices and work as the draw's vertex offset
+
+#include <Smok/Assets/Mesh.hpp>
+#include <Smok/Memory/OffsetAllocator.hpp>
+#include <Smok/Memory/LifetimeDeleteQueue.hpp>
+
+#include <vector>
+
+namespace Smok::Rendering
+{
+	//defines the ranges a static mesh held in the pool, kept so they can be freed after the mesh is gone
+	struct GeometryPoolRange
+	{
+		Asset::Mesh::VertexLayout layout = Asset::Mesh::VertexLayout::Float;
+		Memory::OffsetAllocation vertices;
+		Memory::OffsetAllocation indices;
+		uint32_t generation = 0; //the pool generation the ranges were made in
+	};
+
+	//defines the geometry pool
+	//meshes in the pool must not move in memory, the pool keeps a pointer to each one so defragmenting can update their ranges
+	struct GeometryPool
+	{
+		static constexpr size_t VERTEX_POOL_COUNT = (size_t)Asset::Mesh::VertexLayout::Count;
+
+		//defines the vertex buffer of one vertex layout
+		struct VertexPool
+		{
+			Memory::GPUBuffer buffer;
+			Memory::OffsetAllocator allocator; //in vertices
+			uint32_t stride = 0;
+		};
+
+		VmaAllocator allocator = VK_NULL_HANDLE;
+		uint32_t sharingQueueFamilies[2] = { 0, 0 };
+		uint32_t sharingQueueFamilyCount = 1;
+
+		VkDeviceSize vertexPoolSize = 0; //the size in bytes of each vertex layout's buffer, made the first time a mesh of that layout is added
+		uint32_t maxAllocations = 0; //the most meshes each buffer can hold
+
+		VertexPool vertexPools[VERTEX_POOL_COUNT];
+		Memory::GPUBuffer indexBuffer;
+		Memory::OffsetAllocator indexAllocator; //in indices
+
+		std::vector<Asset::Mesh::StaticMesh*> residents; //every mesh with ranges in the pool
+		uint32_t generation = 1; //bumped by every defragment, ranges released before it are already gone
+
+		//creates the index buffer, vertex buffers are made as vertex layouts get used
+		//sharingQueueFamilies lists the graphics and transfer families when uploads go through a dedicated transfer queue
+		inline bool Init(VmaAllocator& _allocator, const VkDeviceSize& _vertexPoolSize, const uint32_t& indexCapacity, const uint32_t& _maxAllocations = 64 * 1024,
+			const uint32_t* _sharingQueueFamilies = nullptr, const uint32_t& _sharingQueueFamilyCount = 1)
+		{
+			allocator = _allocator;
+			vertexPoolSize = _vertexPoolSize;
+			maxAllocations = _maxAllocations;
+			sharingQueueFamilyCount = (_sharingQueueFamilies && _sharingQueueFamilyCount > 1 ? 2 : 1);
+			if (sharingQueueFamilyCount > 1)
+			{
+				sharingQueueFamilies[0] = _sharingQueueFamilies[0];
+				sharingQueueFamilies[1] = _sharingQueueFamilies[1];
+			}
+
+			if (!indexBuffer.Create(allocator, (VkDeviceSize)indexCapacity * sizeof(uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				VMA_MEMORY_USAGE_GPU_ONLY, 0, sharingQueueFamilies, sharingQueueFamilyCount))
+			{
+				fmt::print("Smok Rendering Error: GeometryPool || Init || Failed to create the index buffer for {} indices.\n", indexCapacity);
+				return false;
+			}
+
+			indexAllocator.Init(indexCapacity, maxAllocations);
+			return true;
+		}
+
+		//destroys every buffer, meshes still in the pool are left with dead ranges
+		inline void Destroy()
+		{
+			for (size_t i = 0; i < VERTEX_POOL_COUNT; ++i)
+			{
+				vertexPools[i].buffer.Destroy(allocator);
+				vertexPools[i].allocator = Memory::OffsetAllocator();
+			}
+
+			indexBuffer.Destroy(allocator);
+			indexAllocator = Memory::OffsetAllocator();
+			residents.clear();
+		}
+
+		//is the pool ready to use
+		inline bool IsInitalized() const { return indexBuffer.IsCreated(); }
+
+		//gets the vertex pool of a layout, creating it's buffer the first time
+		inline VertexPool* GetVertexPool(const Asset::Mesh::VertexLayout& layout)
+		{
+			VertexPool& pool = vertexPools[(size_t)layout];
+			if (pool.buffer.IsCreated())
+				return &pool;
+
+			pool.stride = Asset::Mesh::GetVertexLayoutStride(layout);
+			const uint32_t vertexCapacity = (uint32_t)(vertexPoolSize / pool.stride);
+			if (!pool.buffer.Create(allocator, (VkDeviceSize)vertexCapacity * pool.stride, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				VMA_MEMORY_USAGE_GPU_ONLY, 0, sharingQueueFamilies, sharingQueueFamilyCount))
+			{
+				fmt::print("Smok Rendering Error: GeometryPool || GetVertexPool || Failed to create the vertex buffer for layout {}.\n", (uint32_t)layout);
+				return nullptr;
+			}
+
+			pool.allocator.Init(vertexCapacity, maxAllocations);
+			return &pool;
+		}
+
+		//gets the vertex buffer of a layout, null if no mesh of that layout was ever added
+		inline VkBuffer GetVertexBuffer(const Asset::Mesh::VertexLayout& layout) const { return vertexPools[(size_t)layout].buffer.buffer; }
+
+		//gets the index buffer
+		inline VkBuffer GetIndexBuffer() const { return indexBuffer.buffer; }
+
+		//gives a mesh ranges for it's vertices and indices, sets every sub-mesh's firstIndex and indexCount
+		//the data is not copied, see "MeshUploader::UploadStaticMesh"
+		inline bool Allocate(Asset::Mesh::StaticMesh& mesh)
+		{
+			const uint32_t vertexCount = (uint32_t)mesh.GetVertexCount();
+			if (vertexCount == 0)
+			{
+				fmt::print("Smok Rendering Error: GeometryPool || Allocate || The mesh has no vertices.\n");
+				return false;
+			}
+
+			VertexPool* vertexPool = GetVertexPool(mesh.vertexLayout);
+			if (!vertexPool)
+				return false;
+
+			uint32_t indexCount = 0;
+			for (size_t m = 0; m < mesh.meshes.size(); ++m)
+				indexCount += (uint32_t)mesh.meshes[m].indices.size();
+
+			mesh.poolVertices = vertexPool->allocator.Allocate(vertexCount);
+			if (!mesh.poolVertices.IsValid())
+			{
+				fmt::print("Smok Rendering Warning: GeometryPool || Allocate || No room for {} vertices, defragment or make the pool bigger.\n", vertexCount);
+				return false;
+			}
+
+			if (indexCount > 0)
+			{
+				mesh.poolIndices = indexAllocator.Allocate(indexCount);
+				if (!mesh.poolIndices.IsValid())
+				{
+					fmt::print("Smok Rendering Warning: GeometryPool || Allocate || No room for {} indices, defragment or make the pool bigger.\n", indexCount);
+					vertexPool->allocator.Free(mesh.poolVertices);
+					mesh.poolVertices = Memory::OffsetAllocation();
+					return false;
+				}
+			}
+
+			//sub-meshes are packed back to back in the index range
+			uint32_t firstIndex = (indexCount > 0 ? mesh.poolIndices.offset : 0);
+			for (size_t m = 0; m < mesh.meshes.size(); ++m)
+			{
+				mesh.meshes[m].firstIndex = firstIndex;
+				mesh.meshes[m].indexCount = (uint32_t)mesh.meshes[m].indices.size();
+				firstIndex += mesh.meshes[m].indexCount;
+			}
+
+			mesh.poolGeneration = generation;
+			mesh.poolResidentIndex = (uint32_t)residents.size();
+			residents.emplace_back(&mesh);
+			return true;
+		}
+
+		//takes a mesh out of the pool, it's ranges stay allocated until the returned range is passed to "Free"
+		//so frames in flight can keep drawing from them, push the free into a deletion queue
+		inline GeometryPoolRange Release(Asset::Mesh::StaticMesh& mesh)
+		{
+			GeometryPoolRange range;
+			if (!mesh.UsesGeometryPool())
+				return range;
+
+			range.layout = mesh.vertexLayout;
+			range.vertices = mesh.poolVertices;
+			range.indices = mesh.poolIndices;
+			range.generation = mesh.poolGeneration;
+
+			//swap removes it from the residents
+			if (mesh.poolResidentIndex < residents.size() && residents[mesh.poolResidentIndex] == &mesh)
+			{
+				residents[mesh.poolResidentIndex] = residents.back();
+				residents[mesh.poolResidentIndex]->poolResidentIndex = mesh.poolResidentIndex;
+				residents.pop_back();
+			}
+
+			mesh.poolVertices = Memory::OffsetAllocation();
+			mesh.poolIndices = Memory::OffsetAllocation();
+			mesh.poolResidentIndex = UINT32_MAX;
+			return range;
+		}
+
+		//points the pool at a mesh that was moved to a new address, such as a hot reload swapping it into the live asset
+		inline void Rebind(Asset::Mesh::StaticMesh& mesh)
+		{
+			if (mesh.UsesGeometryPool() && mesh.poolResidentIndex < residents.size())
+				residents[mesh.poolResidentIndex] = &mesh;
+		}
+
+		//frees released ranges, ranges from before a defragment were already dropped by it
+		inline void Free(const GeometryPoolRange& range)
+		{
+			if (range.generation != generation)
+				return;
+
+			vertexPools[(size_t)range.layout].allocator.Free(range.vertices);
+			indexAllocator.Free(range.indices);
+		}
+
+		//gets the indirect draw of a sub-mesh, bind the vertex buffer of the mesh's layout and the index buffer first
+		static inline VkDrawIndexedIndirectCommand GetDrawCommand(const Asset::Mesh::StaticMesh& mesh, const size_t& subMesh, const uint32_t& instanceCount = 1, const uint32_t& firstInstance = 0)
+		{
+			VkDrawIndexedIndirectCommand command = {};
+			command.indexCount = mesh.meshes[subMesh].indexCount;
+			command.instanceCount = instanceCount;
+			command.firstIndex = mesh.meshes[subMesh].firstIndex;
+			command.vertexOffset = (int32_t)mesh.poolVertices.offset;
+			command.firstInstance = firstInstance;
+			return command;
+		}
+
+		//packs every mesh to the front of the buffers so the free space is one range again
+		//each buffer is copied into a new one recorded into commandBuffer, the old buffers are retired through the deletion queue
+		//every range is updated straight away, so commandBuffer must run before anything drawn with the new ranges
+		//no upload can be in flight into the pool when this is called, if every range is already packed nothing is done
+		inline void Defragment(VkCommandBuffer commandBuffer, Memory::FrameDeletionQueue& deletionQueue)
+		{
+			//the ranges of every buffer, the index buffer's last
+			std::vector<Memory::OffsetAllocation*> allocations[VERTEX_POOL_COUNT + 1];
+			for (Asset::Mesh::StaticMesh* mesh : residents)
+			{
+				allocations[(size_t)mesh->vertexLayout].emplace_back(&mesh->poolVertices);
+				allocations[VERTEX_POOL_COUNT].emplace_back(&mesh->poolIndices);
+			}
+
+			//released ranges are only dropped with a generation bump, so a pool with nothing to move is left alone
+			bool anyWouldMove = false;
+			for (size_t b = 0; b <= VERTEX_POOL_COUNT; ++b)
+				anyWouldMove |= !Memory::OffsetAllocator::IsPacked(allocations[b].data(), allocations[b].size());
+			if (!anyWouldMove)
+				return;
+
+			//every new buffer is made before any ranges move, if one can not be made the pool is left as it was
+			//so ranges released before this are still freed against the current generation
+			Memory::GPUBuffer newBuffers[VERTEX_POOL_COUNT + 1];
+			for (size_t b = 0; b <= VERTEX_POOL_COUNT; ++b)
+			{
+				Memory::GPUBuffer& buffer = (b < VERTEX_POOL_COUNT ? vertexPools[b].buffer : indexBuffer);
+				if (!buffer.IsCreated() || Memory::OffsetAllocator::IsPacked(allocations[b].data(), allocations[b].size()))
+					continue;
+
+				const VkBufferUsageFlags usage = (b < VERTEX_POOL_COUNT ? VK_BUFFER_USAGE_VERTEX_BUFFER_BIT : VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+				if (!newBuffers[b].Create(allocator, buffer.size, usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+					VMA_MEMORY_USAGE_GPU_ONLY, 0, sharingQueueFamilies, sharingQueueFamilyCount))
+				{
+					fmt::print("Smok Rendering Error: GeometryPool || Defragment || Failed to create a buffer of {} bytes to defragment into, the pool was not changed.\n", (uint64_t)buffer.size);
+					for (size_t c = 0; c < b; ++c)
+						newBuffers[c].Destroy(allocator);
+					return;
+				}
+			}
+
+			bool compacted = false;
+
+			//vertices, a pass per layout
+			for (size_t l = 0; l < VERTEX_POOL_COUNT; ++l)
+			{
+				VertexPool& pool = vertexPools[l];
+				if (!pool.buffer.IsCreated())
+					continue;
+
+				compacted |= CompactBuffer(commandBuffer, pool.buffer, newBuffers[l], pool.allocator, allocations[l], pool.stride, deletionQueue);
+			}
+
+			//indices, the sub-mesh offsets follow their mesh's range
+			std::vector<uint32_t> oldIndexOffsets(residents.size());
+			for (size_t r = 0; r < residents.size(); ++r)
+				oldIndexOffsets[r] = residents[r]->poolIndices.offset;
+
+			if (CompactBuffer(commandBuffer, indexBuffer, newBuffers[VERTEX_POOL_COUNT], indexAllocator, allocations[VERTEX_POOL_COUNT], sizeof(uint32_t), deletionQueue))
+			{
+				compacted = true;
+				for (size_t r = 0; r < residents.size(); ++r)
+				{
+					Asset::Mesh::StaticMesh* mesh = residents[r];
+					if (!mesh->poolIndices.IsValid() || mesh->poolIndices.offset == oldIndexOffsets[r])
+						continue;
+					for (size_t m = 0; m < mesh->meshes.size(); ++m)
+						mesh->meshes[m].firstIndex = mesh->meshes[m].firstIndex - oldIndexOffsets[r] + mesh->poolIndices.offset;
+				}
+			}
+
+			//released ranges not yet freed were dropped by the compact, even in buffers that did not move
+			generation++;
+			for (Asset::Mesh::StaticMesh* mesh : residents)
+				mesh->poolGeneration = generation;
+
+			if (!compacted)
+				return;
+
+			//the draws after this read what was just copied
+			VkMemoryBarrier barrier = {};
+			barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+		}
+
+		//---internal
+
+		//compacts one buffer's ranges into newBuffer, made by "Defragment", returns if the ranges moved
+		//a buffer already packed has no new buffer and keeps it's own, only it's released ranges are dropped as "Defragment" is bumping the generation
+		inline bool CompactBuffer(VkCommandBuffer commandBuffer, Memory::GPUBuffer& buffer, Memory::GPUBuffer& newBuffer, Memory::OffsetAllocator& rangeAllocator,
+			std::vector<Memory::OffsetAllocation*>& allocations, const VkDeviceSize& unitSize, Memory::FrameDeletionQueue& deletionQueue)
+		{
+			std::vector<Memory::OffsetMove> moves;
+			rangeAllocator.Compact(allocations.data(), allocations.size(), moves);
+			if (!newBuffer.IsCreated())
+				return false;
+
+			//every live range goes into the new buffer, the ones that stayed put too
+			std::vector<VkBufferCopy> regions;
+			regions.reserve(moves.size());
+			for (const Memory::OffsetMove& move : moves)
+				regions.push_back({ move.oldOffset * unitSize, move.newOffset * unitSize, move.size * unitSize });
+			if (!regions.empty())
+				vkCmdCopyBuffer(commandBuffer, buffer.buffer, newBuffer.buffer, (uint32_t)regions.size(), regions.data());
+
+			deletionQueue.RetireBuffer(buffer);
+			buffer = newBuffer;
+			return true;
+		}
+	};
+}
\ No newline at end of file
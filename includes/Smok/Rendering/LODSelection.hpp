@@ -0,0 +1,92 @@
+#pragma once
+
+//defines picking a LOD by screen space error
+//a LOD's geometric error is projected to pixels at the mesh's distance, the cheapest LOD under the pixel budget is drawn
+
+#include <Smok/Components/Camera.hpp>
+#include <Smok/Rendering/RenderQueue.hpp>
+
+#include <cfloat>
+#include <cmath>
+
+namespace Smok::Rendering
+{
+	//the viewport height used when the camera has no render size set, matches the default perspective
+	static constexpr float LOD_DEFAULT_VIEWPORT_HEIGHT = 900.0f;
+
+	//projects a geometric error to pixels
+	//projectionScaleY is projection[1][1], the cotangent of half the vertical FOV
+	static inline float CalculateLODPixelError(const float& geometricError, const float& scale, const float& distance,
+		const float& projectionScaleY, const float& viewportHeight)
+	{
+		if (geometricError <= 0.0f)
+			return 0.0f;
+
+		//inside the bounds, every bit of error shows
+		if (distance <= 0.0f)
+			return FLT_MAX;
+
+		return (geometricError * scale * projectionScaleY * viewportHeight * 0.5f) / distance;
+	}
+
+	//picks the sub-mesh to draw for a source sub-mesh, either it's self or one of it's LODs
+	//the LOD with the fewest indices whose error stays under pixelBudget is picked
+	static inline uint32_t SelectStaticMeshLOD(const Asset::Mesh::StaticMesh& mesh, const uint32_t& sourceSubMesh,
+		const ECS::Comp::Camera& camera, const glm::mat4& modelMatrix, const float& pixelBudget = 1.0f)
+	{
+		if (sourceSubMesh >= mesh.meshes.size())
+			return sourceSubMesh;
+
+		//distance from the camera to the nearest point of the sub-mesh's sphere
+		const Asset::Mesh::Bounds& bounds = mesh.meshes[sourceSubMesh].bounds;
+		glm::vec3 worldCenter; float worldRadius;
+		Asset::Mesh::TransformBoundingSphere(bounds, modelMatrix, worldCenter, worldRadius);
+		const glm::vec4 viewCenter = camera.view * glm::vec4(worldCenter, 1.0f);
+		const float distance = glm::length(glm::vec3(viewCenter)) - worldRadius;
+
+		const float scale = Asset::Mesh::GetMaxAxisScale(modelMatrix);
+		const float projectionScaleY = std::fabs(camera.projection[1][1]); //the default perspective flips Y
+		const float viewportHeight = (camera.renderSize.y > 0.0f ? camera.renderSize.y : LOD_DEFAULT_VIEWPORT_HEIGHT);
+
+		uint32_t best = sourceSubMesh;
+		size_t bestIndexCount = mesh.meshes[sourceSubMesh].indices.size();
+		for (size_t m = 0; m < mesh.meshes.size(); ++m)
+		{
+			const Asset::Mesh::Mesh& LOD = mesh.meshes[m];
+			if (LOD.LODSourceIndex != sourceSubMesh || !LOD.canRender || LOD.indices.size() >= bestIndexCount)
+				continue;
+
+			if (CalculateLODPixelError(LOD.LODError, scale, distance, projectionScaleY, viewportHeight) > pixelBudget)
+				continue;
+
+			best = (uint32_t)m;
+			bestIndexCount = LOD.indices.size();
+		}
+
+		return best;
+	}
+
+	//submits a mesh render to a render queue, swapping every source sub-mesh for it's selected LOD
+	//generated LODs are never submitted on their own, only in place of their source
+	static inline void SubmitWithLOD(RenderQueue& queue, const ECS::Comp::MeshRender& render, const glm::mat4& modelMatrix,
+		const Asset::Mesh::StaticMesh& mesh, const ECS::Comp::Camera& camera, const float& depth, const float& pixelBudget = 1.0f)
+	{
+		auto submit = [&](const uint32_t& subMesh) {
+			if (subMesh < mesh.meshes.size() && mesh.meshes[subMesh].LODSourceIndex != UINT32_MAX)
+				return;
+
+			queue.Submit(render.pipelineLayoutID, render.pipelineID, render.staticMeshID,
+				SelectStaticMeshLOD(mesh, subMesh, camera, modelMatrix, pixelBudget), modelMatrix, depth);
+		};
+
+		if (render.renderSpecificSubMeshes)
+		{
+			for (size_t i = 0; i < render.meshIndexes.size(); ++i)
+				submit(render.meshIndexes[i]);
+			return;
+		}
+
+		for (uint32_t i = 0; i < (uint32_t)mesh.meshes.size(); ++i)
+			submit(i);
+	}
+}
\ No newline at end of file
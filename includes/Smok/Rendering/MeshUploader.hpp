@@ -0,0 +1,447 @@
+#pragma once
+
+//defines batched uploads of static mesh data into device local memory
+//mesh data is copied into a persistently mapped staging ring, every copy made between two "Submit" calls goes to the GPU as one transfer submission
+//completion is tracked with a timeline semaphore, a upload's callback runs from "Update" once the GPU has passed it's submission's value
+
+#include <Smok/Assets/Mesh.hpp>
+#include <Smok/Rendering/GeometryPool.hpp>
+#include <Smok/Profiling/Profiler.hpp>
+
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace Smok::Rendering
+{
+	//defines the batched mesh uploader
+	//use it from one thread, if it shares the graphics queue it must be the thread that submits rendering
+	struct MeshUploader
+	{
+		static constexpr VkDeviceSize DEFAULT_STAGING_SIZE = 64ull * 1024ull * 1024ull;
+		static constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+		//defines a submission the GPU has not finished yet
+		struct Submission
+		{
+			VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+			uint64_t timelineValue = 0; //signaled when the copies are done
+			uint64_t stagingEnd = 0; //the staging ring is free up to here once it's done
+		};
+
+		//defines a callback waiting on a timeline value
+		struct Completion
+		{
+			uint64_t timelineValue = 0;
+			std::function<void()> onComplete;
+		};
+
+		VmaAllocator allocator = VK_NULL_HANDLE;
+		VkDevice device = VK_NULL_HANDLE;
+		VkQueue queue = VK_NULL_HANDLE; //the queue copies are submitted to, a dedicated transfer queue if one was given
+		uint32_t queueFamily = 0;
+		uint32_t sharingQueueFamilies[2] = { 0, 0 }; //the graphics and transfer families, device buffers are shared between them when they differ
+		uint32_t sharingQueueFamilyCount = 1;
+
+		Memory::GPUBuffer staging; //the staging ring, persistently mapped
+		uint64_t stagingHead = 0; //the total bytes ever handed out, the ring offset is this modulo the staging size
+		uint64_t stagingTail = 0; //everything before this is free again
+
+		VkCommandPool commandPool = VK_NULL_HANDLE;
+		std::vector<VkCommandBuffer> freeCommandBuffers; //command buffers from finished submissions
+		VkCommandBuffer recording = VK_NULL_HANDLE; //the command buffer of the open batch
+		VkBuffer pendingDestination = VK_NULL_HANDLE; //copies into the same buffer are merged into one vkCmdCopyBuffer
+		std::vector<VkBufferCopy> pendingRegions;
+
+		VkSemaphore timeline = VK_NULL_HANDLE;
+		uint64_t nextTimelineValue = 1; //the value the open batch will signal
+		uint64_t completedValue = 0; //the last value seen signaled
+
+		std::deque<Submission> inFlight;
+		std::deque<Completion> completions; //always in timeline order
+
+		size_t uploadCount = 0; //the number of meshes uploaded
+		size_t submissionCount = 0; //the number of transfer submissions made
+		uint64_t bytesUploaded = 0;
+
+		//creates the staging ring, command pool and timeline semaphore
+		//the device must have the timelineSemaphore feature enabled
+		//transferQueue can be a dedicated transfer queue, if it's null copies go through the graphics queue
+		inline bool Init(VkDevice _device, VkQueue graphicsQueue, const uint32_t& graphicsQueueFamily, VmaAllocator& _allocator, const VkDeviceSize& stagingSize = DEFAULT_STAGING_SIZE,
+			VkQueue transferQueue = VK_NULL_HANDLE, const uint32_t& transferQueueFamily = 0)
+		{
+			allocator = _allocator;
+			device = _device;
+			queue = (transferQueue != VK_NULL_HANDLE ? transferQueue : graphicsQueue);
+			queueFamily = (transferQueue != VK_NULL_HANDLE ? transferQueueFamily : graphicsQueueFamily);
+			sharingQueueFamilies[0] = graphicsQueueFamily;
+			sharingQueueFamilies[1] = queueFamily;
+			sharingQueueFamilyCount = (queueFamily != graphicsQueueFamily ? 2 : 1);
+
+			const VkDeviceSize alignedStagingSize = (stagingSize + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+			if (!staging.Create(allocator, alignedStagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY, VMA_ALLOCATION_CREATE_MAPPED_BIT) || !staging.mapped)
+			{
+				fmt::print("Smok Rendering Error: MeshUploader || Init || Failed to create a mapped staging ring of {} bytes.\n", (uint64_t)alignedStagingSize);
+				staging.Destroy(allocator);
+				return false;
+			}
+
+			VkCommandPoolCreateInfo poolInfo = {};
+			poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+			poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+			poolInfo.queueFamilyIndex = queueFamily;
+			if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+			{
+				fmt::print("Smok Rendering Error: MeshUploader || Init || Failed to create the transfer command pool.\n");
+				Destroy();
+				return false;
+			}
+
+			VkSemaphoreTypeCreateInfo timelineInfo = {};
+			timelineInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+			timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+			timelineInfo.initialValue = 0;
+			VkSemaphoreCreateInfo semaphoreInfo = {};
+			semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+			semaphoreInfo.pNext = &timelineInfo;
+			if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &timeline) != VK_SUCCESS)
+			{
+				fmt::print("Smok Rendering Error: MeshUploader || Init || Failed to create the timeline semaphore, timeline semaphores need Vulkan 1.2.\n");
+				Destroy();
+				return false;
+			}
+
+			return true;
+		}
+
+		//waits for every upload, runs their callbacks and destroys the uploader
+		inline void Destroy()
+		{
+			if (timeline != VK_NULL_HANDLE)
+				Finish();
+
+			if (commandPool != VK_NULL_HANDLE)
+				vkDestroyCommandPool(device, commandPool, nullptr);
+			commandPool = VK_NULL_HANDLE;
+			freeCommandBuffers.clear();
+			recording = VK_NULL_HANDLE;
+
+			if (timeline != VK_NULL_HANDLE)
+				vkDestroySemaphore(device, timeline, nullptr);
+			timeline = VK_NULL_HANDLE;
+
+			staging.Destroy(allocator);
+			stagingHead = 0;
+			stagingTail = 0;
+		}
+
+		//is the uploader ready to use
+		inline bool IsInitalized() const { return timeline != VK_NULL_HANDLE; }
+
+		//creates the packed device buffers of a static mesh and queues it's data to be copied into them
+		//onComplete runs from "Update" once the copies are done on the GPU, the mesh must not move or be destroyed before then
+		//if staging fails the buffers are destroyed once the copies already recorded into them are done, the mesh is left without them
+		inline bool UploadStaticMesh(Asset::Mesh::StaticMesh& mesh, std::function<void()>&& onComplete)
+		{
+			const VkDeviceSize vertexDataSize = mesh.GetVertexDataSize();
+			if (vertexDataSize == 0)
+			{
+				fmt::print("Smok Rendering Error: MeshUploader || UploadStaticMesh || The mesh has no vertices.\n");
+				return false;
+			}
+
+			//every sub-mesh's indices are packed back to back
+			uint32_t indexCount = 0;
+			for (size_t m = 0; m < mesh.meshes.size(); ++m)
+			{
+				mesh.meshes[m].firstIndex = indexCount;
+				mesh.meshes[m].indexCount = (uint32_t)mesh.meshes[m].indices.size();
+				indexCount += mesh.meshes[m].indexCount;
+			}
+
+			if (!mesh.packedVertexBuffer.Create(allocator, vertexDataSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+				VMA_MEMORY_USAGE_GPU_ONLY, 0, sharingQueueFamilies, sharingQueueFamilyCount))
+				return false;
+			if (indexCount > 0 && !mesh.packedIndexBuffer.Create(allocator, (VkDeviceSize)indexCount * sizeof(uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+				VMA_MEMORY_USAGE_GPU_ONLY, 0, sharingQueueFamilies, sharingQueueFamilyCount))
+			{
+				mesh.packedVertexBuffer.Destroy(allocator);
+				return false;
+			}
+
+			if (StageStaticMesh(mesh, mesh.packedVertexBuffer.buffer, 0, mesh.packedIndexBuffer.buffer, std::move(onComplete)))
+				return true;
+
+			DropPendingRegions(mesh.packedVertexBuffer.buffer);
+			DropPendingRegions(mesh.packedIndexBuffer.buffer);
+			AfterRecordedCopies([allocator = allocator, vertexBuffer = mesh.packedVertexBuffer, indexBuffer = mesh.packedIndexBuffer]() mutable {
+				vertexBuffer.Destroy(allocator);
+				indexBuffer.Destroy(allocator);
+			});
+			mesh.packedVertexBuffer = Memory::GPUBuffer();
+			mesh.packedIndexBuffer = Memory::GPUBuffer();
+			return false;
+		}
+
+		//gives a static mesh ranges in the geometry pool and queues it's data to be copied into them
+		//fails without queuing anything if the pool is full, if staging fails the ranges are freed once the copies already recorded into them are done
+		inline bool UploadStaticMesh(Asset::Mesh::StaticMesh& mesh, GeometryPool& pool, std::function<void()>&& onComplete)
+		{
+			if (!pool.Allocate(mesh))
+				return false;
+
+			const VkDeviceSize vertexOffset = (VkDeviceSize)mesh.poolVertices.offset * Asset::Mesh::GetVertexLayoutStride(mesh.vertexLayout);
+			if (StageStaticMesh(mesh, pool.GetVertexBuffer(mesh.vertexLayout), vertexOffset, pool.GetIndexBuffer(), std::move(onComplete)))
+				return true;
+
+			//the pool's buffers are shared so their merged copies are kept, they land in ranges nobody else can get until then
+			const GeometryPoolRange range = pool.Release(mesh);
+			AfterRecordedCopies([&pool, range]() { pool.Free(range); });
+			return false;
+		}
+
+		//submits every copy queued since the last submit as one submission, returns the timeline value it will signal
+		//returns the last submitted value if nothing was queued
+		inline uint64_t Submit()
+		{
+			SMOK_PROFILE_ZONE("MeshUploader::Submit");
+
+			if (recording == VK_NULL_HANDLE)
+				return nextTimelineValue - 1;
+
+			FlushPendingRegions();
+			vkEndCommandBuffer(recording);
+
+			const uint64_t signalValue = nextTimelineValue;
+			VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+			timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+			timelineInfo.signalSemaphoreValueCount = 1;
+			timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+			VkSubmitInfo submitInfo = {};
+			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.pNext = &timelineInfo;
+			submitInfo.commandBufferCount = 1;
+			submitInfo.pCommandBuffers = &recording;
+			submitInfo.signalSemaphoreCount = 1;
+			submitInfo.pSignalSemaphores = &timeline;
+			if (vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+				fmt::print("Smok Rendering Error: MeshUploader || Submit || Failed to submit the transfer batch for timeline value {}.\n", signalValue);
+
+			inFlight.push_back({ recording, signalValue, stagingHead });
+			recording = VK_NULL_HANDLE;
+			nextTimelineValue++;
+			submissionCount++;
+			return signalValue;
+		}
+
+		//checks what the GPU has finished, frees the staging space and runs the callbacks of finished uploads
+		//returns the last timeline value the GPU has signaled
+		inline uint64_t Update()
+		{
+			vkGetSemaphoreCounterValue(device, timeline, &completedValue);
+
+			while (!inFlight.empty() && inFlight.front().timelineValue <= completedValue)
+			{
+				stagingTail = inFlight.front().stagingEnd;
+				freeCommandBuffers.emplace_back(inFlight.front().commandBuffer);
+				inFlight.pop_front();
+			}
+
+			while (!completions.empty() && completions.front().timelineValue <= completedValue)
+			{
+				std::function<void()> onComplete = std::move(completions.front().onComplete);
+				completions.pop_front();
+				if (onComplete)
+					onComplete();
+			}
+
+			return completedValue;
+		}
+
+		//blocks until the GPU signals a timeline value
+		inline void Wait(const uint64_t& timelineValue)
+		{
+			VkSemaphoreWaitInfo waitInfo = {};
+			waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+			waitInfo.semaphoreCount = 1;
+			waitInfo.pSemaphores = &timeline;
+			waitInfo.pValues = &timelineValue;
+			vkWaitSemaphores(device, &waitInfo, UINT64_MAX);
+		}
+
+		//submits anything queued, waits for all of it and runs every callback
+		inline void Finish()
+		{
+			SMOK_PROFILE_ZONE("MeshUploader::Finish");
+
+			const uint64_t lastValue = Submit();
+			if (lastValue > 0)
+				Wait(lastValue);
+			Update();
+		}
+
+		//gets the timeline semaphore, a graphics submit can wait on it instead of waiting for the callbacks
+		inline VkSemaphore GetTimelineSemaphore() const { return timeline; }
+
+		//---internal
+
+		//stages a static mesh's vertices and every sub-mesh's indices at their firstIndex
+		inline bool StageStaticMesh(const Asset::Mesh::StaticMesh& mesh, const VkBuffer& vertexBuffer, const VkDeviceSize& vertexOffset, const VkBuffer& indexBuffer,
+			std::function<void()>&& onComplete)
+		{
+			const void* vertexData = (mesh.vertexLayout == Asset::Mesh::VertexLayout::Float ? (const void*)mesh.vertices.data() : (const void*)mesh.packedVertices.data());
+			if (!Stage(vertexData, mesh.GetVertexDataSize(), vertexBuffer, vertexOffset))
+				return false;
+
+			for (size_t m = 0; m < mesh.meshes.size(); ++m)
+			{
+				const std::vector<uint32_t>& indices = mesh.meshes[m].indices;
+				if (!indices.empty() && !Stage(indices.data(), indices.size() * sizeof(uint32_t), indexBuffer, (VkDeviceSize)mesh.meshes[m].firstIndex * sizeof(uint32_t)))
+					return false;
+			}
+
+			completions.push_back({ nextTimelineValue, std::move(onComplete) });
+			uploadCount++;
+			return true;
+		}
+
+		//copies data into the staging ring and records a copy into a device buffer, data bigger than the ring is split up
+		inline bool Stage(const void* data, VkDeviceSize size, const VkBuffer& destination, VkDeviceSize destinationOffset)
+		{
+			//chunks are at most half the ring so the next one can be copied in while the GPU reads the last
+			const VkDeviceSize maxChunk = (staging.size / 2) & ~(STAGING_ALIGNMENT - 1);
+			const uint8_t* source = (const uint8_t*)data;
+			while (size > 0)
+			{
+				const VkDeviceSize chunk = (size < maxChunk ? size : maxChunk);
+				VkDeviceSize stagingOffset;
+				if (!AllocateStaging(chunk, stagingOffset))
+				{
+					fmt::print("Smok Rendering Error: MeshUploader || Stage || Failed to get {} bytes of staging space.\n", (uint64_t)chunk);
+					return false;
+				}
+
+				std::memcpy((uint8_t*)staging.mapped + stagingOffset, source, (size_t)chunk);
+				vmaFlushAllocation(allocator, staging.allocation, stagingOffset, chunk);
+				RecordCopy(destination, stagingOffset, destinationOffset, chunk);
+
+				source += chunk;
+				destinationOffset += chunk;
+				size -= chunk;
+				bytesUploaded += chunk;
+			}
+
+			return true;
+		}
+
+		//hands out space in the staging ring, if it's full the open batch is submitted and we wait for the oldest submission
+		inline bool AllocateStaging(const VkDeviceSize& size, VkDeviceSize& offset)
+		{
+			while (true)
+			{
+				//a allocation never wraps around the end of the ring
+				uint64_t start = (stagingHead + STAGING_ALIGNMENT - 1) & ~(uint64_t)(STAGING_ALIGNMENT - 1);
+				uint64_t ringOffset = start % staging.size;
+				if (ringOffset + size > staging.size)
+				{
+					start += staging.size - ringOffset;
+					ringOffset = 0;
+				}
+
+				if (start + size - stagingTail <= staging.size)
+				{
+					stagingHead = start + size;
+					offset = ringOffset;
+					return true;
+				}
+
+				//the open batch may be what's holding the space
+				Submit();
+				if (inFlight.empty())
+				{
+					//the ring is idle, restart at it's beginning so the skipped tail does not count
+					if (size > staging.size)
+						return false;
+					stagingHead = stagingTail = ((stagingHead + staging.size - 1) / staging.size) * staging.size;
+					continue;
+				}
+
+				Wait(inFlight.front().timelineValue);
+				Update();
+			}
+		}
+
+		//records a copy, merged with the previous one when it goes to the same buffer
+		inline void RecordCopy(const VkBuffer& destination, const VkDeviceSize& stagingOffset, const VkDeviceSize& destinationOffset, const VkDeviceSize& size)
+		{
+			if (recording == VK_NULL_HANDLE)
+				BeginRecording();
+
+			if (destination != pendingDestination)
+				FlushPendingRegions();
+
+			pendingDestination = destination;
+			pendingRegions.push_back({ stagingOffset, destinationOffset, size });
+		}
+
+		//drops the merged copies into a buffer that have not been recorded yet
+		inline void DropPendingRegions(const VkBuffer& destination)
+		{
+			if (destination == VK_NULL_HANDLE || destination != pendingDestination)
+				return;
+
+			pendingRegions.clear();
+			pendingDestination = VK_NULL_HANDLE;
+		}
+
+		//runs a callback once every copy recorded or submitted so far is done on the GPU, right away if there are none
+		//a failed upload uses it to free what it's copies still point at
+		inline void AfterRecordedCopies(std::function<void()>&& callback)
+		{
+			const uint64_t lastUse = (recording != VK_NULL_HANDLE ? nextTimelineValue : nextTimelineValue - 1);
+			if (lastUse <= completedValue)
+			{
+				callback();
+				return;
+			}
+
+			completions.push_back({ lastUse, std::move(callback) });
+		}
+
+		//records the merged copies
+		inline void FlushPendingRegions()
+		{
+			if (!pendingRegions.empty())
+				vkCmdCopyBuffer(recording, staging.buffer, pendingDestination, (uint32_t)pendingRegions.size(), pendingRegions.data());
+			pendingRegions.clear();
+			pendingDestination = VK_NULL_HANDLE;
+		}
+
+		//starts the command buffer of a new batch, reusing one from a finished submission when there is one
+		inline void BeginRecording()
+		{
+			if (!freeCommandBuffers.empty())
+			{
+				recording = freeCommandBuffers.back();
+				freeCommandBuffers.pop_back();
+				vkResetCommandBuffer(recording, 0);
+			}
+			else
+			{
+				VkCommandBufferAllocateInfo allocateInfo = {};
+				allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+				allocateInfo.commandPool = commandPool;
+				allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+				allocateInfo.commandBufferCount = 1;
+				vkAllocateCommandBuffers(device, &allocateInfo, &recording);
+			}
+
+			VkCommandBufferBeginInfo beginInfo = {};
+			beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+			vkBeginCommandBuffer(recording, &beginInfo);
+		}
+	};
+}
\ No newline at end of file
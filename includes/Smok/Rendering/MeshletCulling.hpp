@@ -0,0 +1,78 @@
+#pragma once
+
+//defines the CPU reference for culling meshlets
+//each meshlet's sphere is tested against the frustum and it's normal cone against the camera, rejecting clusters a whole sub-mesh draw would have kept
+//this is the same test a task or compute shader runs, kept on the CPU so the results can be checked without a GPU
+
+#include <Smok/Rendering/Frustum.hpp>
+#include <Smok/Assets/Meshlet.hpp>
+#include <Smok/Profiling/Profiler.hpp>
+
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/geometric.hpp>
+
+namespace Smok::Rendering
+{
+	//defines the results of culling meshlets
+	struct MeshletCullStats
+	{
+		size_t meshletCount = 0; //the number of meshlets tested
+		size_t frustumCulledCount = 0; //meshlets outside the frustum
+		size_t coneCulledCount = 0; //meshlets inside the frustum but facing away from the camera
+		size_t visibleCount = 0;
+
+		//gets how many of the tested meshlets were culled, 0.0 to 1.0
+		inline float CulledRatio() const { return (meshletCount == 0 ? 0.0f : 1.0f - (float)visibleCount / (float)meshletCount); }
+	};
+
+	//culls the meshlets of a sub-mesh drawn with a model matrix, writes the index of every visible meshlet and returns how many were written
+	//the frustum and camera position are in world space, outVisible must have room for count indices
+	//the cone test is skipped for matrices that scale unevenly or mirror, as they bend the normals away from the stored cones
+	static inline size_t CullMeshlets(const Frustum& frustum, const glm::vec3& cameraPosition, const glm::mat4& modelMatrix,
+		const Asset::Mesh::Meshlet* meshlets, const size_t& count, uint32_t* outVisible, MeshletCullStats* stats = nullptr)
+	{
+		SMOK_PROFILE_ZONE("CullMeshlets");
+
+		//a even scale keeps the cones exact once the axis is rotated
+		const glm::mat3 rotationScale = glm::mat3(modelMatrix);
+		const float scaleX = glm::length(rotationScale[0]), scaleY = glm::length(rotationScale[1]), scaleZ = glm::length(rotationScale[2]);
+		const float maxScale = glm::max(scaleX, glm::max(scaleY, scaleZ)), minScale = glm::min(scaleX, glm::min(scaleY, scaleZ));
+		const bool conesAreValid = (minScale > 0.0f && maxScale - minScale <= maxScale * 0.001f && glm::dot(glm::cross(rotationScale[0], rotationScale[1]), rotationScale[2]) > 0.0f);
+
+		size_t visibleCount = 0, frustumCulledCount = 0, coneCulledCount = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Asset::Mesh::Meshlet& meshlet = meshlets[i];
+			const glm::vec3 center = glm::vec3(modelMatrix * glm::vec4(meshlet.sphereCenter, 1.0f));
+			const float radius = meshlet.sphereRadius * maxScale;
+			if (!frustum.SphereIsVisible(center, radius))
+			{
+				frustumCulledCount++;
+				continue;
+			}
+
+			if (conesAreValid && meshlet.coneCutoff < 1.0f)
+			{
+				const glm::vec3 axis = rotationScale * meshlet.coneAxis / maxScale;
+				const glm::vec3 offset = center - cameraPosition;
+				if (glm::dot(offset, axis) >= meshlet.coneCutoff * glm::length(offset) + radius)
+				{
+					coneCulledCount++;
+					continue;
+				}
+			}
+
+			outVisible[visibleCount++] = (uint32_t)i;
+		}
+
+		if (stats)
+		{
+			stats->meshletCount += count;
+			stats->frustumCulledCount += frustumCulledCount;
+			stats->coneCulledCount += coneCulledCount;
+			stats->visibleCount += visibleCount;
+		}
+		return visibleCount;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,366 @@
+#pragma once
+
+//defines a render queue that sorts draws by state and collapses them into instanced draws
+//every draw gets a 64 bit key, radix sorted each frame so draws sharing a pipeline and mesh end up next to each other
+
+#include <Smok/Components/MeshComponent.hpp>
+#include <Smok/Assets/Mesh.hpp>
+#include <Smok/Profiling/Profiler.hpp>
+
+#include <BTDSTD/Wireframe/Pipeline/VertexInputDesc.hpp>
+
+#include <glm/mat4x4.hpp>
+
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace Smok::Rendering
+{
+	//the layout of a sort key, from the most expensive state to change down to depth
+	//bits 63 - 56: pipeline layout slot
+	//bits 55 - 44: pipeline slot
+	//bits 43 - 28: static mesh slot
+	//bits 27 - 16: sub-mesh index
+	//bits 15 - 0: depth, front to back
+	static constexpr uint32_t RENDER_KEY_LAYOUT_SHIFT = 56, RENDER_KEY_LAYOUT_BITS = 8;
+	static constexpr uint32_t RENDER_KEY_PIPELINE_SHIFT = 44, RENDER_KEY_PIPELINE_BITS = 12;
+	static constexpr uint32_t RENDER_KEY_MESH_SHIFT = 28, RENDER_KEY_MESH_BITS = 16;
+	static constexpr uint32_t RENDER_KEY_SUB_MESH_SHIFT = 16, RENDER_KEY_SUB_MESH_BITS = 12;
+	static constexpr uint32_t RENDER_KEY_DEPTH_SHIFT = 0, RENDER_KEY_DEPTH_BITS = 16;
+
+	//packs the parts of a sort key, every part is masked to fit
+	static inline uint64_t PackRenderKey(const uint32_t& layoutSlot, const uint32_t& pipelineSlot, const uint32_t& meshSlot, const uint32_t& subMesh, const uint32_t& depth)
+	{
+		auto field = [](const uint32_t& value, const uint32_t& shift, const uint32_t& bits) -> uint64_t {
+			return ((uint64_t)value & ((1ull << bits) - 1)) << shift;
+		};
+
+		return field(layoutSlot, RENDER_KEY_LAYOUT_SHIFT, RENDER_KEY_LAYOUT_BITS) | field(pipelineSlot, RENDER_KEY_PIPELINE_SHIFT, RENDER_KEY_PIPELINE_BITS) |
+			field(meshSlot, RENDER_KEY_MESH_SHIFT, RENDER_KEY_MESH_BITS) | field(subMesh, RENDER_KEY_SUB_MESH_SHIFT, RENDER_KEY_SUB_MESH_BITS) |
+			field(depth, RENDER_KEY_DEPTH_SHIFT, RENDER_KEY_DEPTH_BITS);
+	}
+
+	//gets a field out of a sort key
+	static inline uint32_t GetRenderKeyField(const uint64_t& key, const uint32_t& shift, const uint32_t& bits)
+	{
+		return (uint32_t)((key >> shift) & ((1ull << bits) - 1));
+	}
+
+	//gets the number of bits needed to store count different values, capped to the field's size
+	static inline uint32_t GetRenderKeyBitsToFit(const size_t& count, const uint32_t& maxBits)
+	{
+		uint32_t bits = 0;
+		while (bits < maxBits && ((size_t)1 << bits) < count)
+			bits++;
+		return bits;
+	}
+
+	//defines a entry being sorted, the key and the draw it came from
+	struct RenderSortItem
+	{
+		uint64_t key = 0;
+		uint32_t drawIndex = 0;
+		uint32_t padding = 0;
+	};
+
+	//sorts items by key with a stable LSD radix sort, 8 bits a pass
+	//passes where every key has the same byte are skipped, so keys that only use a few slots sort in a couple passes
+	//scratch is resized to fit and the sorted result always ends up back in items
+	static inline void RadixSortRenderItems(std::vector<RenderSortItem>& items, std::vector<RenderSortItem>& scratch)
+	{
+		const size_t count = items.size();
+		if (count < 2)
+			return;
+
+		//builds every byte's histogram in one read of the keys
+		uint32_t histograms[8][256];
+		std::memset(histograms, 0, sizeof(histograms));
+		for (size_t i = 0; i < count; ++i)
+		{
+			const uint64_t key = items[i].key;
+			for (uint32_t b = 0; b < 8; ++b)
+				histograms[b][(key >> (b * 8)) & 0xFF]++;
+		}
+
+		scratch.resize(count);
+		RenderSortItem* src = items.data();
+		RenderSortItem* dst = scratch.data();
+		for (uint32_t b = 0; b < 8; ++b)
+		{
+			uint32_t* histogram = histograms[b];
+
+			//every key has the same byte, nothing to do
+			if (histogram[(src[0].key >> (b * 8)) & 0xFF] == count)
+				continue;
+
+			uint32_t offset = 0;
+			for (uint32_t d = 0; d < 256; ++d)
+			{
+				const uint32_t digitCount = histogram[d];
+				histogram[d] = offset;
+				offset += digitCount;
+			}
+
+			for (size_t i = 0; i < count; ++i)
+				dst[histogram[(src[i].key >> (b * 8)) & 0xFF]++] = src[i];
+
+			RenderSortItem* temp = src;
+			src = dst;
+			dst = temp;
+		}
+
+		if (src != items.data())
+			std::memcpy(items.data(), src, sizeof(RenderSortItem) * count);
+	}
+
+	//defines a draw as it was submitted
+	struct RenderDraw
+	{
+		uint64_t pipelineLayoutID = 0, pipelineID = 0, staticMeshID = 0;
+		uint32_t subMeshIndex = 0;
+	};
+
+	//defines a instanced draw made from one or more submitted draws
+	struct RenderBatch
+	{
+		uint64_t pipelineLayoutID = 0, pipelineID = 0, staticMeshID = 0;
+		uint32_t subMeshIndex = 0;
+
+		uint32_t firstInstance = 0; //the first transform in RenderQueue::instanceTransforms
+		uint32_t instanceCount = 0; //the number of instances
+
+		bool bindPipeline = false; //the pipeline or layout differ from the last batch
+		bool bindMesh = false; //the static mesh differs from the last batch
+	};
+
+	//defines what the queue did with the last frame
+	struct RenderQueueStats
+	{
+		size_t submittedDraws = 0; //the draws submitted
+		size_t drawCalls = 0; //the instanced draws they became
+		size_t drawCallsSaved = 0; //submittedDraws - drawCalls
+
+		size_t stateChanges = 0; //pipeline and mesh binds after sorting
+		size_t unsortedStateChanges = 0; //pipeline and mesh binds if the draws were recorded in the order they were submitted
+		size_t stateChangesSaved = 0; //unsortedStateChanges - stateChanges
+	};
+
+	//defines the render queue
+	//call Begin, Submit every visible draw, then Build, the batches and instance transforms are ready to record
+	struct RenderQueue
+	{
+		float maxDepth = 1000.0f; //the depth mapped to the back of the key's depth range
+		bool sortByDepth = true; //sorts the instances in a batch front to back, turning it off saves two radix passes
+
+		std::vector<RenderDraw> draws; //the submitted draws
+		std::vector<glm::mat4> drawTransforms; //the model matrix of each submitted draw
+
+		std::vector<RenderSortItem> sortItems, sortScratch;
+
+		std::vector<RenderBatch> batches; //the instanced draws, in the order they should be recorded
+		std::vector<glm::mat4> instanceTransforms; //every batch's transforms packed back to back, upload this as the per-instance buffer
+
+		RenderQueueStats stats;
+
+		//maps IDs to small slots so they fit in the key, reset every frame
+		std::unordered_map<uint64_t, uint32_t> layoutSlots, pipelineSlots, meshSlots;
+		uint32_t maxSubMeshIndex = 0;
+
+		//the last slot looked up for each map, draws are usually submitted grouped by entity so most lookups hit these
+		struct SlotCache { uint64_t ID = 0; uint32_t slot = UINT32_MAX; } lastLayoutSlot, lastPipelineSlot, lastMeshSlot;
+
+		//the size of each field in the compacted keys
+		uint32_t compactMeshBits = 0, compactSubMeshBits = 0, compactDepthBits = 0;
+
+		//starts a new frame
+		inline void Begin(const float& _maxDepth = 1000.0f)
+		{
+			maxDepth = _maxDepth;
+			draws.clear();
+			drawTransforms.clear();
+			sortItems.clear();
+			batches.clear();
+			instanceTransforms.clear();
+			layoutSlots.clear();
+			pipelineSlots.clear();
+			meshSlots.clear();
+			maxSubMeshIndex = 0;
+			lastLayoutSlot = SlotCache();
+			lastPipelineSlot = SlotCache();
+			lastMeshSlot = SlotCache();
+			stats = RenderQueueStats();
+		}
+
+		//submits a single sub-mesh draw, depth is the distance from the camera
+		inline void Submit(const uint64_t& pipelineLayoutID, const uint64_t& pipelineID, const uint64_t& staticMeshID, const uint32_t& subMeshIndex,
+			const glm::mat4& modelMatrix, const float& depth)
+		{
+			//slots that do not fit the key wrap, Build falls back to comparing the real IDs when that happens
+			const uint32_t layoutSlot = GetSlot(layoutSlots, lastLayoutSlot, pipelineLayoutID);
+			const uint32_t pipelineSlot = GetSlot(pipelineSlots, lastPipelineSlot, pipelineID);
+			const uint32_t meshSlot = GetSlot(meshSlots, lastMeshSlot, staticMeshID);
+			if (subMeshIndex > maxSubMeshIndex)
+				maxSubMeshIndex = subMeshIndex;
+
+			const float depthRange = (float)((1u << RENDER_KEY_DEPTH_BITS) - 1);
+			const float normalizedDepth = (maxDepth > 0.0f ? depth / maxDepth : 0.0f);
+			const uint32_t quantizedDepth = (uint32_t)(glm::clamp(normalizedDepth, 0.0f, 1.0f) * depthRange);
+
+			RenderSortItem item;
+			item.key = PackRenderKey(layoutSlot, pipelineSlot, meshSlot, subMeshIndex, quantizedDepth);
+			item.drawIndex = (uint32_t)draws.size();
+			sortItems.emplace_back(item);
+
+			//counts the binds recording in submission order would need, to compare against the sorted order
+			const RenderDraw* last = (draws.empty() ? nullptr : &draws.back());
+			stats.unsortedStateChanges += (!last || last->pipelineLayoutID != pipelineLayoutID || last->pipelineID != pipelineID);
+			stats.unsortedStateChanges += (!last || last->staticMeshID != staticMeshID);
+
+			draws.push_back({ pipelineLayoutID, pipelineID, staticMeshID, subMeshIndex });
+			drawTransforms.emplace_back(modelMatrix);
+		}
+
+		//submits a mesh render, every sub-mesh or only the ones it asks for
+		//generated LODs are skipped when every sub-mesh is drawn, they would draw over their source, use "SubmitWithLOD" to pick one
+		inline void Submit(const ECS::Comp::MeshRender& render, const glm::mat4& modelMatrix, const float& depth, const Asset::Mesh::StaticMesh& mesh)
+		{
+			if (render.renderSpecificSubMeshes)
+			{
+				for (size_t i = 0; i < render.meshIndexes.size(); ++i)
+					Submit(render.pipelineLayoutID, render.pipelineID, render.staticMeshID, render.meshIndexes[i], modelMatrix, depth);
+				return;
+			}
+
+			for (uint32_t i = 0; i < (uint32_t)mesh.meshes.size(); ++i)
+			{
+				if (mesh.meshes[i].LODSourceIndex == UINT32_MAX)
+					Submit(render.pipelineLayoutID, render.pipelineID, render.staticMeshID, i, modelMatrix, depth);
+			}
+		}
+
+		//sorts the draws and collapses them into batches
+		inline void Build()
+		{
+			SMOK_PROFILE_ZONE("RenderQueue::Build");
+
+			stats.submittedDraws = draws.size();
+
+			//while every slot fits it's field, a slot is a ID and batches can be found from the sorted keys alone
+			const bool slotsFit = (layoutSlots.size() <= (1ull << RENDER_KEY_LAYOUT_BITS) && pipelineSlots.size() <= (1ull << RENDER_KEY_PIPELINE_BITS) &&
+				meshSlots.size() <= (1ull << RENDER_KEY_MESH_BITS) && maxSubMeshIndex < (1u << RENDER_KEY_SUB_MESH_BITS));
+
+			CompactKeys();
+			RadixSortRenderItems(sortItems, sortScratch);
+
+			//walks the sorted draws, starting a new batch whenever the pipeline, mesh or sub-mesh changes
+			const uint64_t meshMask = (1ull << compactMeshBits) - 1;
+			const uint32_t pipelineShift = compactMeshBits + compactSubMeshBits;
+			instanceTransforms.resize(sortItems.size());
+			uint64_t lastState = 0;
+			const RenderDraw* lastDraw = nullptr;
+			for (size_t i = 0; i < sortItems.size(); ++i)
+			{
+				const RenderSortItem& item = sortItems[i];
+				instanceTransforms[i] = drawTransforms[item.drawIndex];
+
+				bool pipelineChanged, meshChanged, stateChanged;
+				if (slotsFit)
+				{
+					const uint64_t state = item.key >> compactDepthBits;
+					pipelineChanged = (i == 0 || (state >> pipelineShift) != (lastState >> pipelineShift));
+					meshChanged = (i == 0 || ((state >> compactSubMeshBits) & meshMask) != ((lastState >> compactSubMeshBits) & meshMask));
+					stateChanged = (i == 0 || state != lastState);
+					lastState = state;
+				}
+				else
+				{
+					const RenderDraw& draw = draws[item.drawIndex];
+					pipelineChanged = (!lastDraw || lastDraw->pipelineLayoutID != draw.pipelineLayoutID || lastDraw->pipelineID != draw.pipelineID);
+					meshChanged = (!lastDraw || lastDraw->staticMeshID != draw.staticMeshID);
+					stateChanged = (pipelineChanged || meshChanged || lastDraw->subMeshIndex != draw.subMeshIndex);
+					lastDraw = &draw;
+				}
+
+				if (!stateChanged)
+				{
+					batches.back().instanceCount++;
+					continue;
+				}
+
+				const RenderDraw& draw = draws[item.drawIndex];
+				RenderBatch batch;
+				batch.pipelineLayoutID = draw.pipelineLayoutID;
+				batch.pipelineID = draw.pipelineID;
+				batch.staticMeshID = draw.staticMeshID;
+				batch.subMeshIndex = draw.subMeshIndex;
+				batch.firstInstance = (uint32_t)i;
+				batch.instanceCount = 1;
+				batch.bindPipeline = pipelineChanged;
+				batch.bindMesh = meshChanged;
+				batches.emplace_back(batch);
+				stats.stateChanges += pipelineChanged + meshChanged;
+			}
+
+			stats.drawCalls = batches.size();
+			stats.drawCallsSaved = stats.submittedDraws - stats.drawCalls;
+			stats.stateChangesSaved = (stats.unsortedStateChanges > stats.stateChanges ? stats.unsortedStateChanges - stats.stateChanges : 0);
+		}
+
+		//---internal
+
+		//gets the slot of a ID, giving it the next one if it's new this frame
+		static inline uint32_t GetSlot(std::unordered_map<uint64_t, uint32_t>& slots, SlotCache& cache, const uint64_t& ID)
+		{
+			if (cache.slot != UINT32_MAX && cache.ID == ID)
+				return cache.slot;
+
+			cache.ID = ID;
+			cache.slot = slots.try_emplace(ID, (uint32_t)slots.size()).first->second;
+			return cache.slot;
+		}
+
+		//repacks every key using only the bits this frame's slots need, keeping the same order
+		//most frames only use a handful of pipelines and meshes, so this cuts the number of radix passes
+		inline void CompactKeys()
+		{
+			//the layout is the top field, so it never needs shifting
+			const uint32_t pipelineBits = GetRenderKeyBitsToFit(pipelineSlots.size(), RENDER_KEY_PIPELINE_BITS);
+			compactMeshBits = GetRenderKeyBitsToFit(meshSlots.size(), RENDER_KEY_MESH_BITS);
+			compactSubMeshBits = GetRenderKeyBitsToFit((size_t)maxSubMeshIndex + 1, RENDER_KEY_SUB_MESH_BITS);
+			compactDepthBits = (sortByDepth ? RENDER_KEY_DEPTH_BITS : 0);
+
+			for (size_t i = 0; i < sortItems.size(); ++i)
+			{
+				const uint64_t key = sortItems[i].key;
+				uint64_t compact = GetRenderKeyField(key, RENDER_KEY_LAYOUT_SHIFT, RENDER_KEY_LAYOUT_BITS);
+				compact = (compact << pipelineBits) | GetRenderKeyField(key, RENDER_KEY_PIPELINE_SHIFT, pipelineBits);
+				compact = (compact << compactMeshBits) | GetRenderKeyField(key, RENDER_KEY_MESH_SHIFT, compactMeshBits);
+				compact = (compact << compactSubMeshBits) | GetRenderKeyField(key, RENDER_KEY_SUB_MESH_SHIFT, compactSubMeshBits);
+				compact = (compact << compactDepthBits) | GetRenderKeyField(key, RENDER_KEY_DEPTH_SHIFT, compactDepthBits);
+				sortItems[i].key = compact;
+			}
+		}
+	};
+
+	//adds the per-instance transform binding to a vertex input description, shaders read the model matrix as 4 vec4 columns
+	//binding should be the one the instance buffer is bound to, firstLocation the first of the 4 locations the columns use
+	static inline void AddInstanceTransformInputDescription(Wireframe::Pipeline::VertexInputDescription& description, const uint32_t& binding = 1, const uint32_t& firstLocation = 4)
+	{
+		VkVertexInputBindingDescription instanceBinding = {};
+		instanceBinding.binding = binding;
+		instanceBinding.stride = sizeof(glm::mat4);
+		instanceBinding.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+		description.bindings.push_back(instanceBinding);
+
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			VkVertexInputAttributeDescription columnAttribute = {};
+			columnAttribute.binding = binding;
+			columnAttribute.location = firstLocation + c;
+			columnAttribute.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+			columnAttribute.offset = sizeof(glm::vec4) * c;
+			description.attributes.push_back(columnAttribute);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+//SmokCook, cooks the static meshes under a folder into a output folder, keeping the same paths
+//meshes whose source and settings have not changed since the last cook are skipped, cooked meshes are cached by the hash of their source and settings
+//
+//SmokCook <source folder> <output folder> [--cache <folder>] [--layout float | packed-half | packed-unorm | quantized-half | quantized-unorm] [--weld <epsilon>] [--lods] [--optimize [cache size]] [--meshlets [max vertices] [max triangles]] [--encode [all | indices | vertices]] [--threads N]
+
+#include <Smok/Assets/MeshCook.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+//prints how to use the tool
+static inline void PrintUsage()
+{
+	fmt::print("SmokCook <source folder> <output folder> [--cache <folder>] [--layout float | packed-half | packed-unorm | quantized-half | quantized-unorm] [--weld <epsilon>] [--lods] [--optimize [cache size]] [--meshlets [max vertices] [max triangles]] [--encode [all | indices | vertices]] [--threads N]\n"
+		"The cache defaults to \"<output folder>/.smokcook\".\n");
+}
+
+//gets a vertex layout by it's name on the command line
+static inline bool GetVertexLayout(const std::string& name, Smok::Asset::Mesh::VertexLayout& layout)
+{
+	static const char* names[(size_t)Smok::Asset::Mesh::VertexLayout::Count] = { "float", "packed-half", "packed-unorm", "quantized-half", "quantized-unorm" };
+	for (size_t l = 0; l < (size_t)Smok::Asset::Mesh::VertexLayout::Count; ++l)
+	{
+		if (name == names[l])
+		{
+			layout = (Smok::Asset::Mesh::VertexLayout)l;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	const std::filesystem::path sourceFolder = argv[1], outputFolder = argv[2];
+	std::filesystem::path cacheFolder = outputFolder / ".smokcook";
+	Smok::Asset::Mesh::MeshCookSettings settings;
+	uint32_t threadCount = 0;
+	for (int i = 3; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+			cacheFolder = argv[++i];
+		else if (std::strcmp(argv[i], "--layout") == 0 && i + 1 < argc && GetVertexLayout(argv[i + 1], settings.vertexLayout))
+			++i;
+		else if (std::strcmp(argv[i], "--weld") == 0 && i + 1 < argc)
+		{
+			settings.weldVertices = true;
+			settings.weldSettings.positionEpsilon = settings.weldSettings.normalEpsilon = settings.weldSettings.colorEpsilon =
+				settings.weldSettings.textureCoordsEpsilon = (float)std::atof(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--lods") == 0)
+			settings.generateLODs = true;
+		else if (std::strcmp(argv[i], "--optimize") == 0)
+		{
+			settings.optimize = true;
+			if (i + 1 < argc && std::isdigit((unsigned char)argv[i + 1][0]))
+				settings.optimizeSettings.cacheSize = (uint32_t)std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--meshlets") == 0)
+		{
+			settings.buildMeshlets = true;
+			if (i + 1 < argc && std::isdigit((unsigned char)argv[i + 1][0]))
+				settings.meshletSettings.maxVertices = (uint32_t)std::atoi(argv[++i]);
+			if (i + 1 < argc && std::isdigit((unsigned char)argv[i + 1][0]))
+				settings.meshletSettings.maxTriangles = (uint32_t)std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--encode") == 0)
+		{
+			settings.encoding = Smok::Asset::Mesh::MeshEncoding_All;
+			if (i + 1 < argc && std::strcmp(argv[i + 1], "all") == 0)
+				++i;
+			else if (i + 1 < argc && std::strcmp(argv[i + 1], "indices") == 0)
+			{
+				settings.encoding = Smok::Asset::Mesh::MeshEncoding_Indices;
+				++i;
+			}
+			else if (i + 1 < argc && std::strcmp(argv[i + 1], "vertices") == 0)
+			{
+				settings.encoding = Smok::Asset::Mesh::MeshEncoding_Vertices;
+				++i;
+			}
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+			threadCount = (uint32_t)std::atoi(argv[++i]);
+		else
+		{
+			fmt::print("SmokCook Error: Unknown or incomplete option \"{}\".\n", argv[i]);
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	//every binary under the source folder is a job, the decl beside it is only read for v1 binaries
+	std::vector<Smok::Asset::Mesh::MeshCookJob> jobs;
+	std::error_code error;
+	for (auto it = std::filesystem::recursive_directory_iterator(sourceFolder, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+	{
+		if (!it->is_regular_file() || it->path().extension() != "." + Smok::Asset::Mesh::Serilize::GetSmeshBinaryFileExtensionStr())
+			continue;
+
+		std::filesystem::path decl = it->path();
+		decl.replace_extension(Smok::Asset::Mesh::Serilize::GetSmeshDeclFileExtensionStr());
+		const std::filesystem::path output = outputFolder / std::filesystem::relative(it->path(), sourceFolder);
+		std::filesystem::path outputDecl = output;
+		outputDecl.replace_extension(Smok::Asset::Mesh::Serilize::GetSmeshDeclFileExtensionStr());
+
+		Smok::Asset::Mesh::MeshCookJob& job = jobs.emplace_back();
+		job.sourceDeclFile = BTD::IO::FileInfo(decl.string());
+		job.sourceBinaryFile = BTD::IO::FileInfo(it->path().string());
+		job.outputDeclFile = BTD::IO::FileInfo(outputDecl.string());
+		job.outputBinaryFile = BTD::IO::FileInfo(output.string());
+		job.settings = settings;
+	}
+	if (error)
+	{
+		fmt::print("SmokCook Error: Failed to read the folder \"{}\", {}.\n", sourceFolder.string(), error.message());
+		return 1;
+	}
+
+	Smok::Asset::Mesh::MeshCooker cooker;
+	cooker.threadCount = threadCount;
+	if (!cooker.Init(cacheFolder.string()))
+		return 1;
+
+	const Smok::Asset::Mesh::MeshCookStats stats = cooker.Cook(jobs);
+	fmt::print("Cooked {} static meshes in {:.1f} ms, {} up to date, {} from the cache, {} cooked, {} failed, {} bytes read.\n",
+		jobs.size(), stats.milliseconds, stats.upToDate, stats.cacheHits, stats.cooked, stats.failed, stats.bytesRead);
+	return (stats.failed > 0 ? 1 : 0);
+}
\ No newline at end of file
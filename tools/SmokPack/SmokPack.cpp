@@ -0,0 +1,168 @@
+//SmokPack, bundles the static meshes under a folder and any graphics pipelines given into a Smok asset pack
+//each mesh is named by it's path from the folder without the extension, "meshes/rock.smesh" becomes "meshes/rock"
+//each pipeline is named by it's --pipeline name, the SPIR-V paths in the shader settings are read from the working directory the same as the game does
+//
+//SmokPack pack <output.spak> <folder> [--pipeline <name> <pipeline settings> <vertex shader settings> <fragment shader settings>]... [--lz4 | --zstd] [--level N] [--align N]
+//SmokPack list <pack.spak>
+//SmokPack verify <pack.spak>
+
+#include <Smok/Assets/AssetPack.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+//prints how to use the tool
+static inline void PrintUsage()
+{
+	fmt::print("SmokPack pack <output.{0}> <folder> [--pipeline <name> <pipeline settings> <vertex shader settings> <fragment shader settings>]... [--lz4 | --zstd] [--level N] [--align N]\n"
+		"SmokPack list <pack.{0}>\n"
+		"SmokPack verify <pack.{0}>\n", Smok::Asset::Pack::GetAssetPackFileExtensionStr());
+}
+
+//defines a graphics pipeline given on the command line
+struct PipelineFiles
+{
+	std::string name;
+	std::string pipelineFile;
+	std::string vertexShaderFile;
+	std::string fragmentShaderFile;
+};
+
+//packs every static mesh under a folder and the graphics pipelines
+static inline int Pack(const std::string& output, const std::string& folder, const std::vector<PipelineFiles>& pipelines, Smok::Asset::Pack::AssetPackWriter& writer)
+{
+	const auto start = std::chrono::high_resolution_clock::now();
+
+	//the binaries are gathered and sorted first so the same folder always makes the same pack
+	std::vector<std::filesystem::path> binaries;
+	std::error_code error;
+	for (auto it = std::filesystem::recursive_directory_iterator(folder, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+	{
+		if (it->is_regular_file() && it->path().extension() == "." + Smok::Asset::Mesh::Serilize::GetSmeshBinaryFileExtensionStr())
+			binaries.emplace_back(it->path());
+	}
+	if (error)
+	{
+		fmt::print("SmokPack Error: Failed to read the folder \"{}\", {}.\n", folder, error.message());
+		return 1;
+	}
+	std::sort(binaries.begin(), binaries.end());
+
+	if (!writer.Begin(BTD::IO::FileInfo(output)))
+		return 1;
+
+	size_t failed = 0;
+	for (const std::filesystem::path& binary : binaries)
+	{
+		std::filesystem::path decl = binary;
+		decl.replace_extension(Smok::Asset::Mesh::Serilize::GetSmeshDeclFileExtensionStr());
+
+		std::filesystem::path name = std::filesystem::relative(binary, folder);
+		name.replace_extension();
+		if (!writer.AddStaticMeshFiles(name.generic_string(), BTD::IO::FileInfo(decl.string()), BTD::IO::FileInfo(binary.string())))
+			failed++;
+	}
+
+	for (const PipelineFiles& pipeline : pipelines)
+	{
+		if (!writer.AddGraphicsPipelineFiles(pipeline.name, BTD::IO::FileInfo(pipeline.pipelineFile),
+			BTD::IO::FileInfo(pipeline.vertexShaderFile), BTD::IO::FileInfo(pipeline.fragmentShaderFile)))
+			failed++;
+	}
+
+	//a pack missing assets would fail at runtime instead of here
+	if (failed > 0)
+	{
+		fmt::print("SmokPack Error: {} of {} assets could not be packed, \"{}\" was not written.\n", failed, binaries.size() + pipelines.size(), output);
+		writer.Abort();
+		return 1;
+	}
+
+	if (!writer.Finish())
+		return 1;
+
+	const Smok::Asset::Pack::PackWriteStats& stats = writer.stats;
+	fmt::print("Packed {} static meshes and {} graphics pipelines as {} entries into \"{}\" in {:.1f} ms, {} bytes stored for {} bytes of data ({:.1f}%), {} entries compressed.\n",
+		binaries.size(), pipelines.size(), stats.entries, output, std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count(),
+		stats.bytesStored, stats.bytesIn, (stats.bytesIn > 0 ? 100.0 * (double)stats.bytesStored / (double)stats.bytesIn : 100.0), stats.compressedEntries);
+	return 0;
+}
+
+//lists or verifies every entry in a pack
+static inline int List(const std::string& input, const bool& verify)
+{
+	Smok::Asset::Pack::AssetPack pack;
+	if (!pack.Open(BTD::IO::FileInfo(input)))
+		return 1;
+
+	size_t failed = 0;
+	for (size_t e = 0; e < pack.GetEntryCount(); ++e)
+	{
+		const Smok::Asset::Pack::PackEntry& entry = pack.GetEntry(e);
+		const bool isValid = (!verify || pack.VerifyEntry(entry));
+		failed += !isValid;
+		fmt::print("{:016x} {:>17} {:>12} {:>12} {:>5} {}{}\n", entry.assetHash, Smok::Asset::Pack::GetPackEntryTypeStr(entry.type), entry.size, entry.storedSize,
+			Smok::Asset::Pack::GetPackCompressionStr(entry.compression), pack.GetName(entry), (isValid ? "" : " CORRUPT"));
+	}
+
+	fmt::print("{} entries, {} bytes.\n", pack.GetEntryCount(), pack.file.size);
+	if (verify && failed > 0)
+	{
+		fmt::print("SmokPack Error: {} entries in \"{}\" do not match the hash they were packed with.\n", failed, input);
+		return 1;
+	}
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	const std::string command = argv[1];
+	if (command == "list" || command == "verify")
+		return List(argv[2], command == "verify");
+
+	if (command != "pack" || argc < 4)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	Smok::Asset::Pack::AssetPackWriter writer;
+	std::vector<PipelineFiles> pipelines;
+	for (int i = 4; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--pipeline") == 0 && i + 4 < argc)
+		{
+			pipelines.push_back({ argv[i + 1], argv[i + 2], argv[i + 3], argv[i + 4] });
+			i += 4;
+		}
+		else if (std::strcmp(argv[i], "--lz4") == 0)
+			writer.compression = Smok::Asset::Pack::PackCompression::LZ4;
+		else if (std::strcmp(argv[i], "--zstd") == 0)
+			writer.compression = Smok::Asset::Pack::PackCompression::Zstd;
+		else if (std::strcmp(argv[i], "--level") == 0 && i + 1 < argc)
+			writer.compressionLevel = std::atoi(argv[++i]);
+		else if (std::strcmp(argv[i], "--align") == 0 && i + 1 < argc)
+			writer.payloadAlignment = std::strtoull(argv[++i], nullptr, 10);
+		else
+		{
+			fmt::print("SmokPack Error: Unknown option \"{}\".\n", argv[i]);
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	return Pack(argv[2], argv[3], pipelines, writer);
+}
\ No newline at end of file